@@ -0,0 +1,46 @@
+#include "affine_transform.h"
+
+#include <glm/geometric.hpp> // glm::cross, glm::dot
+
+
+
+AffineTransform inverse(AffineTransform const &t) {
+	glm::vec4 const &r0 = t.m_Rows[0];
+	glm::vec4 const &r1 = t.m_Rows[1];
+	glm::vec4 const &r2 = t.m_Rows[2];
+
+	// inverse of the 3x3 linear part = adjugate / determinant (cofactors via cross products of the rows)
+	glm::vec3 const a(r0);
+	glm::vec3 const b(r1);
+	glm::vec3 const c(r2);
+	glm::vec3 const bc = glm::cross(b, c);
+	float const det = glm::dot(a, bc);
+	if (0.0f == det) return AffineTransform::identity();
+	float const invDet = 1.0f / det;
+	glm::vec3 const ca = glm::cross(c, a);
+	glm::vec3 const ab = glm::cross(a, b);
+
+	// the cross products are the COLUMNS of the inverse, so transpose them into rows
+	AffineTransform result;
+	result.m_Rows[0] = glm::vec4(bc.x, ca.x, ab.x, 0.0f) * invDet;
+	result.m_Rows[1] = glm::vec4(bc.y, ca.y, ab.y, 0.0f) * invDet;
+	result.m_Rows[2] = glm::vec4(bc.z, ca.z, ab.z, 0.0f) * invDet;
+
+	// translation = -inverse(L) * t
+	glm::vec3 const translation = -result.transformVector(t.getTranslation());
+	result.m_Rows[0].w = translation.x;
+	result.m_Rows[1].w = translation.y;
+	result.m_Rows[2].w = translation.z;
+	return result;
+}
+
+AffineTransform inverseRigid(AffineTransform const &t) {
+	AffineTransform result;
+	for (int r = 0; r < 3; ++r) result.m_Rows[r] = glm::vec4(t.m_Rows[0][r], t.m_Rows[1][r], t.m_Rows[2][r], 0.0f);
+
+	glm::vec3 const translation = -result.transformVector(t.getTranslation());
+	result.m_Rows[0].w = translation.x;
+	result.m_Rows[1].w = translation.y;
+	result.m_Rows[2].w = translation.z;
+	return result;
+}
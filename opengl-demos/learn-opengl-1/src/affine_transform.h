@@ -0,0 +1,144 @@
+#pragma once
+
+#include <glm/vec3.hpp> // glm::vec3
+#include <glm/vec4.hpp> // glm::vec4
+#include <glm/mat4x4.hpp> // glm::mat4
+#include <glm/geometric.hpp> // glm::normalize
+
+#include <cmath>
+
+// compact affine transform for MODEL and VIEW matrices (see the MODEL/VIEW/PROJECTION note at the bottom of main.cpp)
+// - both are always affine, so the bottom row of their glm::mat4 is always (0, 0, 0, 1) and never needs storing or multiplying
+// - 3 rows of 4 floats = 48 bytes instead of 64 (25% less to store/upload per object or per instance)
+// - stored ROW-major so each row is 1 vec4 (3 vec4 attributes if it's ever streamed per instance)
+// - inverse is a 3x3 inverse + translation (no general 4x4 inverse): about half the time of glm::inverse in glmBenchMain()
+// - building and composing is SLOWER than glm::mat4, measured with glmBenchMain() (ns per op, glm::mat4 in brackets):
+//   compose 18.1 (11.8), translate 24 (4.5), rotate 46 (27), camera() 120 (84). glm's mat4 * mat4 is 4 SIMD column sums and
+//   its translate/rotate only touch the columns they change, the 12 floats saved don't make up for that
+// - so it's worth it where transforms are stored, streamed or inverted (scene graph world transforms, per-object data, view
+//   matrices), building a matrix from a few steps (like camera()) stays glm::mat4
+// - the factories, compose and mat4 * AffineTransform are inline (out of line, every step was a call and a trip through memory)
+
+
+
+struct AffineTransform {
+	glm::vec4 m_Rows[3]; // row r = (linear part row r, translation r)
+
+	static AffineTransform identity();
+	static AffineTransform translation(glm::vec3 const &t);
+	static AffineTransform scale(glm::vec3 const &s);
+	static AffineTransform rotation(float angle, glm::vec3 const &axis); // radians, axis doesn't need to be normalized (same as glm::rotate)
+	static AffineTransform fromTRS(glm::vec3 const &t, glm::vec3 const &axis, float angle, glm::vec3 const &s); // T * R * S
+	static AffineTransform fromMat4(glm::mat4 const &m); // drops the bottom row, so only meaningful for affine m
+
+	glm::mat4 toMat4() const;
+
+	glm::vec3 transformPoint(glm::vec3 const &p) const {
+		glm::vec4 const p4(p, 1.0f);
+		return glm::vec3(dot4(m_Rows[0], p4), dot4(m_Rows[1], p4), dot4(m_Rows[2], p4));
+	}
+
+	// directions ignore the translation
+	glm::vec3 transformVector(glm::vec3 const &v) const {
+		glm::vec4 const v4(v, 0.0f);
+		return glm::vec3(dot4(m_Rows[0], v4), dot4(m_Rows[1], v4), dot4(m_Rows[2], v4));
+	}
+
+	glm::vec3 getTranslation() const { return glm::vec3(m_Rows[0].w, m_Rows[1].w, m_Rows[2].w); }
+
+private:
+	static float dot4(glm::vec4 const &a, glm::vec4 const &b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+};
+
+
+
+inline AffineTransform AffineTransform::identity() {
+	AffineTransform t;
+	t.m_Rows[0] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+	t.m_Rows[1] = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
+	t.m_Rows[2] = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
+	return t;
+}
+
+inline AffineTransform AffineTransform::translation(glm::vec3 const &t) {
+	AffineTransform result = identity();
+	result.m_Rows[0].w = t.x;
+	result.m_Rows[1].w = t.y;
+	result.m_Rows[2].w = t.z;
+	return result;
+}
+
+inline AffineTransform AffineTransform::scale(glm::vec3 const &s) {
+	AffineTransform result;
+	result.m_Rows[0] = glm::vec4(s.x, 0.0f, 0.0f, 0.0f);
+	result.m_Rows[1] = glm::vec4(0.0f, s.y, 0.0f, 0.0f);
+	result.m_Rows[2] = glm::vec4(0.0f, 0.0f, s.z, 0.0f);
+	return result;
+}
+
+inline AffineTransform AffineTransform::rotation(float angle, glm::vec3 const &axis) {
+	// same axis-angle formula as glm::rotate, written out by row
+	float const c = std::cos(angle);
+	float const s = std::sin(angle);
+	glm::vec3 const a = glm::normalize(axis);
+	glm::vec3 const temp = (1.0f - c) * a;
+
+	AffineTransform result;
+	result.m_Rows[0] = glm::vec4(c + temp.x * a.x, temp.y * a.x - s * a.z, temp.z * a.x + s * a.y, 0.0f);
+	result.m_Rows[1] = glm::vec4(temp.x * a.y + s * a.z, c + temp.y * a.y, temp.z * a.y - s * a.x, 0.0f);
+	result.m_Rows[2] = glm::vec4(temp.x * a.z - s * a.y, temp.y * a.z + s * a.x, c + temp.z * a.z, 0.0f);
+	return result;
+}
+
+inline AffineTransform AffineTransform::fromTRS(glm::vec3 const &t, glm::vec3 const &axis, float angle, glm::vec3 const &s) {
+	// R * S just scales the columns of R, then T only fills in the translation
+	AffineTransform result = rotation(angle, axis);
+	glm::vec4 const columnScale(s, 0.0f);
+	for (int r = 0; r < 3; ++r) result.m_Rows[r] *= columnScale;
+	result.m_Rows[0].w = t.x;
+	result.m_Rows[1].w = t.y;
+	result.m_Rows[2].w = t.z;
+	return result;
+}
+
+inline AffineTransform AffineTransform::fromMat4(glm::mat4 const &m) {
+	// glm::mat4 is column-major (m[column][row])
+	AffineTransform result;
+	for (int r = 0; r < 3; ++r) result.m_Rows[r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+	return result;
+}
+
+inline glm::mat4 AffineTransform::toMat4() const {
+	glm::mat4 m;
+	for (int c = 0; c < 4; ++c) m[c] = glm::vec4(m_Rows[0][c], m_Rows[1][c], m_Rows[2][c], (3 == c) ? 1.0f : 0.0f);
+	return m;
+}
+
+
+
+// a * b = apply b first, then a (same order as glm::mat4 multiplication)
+inline AffineTransform operator*(AffineTransform const &a, AffineTransform const &b) {
+	AffineTransform result;
+	for (int r = 0; r < 3; ++r) {
+		glm::vec4 const &row = a.m_Rows[r];
+		// + row.w * the implicit (0, 0, 0, 1) bottom row of b, as part of the same sum (adding it to .w afterwards stores the row,
+		// reloads 1 float and stores again, and the next load of that row stalls on store forwarding)
+		result.m_Rows[r] = row.x * b.m_Rows[0] + row.y * b.m_Rows[1] + row.z * b.m_Rows[2] + glm::vec4(0.0f, 0.0f, 0.0f, row.w);
+	}
+	return result;
+}
+
+// projection * (view * model), the only place a full 4x4 is still needed (b's implicit bottom row saves a quarter of the multiplies)
+inline glm::mat4 operator*(glm::mat4 const &a, AffineTransform const &b) {
+	// column c of the result = a * (column c of b), where b's columns have an implicit 0 (or 1 for the translation) at the bottom
+	glm::mat4 result;
+	for (int c = 0; c < 3; ++c) result[c] = a[0] * b.m_Rows[0][c] + a[1] * b.m_Rows[1][c] + a[2] * b.m_Rows[2][c];
+	result[3] = a[0] * b.m_Rows[0].w + a[1] * b.m_Rows[1].w + a[2] * b.m_Rows[2].w + a[3];
+	return result;
+}
+
+// general affine inverse (handles scale and shear), returns identity for singular transforms
+AffineTransform inverse(AffineTransform const &t);
+
+// inverse for rotation + translation only (e.g. a camera's VIEW), just a transpose
+AffineTransform inverseRigid(AffineTransform const &t);
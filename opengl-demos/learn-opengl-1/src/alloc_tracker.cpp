@@ -0,0 +1,254 @@
+#include "alloc_tracker.h"
+
+#include <cassert>
+#include <iostream>
+
+#ifdef ALLOCATION_TRACKING
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <dbghelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#include <malloc.h> // _aligned_malloc
+#if defined(_DEBUG)
+#include <crtdbg.h>
+#endif
+#elif defined(__GLIBC__)
+#include <execinfo.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace {
+	size_t const MAX_OFFENDERS = 32;
+	size_t const MAX_STACK_DEPTH = 24;
+
+	// fixed storage, the hooks can't allocate
+	struct Offender {
+		size_t m_Size;
+		unsigned int m_Depth;
+		void *m_Stack[MAX_STACK_DEPTH];
+	};
+
+	std::atomic<uint64_t> s_Allocations{ 0 };
+	std::atomic<uint64_t> s_Bytes{ 0 };
+	std::atomic<bool> s_CaptureStacks{ false };
+	std::atomic<size_t> s_OffenderCount{ 0 }; // can go past MAX_OFFENDERS, the rest are dropped
+	Offender s_Offenders[MAX_OFFENDERS];
+
+	thread_local uint64_t t_Allocations = 0;
+	thread_local uint64_t t_Bytes = 0;
+	thread_local bool t_InHook = false; // stack capture may allocate, and operator new's malloc() must not count twice
+
+	void recordAllocation(size_t size) {
+		s_Allocations.fetch_add(1, std::memory_order_relaxed);
+		s_Bytes.fetch_add(size, std::memory_order_relaxed);
+		++t_Allocations;
+		t_Bytes += size;
+
+		if (!s_CaptureStacks.load(std::memory_order_relaxed)) return;
+		size_t const index = s_OffenderCount.fetch_add(1, std::memory_order_relaxed);
+		if (index >= MAX_OFFENDERS) return;
+		Offender &offender = s_Offenders[index];
+		offender.m_Size = size;
+#if defined(_WIN32)
+		offender.m_Depth = CaptureStackBackTrace(2, MAX_STACK_DEPTH, offender.m_Stack, nullptr);
+#elif defined(__GLIBC__)
+		offender.m_Depth = static_cast<unsigned int>(backtrace(offender.m_Stack, MAX_STACK_DEPTH));
+#else
+		offender.m_Depth = 0;
+#endif
+	}
+
+	// alignment 0 = malloc()'s own
+	void *trackedAlloc(size_t size, size_t alignment = 0) {
+		bool const outer = !t_InHook;
+		t_InHook = true;
+		if (outer) recordAllocation(size);
+		size = size ? size : 1;
+		void *memory = nullptr;
+		if (0 == alignment) memory = std::malloc(size);
+#if defined(_WIN32)
+		else memory = _aligned_malloc(size, alignment);
+#else
+		else if (0 != posix_memalign(&memory, alignment < sizeof(void *) ? sizeof(void *) : alignment, size)) memory = nullptr;
+#endif
+		t_InHook = !outer;
+		return memory;
+	}
+
+	// what trackedAlloc() with an alignment returned (_aligned_malloc() memory can't go to free())
+	void alignedFree(void *memory) {
+#if defined(_WIN32)
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+#if defined(_WIN32) && defined(_DEBUG)
+	// debug CRT: sees malloc() as well (operator new's own malloc() is skipped through t_InHook)
+	int crtAllocHook(int allocType, void *, size_t size, int blockType, long, unsigned char const *, int) {
+		if (_HOOK_FREE == allocType || _CRT_BLOCK == blockType || t_InHook) return TRUE;
+		t_InHook = true;
+		recordAllocation(size);
+		t_InHook = false;
+		return TRUE;
+	}
+
+	struct CrtHookInstaller {
+		CrtHookInstaller() { _CrtSetAllocHook(crtAllocHook); }
+	} s_CrtHookInstaller;
+#endif
+}
+
+
+
+void *operator new(size_t size) {
+	void *memory = trackedAlloc(size);
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void *operator new[](size_t size) {
+	void *memory = trackedAlloc(size);
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void *operator new(size_t size, std::nothrow_t const &) noexcept { return trackedAlloc(size); }
+void *operator new[](size_t size, std::nothrow_t const &) noexcept { return trackedAlloc(size); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::nothrow_t const &) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::nothrow_t const &) noexcept { std::free(memory); }
+
+#if defined(__cpp_aligned_new)
+// over-aligned types (alignas bigger than the default new alignment) come through these
+void *operator new(size_t size, std::align_val_t alignment) {
+	void *memory = trackedAlloc(size, static_cast<size_t>(alignment));
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+	void *memory = trackedAlloc(size, static_cast<size_t>(alignment));
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void *operator new(size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept { return trackedAlloc(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept { return trackedAlloc(size, static_cast<size_t>(alignment)); }
+void operator delete(void *memory, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete(void *memory, size_t, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete(void *memory, std::align_val_t, std::nothrow_t const &) noexcept { alignedFree(memory); }
+void operator delete[](void *memory, std::align_val_t, std::nothrow_t const &) noexcept { alignedFree(memory); }
+#endif
+
+
+
+AllocationCounts processAllocationCounts() {
+	AllocationCounts counts;
+	counts.m_Allocations = s_Allocations.load(std::memory_order_relaxed);
+	counts.m_Bytes = s_Bytes.load(std::memory_order_relaxed);
+	return counts;
+}
+
+AllocationCounts threadAllocationCounts() {
+	AllocationCounts counts;
+	counts.m_Allocations = t_Allocations;
+	counts.m_Bytes = t_Bytes;
+	return counts;
+}
+
+void setAllocationStackCapture(bool capture) {
+	s_CaptureStacks.store(capture, std::memory_order_relaxed);
+}
+
+size_t reportAllocationOffenders() {
+	bool const capturing = s_CaptureStacks.exchange(false, std::memory_order_relaxed); // the printing allocates too
+	size_t const count = s_OffenderCount.load(std::memory_order_relaxed);
+	size_t const captured = count < MAX_OFFENDERS ? count : MAX_OFFENDERS;
+
+#if defined(_WIN32)
+	HANDLE const process = GetCurrentProcess();
+	static bool s_SymbolsLoaded = false;
+	if (!s_SymbolsLoaded) s_SymbolsLoaded = 0 != SymInitialize(process, nullptr, TRUE);
+#endif
+
+	for (size_t i = 0; i < captured; ++i) {
+		Offender const &offender = s_Offenders[i];
+		std::cout << "ALLOCATION::OFFENDER " << offender.m_Size << " bytes" << std::endl;
+#if defined(_WIN32)
+		char symbolStorage[sizeof(SYMBOL_INFO) + 256] = {};
+		SYMBOL_INFO *symbol = reinterpret_cast<SYMBOL_INFO *>(symbolStorage);
+		symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		symbol->MaxNameLen = 255;
+		for (unsigned int frame = 0; frame < offender.m_Depth; ++frame) {
+			DWORD64 const address = reinterpret_cast<DWORD64>(offender.m_Stack[frame]);
+			IMAGEHLP_LINE64 line = {};
+			line.SizeOfStruct = sizeof(line);
+			DWORD displacement = 0;
+			std::cout << "    " << offender.m_Stack[frame];
+			if (s_SymbolsLoaded && SymFromAddr(process, address, nullptr, symbol)) std::cout << " " << symbol->Name;
+			if (s_SymbolsLoaded && SymGetLineFromAddr64(process, address, &displacement, &line)) std::cout << " (" << line.FileName << ":" << line.LineNumber << ")";
+			std::cout << std::endl;
+		}
+#elif defined(__GLIBC__)
+		std::cout.flush();
+		backtrace_symbols_fd(const_cast<void **>(offender.m_Stack), static_cast<int>(offender.m_Depth), STDOUT_FILENO);
+#endif
+	}
+	if (count > captured) std::cout << "ALLOCATION::OFFENDER " << count - captured << " more (not captured)" << std::endl;
+
+	s_OffenderCount.store(0, std::memory_order_relaxed);
+	s_CaptureStacks.store(capturing, std::memory_order_relaxed);
+	return count;
+}
+#endif // ALLOCATION_TRACKING
+
+
+
+ZeroAllocationCheck::ZeroAllocationCheck(char const *name, uint64_t warmupFrames) : m_Name(name), m_WarmupFrames(warmupFrames), m_Last(processAllocationCounts()) {}
+
+ZeroAllocationCheck::~ZeroAllocationCheck() {
+#ifdef ALLOCATION_TRACKING
+	setAllocationStackCapture(false);
+	std::cout << "ZERO_ALLOCATION::" << m_Name << (0 == m_FramesWithAllocations ? "::PASSED " : "::FAILED ") << m_FramesWithAllocations
+		<< " of " << (m_Frame > m_WarmupFrames ? m_Frame - m_WarmupFrames : 0) << " frames after warm-up allocated" << std::endl;
+	assert(0 == m_FramesWithAllocations && "the steady-state frame allocated, see the ALLOCATION::OFFENDER stacks above");
+#endif
+}
+
+void ZeroAllocationCheck::endFrame() {
+#ifdef ALLOCATION_TRACKING
+	++m_Frame;
+	AllocationCounts const now = processAllocationCounts();
+	uint64_t const allocations = now.m_Allocations - m_Last.m_Allocations;
+	uint64_t const bytes = now.m_Bytes - m_Last.m_Bytes;
+	m_Last = now;
+
+	if (m_Frame == m_WarmupFrames) setAllocationStackCapture(true);
+	if (m_Frame <= m_WarmupFrames || 0 == allocations) return;
+
+	++m_FramesWithAllocations;
+	if (m_FramesWithAllocations <= MAX_REPORTED_FRAMES) {
+		std::cout << "ALLOCATION::FRAME::" << m_Name << " frame " << m_Frame << ": " << allocations << " allocations, " << bytes << " bytes" << std::endl;
+		reportAllocationOffenders();
+	}
+	else {
+		s_OffenderCount.store(0, std::memory_order_relaxed);
+	}
+	m_Last = processAllocationCounts(); // don't blame the printing on the next frame
+#endif
+}
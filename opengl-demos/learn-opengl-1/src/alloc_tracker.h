@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// heap allocation tracking, to prove the steady-state frame doesn't allocate (allocation spikes = frame-time hitches)
+// - only with ALLOCATION_TRACKING defined: msbuild /p:AllocationTracking=true (or that environment variable when starting
+//   Visual Studio) adds it to any configuration, Debug|Win32 is the one to check with (console output, asserts, malloc hook);
+//   elsewhere -DALLOCATION_TRACKING. Without it everything below compiles to nothing and reports 0
+// - counted: every global operator new (plain, array, nothrow and, with C++17 aligned new, the align_val_t forms),
+//   alloc_tracker.cpp replaces them and the matching deletes
+// - plain malloc()/calloc()/realloc() (C code, GLFW, the GL driver) are only counted under _WIN32 && _DEBUG, through a
+//   _CrtSetAllocHook: in release builds and on other platforms they go unseen, so a check passing there only covers new
+// - process-wide counts, per-thread counts (AllocationScope) and per-frame checks (ZeroAllocationCheck)
+// - while stack capture is on, every allocation records its call stack (up to MAX_OFFENDERS), reportAllocationOffenders() prints them
+
+
+
+struct AllocationCounts {
+	uint64_t m_Allocations = 0;
+	uint64_t m_Bytes = 0;
+};
+
+#ifdef ALLOCATION_TRACKING
+// all threads, since startup
+AllocationCounts processAllocationCounts();
+// the calling thread, since it started
+AllocationCounts threadAllocationCounts();
+void setAllocationStackCapture(bool capture);
+// prints the captured stacks and forgets them, returns how many there were
+size_t reportAllocationOffenders();
+#else
+inline AllocationCounts processAllocationCounts() { return AllocationCounts(); }
+inline AllocationCounts threadAllocationCounts() { return AllocationCounts(); }
+inline void setAllocationStackCapture(bool) {}
+inline size_t reportAllocationOffenders() { return 0; }
+#endif
+
+
+
+// the calling thread's allocations since construction
+class AllocationScope {
+public:
+	AllocationScope() : m_Start(threadAllocationCounts()) {}
+
+	AllocationCounts getCounts() const {
+		AllocationCounts counts = threadAllocationCounts();
+		counts.m_Allocations -= m_Start.m_Allocations;
+		counts.m_Bytes -= m_Start.m_Bytes;
+		return counts;
+	}
+
+private:
+	AllocationCounts m_Start;
+};
+
+// endFrame() once per frame: after the warm-up frames, every frame that allocated (any thread) is reported with its stacks
+// the destructor prints a summary and asserts (debug builds) that there were none
+class ZeroAllocationCheck {
+public:
+	static size_t const MAX_REPORTED_FRAMES = 8; // only the first few get printed
+
+	explicit ZeroAllocationCheck(char const *name, uint64_t warmupFrames = 60);
+	~ZeroAllocationCheck();
+
+	ZeroAllocationCheck(ZeroAllocationCheck const &) = delete;
+	ZeroAllocationCheck &operator=(ZeroAllocationCheck const &) = delete;
+
+	void endFrame();
+	uint64_t getFramesWithAllocations() const { return m_FramesWithAllocations; }
+
+private:
+	char const *m_Name;
+	uint64_t m_WarmupFrames;
+	uint64_t m_Frame = 0;
+	uint64_t m_FramesWithAllocations = 0;
+	AllocationCounts m_Last;
+};
@@ -0,0 +1,717 @@
+#include "bc_encoder.h"
+#include "texture_container.h"
+
+#include <glad/glad.h>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// EXT_texture_compression_s3tc / EXT_texture_sRGB, not in the core 3.3 glad header
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+
+
+namespace {
+	uint32_t const ENCODER_VERSION = 1; // bump whenever the encoder's output changes, so old cache files stop matching
+
+	// 16 pixels, 1 array per channel so 4 pixels fill an SSE register
+	struct ColorBlock {
+		alignas(16) float m_R[16];
+		alignas(16) float m_G[16];
+		alignas(16) float m_B[16];
+	};
+
+	struct ValueBlock {
+		alignas(16) float m_Values[16];
+	};
+
+	// nearest palette entry for each pixel, returns the summed squared error (exact: integer values, well below 2^24)
+	typedef float (*MatchColorsFn)(ColorBlock const &block, float const (&palette)[4][3], uint8_t *indices);
+	typedef float (*MatchValuesFn)(ValueBlock const &block, float const (&palette)[8], uint8_t *indices);
+
+	struct Matchers {
+		MatchColorsFn m_Colors;
+		MatchValuesFn m_Values;
+	};
+
+
+
+	// --- palettes (the encoder scores candidates against exactly what decodeBc() produces)
+
+	void unpack565(uint16_t color, int (&rgb)[3]) {
+		int const r = color >> 11;
+		int const g = (color >> 5) & 63;
+		int const b = color & 31;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	uint16_t pack565(float r, float g, float b) {
+		int const r8 = static_cast<int>(std::min(std::max(r, 0.0f), 255.0f) + 0.5f);
+		int const g8 = static_cast<int>(std::min(std::max(g, 0.0f), 255.0f) + 0.5f);
+		int const b8 = static_cast<int>(std::min(std::max(b, 0.0f), 255.0f) + 0.5f);
+		return static_cast<uint16_t>((((r8 * 31 + 127) / 255) << 11) | (((g8 * 63 + 127) / 255) << 5) | ((b8 * 31 + 127) / 255));
+	}
+
+	// threeColor: BC1's c0 <= c1 mode (index 2 = midpoint, 3 = black), BC3 always uses 4 colours
+	void colorPalette(uint16_t c0, uint16_t c1, bool threeColor, int (&palette)[4][3]) {
+		unpack565(c0, palette[0]);
+		unpack565(c1, palette[1]);
+		for (int c = 0; c < 3; ++c) {
+			if (threeColor) {
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+			else {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+		}
+	}
+
+	// a0 > a1: 6 interpolated values, otherwise 4 + 0 and 255
+	void valuePalette(int a0, int a1, int (&palette)[8]) {
+		palette[0] = a0;
+		palette[1] = a1;
+		if (a0 > a1) {
+			for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+			return;
+		}
+		for (int i = 2; i < 6; ++i) palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+
+
+	// --- palette matching, the inner loop of every endpoint search
+
+	float matchColorsScalar(ColorBlock const &block, float const (&palette)[4][3], uint8_t *indices) {
+		float total = 0.0f;
+		for (int p = 0; p < 16; ++p) {
+			float best = FLT_MAX;
+			uint8_t bestIndex = 0;
+			for (int i = 0; i < 4; ++i) {
+				float const dr = block.m_R[p] - palette[i][0];
+				float const dg = block.m_G[p] - palette[i][1];
+				float const db = block.m_B[p] - palette[i][2];
+				float const distance = dr * dr + dg * dg + db * db;
+				if (distance < best) {
+					best = distance;
+					bestIndex = static_cast<uint8_t>(i);
+				}
+			}
+			indices[p] = bestIndex;
+			total += best;
+		}
+		return total;
+	}
+
+	float matchValuesScalar(ValueBlock const &block, float const (&palette)[8], uint8_t *indices) {
+		float total = 0.0f;
+		for (int p = 0; p < 16; ++p) {
+			float best = FLT_MAX;
+			uint8_t bestIndex = 0;
+			for (int i = 0; i < 8; ++i) {
+				float const d = block.m_Values[p] - palette[i];
+				if (d * d < best) {
+					best = d * d;
+					bestIndex = static_cast<uint8_t>(i);
+				}
+			}
+			indices[p] = bestIndex;
+			total += best;
+		}
+		return total;
+	}
+
+	// same sums in the same order, 4 pixels at a time, ties keep the lower index like the scalar loop
+	float horizontalSum(__m128 v) {
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, v);
+		return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	}
+
+	void storeIndices(__m128i index, uint8_t *indices) {
+		alignas(16) int32_t lanes[4];
+		_mm_store_si128(reinterpret_cast<__m128i *>(lanes), index);
+		for (int i = 0; i < 4; ++i) indices[i] = static_cast<uint8_t>(lanes[i]);
+	}
+
+	float matchColorsSSE2(ColorBlock const &block, float const (&palette)[4][3], uint8_t *indices) {
+		__m128 total = _mm_setzero_ps();
+		for (int q = 0; q < 16; q += 4) {
+			__m128 const r = _mm_load_ps(block.m_R + q);
+			__m128 const g = _mm_load_ps(block.m_G + q);
+			__m128 const b = _mm_load_ps(block.m_B + q);
+			__m128 best = _mm_set1_ps(FLT_MAX);
+			__m128i bestIndex = _mm_setzero_si128();
+			for (int i = 0; i < 4; ++i) {
+				__m128 const dr = _mm_sub_ps(r, _mm_set1_ps(palette[i][0]));
+				__m128 const dg = _mm_sub_ps(g, _mm_set1_ps(palette[i][1]));
+				__m128 const db = _mm_sub_ps(b, _mm_set1_ps(palette[i][2]));
+				__m128 const distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+				__m128i const closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+				best = _mm_min_ps(distance, best);
+				bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(i)), _mm_andnot_si128(closer, bestIndex));
+			}
+			total = _mm_add_ps(total, best);
+			storeIndices(bestIndex, indices + q);
+		}
+		return horizontalSum(total);
+	}
+
+	float matchValuesSSE2(ValueBlock const &block, float const (&palette)[8], uint8_t *indices) {
+		__m128 total = _mm_setzero_ps();
+		for (int q = 0; q < 16; q += 4) {
+			__m128 const values = _mm_load_ps(block.m_Values + q);
+			__m128 best = _mm_set1_ps(FLT_MAX);
+			__m128i bestIndex = _mm_setzero_si128();
+			for (int i = 0; i < 8; ++i) {
+				__m128 const d = _mm_sub_ps(values, _mm_set1_ps(palette[i]));
+				__m128 const distance = _mm_mul_ps(d, d);
+				__m128i const closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+				best = _mm_min_ps(distance, best);
+				bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(i)), _mm_andnot_si128(closer, bestIndex));
+			}
+			total = _mm_add_ps(total, best);
+			storeIndices(bestIndex, indices + q);
+		}
+		return horizontalSum(total);
+	}
+
+
+
+	// --- colour blocks (BC1, the colour half of BC3)
+
+	struct ColorCandidate {
+		uint16_t m_C0 = 0;
+		uint16_t m_C1 = 0;
+		uint8_t m_Indices[16] = {};
+		float m_Error = FLT_MAX;
+	};
+
+	// scores an endpoint pair in 4-colour order (c0 > c1), keeps it if it beats best
+	bool tryColorEndpoints(ColorBlock const &block, Matchers const &matchers, uint16_t c0, uint16_t c1, ColorCandidate &best) {
+		if (c0 < c1) std::swap(c0, c1);
+		int palette[4][3];
+		colorPalette(c0, c1, false, palette);
+		float paletteF[4][3];
+		for (int i = 0; i < 4; ++i) {
+			for (int c = 0; c < 3; ++c) paletteF[i][c] = static_cast<float>(palette[i][c]);
+		}
+		ColorCandidate candidate;
+		candidate.m_C0 = c0;
+		candidate.m_C1 = c1;
+		candidate.m_Error = matchers.m_Colors(block, paletteF, candidate.m_Indices);
+		if (candidate.m_Error >= best.m_Error) return false;
+		best = candidate;
+		return true;
+	}
+
+	// least squares endpoints for the current indices (each pixel is w * end0 + (1 - w) * end1)
+	bool refitColor(ColorBlock const &block, ColorCandidate const &current, uint16_t &c0, uint16_t &c1) {
+		float const WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+		float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+		float ax[3] = {}, bx[3] = {};
+		for (int p = 0; p < 16; ++p) {
+			float const w = WEIGHTS[current.m_Indices[p]];
+			float const pixel[3] = { block.m_R[p], block.m_G[p], block.m_B[p] };
+			aa += w * w;
+			bb += (1.0f - w) * (1.0f - w);
+			ab += w * (1.0f - w);
+			for (int c = 0; c < 3; ++c) {
+				ax[c] += w * pixel[c];
+				bx[c] += (1.0f - w) * pixel[c];
+			}
+		}
+		float const determinant = aa * bb - ab * ab;
+		if (std::fabs(determinant) < 1e-6f) return false;
+		float end0[3], end1[3];
+		for (int c = 0; c < 3; ++c) {
+			end0[c] = (ax[c] * bb - bx[c] * ab) / determinant;
+			end1[c] = (bx[c] * aa - ax[c] * ab) / determinant;
+		}
+		c0 = pack565(end0[0], end0[1], end0[2]);
+		c1 = pack565(end1[0], end1[1], end1[2]);
+		return true;
+	}
+
+	void principalAxisEndpoints(ColorBlock const &block, uint16_t &c0, uint16_t &c1) {
+		float mean[3] = {};
+		for (int p = 0; p < 16; ++p) {
+			mean[0] += block.m_R[p];
+			mean[1] += block.m_G[p];
+			mean[2] += block.m_B[p];
+		}
+		for (float &m : mean) m /= 16.0f;
+
+		float covariance[6] = {}; // rr rg rb gg gb bb
+		for (int p = 0; p < 16; ++p) {
+			float const r = block.m_R[p] - mean[0];
+			float const g = block.m_G[p] - mean[1];
+			float const b = block.m_B[p] - mean[2];
+			covariance[0] += r * r;
+			covariance[1] += r * g;
+			covariance[2] += r * b;
+			covariance[3] += g * g;
+			covariance[4] += g * b;
+			covariance[5] += b * b;
+		}
+
+		// power iteration
+		float axis[3] = { 1.0f, 1.0f, 1.0f };
+		for (int iteration = 0; iteration < 8; ++iteration) {
+			float const x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+			float const y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+			float const z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+			float const length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+			if (length < 1e-6f) break; // flat block, any axis will do
+			axis[0] = x / length;
+			axis[1] = y / length;
+			axis[2] = z / length;
+		}
+
+		float lowest = FLT_MAX, highest = -FLT_MAX;
+		for (int p = 0; p < 16; ++p) {
+			float const t = (block.m_R[p] - mean[0]) * axis[0] + (block.m_G[p] - mean[1]) * axis[1] + (block.m_B[p] - mean[2]) * axis[2];
+			lowest = std::min(lowest, t);
+			highest = std::max(highest, t);
+		}
+		c0 = pack565(mean[0] + axis[0] * highest, mean[1] + axis[1] * highest, mean[2] + axis[2] * highest);
+		c1 = pack565(mean[0] + axis[0] * lowest, mean[1] + axis[1] * lowest, mean[2] + axis[2] * lowest);
+	}
+
+	// 1 endpoint's 565 component moved by delta, false if that leaves the range
+	bool nudge565(uint16_t color, int channel, int delta, uint16_t &out) {
+		int const SHIFT[3] = { 11, 5, 0 };
+		int const MAX[3] = { 31, 63, 31 };
+		int const value = ((color >> SHIFT[channel]) & MAX[channel]) + delta;
+		if (0 > value || MAX[channel] < value) return false;
+		out = static_cast<uint16_t>((color & ~(MAX[channel] << SHIFT[channel])) | (value << SHIFT[channel]));
+		return true;
+	}
+
+	void encodeColorBlock(uint8_t const (&pixels)[16][4], BcQuality quality, Matchers const &matchers, uint8_t *out) {
+		ColorBlock block;
+		for (int p = 0; p < 16; ++p) {
+			block.m_R[p] = pixels[p][0];
+			block.m_G[p] = pixels[p][1];
+			block.m_B[p] = pixels[p][2];
+		}
+
+		ColorCandidate best;
+		if (BcQuality::Fast == quality) {
+			float low[3] = { 255.0f, 255.0f, 255.0f };
+			float high[3] = { 0.0f, 0.0f, 0.0f };
+			for (int p = 0; p < 16; ++p) {
+				for (int c = 0; c < 3; ++c) {
+					low[c] = std::min(low[c], static_cast<float>(pixels[p][c]));
+					high[c] = std::max(high[c], static_cast<float>(pixels[p][c]));
+				}
+			}
+			for (int c = 0; c < 3; ++c) {
+				float const inset = (high[c] - low[c]) / 16.0f; // the ends of the box are rarely hit exactly
+				low[c] += inset;
+				high[c] -= inset;
+			}
+			tryColorEndpoints(block, matchers, pack565(high[0], high[1], high[2]), pack565(low[0], low[1], low[2]), best);
+		}
+		else {
+			uint16_t c0, c1;
+			principalAxisEndpoints(block, c0, c1);
+			tryColorEndpoints(block, matchers, c0, c1, best);
+
+			int const refits = BcQuality::High == quality ? 3 : 1;
+			for (int i = 0; i < refits; ++i) {
+				if (!refitColor(block, best, c0, c1) || !tryColorEndpoints(block, matchers, c0, c1, best)) break;
+			}
+
+			// local search: every 565 component of both endpoints +-1, until nothing improves
+			for (int pass = 0; BcQuality::High == quality && pass < 4 && 0.0f < best.m_Error; ++pass) {
+				bool improved = false;
+				for (int endpoint = 0; endpoint < 2; ++endpoint) {
+					for (int channel = 0; channel < 3; ++channel) {
+						for (int delta = -1; delta <= 1; delta += 2) {
+							uint16_t const base = 0 == endpoint ? best.m_C0 : best.m_C1;
+							uint16_t const other = 0 == endpoint ? best.m_C1 : best.m_C0;
+							uint16_t moved;
+							if (nudge565(base, channel, delta, moved)) improved = tryColorEndpoints(block, matchers, moved, other, best) || improved;
+						}
+					}
+				}
+				if (!improved) break;
+			}
+		}
+
+		out[0] = static_cast<uint8_t>(best.m_C0);
+		out[1] = static_cast<uint8_t>(best.m_C0 >> 8);
+		out[2] = static_cast<uint8_t>(best.m_C1);
+		out[3] = static_cast<uint8_t>(best.m_C1 >> 8);
+		uint32_t bits = 0;
+		for (int p = 0; p < 16; ++p) bits |= static_cast<uint32_t>(best.m_Indices[p]) << (2 * p);
+		for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<uint8_t>(bits >> (8 * i));
+	}
+
+
+
+	// --- single channel blocks (BC4, BC3 alpha, each half of BC5)
+
+	struct ValueCandidate {
+		int m_A0 = 0;
+		int m_A1 = 0;
+		uint8_t m_Indices[16] = {};
+		float m_Error = FLT_MAX;
+	};
+
+	bool tryValueEndpoints(ValueBlock const &block, Matchers const &matchers, int a0, int a1, ValueCandidate &best) {
+		int palette[8];
+		valuePalette(a0, a1, palette);
+		float paletteF[8];
+		for (int i = 0; i < 8; ++i) paletteF[i] = static_cast<float>(palette[i]);
+		ValueCandidate candidate;
+		candidate.m_A0 = a0;
+		candidate.m_A1 = a1;
+		candidate.m_Error = matchers.m_Values(block, paletteF, candidate.m_Indices);
+		if (candidate.m_Error >= best.m_Error) return false;
+		best = candidate;
+		return true;
+	}
+
+	void encodeValueBlock(uint8_t const (&values)[16], BcQuality quality, Matchers const &matchers, uint8_t *out) {
+		ValueBlock block;
+		int low = 255, high = 0;
+		int innerLow = 255, innerHigh = 0; // without the 0s and 255s, which the 6-value mode has for free
+		for (int p = 0; p < 16; ++p) {
+			block.m_Values[p] = values[p];
+			low = std::min<int>(low, values[p]);
+			high = std::max<int>(high, values[p]);
+			if (0 == values[p] || 255 == values[p]) continue;
+			innerLow = std::min<int>(innerLow, values[p]);
+			innerHigh = std::max<int>(innerHigh, values[p]);
+		}
+
+		ValueCandidate best;
+		tryValueEndpoints(block, matchers, high, low, best);
+		if (BcQuality::Fast != quality && innerLow <= innerHigh) tryValueEndpoints(block, matchers, innerLow, innerHigh, best);
+		if (BcQuality::High == quality && 0.0f < best.m_Error) {
+			// shrink the range a little from both ends (the extremes are often outliers)
+			for (int d0 = 0; d0 <= 3; ++d0) {
+				for (int d1 = 0; d1 <= 3; ++d1) {
+					int const a0 = high - d0;
+					int const a1 = low + d1;
+					if (a0 > a1) tryValueEndpoints(block, matchers, a0, a1, best);
+				}
+			}
+		}
+
+		out[0] = static_cast<uint8_t>(best.m_A0);
+		out[1] = static_cast<uint8_t>(best.m_A1);
+		uint64_t bits = 0;
+		for (int p = 0; p < 16; ++p) bits |= static_cast<uint64_t>(best.m_Indices[p]) << (3 * p);
+		for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+	}
+
+
+
+	// --- decoding
+
+	void decodeColorBlock(uint8_t const *block, bool alwaysFourColor, uint8_t (&pixels)[16][4]) {
+		uint16_t const c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+		uint16_t const c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+		int palette[4][3];
+		colorPalette(c0, c1, !alwaysFourColor && c0 <= c1, palette);
+		uint32_t const bits = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+		for (int p = 0; p < 16; ++p) {
+			int const index = (bits >> (2 * p)) & 3;
+			for (int c = 0; c < 3; ++c) pixels[p][c] = static_cast<uint8_t>(palette[index][c]);
+		}
+	}
+
+	void decodeValueBlock(uint8_t const *block, uint8_t (&values)[16]) {
+		int palette[8];
+		valuePalette(block[0], block[1], palette);
+		uint64_t bits = 0;
+		for (int i = 0; i < 6; ++i) bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+		for (int p = 0; p < 16; ++p) values[p] = static_cast<uint8_t>(palette[(bits >> (3 * p)) & 7]);
+	}
+
+
+
+	void fetchBlock(Image const &image, int blockX, int blockY, uint8_t (&pixels)[16][4]) {
+		for (int y = 0; y < 4; ++y) {
+			int const row = std::min(blockY * 4 + y, image.m_Height - 1);
+			for (int x = 0; x < 4; ++x) {
+				int const column = std::min(blockX * 4 + x, image.m_Width - 1);
+				std::memcpy(pixels[y * 4 + x], &image.m_Pixels[(static_cast<size_t>(row) * image.m_Width + column) * 4], 4);
+			}
+		}
+	}
+
+	void encodeBlock(uint8_t const (&pixels)[16][4], BcSettings const &settings, Matchers const &matchers, uint8_t *out) {
+		uint8_t values[16];
+		switch (settings.m_Format) {
+		case BcFormat::BC1:
+			encodeColorBlock(pixels, settings.m_Quality, matchers, out);
+			break;
+		case BcFormat::BC3:
+			for (int p = 0; p < 16; ++p) values[p] = pixels[p][3];
+			encodeValueBlock(values, settings.m_Quality, matchers, out);
+			encodeColorBlock(pixels, settings.m_Quality, matchers, out + 8);
+			break;
+		case BcFormat::BC4:
+			for (int p = 0; p < 16; ++p) values[p] = pixels[p][0];
+			encodeValueBlock(values, settings.m_Quality, matchers, out);
+			break;
+		case BcFormat::BC5:
+			for (int p = 0; p < 16; ++p) values[p] = pixels[p][0];
+			encodeValueBlock(values, settings.m_Quality, matchers, out);
+			for (int p = 0; p < 16; ++p) values[p] = pixels[p][1];
+			encodeValueBlock(values, settings.m_Quality, matchers, out + 8);
+			break;
+		}
+	}
+
+	void decodeBlock(uint8_t const *block, BcFormat format, uint8_t (&pixels)[16][4]) {
+		std::memset(pixels, 0, sizeof(pixels));
+		uint8_t values[16];
+		for (int p = 0; p < 16; ++p) pixels[p][3] = 255;
+		switch (format) {
+		case BcFormat::BC1:
+			decodeColorBlock(block, false, pixels);
+			break;
+		case BcFormat::BC3:
+			decodeValueBlock(block, values);
+			for (int p = 0; p < 16; ++p) pixels[p][3] = values[p];
+			decodeColorBlock(block + 8, true, pixels);
+			break;
+		case BcFormat::BC4:
+			decodeValueBlock(block, values);
+			for (int p = 0; p < 16; ++p) pixels[p][0] = values[p];
+			break;
+		case BcFormat::BC5:
+			decodeValueBlock(block, values);
+			for (int p = 0; p < 16; ++p) pixels[p][0] = values[p];
+			decodeValueBlock(block + 8, values);
+			for (int p = 0; p < 16; ++p) pixels[p][1] = values[p];
+			break;
+		}
+	}
+
+
+
+	uint64_t fnv1a(uint64_t hash, void const *data, size_t size) {
+		uint8_t const *bytes = static_cast<uint8_t const *>(data);
+		for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+		return hash;
+	}
+
+}
+
+
+
+size_t bcBlockBytes(BcFormat format) {
+	return BcFormat::BC1 == format || BcFormat::BC4 == format ? 8 : 16;
+}
+
+size_t bcImageBytes(BcFormat format, int width, int height) {
+	return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * bcBlockBytes(format);
+}
+
+unsigned int bcGLFormat(BcFormat format, bool srgb) {
+	switch (format) {
+	case BcFormat::BC1: return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case BcFormat::BC3: return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case BcFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+	case BcFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+	}
+	return 0;
+}
+
+char const *bcFormatName(BcFormat format) {
+	switch (format) {
+	case BcFormat::BC1: return "BC1";
+	case BcFormat::BC3: return "BC3";
+	case BcFormat::BC4: return "BC4";
+	case BcFormat::BC5: return "BC5";
+	}
+	return "?";
+}
+
+
+
+void encodeBc(Image const &image, BcSettings const &settings, std::vector<uint8_t> &blocks, ParallelForFn const &parallelFor) {
+	int const blocksX = (image.m_Width + 3) / 4;
+	int const blocksY = (image.m_Height + 3) / 4;
+	size_t const blockBytes = bcBlockBytes(settings.m_Format);
+	blocks.resize(bcImageBytes(settings.m_Format, image.m_Width, image.m_Height));
+	if (image.m_Pixels.empty()) return;
+
+	Matchers matchers = { matchColorsScalar, matchValuesScalar };
+	if (SimdLevel::SSE2 <= clampSimdLevel(settings.m_Simd)) matchers = { matchColorsSSE2, matchValuesSSE2 };
+
+	parallelFor(static_cast<size_t>(blocksY), [&](size_t begin, size_t end) {
+		uint8_t pixels[16][4];
+		for (size_t blockY = begin; blockY < end; ++blockY) {
+			uint8_t *out = &blocks[blockY * blocksX * blockBytes];
+			for (int blockX = 0; blockX < blocksX; ++blockX, out += blockBytes) {
+				fetchBlock(image, blockX, static_cast<int>(blockY), pixels);
+				encodeBlock(pixels, settings, matchers, out);
+			}
+		}
+	});
+}
+
+void decodeBc(uint8_t const *blocks, BcFormat format, int width, int height, Image &out) {
+	out.m_Width = width;
+	out.m_Height = height;
+	out.m_Pixels.resize(static_cast<size_t>(width) * height * 4);
+	int const blocksX = (width + 3) / 4;
+	int const blocksY = (height + 3) / 4;
+	uint8_t pixels[16][4];
+	for (int blockY = 0; blockY < blocksY; ++blockY) {
+		for (int blockX = 0; blockX < blocksX; ++blockX, blocks += bcBlockBytes(format)) {
+			decodeBlock(blocks, format, pixels);
+			for (int y = 0; y < 4 && blockY * 4 + y < height; ++y) {
+				for (int x = 0; x < 4 && blockX * 4 + x < width; ++x) {
+					std::memcpy(&out.m_Pixels[(static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4], pixels[y * 4 + x], 4);
+				}
+			}
+		}
+	}
+}
+
+double bcPsnr(Image const &original, Image const &decoded, BcFormat format) {
+	int const CHANNELS[4] = { 3, 4, 1, 2 }; // BC1 RGB, BC3 RGBA, BC4 R, BC5 RG
+	int const channels = CHANNELS[static_cast<int>(format)];
+	double squaredError = 0.0;
+	size_t const pixels = std::min(original.m_Pixels.size(), decoded.m_Pixels.size()) / 4;
+	for (size_t i = 0; i < pixels; ++i) {
+		for (int c = 0; c < channels; ++c) {
+			double const d = static_cast<double>(original.m_Pixels[4 * i + c]) - decoded.m_Pixels[4 * i + c];
+			squaredError += d * d;
+		}
+	}
+	if (0.0 == squaredError) return 99.0;
+	double const meanSquaredError = squaredError / (static_cast<double>(pixels) * channels);
+	return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+
+
+void compressTexture(std::vector<Image> const &levels, BcSettings const &settings, CompressedTexture &out, ParallelForFn const &parallelFor) {
+	out.m_Format = settings.m_Format;
+	out.m_Srgb = settings.m_Srgb;
+	out.m_Width = levels.empty() ? 0 : levels[0].m_Width;
+	out.m_Height = levels.empty() ? 0 : levels[0].m_Height;
+	out.m_Levels.resize(levels.size());
+	for (size_t i = 0; i < levels.size(); ++i) encodeBc(levels[i], settings, out.m_Levels[i], parallelFor);
+}
+
+
+
+uint64_t BcCache::makeKey(std::vector<Image> const &levels, BcSettings const &settings) {
+	// everything that changes the blocks (m_Simd doesn't)
+	uint32_t const header[5] = { ENCODER_VERSION, static_cast<uint32_t>(settings.m_Format), static_cast<uint32_t>(settings.m_Quality),
+		settings.m_Srgb ? 1u : 0u, static_cast<uint32_t>(levels.size()) };
+	uint64_t hash = fnv1a(0xCBF29CE484222325ull, header, sizeof(header));
+	for (Image const &level : levels) {
+		int32_t const size[2] = { level.m_Width, level.m_Height };
+		hash = fnv1a(hash, size, sizeof(size));
+		hash = fnv1a(hash, level.m_Pixels.data(), level.m_Pixels.size());
+	}
+	return hash;
+}
+
+std::string BcCache::getPath(uint64_t key) const {
+	char name[32];
+	std::snprintf(name, sizeof(name), "%08x%08x.ktx", static_cast<unsigned int>(key >> 32), static_cast<unsigned int>(key));
+	return m_Directory + "/" + name;
+}
+
+bool BcCache::load(uint64_t key, CompressedTexture &out) const {
+	MappedFile file;
+	TextureContainerView view;
+	if (!file.open(getPath(key)) || !parseKtx(file.data(), file.size(), view) || !view.m_Compressed) return false;
+
+	// back from the GL format to the settings that produce it
+	bool found = false;
+	for (BcFormat const format : { BcFormat::BC1, BcFormat::BC3, BcFormat::BC4, BcFormat::BC5 }) {
+		for (bool const srgb : { false, true }) {
+			if (found || bcGLFormat(format, srgb) != view.m_InternalFormat) continue; // BC4/BC5 come out the same either way
+			out.m_Format = format;
+			out.m_Srgb = srgb;
+			found = true;
+		}
+	}
+	if (!found) return false;
+
+	out.m_Width = view.m_Width;
+	out.m_Height = view.m_Height;
+	out.m_Levels.resize(view.m_LevelCount);
+	for (int level = 0; level < view.m_LevelCount; ++level) out.m_Levels[level].assign(view.m_Levels[level].m_Data, view.m_Levels[level].m_Data + view.m_Levels[level].m_Size);
+	return true;
+}
+
+bool BcCache::store(uint64_t key, CompressedTexture const &texture) const {
+	return writeKtx(getPath(key), bcGLFormat(texture.m_Format, texture.m_Srgb), texture.m_Width, texture.m_Height, texture.m_Levels);
+}
+
+bool compressTextureCached(std::vector<Image> const &levels, BcSettings const &settings, BcCache const &cache, CompressedTexture &out, ParallelForFn const &parallelFor) {
+	uint64_t const key = BcCache::makeKey(levels, settings);
+	if (cache.load(key, out)) return true;
+	compressTexture(levels, settings, out, parallelFor);
+	cache.store(key, out);
+	return false;
+}
+
+
+
+bool isS3tcSupported() {
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; ++i) {
+		char const *name = reinterpret_cast<char const *>(glGetStringi(GL_EXTENSIONS, i));
+		if (nullptr != name && 0 == std::strcmp(name, "GL_EXT_texture_compression_s3tc")) return true;
+	}
+	return false;
+}
+
+unsigned int uploadCompressedTexture(CompressedTexture const &texture) {
+	GLint previousTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	GLuint object = 0;
+	glGenTextures(1, &object);
+	glBindTexture(GL_TEXTURE_2D, object);
+
+	GLenum const format = bcGLFormat(texture.m_Format, texture.m_Srgb);
+	GLint const levelCount = static_cast<GLint>(texture.m_Levels.size());
+	for (GLint level = 0; level < levelCount; ++level) {
+		std::vector<uint8_t> const &blocks = texture.m_Levels[level];
+		glCompressedTexImage2D(GL_TEXTURE_2D, level, format, std::max(1, texture.m_Width >> level), std::max(1, texture.m_Height >> level), 0,
+			static_cast<GLsizei>(blocks.size()), blocks.data());
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::max(0, levelCount - 1));
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, 1 < levelCount ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glBindTexture(GL_TEXTURE_2D, previousTexture);
+	return object;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "cpu_features.h"
+#include "image_codec.h"
+#include "scene_graph.h" // ParallelForFn, serialFor
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// block compression (S3TC / RGTC) of RGBA8 images, 4x4 pixel blocks at 4 or 8 bits per pixel instead of 32
+// - BC1: RGB, opaque (8 bytes), BC3: RGB + BC4-coded alpha (16 bytes), BC4: R only (8 bytes), BC5: R + G, e.g. normal maps (16 bytes)
+// - colour endpoint search per quality: Fast = bounding box with inset (the classic real-time DXT approach),
+//   Normal = principal axis + 1 least-squares refit, High = Normal + more refits + a +-1 search around each endpoint
+// - the inner loop (palette match + error of 16 pixels against a candidate pair) runs 4 pixels at a time in SSE2,
+//   the scalar path is the reference and produces the same blocks
+// - block rows go to ParallelForFn, so 1 image spreads over every thread
+// - CompressedTexture keeps all the levels, a disk cache of KTX files (keyed by a hash of the pixels + settings) skips re-encoding,
+//   uploadCompressedTexture() sends it with glCompressedTexImage2D()
+// NOTE: BC1/BC3 are EXT_texture_compression_s3tc (every desktop driver has it, but it's not core), BC4/BC5 are core RGTC
+
+
+
+enum class BcFormat {
+	BC1,
+	BC3,
+	BC4,
+	BC5
+};
+
+enum class BcQuality {
+	Fast,
+	Normal,
+	High
+};
+
+struct BcSettings {
+	BcFormat m_Format = BcFormat::BC1;
+	BcQuality m_Quality = BcQuality::Normal;
+	bool m_Srgb = true; // only picks the GL format (BC1/BC3), blocks are encoded on the stored values either way
+	SimdLevel m_Simd = SimdLevel::SSE2; // Scalar or SSE2
+};
+
+size_t bcBlockBytes(BcFormat format);
+size_t bcImageBytes(BcFormat format, int width, int height); // partial blocks at the edges count as whole ones
+unsigned int bcGLFormat(BcFormat format, bool srgb);
+char const *bcFormatName(BcFormat format);
+
+// image -> blocks, left to right then up (the rows in the image's order), edge blocks repeat the last row/column
+void encodeBc(Image const &image, BcSettings const &settings, std::vector<uint8_t> &blocks, ParallelForFn const &parallelFor = serialFor);
+// blocks -> image (for measuring quality, or as a software fallback), channels a format doesn't have come out as 0 (alpha 255)
+void decodeBc(uint8_t const *blocks, BcFormat format, int width, int height, Image &out);
+
+// over the channels the format stores
+double bcPsnr(Image const &original, Image const &decoded, BcFormat format);
+
+
+
+struct CompressedTexture {
+	BcFormat m_Format = BcFormat::BC1;
+	bool m_Srgb = true;
+	int m_Width = 0; // of level 0
+	int m_Height = 0;
+	std::vector<std::vector<uint8_t>> m_Levels;
+};
+
+// every level of a chain (e.g. from generateMipChain())
+void compressTexture(std::vector<Image> const &levels, BcSettings const &settings, CompressedTexture &out, ParallelForFn const &parallelFor = serialFor);
+
+// compressed results by content hash, 1 KTX file per texture in a directory that must already exist
+// a warm start can skip load() and hand getPath(key) to loadTextureContainer() (texture_container.h) to upload from the mapped file
+class BcCache {
+public:
+	explicit BcCache(std::string const &directory) : m_Directory(directory) {}
+
+	static uint64_t makeKey(std::vector<Image> const &levels, BcSettings const &settings);
+
+	bool load(uint64_t key, CompressedTexture &out) const; // false = not there (or unreadable)
+	bool store(uint64_t key, CompressedTexture const &texture) const;
+	std::string getPath(uint64_t key) const;
+
+private:
+	std::string m_Directory;
+};
+
+// compressTexture() unless the cache already has it, stores what it had to encode, returns true on a cache hit
+bool compressTextureCached(std::vector<Image> const &levels, BcSettings const &settings, BcCache const &cache, CompressedTexture &out,
+	ParallelForFn const &parallelFor = serialFor);
+
+// GL thread: the driver lists EXT_texture_compression_s3tc (needed for BC1/BC3)
+bool isS3tcSupported();
+// GL thread: new texture with every level, trilinear filtering, returns its name (the GL_TEXTURE_2D binding is restored)
+unsigned int uploadCompressedTexture(CompressedTexture const &texture);
@@ -0,0 +1,98 @@
+#include "bc_encoder.h"
+#include "benchmarks.h"
+#include "job_system.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+
+// block compression throughput and quality
+// - per format and quality: MPix/s scalar vs SSE2 on 1 thread (their blocks are compared), then on every hardware thread
+// - PSNR of the decoded blocks against the source, Fast (bounding box, what real-time DXT encoders do) is the reference point
+//   the better modes are measured against
+
+
+
+namespace {
+	int const BENCH_IMAGE_SIZE = 512;
+	size_t const BLOCK_ROW_GRAIN = 4;
+
+	// gradients, hard edges and a band of noise, a rough stand-in for a photo-ish albedo with an alpha mask
+	Image makeImage(int size) {
+		std::mt19937 rng(7);
+		Image image;
+		image.m_Width = image.m_Height = size;
+		image.m_Pixels.resize(static_cast<size_t>(size) * size * 4);
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				uint8_t *pixel = &image.m_Pixels[(static_cast<size_t>(y) * size + x) * 4];
+				bool const noisy = 1 == (y / 64) % 4;
+				bool const edge = 0 == ((x / 24) + (y / 24)) % 5;
+				pixel[0] = static_cast<uint8_t>(noisy ? x * 255 / size + rng() % 32 : x * 255 / size);
+				pixel[1] = static_cast<uint8_t>(edge ? 40 : y * 255 / size);
+				pixel[2] = static_cast<uint8_t>(edge ? 220 : (x + y) / 4);
+				pixel[3] = static_cast<uint8_t>(edge ? 0 : 255 - (x * y) % 256);
+			}
+		}
+		return image;
+	}
+
+	// ms per image, run until ~0.25s has been measured
+	double measureEncodeMs(Image const &image, BcSettings const &settings, std::vector<uint8_t> &blocks, ParallelForFn const &parallelFor) {
+		int calls = 0;
+		double const start = benchSeconds();
+		double elapsed = 0.0;
+		do {
+			encodeBc(image, settings, blocks, parallelFor);
+			++calls;
+			elapsed = benchSeconds() - start;
+		} while (elapsed < 0.25);
+		return elapsed / calls * 1e3;
+	}
+
+	char const *qualityName(BcQuality quality) {
+		return BcQuality::Fast == quality ? "fast" : BcQuality::Normal == quality ? "normal" : "high";
+	}
+}
+
+
+
+int bcEncoderBenchMain() {
+	bool ok = true;
+	Image const image = makeImage(BENCH_IMAGE_SIZE);
+	double const pixels = static_cast<double>(BENCH_IMAGE_SIZE) * BENCH_IMAGE_SIZE;
+
+	unsigned int const threads = std::max(1u, std::thread::hardware_concurrency());
+	JobSystem jobs(threads);
+	ParallelForFn const parallelFor = [&jobs](size_t rows, std::function<void(size_t, size_t)> const &body) { jobs.parallelFor(rows, body, BLOCK_ROW_GRAIN); };
+
+	std::printf("%dx%d, %u threads\n", BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE, threads);
+	std::printf("%6s %8s %14s %14s %14s %8s\n", "format", "quality", "scalar MPix/s", "SSE2 MPix/s", "MT MPix/s", "PSNR");
+	for (BcFormat const format : { BcFormat::BC1, BcFormat::BC3, BcFormat::BC4, BcFormat::BC5 }) {
+		for (BcQuality const quality : { BcQuality::Fast, BcQuality::Normal, BcQuality::High }) {
+			BcSettings settings;
+			settings.m_Format = format;
+			settings.m_Quality = quality;
+
+			std::vector<uint8_t> scalarBlocks, blocks, threadedBlocks;
+			settings.m_Simd = SimdLevel::Scalar;
+			double const scalarMs = measureEncodeMs(image, settings, scalarBlocks, serialFor);
+			settings.m_Simd = SimdLevel::SSE2;
+			double const simdMs = measureEncodeMs(image, settings, blocks, serialFor);
+			double const threadedMs = measureEncodeMs(image, settings, threadedBlocks, parallelFor);
+			ok = ok && scalarBlocks == blocks && threadedBlocks == blocks;
+
+			Image decoded;
+			decodeBc(blocks.data(), format, image.m_Width, image.m_Height, decoded);
+			std::printf("%6s %8s %14.1f %14.1f %14.1f %8.2f\n", bcFormatName(format), qualityName(quality),
+				pixels / (scalarMs * 1e3), pixels / (simdMs * 1e3), pixels / (threadedMs * 1e3), bcPsnr(image, decoded, format));
+		}
+	}
+
+	if (!ok) std::printf("MISMATCH: scalar, SSE2 and multithreaded blocks differ\n");
+	return ok ? 0 : -1;
+}
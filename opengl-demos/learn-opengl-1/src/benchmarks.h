@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+
+// micro-benchmark entry points
+// swap one of these into main() the same way as the hello triangle demos, and build in RELEASE (DEBUG numbers are meaningless)
+
+
+
+int rasterizerBenchMain();
+int vertexTransformBenchMain();
+int sceneGraphBenchMain();
+int glmBenchMain();
+int jobSystemBenchMain();
+int textureImportBenchMain();
+int bcEncoderBenchMain();
+int textureContainerBenchMain();
+int textureAtlasBenchMain();
+int resourceLoaderBenchMain();
+int tlsfAllocatorBenchMain();
+int textureStreamerBenchMain();
+int logBenchMain();
+
+
+
+// wall-clock seconds from an arbitrary (but fixed) point, for timing benchmark loops
+inline double benchSeconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
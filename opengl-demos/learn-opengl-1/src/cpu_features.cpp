@@ -0,0 +1,91 @@
+#include "cpu_features.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+
+
+namespace {
+	void cpuid(int leaf, int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+		int r[4];
+		__cpuidex(r, leaf, subleaf);
+		for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned int>(r[i]);
+#else
+		__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+	}
+
+	// which register states the OS preserves on a context switch (bit 1 = XMM, bit 2 = YMM, bits 5-7 = ZMM/opmask)
+	unsigned long long xgetbv0() {
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned int lo, hi;
+		__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+		return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+	}
+
+	CpuFeatures detectCpuFeatures() {
+		CpuFeatures features;
+
+		unsigned int regs[4] = {};
+		cpuid(0, 0, regs);
+		unsigned int const maxLeaf = regs[0];
+		if (maxLeaf < 1) return features;
+
+		cpuid(1, 0, regs);
+		features.m_SSE2 = 0 != (regs[3] & (1u << 26));
+		features.m_SSE41 = 0 != (regs[2] & (1u << 19));
+		features.m_FMA = 0 != (regs[2] & (1u << 12));
+		bool const osxsave = 0 != (regs[2] & (1u << 27));
+		bool const avxBit = 0 != (regs[2] & (1u << 28));
+
+		unsigned long long const xcr0 = osxsave ? xgetbv0() : 0;
+		bool const osYmm = 0x6 == (xcr0 & 0x6);
+		bool const osZmm = 0xE6 == (xcr0 & 0xE6);
+
+		features.m_AVX = avxBit && osYmm;
+		features.m_FMA = features.m_FMA && features.m_AVX;
+
+		if (7 <= maxLeaf) {
+			cpuid(7, 0, regs);
+			features.m_AVX2 = features.m_AVX && 0 != (regs[1] & (1u << 5));
+			features.m_AVX512F = osZmm && 0 != (regs[1] & (1u << 16));
+		}
+
+		if (features.m_AVX512F && features.m_AVX2 && features.m_FMA) features.m_BestLevel = SimdLevel::AVX512;
+		else if (features.m_AVX2 && features.m_FMA) features.m_BestLevel = SimdLevel::AVX2;
+		else if (features.m_SSE41) features.m_BestLevel = SimdLevel::SSE41;
+		else if (features.m_SSE2) features.m_BestLevel = SimdLevel::SSE2;
+
+		return features;
+	}
+}
+
+
+
+CpuFeatures const &getCpuFeatures() {
+	static CpuFeatures const s_Features = detectCpuFeatures(); // thread-safe init (magic statics)
+	return s_Features;
+}
+
+SimdLevel clampSimdLevel(SimdLevel requested) {
+	SimdLevel const best = getCpuFeatures().m_BestLevel;
+	return (requested < best) ? requested : best;
+}
+
+char const *simdLevelName(SimdLevel level) {
+	switch (level) {
+		case SimdLevel::Scalar: return "scalar";
+		case SimdLevel::SSE2: return "sse2";
+		case SimdLevel::SSE41: return "sse4.1";
+		case SimdLevel::AVX2: return "avx2";
+		case SimdLevel::AVX512: return "avx512";
+	}
+	return "unknown";
+}
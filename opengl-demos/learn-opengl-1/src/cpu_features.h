@@ -0,0 +1,49 @@
+#pragma once
+
+// runtime detection of the x86 SIMD extensions the CPU-side kernels can dispatch to
+// NOTE: the project builds with the default /arch (SSE2 on x86), so anything above SSE2 must be checked at runtime before use
+
+
+
+// MSVC lets any function use any intrinsic, but GCC/Clang need the target enabled per-function
+// so the wider kernels are tagged with these and only ever called after a getCpuFeatures() check
+#if defined(_MSC_VER)
+#define SIMD_TARGET_SSE41
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX2_FMA
+#define SIMD_TARGET_AVX512
+#else
+#define SIMD_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX2_FMA __attribute__((target("avx2,fma"))) // NOTE: lets GCC contract mul + add into fma, so results can differ from scalar code in the last bit
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+
+
+
+// ordered from narrowest to widest, so (SimdLevel::AVX2 <= level) means "AVX2 or better"
+enum class SimdLevel {
+	Scalar = 0,
+	SSE2,
+	SSE41,
+	AVX2,
+	AVX512
+};
+
+struct CpuFeatures {
+	bool m_SSE2 = false;
+	bool m_SSE41 = false;
+	bool m_AVX = false; // also requires the OS to save YMM state (XGETBV)
+	bool m_AVX2 = false;
+	bool m_FMA = false;
+	bool m_AVX512F = false; // also requires the OS to save ZMM state (XGETBV)
+	SimdLevel m_BestLevel = SimdLevel::Scalar;
+};
+
+// queried once on first use, then cached
+CpuFeatures const &getCpuFeatures();
+
+// clamp a requested level to what this CPU can actually run
+SimdLevel clampSimdLevel(SimdLevel requested);
+
+char const *simdLevelName(SimdLevel level);
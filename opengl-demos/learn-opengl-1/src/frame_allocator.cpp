@@ -0,0 +1,104 @@
+#include "frame_allocator.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+
+namespace {
+	uintptr_t alignUp(uintptr_t value, size_t alignment) {
+		return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+	}
+}
+
+
+
+LinearArena::LinearArena(size_t capacity) : m_Memory(new uint8_t[capacity]), m_Capacity(capacity) {
+	m_Overflow.reserve(64);
+}
+
+LinearArena::~LinearArena() {
+	reset();
+	delete[] m_Memory;
+}
+
+void *LinearArena::allocate(size_t size, size_t alignment) {
+	uintptr_t const base = reinterpret_cast<uintptr_t>(m_Memory);
+	size_t const begin = static_cast<size_t>(alignUp(base + m_Offset, alignment) - base);
+	if (begin + size > m_Capacity) return allocateOverflow(size, alignment);
+
+	m_Offset = begin + size;
+#if FRAME_ALLOCATOR_DEBUG
+	++m_Allocations;
+	m_HighWater = std::max(m_HighWater, m_Offset + m_OverflowBytes);
+#endif
+	return m_Memory + begin;
+}
+
+void *LinearArena::allocateOverflow(size_t size, size_t alignment) {
+	// over-allocate so the block can be aligned, the raw pointer is what gets freed
+	void *block = ::operator new(size + alignment);
+	m_Overflow.push_back(block);
+	m_OverflowBytes += size + alignment;
+#if FRAME_ALLOCATOR_DEBUG
+	++m_Allocations;
+	++m_OverflowAllocations;
+	m_HighWater = std::max(m_HighWater, m_Offset + m_OverflowBytes);
+#endif
+	return reinterpret_cast<void *>(alignUp(reinterpret_cast<uintptr_t>(block), alignment));
+}
+
+void LinearArena::reset() {
+	for (void *block : m_Overflow) ::operator delete(block);
+	m_Overflow.clear();
+	m_OverflowBytes = 0;
+	rewind(0);
+#if FRAME_ALLOCATOR_DEBUG
+	m_Allocations = 0;
+#endif
+}
+
+void LinearArena::rewind(Marker marker) {
+	if (marker >= m_Offset) return;
+#if FRAME_ALLOCATOR_DEBUG
+	std::memset(m_Memory + marker, 0xCD, m_Offset - marker);
+#endif
+	m_Offset = marker;
+}
+
+ArenaStats LinearArena::getStats() const {
+	ArenaStats stats;
+	stats.m_Capacity = m_Capacity;
+	stats.m_Used = m_Offset;
+	stats.m_OverflowBytes = m_OverflowBytes;
+#if FRAME_ALLOCATOR_DEBUG
+	stats.m_HighWater = m_HighWater;
+	stats.m_Allocations = m_Allocations;
+	stats.m_OverflowAllocations = m_OverflowAllocations;
+#endif
+	return stats;
+}
+
+
+
+FrameArenas::FrameArenas(size_t capacityPerFrame) {
+	for (std::unique_ptr<LinearArena> &arena : m_Arenas) arena.reset(new LinearArena(capacityPerFrame));
+}
+
+void FrameArenas::beginFrame() {
+	m_Current = (m_Current + 1) % FRAME_ARENA_COUNT;
+	m_Arenas[m_Current]->reset();
+}
+
+size_t FrameArenas::getHighWater() const {
+	size_t highWater = 0;
+	for (std::unique_ptr<LinearArena> const &arena : m_Arenas) highWater = std::max(highWater, arena->getStats().m_HighWater);
+	return highWater;
+}
+
+
+
+LinearArena &scratchArena() {
+	thread_local LinearArena t_Scratch(SCRATCH_CAPACITY);
+	return t_Scratch;
+}
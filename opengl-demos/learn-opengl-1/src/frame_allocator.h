@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+// allocators for transient per-frame data (draw lists, culling results, command buffers, ...), no general-purpose heap on the hot path
+// - LinearArena: bump allocation out of 1 preallocated block, freed all at once (reset) or back to a marker (rewind)
+// - FrameArenas: FRAME_ARENA_COUNT arenas used round-robin, so what frame N allocated is still valid while the render thread
+//   (or the GPU) is up to FRAME_ARENA_COUNT - 1 frames behind
+// - scratchArena(): 1 arena per thread for temporaries inside a function, ScratchScope rewinds it when it goes out of scope
+// - ArenaAllocator<T>: std::vector<T, ArenaAllocator<T>> etc. on any of them (deallocate does nothing, memory comes back on reset/rewind)
+// running past the capacity doesn't fail, it falls back to heap blocks that are freed on the next reset and counted in the stats,
+// so the capacity can be tuned from the high-water marks
+
+
+
+// high-water marks and allocation counts, on in debug builds (define as 0 or 1 to override)
+// also fills reset/rewound memory with 0xCD so use-after-reset shows up as garbage right away
+#ifndef FRAME_ALLOCATOR_DEBUG
+#if defined(_DEBUG)
+#define FRAME_ALLOCATOR_DEBUG 1
+#else
+#define FRAME_ALLOCATOR_DEBUG 0
+#endif
+#endif
+
+
+
+struct ArenaStats {
+	size_t m_Capacity = 0;
+	size_t m_Used = 0; // right now (not counting overflow)
+	size_t m_OverflowBytes = 0; // right now, heap blocks past the capacity
+
+	// FRAME_ALLOCATOR_DEBUG only
+	size_t m_HighWater = 0; // most ever in use at once, including overflow
+	size_t m_Allocations = 0; // since the last reset
+	size_t m_OverflowAllocations = 0; // ever, should stay 0 in a well-sized arena
+};
+
+class LinearArena {
+public:
+	typedef size_t Marker;
+
+	explicit LinearArena(size_t capacity);
+	~LinearArena();
+
+	LinearArena(LinearArena const &) = delete;
+	LinearArena &operator=(LinearArena const &) = delete;
+
+	// never returns nullptr (overflows to the heap instead), alignment has to be a power of 2
+	void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	template <typename T>
+	T *allocateArray(size_t count) { return static_cast<T *>(allocate(count * sizeof(T), alignof(T))); }
+
+	// frees everything (overflow blocks too)
+	void reset();
+
+	// rewind() frees everything allocated after getMarker(), markers have to be rewound in reverse order
+	// allocations that overflowed to the heap after the marker stay around until the next reset
+	Marker getMarker() const { return m_Offset; }
+	void rewind(Marker marker);
+
+	size_t getCapacity() const { return m_Capacity; }
+	ArenaStats getStats() const;
+
+private:
+	void *allocateOverflow(size_t size, size_t alignment);
+
+	uint8_t *m_Memory;
+	size_t m_Capacity;
+	size_t m_Offset = 0;
+	std::vector<void *> m_Overflow; // heap blocks past the capacity, freed on reset (reserved up front)
+	size_t m_OverflowBytes = 0;
+#if FRAME_ALLOCATOR_DEBUG
+	size_t m_HighWater = 0;
+	size_t m_Allocations = 0;
+	size_t m_OverflowAllocations = 0;
+#endif
+};
+
+
+
+class FrameArenas {
+public:
+	static size_t const FRAME_ARENA_COUNT = 3; // frames in flight
+
+	explicit FrameArenas(size_t capacityPerFrame);
+
+	// at the start of a frame, resets the oldest arena and makes it current
+	void beginFrame();
+
+	LinearArena &current() { return *m_Arenas[m_Current]; }
+	// the arena of framesAgo frames back (< FRAME_ARENA_COUNT), its memory is still valid
+	LinearArena &previous(size_t framesAgo) { return *m_Arenas[(m_Current + FRAME_ARENA_COUNT - framesAgo) % FRAME_ARENA_COUNT]; }
+
+	// highest high-water mark over all arenas
+	size_t getHighWater() const;
+
+private:
+	std::unique_ptr<LinearArena> m_Arenas[FRAME_ARENA_COUNT];
+	size_t m_Current = 0;
+};
+
+
+
+// the calling thread's scratch arena (created with SCRATCH_CAPACITY on first use, lives as long as the thread)
+size_t const SCRATCH_CAPACITY = 256 * 1024;
+LinearArena &scratchArena();
+
+// everything allocated from the thread's scratch arena during this scope is freed at its end
+class ScratchScope {
+public:
+	ScratchScope() : m_Arena(scratchArena()), m_Marker(m_Arena.getMarker()) {}
+	~ScratchScope() { m_Arena.rewind(m_Marker); }
+
+	ScratchScope(ScratchScope const &) = delete;
+	ScratchScope &operator=(ScratchScope const &) = delete;
+
+	LinearArena &arena() { return m_Arena; }
+
+private:
+	LinearArena &m_Arena;
+	LinearArena::Marker m_Marker;
+};
+
+
+
+// STL allocator on a LinearArena, the arena has to outlive the container (and its reset/rewind)
+template <typename T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+
+	explicit ArenaAllocator(LinearArena &arena) : m_Arena(&arena) {}
+	template <typename U>
+	ArenaAllocator(ArenaAllocator<U> const &other) : m_Arena(other.getArena()) {}
+
+	T *allocate(size_t count) { return m_Arena->allocateArray<T>(count); }
+	void deallocate(T *, size_t) {}
+
+	LinearArena *getArena() const { return m_Arena; }
+
+private:
+	LinearArena *m_Arena;
+};
+
+template <typename T, typename U>
+bool operator==(ArenaAllocator<T> const &a, ArenaAllocator<U> const &b) { return a.getArena() == b.getArena(); }
+template <typename T, typename U>
+bool operator!=(ArenaAllocator<T> const &a, ArenaAllocator<U> const &b) { return a.getArena() != b.getArena(); }
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,170 @@
+#include "frame_loop.h"
+
+#include "alloc_tracker.h"
+
+//NOTE: must include glad before glfw
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+// Sleep() granularity is ~15.6ms unless the timer resolution is raised
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+
+
+namespace {
+	double const MAX_FRAME_TIME = 0.25; // longer frames (breakpoints, window drags) are clamped so the simulation doesn't spiral
+	double const SLEEP_QUANTUM = 0.001; // seconds per sleep_for() while far from the deadline
+}
+
+
+
+size_t const FrameLoop::FRAME_HISTORY;
+
+
+
+double frameSeconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+FrameLoop::FrameLoop(GLFWwindow *window, FrameLoopSettings const &settings) : m_Window(window), m_Settings(settings) {
+#ifdef _WIN32
+	timeBeginPeriod(1);
+#endif
+	setSwapInterval(m_Settings.m_SwapInterval);
+}
+
+FrameLoop::~FrameLoop() {
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void FrameLoop::setSwapInterval(int interval) {
+	m_Settings.m_SwapInterval = interval;
+	glfwSwapInterval(interval);
+}
+
+void FrameLoop::setOnDemand(bool onDemand) {
+	m_Settings.m_OnDemand = onDemand;
+	requestRedraw(); // so switching shows up right away
+}
+
+void FrameLoop::requestRedraw() {
+	m_RedrawRequested.store(true, std::memory_order_release);
+	glfwPostEmptyEvent();
+}
+
+
+
+void FrameLoop::run(FrameCallbacks const &callbacks) {
+	double accumulator = 0.0;
+	double previousStart = frameSeconds();
+	bool wasSimulating = true;
+	uint64_t previousAllocations = processAllocationCounts().m_Allocations;
+
+	while (!glfwWindowShouldClose(m_Window)) {
+		// input (on-demand mode: block until there's an event, a requestRedraw() or the timeout)
+		bool const onDemand = m_Settings.m_OnDemand;
+		if (onDemand && !m_Animating && !m_RedrawRequested.load(std::memory_order_acquire)) glfwWaitEventsTimeout(m_Settings.m_IdleTimeout);
+		else glfwPollEvents();
+		bool const changed = callbacks.m_Input ? callbacks.m_Input() : false;
+		bool const requested = m_RedrawRequested.exchange(false, std::memory_order_acq_rel);
+		if (onDemand && !m_Animating && !changed && !requested) {
+			++m_Stats.m_IdleWakeups;
+			continue;
+		}
+
+		double const frameStart = frameSeconds();
+		double const frameTime = frameStart - previousStart;
+		previousStart = frameStart;
+		if (0 < m_Stats.m_FrameIndex) updateStats(frameTime);
+		uint64_t const allocations = processAllocationCounts().m_Allocations;
+		m_Stats.m_Allocations = allocations - previousAllocations;
+		previousAllocations = allocations;
+
+		// simulation, in fixed steps (on-demand mode: only while animating, and from a fresh start, not to catch up on idle time)
+		double const step = m_Settings.m_SimulationStep;
+		bool const simulating = !onDemand || m_Animating;
+		if (simulating && wasSimulating) accumulator += std::min(frameTime, MAX_FRAME_TIME);
+		else accumulator = 0.0;
+		wasSimulating = simulating;
+		int steps = 0;
+		while (step <= accumulator && steps < m_Settings.m_MaxStepsPerFrame) {
+			if (callbacks.m_Simulate) callbacks.m_Simulate(step);
+			accumulator -= step;
+			++steps;
+		}
+		if (step <= accumulator) accumulator = std::fmod(accumulator, step); // gave up catching up
+		m_Stats.m_SimulationSteps = steps;
+
+		// render, between the last 2 simulation states
+		if (callbacks.m_Render) callbacks.m_Render(accumulator / step);
+		double const workEnd = frameSeconds();
+		m_Stats.m_WorkTime = workEnd - frameStart;
+
+		// the limiter only paces when vsync is off (with vsync on, the swap already waits and the 2 waits would add up)
+		// it paces from the previous deadline, not from frameStart, so a late wake-up isn't carried into the next frame
+		double const target = m_Settings.m_TargetFrameTime;
+		if (0.0 < target && 0 >= m_Settings.m_SwapInterval) {
+			m_Deadline += target;
+			if (m_Deadline < workEnd - target) m_Deadline = workEnd; // over a frame behind (hitch, idle in on-demand mode): don't burst to catch up
+			waitUntil(m_Deadline);
+		}
+		m_Stats.m_WaitTime = frameSeconds() - workEnd;
+
+		glfwSwapBuffers(m_Window);
+		++m_Stats.m_FrameIndex;
+	}
+}
+
+void FrameLoop::waitUntil(double deadline) {
+	// sleep while the deadline is further away than a sleep can overshoot, learning the overshoot as we go
+	double now = frameSeconds();
+	while (deadline - now > m_SleepOvershoot + SLEEP_QUANTUM) {
+		std::this_thread::sleep_for(std::chrono::duration<double>(SLEEP_QUANTUM));
+		double const after = frameSeconds();
+		double const overshoot = after - now - SLEEP_QUANTUM;
+		// jump up to a late wake-up right away, only creep back down (an occasional late wake-up is what causes missed deadlines)
+		m_SleepOvershoot = overshoot > m_SleepOvershoot ? overshoot : m_SleepOvershoot * 0.99 + std::max(0.0, overshoot) * 0.01;
+		now = after;
+	}
+
+	// spin the rest
+	while (frameSeconds() < deadline) std::this_thread::yield();
+}
+
+void FrameLoop::updateStats(double frameTime) {
+	m_Stats.m_FrameTime = frameTime;
+	m_History[(m_Stats.m_FrameIndex - 1) % FRAME_HISTORY] = frameTime;
+
+	size_t const count = static_cast<size_t>(std::min<uint64_t>(m_Stats.m_FrameIndex, FRAME_HISTORY));
+	double sum = 0.0;
+	double minTime = m_History[0];
+	double maxTime = m_History[0];
+	for (size_t i = 0; i < count; ++i) {
+		sum += m_History[i];
+		minTime = std::min(minTime, m_History[i]);
+		maxTime = std::max(maxTime, m_History[i]);
+	}
+	double const average = sum / count;
+	double variance = 0.0;
+	for (size_t i = 0; i < count; ++i) variance += (m_History[i] - average) * (m_History[i] - average);
+
+	m_Stats.m_AverageFrameTime = average;
+	m_Stats.m_MinFrameTime = minTime;
+	m_Stats.m_MaxFrameTime = maxTime;
+	m_Stats.m_FrameTimeJitter = std::sqrt(variance / count);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// frame pacing for the demo mains (instead of rendering as fast as possible, see the COIL WHINE note at the bottom of main.cpp)
+// - fixed-timestep simulation: m_Simulate always sees the same dt, however long frames take
+// - render interpolation: m_Render gets how far (0..1) the current time is between the last 2 simulation steps
+// - glfwSwapInterval() for vsync, or (swap interval 0) a hybrid sleep + spin limiter for a target frame time
+//   (sleep while far from the deadline, spin the rest, so the jitter is sub-millisecond even with coarse OS sleeps)
+// - per-frame timing stats
+// - on-demand mode for static/tool windows: glfwWaitEventsTimeout() instead of glfwPollEvents(), and a frame is only rendered
+//   when input/resize changed something, someone called requestRedraw() or an animation is running (idle CPU/GPU ~0)
+
+
+
+struct GLFWwindow;
+
+struct FrameLoopSettings {
+	double m_SimulationStep = 1.0 / 120.0; // seconds per simulation step
+	int m_MaxStepsPerFrame = 8; // catching up stops here (e.g. after a breakpoint), the rest of the backlog is dropped
+	double m_TargetFrameTime = 0.0; // seconds, 0 = no limiter, only used while m_SwapInterval is 0 (vsync already paces the frames)
+	int m_SwapInterval = 1; // glfwSwapInterval(), 1 = vsync, 0 = off
+	bool m_OnDemand = false; // only render when something changed
+	double m_IdleTimeout = 0.5; // seconds, longest glfwWaitEventsTimeout() while idle in on-demand mode
+};
+
+struct FrameStats {
+	uint64_t m_FrameIndex = 0;
+	double m_FrameTime = 0.0; // start of the previous frame to start of this one (seconds)
+	double m_WorkTime = 0.0; // input + simulation + render, before the limiter
+	double m_WaitTime = 0.0; // spent in the limiter (0 with vsync, the wait is in glfwSwapBuffers() then)
+	int m_SimulationSteps = 0;
+	uint64_t m_IdleWakeups = 0; // on-demand mode: loop iterations that woke up but had nothing to render
+	uint64_t m_Allocations = 0; // heap allocations (all threads) since the previous frame, only with ALLOCATION_TRACKING (alloc_tracker.h)
+
+	// over the last FRAME_HISTORY rendered frames (in on-demand mode the frame time includes the idle time before it)
+	double m_AverageFrameTime = 0.0;
+	double m_MinFrameTime = 0.0;
+	double m_MaxFrameTime = 0.0;
+	double m_FrameTimeJitter = 0.0; // standard deviation of the frame time
+};
+
+struct FrameCallbacks {
+	std::function<bool(void)> m_Input; // once per loop iteration, right after the events are polled, true = something changed (redraw)
+	std::function<void(double dt)> m_Simulate; // 0+ times per frame, dt is always the simulation step (on-demand mode: only while animating)
+	std::function<void(double alpha)> m_Render; // once per frame, blend previous/current simulation state by alpha
+};
+
+
+
+class FrameLoop {
+public:
+	static size_t const FRAME_HISTORY = 120;
+
+	// window's context has to be current (for glfwSwapInterval)
+	explicit FrameLoop(GLFWwindow *window, FrameLoopSettings const &settings = FrameLoopSettings());
+	~FrameLoop();
+
+	FrameLoop(FrameLoop const &) = delete;
+	FrameLoop &operator=(FrameLoop const &) = delete;
+
+	// until glfwWindowShouldClose()
+	void run(FrameCallbacks const &callbacks);
+
+	void setSwapInterval(int interval);
+	void setTargetFrameTime(double seconds) { m_Settings.m_TargetFrameTime = seconds; }
+	void setOnDemand(bool onDemand);
+	bool isOnDemand() const { return m_Settings.m_OnDemand; }
+
+	// on-demand mode: render continuously while animating (e.g. a camera glide), idle again once it's false
+	void setAnimating(bool animating) { m_Animating = animating; }
+	// on-demand mode: render 1 more frame, any thread (wakes the main thread up from glfwWaitEventsTimeout())
+	void requestRedraw();
+
+	FrameLoopSettings const &getSettings() const { return m_Settings; }
+	FrameStats const &getStats() const { return m_Stats; }
+
+private:
+	void waitUntil(double deadline); // sleep, then spin the last stretch
+	void updateStats(double frameTime);
+
+	GLFWwindow *m_Window;
+	FrameLoopSettings m_Settings;
+	FrameStats m_Stats;
+	double m_History[FRAME_HISTORY] = {};
+	double m_Deadline = 0.0; // the limiter's previous deadline (frameSeconds())
+	double m_SleepOvershoot = 0.002; // how late a sleep can wake up (seconds), learned as the loop runs
+	bool m_Animating = false;
+	std::atomic<bool> m_RedrawRequested{ true }; // the first frame always renders
+};
+
+// seconds on a monotonic clock
+double frameSeconds();
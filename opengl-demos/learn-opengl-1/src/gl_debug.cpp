@@ -0,0 +1,290 @@
+#include "gl_debug.h"
+#include "log.h"
+
+//NOTE: must include glad before glfw
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// GL 4.3 / KHR_debug enums (ARB_debug_output uses the same values), for when glad is generated without them
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_CONTEXT_FLAG_DEBUG_BIT 0x00000002
+#define GL_DEBUG_SOURCE_API 0x8246
+#define GL_DEBUG_SOURCE_WINDOW_SYSTEM 0x8247
+#define GL_DEBUG_SOURCE_SHADER_COMPILER 0x8248
+#define GL_DEBUG_SOURCE_THIRD_PARTY 0x8249
+#define GL_DEBUG_SOURCE_APPLICATION 0x824A
+#define GL_DEBUG_SOURCE_OTHER 0x824B
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR 0x824D
+#define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR 0x824E
+#define GL_DEBUG_TYPE_PORTABILITY 0x824F
+#define GL_DEBUG_TYPE_PERFORMANCE 0x8250
+#define GL_DEBUG_TYPE_OTHER 0x8251
+#define GL_DEBUG_TYPE_MARKER 0x8268
+#define GL_DEBUG_TYPE_PUSH_GROUP 0x8269
+#define GL_DEBUG_TYPE_POP_GROUP 0x826A
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#endif
+
+
+
+namespace {
+	using DebugMessageCallbackFn = void (APIENTRYP)(GLDEBUGPROC callback, void const *userParam);
+	using DebugMessageControlFn = void (APIENTRYP)(GLenum source, GLenum type, GLenum severity, GLsizei count, GLuint const *ids, GLboolean enabled);
+	using PushDebugGroupFn = void (APIENTRYP)(GLenum source, GLuint id, GLsizei length, GLchar const *message);
+	using PopDebugGroupFn = void (APIENTRYP)();
+	using ObjectLabelFn = void (APIENTRYP)(GLenum identifier, GLuint name, GLsizei length, GLchar const *label);
+
+	char const *const TYPE_NAMES[] = { "ERROR", "DEPRECATED", "UNDEFINED_BEHAVIOR", "PORTABILITY", "PERFORMANCE", "OTHER" };
+	char const *const SEVERITY_NAMES[] = { "NOTIFICATION", "LOW", "MEDIUM", "HIGH" };
+	size_t const TYPE_COUNT = static_cast<size_t>(GLDebugType::COUNT);
+
+	struct DebugMessage {
+		GLDebugType m_Type = GLDebugType::Other;
+		GLDebugSeverity m_Severity = GLDebugSeverity::Notification;
+		GLenum m_Source = 0;
+		GLuint m_Id = 0;
+		std::string m_Text;
+		uint64_t m_Count = 0;
+		uint64_t m_FirstFrame = 0;
+		bool m_Printed = false;
+	};
+
+	DebugMessageCallbackFn s_DebugMessageCallback = nullptr;
+	DebugMessageControlFn s_DebugMessageControl = nullptr;
+	PushDebugGroupFn s_PushDebugGroup = nullptr; // KHR_debug only, like s_ObjectLabel
+	PopDebugGroupFn s_PopDebugGroup = nullptr;
+	ObjectLabelFn s_ObjectLabel = nullptr;
+	bool s_Enabled = false;
+	bool s_Khr = false;
+	GLDebugSettings s_Settings;
+
+	// the callback can come from driver threads, the frame counters are only ever added to there
+	std::mutex s_Mutex;
+	std::unordered_map<uint64_t, DebugMessage> s_Messages; // by messageKey()
+	uint64_t s_Frame = 0;
+	uint32_t s_FramePrints = 0;
+	std::atomic<uint32_t> s_FrameCounts[TYPE_COUNT];
+	std::atomic<uint32_t> s_FrameNew(0);
+	std::atomic<uint32_t> s_FrameHeldBack(0);
+	GLDebugFrameStats s_LastFrame;
+
+	GLDebugType toType(GLenum type) {
+		switch (type) {
+		case GL_DEBUG_TYPE_ERROR: return GLDebugType::Error;
+		case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return GLDebugType::DeprecatedBehavior;
+		case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return GLDebugType::UndefinedBehavior;
+		case GL_DEBUG_TYPE_PORTABILITY: return GLDebugType::Portability;
+		case GL_DEBUG_TYPE_PERFORMANCE: return GLDebugType::Performance;
+		default: return GLDebugType::Other;
+		}
+	}
+
+	GLDebugSeverity toSeverity(GLenum severity) {
+		switch (severity) {
+		case GL_DEBUG_SEVERITY_HIGH: return GLDebugSeverity::High;
+		case GL_DEBUG_SEVERITY_MEDIUM: return GLDebugSeverity::Medium;
+		case GL_DEBUG_SEVERITY_LOW: return GLDebugSeverity::Low;
+		default: return GLDebugSeverity::Notification;
+		}
+	}
+
+	char const *sourceName(GLenum source) {
+		switch (source) {
+		case GL_DEBUG_SOURCE_API: return "api";
+		case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "window system";
+		case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+		case GL_DEBUG_SOURCE_THIRD_PARTY: return "third party";
+		case GL_DEBUG_SOURCE_APPLICATION: return "application";
+		default: return "other";
+		}
+	}
+
+	void printMessage(DebugMessage const &message) {
+		std::cout << "GL_DEBUG::" << TYPE_NAMES[static_cast<size_t>(message.m_Type)] << "::" << SEVERITY_NAMES[static_cast<size_t>(message.m_Severity)]
+			<< " (" << sourceName(message.m_Source) << ", id " << message.m_Id << ", frame " << message.m_FirstFrame << "): " << message.m_Text << std::endl;
+	}
+
+	LogSeverity toLogSeverity(DebugMessage const &message) {
+		if (GLDebugType::Error == message.m_Type || GLDebugSeverity::High == message.m_Severity) return LogSeverity::Error;
+		return GLDebugSeverity::Medium == message.m_Severity ? LogSeverity::Warning : LogSeverity::Info;
+	}
+
+	// FNV-1a, so a repeat is found without building a string
+	uint64_t messageKey(GLenum source, GLenum type, GLuint id, char const *text, size_t length) {
+		uint64_t hash = 14695981039346656037ull;
+		uint32_t const header[] = { source, type, id };
+		for (size_t i = 0; i < sizeof(header); ++i) hash = (hash ^ reinterpret_cast<uint8_t const *>(header)[i]) * 1099511628211ull;
+		for (size_t i = 0; i < length; ++i) hash = (hash ^ static_cast<uint8_t>(text[i])) * 1099511628211ull;
+		return hash;
+	}
+
+	void APIENTRY debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, GLchar const *text, void const *) {
+		// ARB_debug_output has no severity filter for the callback, so it's applied here too
+		GLDebugSeverity const messageSeverity = toSeverity(severity);
+		if (messageSeverity < s_Settings.m_MinSeverity) return;
+		GLDebugType const messageType = toType(type);
+		s_FrameCounts[static_cast<size_t>(messageType)].fetch_add(1, std::memory_order_relaxed);
+
+		size_t const textLength = 0 <= length ? static_cast<size_t>(length) : std::strlen(text);
+		uint64_t const key = messageKey(source, type, id, text, textLength);
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		DebugMessage &message = s_Messages[key];
+		if (0 != message.m_Count++) return; // a repeat, only counted
+		message.m_Type = messageType;
+		message.m_Severity = messageSeverity;
+		message.m_Source = source;
+		message.m_Id = id;
+		message.m_Text.assign(text, textLength);
+		message.m_FirstFrame = s_Frame;
+		s_FrameNew.fetch_add(1, std::memory_order_relaxed);
+		if (s_FramePrints >= s_Settings.m_MaxPrintsPerFrame) {
+			s_FrameHeldBack.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		++s_FramePrints;
+		message.m_Printed = true;
+		// the callback runs inside the GL call (or on a driver thread), so it's only queued for the logger thread
+		logMessage(toLogSeverity(message), "GL_DEBUG::%s::%s (%s, id %u, frame %llu): %s", TYPE_NAMES[static_cast<size_t>(message.m_Type)],
+			SEVERITY_NAMES[static_cast<size_t>(message.m_Severity)], sourceName(message.m_Source), message.m_Id, message.m_FirstFrame, message.m_Text);
+	}
+
+	GLenum toGLSeverity(GLDebugSeverity severity) {
+		switch (severity) {
+		case GLDebugSeverity::High: return GL_DEBUG_SEVERITY_HIGH;
+		case GLDebugSeverity::Medium: return GL_DEBUG_SEVERITY_MEDIUM;
+		case GLDebugSeverity::Low: return GL_DEBUG_SEVERITY_LOW;
+		default: return GL_DEBUG_SEVERITY_NOTIFICATION;
+		}
+	}
+}
+
+
+
+bool initGLDebugOutput(GLDebugSettings const &settings) {
+	shutdownGLDebugOutput();
+	s_Settings = settings;
+	s_Khr = 4 < GLVersion.major || (4 == GLVersion.major && 3 <= GLVersion.minor) || glfwExtensionSupported("GL_KHR_debug");
+	if (!s_Khr && !glfwExtensionSupported("GL_ARB_debug_output")) return false;
+
+	s_DebugMessageCallback = reinterpret_cast<DebugMessageCallbackFn>(glfwGetProcAddress(s_Khr ? "glDebugMessageCallback" : "glDebugMessageCallbackARB"));
+	s_DebugMessageControl = reinterpret_cast<DebugMessageControlFn>(glfwGetProcAddress(s_Khr ? "glDebugMessageControl" : "glDebugMessageControlARB"));
+	if (s_Khr) {
+		s_PushDebugGroup = reinterpret_cast<PushDebugGroupFn>(glfwGetProcAddress("glPushDebugGroup"));
+		s_PopDebugGroup = reinterpret_cast<PopDebugGroupFn>(glfwGetProcAddress("glPopDebugGroup"));
+		s_ObjectLabel = reinterpret_cast<ObjectLabelFn>(glfwGetProcAddress("glObjectLabel"));
+	}
+	if (nullptr == s_DebugMessageCallback || nullptr == s_DebugMessageControl) {
+		shutdownGLDebugOutput();
+		return false;
+	}
+
+	// below the minimum severity the driver doesn't even build the strings, and our own groups don't echo back
+	s_DebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+	GLDebugSeverity const SEVERITIES[] = { GLDebugSeverity::Notification, GLDebugSeverity::Low, GLDebugSeverity::Medium };
+	for (GLDebugSeverity const severity : SEVERITIES) {
+		if (severity < settings.m_MinSeverity) s_DebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, toGLSeverity(severity), 0, nullptr, GL_FALSE);
+	}
+	if (s_Khr) {
+		s_DebugMessageControl(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_PUSH_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+		s_DebugMessageControl(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_POP_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+	}
+
+	for (std::atomic<uint32_t> &count : s_FrameCounts) count.store(0);
+	s_DebugMessageCallback(debugCallback, nullptr);
+	if (s_Khr) glEnable(GL_DEBUG_OUTPUT); // ARB_debug_output is always on in a debug context
+	if (settings.m_Synchronous) glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	else glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	s_Enabled = true;
+	return true;
+}
+
+void shutdownGLDebugOutput() {
+	if (s_Enabled) {
+		s_DebugMessageCallback(nullptr, nullptr);
+		if (s_Khr) glDisable(GL_DEBUG_OUTPUT);
+	}
+	s_Enabled = false;
+	s_DebugMessageCallback = nullptr;
+	s_DebugMessageControl = nullptr;
+	s_PushDebugGroup = nullptr;
+	s_PopDebugGroup = nullptr;
+	s_ObjectLabel = nullptr;
+}
+
+bool isGLDebugOutputEnabled() {
+	return s_Enabled;
+}
+
+bool isGLDebugContext() {
+	GLint flags = 0;
+	glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+	return 0 != (flags & GL_CONTEXT_FLAG_DEBUG_BIT);
+}
+
+
+
+void endGLDebugFrame() {
+	if (!s_Enabled) return;
+	GLDebugFrameStats stats;
+	for (size_t type = 0; type < TYPE_COUNT; ++type) stats.m_Messages[type] = s_FrameCounts[type].exchange(0, std::memory_order_relaxed);
+	stats.m_NewMessages = s_FrameNew.exchange(0, std::memory_order_relaxed);
+	stats.m_HeldBack = s_FrameHeldBack.exchange(0, std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	s_LastFrame = stats;
+	s_FramePrints = 0;
+	++s_Frame;
+}
+
+GLDebugFrameStats getGLDebugLastFrame() {
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	return s_LastFrame;
+}
+
+void printGLDebugReport() {
+	flushLog(); // the messages printed as they came first
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	uint64_t totals[TYPE_COUNT] = {};
+	std::vector<DebugMessage const *> messages;
+	for (std::pair<uint64_t const, DebugMessage> const &entry : s_Messages) {
+		totals[static_cast<size_t>(entry.second.m_Type)] += entry.second.m_Count;
+		messages.push_back(&entry.second);
+	}
+	std::sort(messages.begin(), messages.end(), [](DebugMessage const *a, DebugMessage const *b) { return a->m_Count > b->m_Count; });
+
+	std::cout << "GL_DEBUG::REPORT " << messages.size() << " distinct messages over " << s_Frame << " frames:";
+	for (size_t type = 0; type < TYPE_COUNT; ++type) std::cout << " " << TYPE_NAMES[type] << " " << totals[type];
+	std::cout << std::endl;
+	for (DebugMessage const *message : messages) {
+		std::cout << "    " << message->m_Count << "x " << (message->m_Printed ? "" : "(held back) ");
+		printMessage(*message);
+	}
+}
+
+
+
+void labelGLObject(GLLabelIdentifier identifier, unsigned int name, char const *label) {
+	if (nullptr != s_ObjectLabel) s_ObjectLabel(static_cast<GLenum>(identifier), name, -1, label);
+}
+
+GLDebugGroup::GLDebugGroup(char const *name) : m_Pushed(nullptr != s_PushDebugGroup) {
+	if (m_Pushed) s_PushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+}
+
+GLDebugGroup::~GLDebugGroup() {
+	if (m_Pushed) s_PopDebugGroup();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// GL debug output (GL 4.3 / GL_KHR_debug, or the older GL_ARB_debug_output): errors and the driver's performance warnings
+// - the entry points are loaded here (glfwGetProcAddress), the glad in the tree is generated for 3.3 without them
+// - ask for a debug context (GLFW_OPENGL_DEBUG_CONTEXT) to get everything, plain contexts may only report some or nothing
+// - every message is classified (GLDebugType, notably Performance: slow paths, stalls, shader recompiles), deduplicated
+//   (source + type + id + text) and counted per frame, the first occurrence is logged (log.h), repeats are only counted
+//   and more than m_MaxPrintsPerFrame new messages in a frame are held back for printGLDebugReport()
+// - GLDebugGroup pushes a named debug group (KHR_debug only) around a render pass, so captures (RenderDoc, Nsight) show the passes
+// NOTE: asynchronous output (m_Synchronous = false) calls back from driver threads, everything here is thread safe for that
+
+
+
+enum class GLDebugType {
+	Error,
+	DeprecatedBehavior,
+	UndefinedBehavior,
+	Portability,
+	Performance,
+	Other, // incl. markers and groups (which only come back when not filtered)
+	COUNT
+};
+
+enum class GLDebugSeverity {
+	Notification,
+	Low,
+	Medium,
+	High
+};
+
+struct GLDebugSettings {
+	GLDebugSeverity m_MinSeverity = GLDebugSeverity::Low; // some drivers send a notification for every buffer they place
+	bool m_Synchronous = true; // messages arrive inside the GL call that caused them (a breakpoint in the callback shows the culprit)
+	uint32_t m_MaxPrintsPerFrame = 8;
+};
+
+struct GLDebugFrameStats {
+	uint32_t m_Messages[static_cast<size_t>(GLDebugType::COUNT)] = {}; // repeats included
+	uint32_t m_NewMessages = 0; // first occurrences
+	uint32_t m_HeldBack = 0; // new ones over m_MaxPrintsPerFrame
+};
+
+// GL thread, current context, false = neither KHR_debug nor ARB_debug_output (everything below is then a no-op)
+bool initGLDebugOutput(GLDebugSettings const &settings = GLDebugSettings());
+void shutdownGLDebugOutput();
+bool isGLDebugOutputEnabled();
+bool isGLDebugContext(); // GL_CONTEXT_FLAG_DEBUG_BIT
+
+// once per frame
+void endGLDebugFrame();
+GLDebugFrameStats getGLDebugLastFrame();
+
+// per type totals, then every distinct message with its count (most frequent first) and any that were held back
+void printGLDebugReport();
+
+// glObjectLabel()'s identifiers (their GL_ enums aren't in the 3.3 glad)
+enum class GLLabelIdentifier : unsigned int {
+	Buffer = 0x82E0,
+	Shader = 0x82E1,
+	Program = 0x82E2,
+	VertexArray = 0x8074,
+	Query = 0x82E3,
+	Sampler = 0x82E6,
+	Texture = 0x1702,
+	Renderbuffer = 0x8D41,
+	Framebuffer = 0x8D40
+};
+
+// KHR_debug only, for captures: a name for an object (it has to exist already, i.e. been bound once after glGen*)
+void labelGLObject(GLLabelIdentifier identifier, unsigned int name, char const *label);
+
+// a named debug group for the scope (KHR_debug only)
+class GLDebugGroup {
+public:
+	explicit GLDebugGroup(char const *name);
+	~GLDebugGroup();
+
+	GLDebugGroup(GLDebugGroup const &) = delete;
+	GLDebugGroup &operator=(GLDebugGroup const &) = delete;
+
+private:
+	bool m_Pushed;
+};
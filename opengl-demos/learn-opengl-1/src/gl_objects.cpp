@@ -0,0 +1,149 @@
+#include "gl_objects.h"
+
+#include <glad/glad.h>
+
+#include <iostream>
+#include <utility>
+
+
+
+namespace {
+	char const *const TYPE_NAMES[] = { "buffer", "vertex array", "program", "texture" };
+}
+
+
+
+GLObjects::GLObjects() {}
+
+GLObjects::~GLObjects() {
+	deleteAll();
+}
+
+void GLObjects::deleteAll() {
+	for (RetiredFrame &frame : m_RetiredFrames) {
+		glDeleteSync(static_cast<GLsync>(frame.m_Fence));
+		for (size_t type = 0; type < static_cast<size_t>(GLObjectType::COUNT); ++type) deleteNames(type, frame.m_Names[type]);
+	}
+	m_RetiredFrames.clear();
+
+	for (size_t type = 0; type < static_cast<size_t>(GLObjectType::COUNT); ++type) {
+		Pool &pool = m_Pools[type];
+		std::vector<unsigned int> names;
+		names.swap(pool.m_PendingDeletes);
+		names.insert(names.end(), pool.m_SpareNames.begin(), pool.m_SpareNames.end());
+		pool.m_SpareNames.clear();
+		for (size_t i = 0; i < pool.m_Generations.size(); ++i) {
+			if (0 == (pool.m_Generations[i] & 1)) continue;
+			names.push_back(pool.m_Names[i]);
+			// free the slot, so handles to it go stale
+			++pool.m_Generations[i];
+			pool.m_Names[i] = 0;
+			pool.m_Labels[i] = nullptr;
+			pool.m_FreeSlots.push_back(static_cast<uint32_t>(i));
+		}
+		pool.m_LiveCount = 0;
+		deleteNames(type, names);
+	}
+}
+
+
+
+void GLObjects::createSlot(size_t type, char const *label, uint32_t &index, uint32_t &generation) {
+	Pool &pool = m_Pools[type];
+
+	unsigned int name = 0;
+	if (static_cast<size_t>(GLObjectType::Program) == type) {
+		name = glCreateProgram();
+	}
+	else {
+		if (pool.m_SpareNames.empty()) {
+			pool.m_SpareNames.resize(GEN_BATCH);
+			GLsizei const count = static_cast<GLsizei>(GEN_BATCH);
+			if (static_cast<size_t>(GLObjectType::Buffer) == type) glGenBuffers(count, pool.m_SpareNames.data());
+			else if (static_cast<size_t>(GLObjectType::VertexArray) == type) glGenVertexArrays(count, pool.m_SpareNames.data());
+			else glGenTextures(count, pool.m_SpareNames.data());
+		}
+		name = pool.m_SpareNames.back();
+		pool.m_SpareNames.pop_back();
+	}
+
+	if (pool.m_FreeSlots.empty()) {
+		index = static_cast<uint32_t>(pool.m_Generations.size());
+		pool.m_Generations.push_back(1);
+		pool.m_Names.push_back(name);
+		pool.m_Labels.push_back(label);
+	}
+	else {
+		index = pool.m_FreeSlots.back();
+		pool.m_FreeSlots.pop_back();
+		++pool.m_Generations[index];
+		pool.m_Names[index] = name;
+		pool.m_Labels[index] = label;
+	}
+	generation = pool.m_Generations[index];
+	++pool.m_LiveCount;
+}
+
+void GLObjects::destroySlot(size_t type, uint32_t index, uint32_t generation) {
+	Pool &pool = m_Pools[type];
+	if (index >= pool.m_Generations.size() || pool.m_Generations[index] != generation || 0 == (generation & 1)) return; // stale/invalid
+
+	pool.m_PendingDeletes.push_back(pool.m_Names[index]);
+	++pool.m_Generations[index];
+	pool.m_Names[index] = 0;
+	pool.m_Labels[index] = nullptr;
+	pool.m_FreeSlots.push_back(index);
+	--pool.m_LiveCount;
+}
+
+void GLObjects::deleteNames(size_t type, std::vector<unsigned int> &names) {
+	if (names.empty()) return;
+
+	GLsizei const count = static_cast<GLsizei>(names.size());
+	if (static_cast<size_t>(GLObjectType::Buffer) == type) glDeleteBuffers(count, names.data());
+	else if (static_cast<size_t>(GLObjectType::VertexArray) == type) glDeleteVertexArrays(count, names.data());
+	else if (static_cast<size_t>(GLObjectType::Texture) == type) glDeleteTextures(count, names.data());
+	else for (unsigned int name : names) glDeleteProgram(name); // no batched version
+	names.clear();
+}
+
+
+
+void GLObjects::endFrame() {
+	// delete what the GPU is done with (fences signal in order, so stop at the first one that hasn't)
+	size_t finished = 0;
+	while (finished < m_RetiredFrames.size()) {
+		GLsync fence = static_cast<GLsync>(m_RetiredFrames[finished].m_Fence);
+		GLenum const status = glClientWaitSync(fence, 0, 0);
+		if (GL_ALREADY_SIGNALED != status && GL_CONDITION_SATISFIED != status) break;
+		glDeleteSync(fence);
+		for (size_t type = 0; type < static_cast<size_t>(GLObjectType::COUNT); ++type) deleteNames(type, m_RetiredFrames[finished].m_Names[type]);
+		++finished;
+	}
+	m_RetiredFrames.erase(m_RetiredFrames.begin(), m_RetiredFrames.begin() + finished);
+
+	// fence this frame's destroy()s
+	bool any = false;
+	for (Pool const &pool : m_Pools) any = any || !pool.m_PendingDeletes.empty();
+	if (!any) return;
+
+	RetiredFrame frame;
+	frame.m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	for (size_t type = 0; type < static_cast<size_t>(GLObjectType::COUNT); ++type) frame.m_Names[type].swap(m_Pools[type].m_PendingDeletes);
+	m_RetiredFrames.push_back(std::move(frame));
+}
+
+
+
+size_t GLObjects::reportLeaks() const {
+	size_t leaks = 0;
+	for (size_t type = 0; type < static_cast<size_t>(GLObjectType::COUNT); ++type) {
+		Pool const &pool = m_Pools[type];
+		for (size_t i = 0; i < pool.m_Generations.size(); ++i) {
+			if (0 == (pool.m_Generations[i] & 1)) continue;
+			std::cout << "LEAK::GL_OBJECT::" << TYPE_NAMES[type] << " " << pool.m_Names[i] << " (" << (pool.m_Labels[i] ? pool.m_Labels[i] : "unlabeled") << ")" << std::endl;
+			++leaks;
+		}
+	}
+	return leaks;
+}
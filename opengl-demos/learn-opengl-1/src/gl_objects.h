@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GL objects behind typed generational handles instead of raw unsigned int names
+// - 1 dense pool per object type: a handle is (slot index, generation), lookup is 2 array reads and a stale handle
+//   (its object was destroyed, maybe the slot reused) gets 0 instead of someone else's object
+// - names come from batched glGen*() calls (GEN_BATCH at a time), deletions from 1 glDelete*() per type and frame
+// - destroy() is deferred: the handle dies right away, the GL object is deleted once a fence shows the GPU is done with
+//   the frame it was last used in (endFrame())
+// - reportLeaks() lists what's still alive (with the label it was created with)
+
+
+
+enum class GLObjectType : uint8_t {
+	Buffer,
+	VertexArray,
+	Program,
+	Texture,
+	COUNT
+};
+
+// generation 0 is never handed out, so a default constructed handle is invalid
+template <GLObjectType TYPE>
+struct GLHandle {
+	uint32_t m_Index = 0;
+	uint32_t m_Generation = 0;
+
+	bool isValid() const { return 0 != m_Generation; }
+	bool operator==(GLHandle const &other) const { return m_Index == other.m_Index && m_Generation == other.m_Generation; }
+	bool operator!=(GLHandle const &other) const { return !(*this == other); }
+};
+
+typedef GLHandle<GLObjectType::Buffer> BufferHandle;
+typedef GLHandle<GLObjectType::VertexArray> VertexArrayHandle;
+typedef GLHandle<GLObjectType::Program> ProgramHandle;
+typedef GLHandle<GLObjectType::Texture> TextureHandle;
+
+
+
+class GLObjects {
+public:
+	static size_t const GEN_BATCH = 64; // names per glGen*() call (programs can only be created 1 at a time)
+
+	GLObjects();
+	~GLObjects(); // deleteAll(), so either the GL context is still current or deleteAll() was called before
+
+	GLObjects(GLObjects const &) = delete;
+	GLObjects &operator=(GLObjects const &) = delete;
+
+	// label is only kept as a pointer (string literals), it shows up in reportLeaks()
+	BufferHandle createBuffer(char const *label = nullptr) { return create<GLObjectType::Buffer>(label); }
+	VertexArrayHandle createVertexArray(char const *label = nullptr) { return create<GLObjectType::VertexArray>(label); }
+	ProgramHandle createProgram(char const *label = nullptr) { return create<GLObjectType::Program>(label); }
+	TextureHandle createTexture(char const *label = nullptr) { return create<GLObjectType::Texture>(label); }
+
+	// GL name, 0 for invalid/stale handles
+	template <GLObjectType TYPE>
+	unsigned int get(GLHandle<TYPE> handle) const {
+		Pool const &pool = m_Pools[static_cast<size_t>(TYPE)];
+		return handle.m_Index < pool.m_Generations.size() && pool.m_Generations[handle.m_Index] == handle.m_Generation ? pool.m_Names[handle.m_Index] : 0;
+	}
+
+	// the handle is invalidated (and reset) right away, the GL object is deleted once the GPU is done with this frame
+	template <GLObjectType TYPE>
+	void destroy(GLHandle<TYPE> &handle) {
+		destroySlot(static_cast<size_t>(TYPE), handle.m_Index, handle.m_Generation);
+		handle = GLHandle<TYPE>();
+	}
+
+	// once per frame after its last GL call: fences this frame's destroy()s, deletes those of frames the GPU has finished
+	void endFrame();
+
+	size_t getLiveCount(GLObjectType type) const { return m_Pools[static_cast<size_t>(type)].m_LiveCount; }
+	// prints every live object, returns how many there were
+	size_t reportLeaks() const;
+
+	// deletes everything right away, pending destroy()s and live objects alike (the destructor does the same)
+	void deleteAll();
+
+private:
+	struct Pool {
+		// per slot, structure of arrays so get() only touches the 2 it needs
+		std::vector<uint32_t> m_Generations; // odd = live, even = free (so a freed slot's old handles never match)
+		std::vector<unsigned int> m_Names;
+		std::vector<char const *> m_Labels;
+
+		std::vector<uint32_t> m_FreeSlots;
+		std::vector<unsigned int> m_SpareNames; // from glGen*(), not handed out yet
+		std::vector<unsigned int> m_PendingDeletes; // destroyed this frame
+		size_t m_LiveCount = 0;
+	};
+
+	struct RetiredFrame {
+		void *m_Fence; // GLsync
+		std::vector<unsigned int> m_Names[static_cast<size_t>(GLObjectType::COUNT)];
+	};
+
+	template <GLObjectType TYPE>
+	GLHandle<TYPE> create(char const *label) {
+		GLHandle<TYPE> handle;
+		createSlot(static_cast<size_t>(TYPE), label, handle.m_Index, handle.m_Generation);
+		return handle;
+	}
+
+	void createSlot(size_t type, char const *label, uint32_t &index, uint32_t &generation);
+	void destroySlot(size_t type, uint32_t index, uint32_t generation);
+	void deleteNames(size_t type, std::vector<unsigned int> &names); // batched glDelete*(), clears names
+
+	Pool m_Pools[static_cast<size_t>(GLObjectType::COUNT)];
+	std::vector<RetiredFrame> m_RetiredFrames; // oldest first
+};
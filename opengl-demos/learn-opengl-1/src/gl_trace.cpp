@@ -0,0 +1,1575 @@
+#include "gl_trace.h"
+#include "texture_container.h" // MappedFile
+
+//NOTE: must include glad before glfw
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+
+
+// trace file: header, then per call u16 function id + u32 record bytes + the arguments in order + the result, u16 FRAME_MARKER between frames
+// - scalars raw, GLsync as an id (the replay maps ids to its own syncs), strings with their length and a NUL
+// - const pointers a function reads: element count (NULL_COUNT = nullptr) + the elements, 8 byte aligned in the file so the
+//   replay hands GL pointers straight into the mapped trace
+// - void pointers: nullptr, a buffer offset (element/attribute pointers, uploads while an unpack buffer is bound) or client bytes
+// - output pointers: only the size the replay has to provide (or the offset into a bound pack buffer)
+// NOTE: the glad names are macros (glCullFace -> glad_glCullFace), so GLFunction::glCullFace is really GLFunction::glad_glCullFace,
+//       which is fine as long as every use goes through the macro too
+
+
+
+namespace {
+	enum class GLFunction : uint16_t {
+#define GL_FUNCTION(name) name,
+#include "gl_trace_functions.inl"
+#undef GL_FUNCTION
+		Count
+	};
+
+	size_t const FUNCTION_COUNT = static_cast<size_t>(GLFunction::Count);
+
+	char const *const FUNCTION_NAMES[FUNCTION_COUNT] = {
+#define GL_FUNCTION(name) #name,
+#include "gl_trace_functions.inl"
+#undef GL_FUNCTION
+	};
+
+	uint32_t const TRACE_MAGIC = 0x52544C47; // "GLTR"
+	uint32_t const TRACE_VERSION = 1;
+	uint16_t const FRAME_MARKER = 0xFFFF;
+	uint32_t const NULL_COUNT = 0xFFFFFFFF;
+	size_t const PAYLOAD_ALIGNMENT = 8;
+	size_t const FLUSH_BYTES = 64 * 1024 * 1024; // a frame with more than this (big uploads) is written out early
+	size_t const OUTPUT_SLOTS = 4; // glGetActiveUniform has 4 output pointers
+	size_t const OUTPUT_BYTES = 1024 * 1024; // replay scratch per output pointer, when the trace has no size for it
+
+	enum PointerKind : uint8_t {
+		POINTER_NULL,
+		POINTER_OFFSET,
+		POINTER_CLIENT
+	};
+
+	struct TraceHeader {
+		uint32_t m_Magic = TRACE_MAGIC;
+		uint32_t m_Version = TRACE_VERSION;
+		uint32_t m_FunctionCount = static_cast<uint32_t>(FUNCTION_COUNT);
+		int32_t m_Width = 0; // the viewport when recording started
+		int32_t m_Height = 0;
+	};
+
+	using Clock = std::chrono::steady_clock;
+
+	double ticksToMs(Clock::rep ticks) {
+		return std::chrono::duration<double, std::milli>(Clock::duration(ticks)).count();
+	}
+
+	size_t toSize(int64_t value) {
+		return 0 < value ? static_cast<size_t>(value) : 0;
+	}
+
+
+
+	// recording side
+	class TraceWriter {
+	public:
+		bool open(std::string const &path) {
+			m_File = std::fopen(path.c_str(), "wb");
+			m_Flushed = 0;
+			m_Buffer.clear();
+			m_Buffer.reserve(4 * 1024 * 1024);
+			return nullptr != m_File;
+		}
+
+		void close() {
+			if (nullptr == m_File) return;
+			flush();
+			std::fclose(m_File);
+			m_File = nullptr;
+		}
+
+		void flush() {
+			if (!m_Buffer.empty()) std::fwrite(m_Buffer.data(), 1, m_Buffer.size(), m_File);
+			m_Flushed += m_Buffer.size();
+			m_Buffer.clear();
+		}
+
+		void bytes(void const *data, size_t size) {
+			uint8_t const *begin = static_cast<uint8_t const *>(data);
+			m_Buffer.insert(m_Buffer.end(), begin, begin + size);
+		}
+
+		template <typename T>
+		void value(T const &v) {
+			bytes(&v, sizeof(T));
+		}
+
+		// count + 8 byte aligned elements, nullptr = NULL_COUNT
+		template <typename T>
+		void array(T const *data, size_t count) {
+			value(nullptr == data ? NULL_COUNT : static_cast<uint32_t>(count));
+			if (nullptr == data) return;
+			m_Buffer.resize(m_Buffer.size() + (PAYLOAD_ALIGNMENT - (m_Flushed + m_Buffer.size()) % PAYLOAD_ALIGNMENT) % PAYLOAD_ALIGNMENT, 0);
+			bytes(data, count * sizeof(T));
+		}
+
+		void string(char const *data, size_t length) {
+			value(nullptr == data ? NULL_COUNT : static_cast<uint32_t>(length));
+			if (nullptr == data) return;
+			bytes(data, length);
+			value('\0');
+		}
+
+		// record bytes are patched in by endRecord()
+		size_t beginRecord(uint16_t id) {
+			value(id);
+			size_t const at = m_Buffer.size();
+			value(uint32_t(0));
+			return at;
+		}
+
+		void endRecord(size_t at) {
+			uint32_t const size = static_cast<uint32_t>(m_Buffer.size() - at - sizeof(uint32_t));
+			std::memcpy(&m_Buffer[at], &size, sizeof(size));
+			if (FLUSH_BYTES <= m_Buffer.size()) flush();
+		}
+
+	private:
+		std::FILE *m_File = nullptr;
+		std::vector<uint8_t> m_Buffer; // the current frame
+		uint64_t m_Flushed = 0; // bytes already in the file (payload alignment is relative to the file start)
+	};
+
+	struct PixelStore {
+		GLint m_Alignment = 4;
+		GLint m_RowLength = 0;
+		GLint m_ImageHeight = 0;
+		GLint m_SkipPixels = 0;
+		GLint m_SkipRows = 0;
+		GLint m_SkipImages = 0;
+	};
+
+	struct Mapping {
+		GLenum m_Target = 0;
+		uint8_t *m_Pointer = nullptr;
+		size_t m_Length = 0;
+		bool m_Capture = false; // written by the app and not flushed explicitly: the whole range is recorded at unmap
+	};
+
+	struct FunctionCounters {
+		uint64_t m_Calls = 0;
+		Clock::rep m_Ticks = 0;
+	};
+
+	bool s_Installed = false;
+	thread_local bool t_TraceThread = false;
+	bool s_IsDraw[FUNCTION_COUNT] = {};
+	FunctionCounters s_Functions[FUNCTION_COUNT];
+	FunctionCounters s_Frame;
+	uint64_t s_FrameDraws = 0;
+	uint64_t s_FrameTriangles = 0;
+	uint64_t s_FrameStateChanges = 0;
+	uint64_t s_FrameFiltered = 0;
+	uint64_t s_FrameUploadBytes = 0;
+	GLTraceFrameStats s_LastFrame;
+	std::unordered_map<GLuint, size_t> s_BufferSizes; // buffer name -> its last glBufferData size
+	uint64_t s_BufferBytes = 0;
+
+	bool s_Recording = false;
+	TraceWriter s_Writer;
+	std::unordered_map<GLsync, uint32_t> s_SyncIds;
+	uint32_t s_NextSyncId = 0;
+
+	// tracked (not queried) so sizing an upload doesn't cost a driver round trip
+	PixelStore s_Unpack;
+	PixelStore s_Pack;
+	GLuint s_UnpackBuffer = 0;
+	GLuint s_PackBuffer = 0;
+	std::vector<Mapping> s_Mappings;
+
+
+
+	// the redundant state filter's view of the context: what the tracer last passed on, UNKNOWN until then
+	GLuint const UNKNOWN = 0xFFFFFFFF;
+	size_t const TEXTURE_UNITS = 32; // units above aren't filtered
+	// not GL_ELEMENT_ARRAY_BUFFER, that binding belongs to the vertex array
+	GLenum const BUFFER_TARGETS[] = { GL_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER,
+		GL_TEXTURE_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER, GL_UNIFORM_BUFFER };
+	GLenum const TEXTURE_TARGETS[] = { GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_3D, GL_TEXTURE_1D_ARRAY, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_RECTANGLE,
+		GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BUFFER, GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_2D_MULTISAMPLE_ARRAY };
+	GLenum const CAPABILITIES[] = { GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_SCISSOR_TEST, GL_DEPTH_CLAMP, GL_MULTISAMPLE,
+		GL_SAMPLE_ALPHA_TO_COVERAGE, GL_POLYGON_OFFSET_FILL, GL_POLYGON_OFFSET_LINE, GL_POLYGON_OFFSET_POINT, GL_FRAMEBUFFER_SRGB,
+		GL_PRIMITIVE_RESTART, GL_RASTERIZER_DISCARD, GL_PROGRAM_POINT_SIZE, GL_TEXTURE_CUBE_MAP_SEAMLESS };
+	size_t const BUFFER_TARGET_COUNT = sizeof(BUFFER_TARGETS) / sizeof(BUFFER_TARGETS[0]);
+	size_t const TEXTURE_TARGET_COUNT = sizeof(TEXTURE_TARGETS) / sizeof(TEXTURE_TARGETS[0]);
+	size_t const CAPABILITY_COUNT = sizeof(CAPABILITIES) / sizeof(CAPABILITIES[0]);
+
+	struct StateCache {
+		GLuint m_Program;
+		GLuint m_VertexArray;
+		GLuint m_ActiveUnit; // glActiveTexture() - GL_TEXTURE0
+		GLuint m_DrawFramebuffer;
+		GLuint m_ReadFramebuffer;
+		GLuint m_PolygonMode;
+		GLuint m_Buffers[BUFFER_TARGET_COUNT];
+		GLuint m_Textures[TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+		GLuint m_Capabilities[CAPABILITY_COUNT]; // GL_TRUE / GL_FALSE
+	};
+
+	bool s_StateFilter = false; // setGLStateFilter()
+	StateCache s_State;
+
+	void forgetState() {
+		s_State.m_Program = s_State.m_VertexArray = s_State.m_ActiveUnit = UNKNOWN;
+		s_State.m_DrawFramebuffer = s_State.m_ReadFramebuffer = s_State.m_PolygonMode = UNKNOWN;
+		std::fill_n(s_State.m_Buffers, BUFFER_TARGET_COUNT, UNKNOWN);
+		std::fill_n(&s_State.m_Textures[0][0], TEXTURE_UNITS * TEXTURE_TARGET_COUNT, UNKNOWN);
+		std::fill_n(s_State.m_Capabilities, CAPABILITY_COUNT, UNKNOWN);
+	}
+
+	// deleted objects are unbound by GL, their names can come back from the next glGen*()
+	void forgetName(GLuint *values, size_t count, GLuint name) {
+		for (size_t i = 0; i < count; ++i) {
+			if (name == values[i]) values[i] = UNKNOWN;
+		}
+	}
+
+	template <size_t N>
+	size_t indexOf(GLenum const (&values)[N], GLenum value) {
+		for (size_t i = 0; i < N; ++i) {
+			if (value == values[i]) return i;
+		}
+		return N;
+	}
+
+	// false = the cache already had value (a redundant call), otherwise it's cached from now on
+	bool changes(GLuint &cached, GLuint value) {
+		if (cached == value) return false;
+		cached = value;
+		return true;
+	}
+
+	GLuint *bufferSlot(GLenum target) {
+		size_t const index = indexOf(BUFFER_TARGETS, target);
+		return BUFFER_TARGET_COUNT == index ? nullptr : &s_State.m_Buffers[index];
+	}
+
+	GLuint *textureSlot(GLenum target) {
+		size_t const index = indexOf(TEXTURE_TARGETS, target);
+		if (TEXTURE_UNITS <= s_State.m_ActiveUnit || TEXTURE_TARGET_COUNT == index) return nullptr; // UNKNOWN included
+		return &s_State.m_Textures[s_State.m_ActiveUnit][index];
+	}
+
+	GLuint *capabilitySlot(GLenum capability) {
+		size_t const index = indexOf(CAPABILITIES, capability);
+		return CAPABILITY_COUNT == index ? nullptr : &s_State.m_Capabilities[index];
+	}
+
+	bool redundantFramebuffer(GLenum target, GLuint name) {
+		if (GL_DRAW_FRAMEBUFFER == target) return !changes(s_State.m_DrawFramebuffer, name);
+		if (GL_READ_FRAMEBUFFER == target) return !changes(s_State.m_ReadFramebuffer, name);
+		bool const redundant = name == s_State.m_DrawFramebuffer && name == s_State.m_ReadFramebuffer;
+		s_State.m_DrawFramebuffer = name;
+		s_State.m_ReadFramebuffer = name;
+		return redundant;
+	}
+
+	// the generic binding point's query (the copy targets have no separate _BINDING enum), 0 = not tracked
+	GLenum bufferBinding(GLenum target) {
+		switch (target) {
+		case GL_ARRAY_BUFFER: return GL_ARRAY_BUFFER_BINDING;
+		case GL_ELEMENT_ARRAY_BUFFER: return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+		case GL_PIXEL_PACK_BUFFER: return GL_PIXEL_PACK_BUFFER_BINDING;
+		case GL_PIXEL_UNPACK_BUFFER: return GL_PIXEL_UNPACK_BUFFER_BINDING;
+		case GL_UNIFORM_BUFFER: return GL_UNIFORM_BUFFER_BINDING;
+		case GL_TRANSFORM_FEEDBACK_BUFFER: return GL_TRANSFORM_FEEDBACK_BUFFER_BINDING;
+		case GL_COPY_READ_BUFFER: return GL_COPY_READ_BUFFER;
+		case GL_COPY_WRITE_BUFFER: return GL_COPY_WRITE_BUFFER;
+		default: return 0;
+		}
+	}
+
+
+
+	// replay side, every read is bounds checked (m_Failed, and zeros from then on)
+	class TraceReader {
+	public:
+		TraceReader(uint8_t const *data, size_t size) : m_Data(data), m_Size(size) {}
+
+		bool failed() const { return m_Failed; }
+		size_t position() const { return m_Position; }
+		void seek(size_t position) { m_Position = position; }
+		bool atEnd() const { return m_Size <= m_Position; }
+
+		bool skip(size_t size) {
+			if (m_Failed || m_Size - m_Position < size) {
+				m_Failed = true;
+				return false;
+			}
+			m_Position += size;
+			return true;
+		}
+
+		template <typename T>
+		T value() {
+			T v = T();
+			if (skip(sizeof(T))) std::memcpy(&v, m_Data + m_Position - sizeof(T), sizeof(T));
+			return v;
+		}
+
+		template <typename T>
+		T const *array(size_t *count = nullptr) {
+			uint32_t const elements = value<uint32_t>();
+			if (nullptr != count) *count = 0;
+			if (m_Failed || NULL_COUNT == elements) return nullptr;
+			if (!skip((PAYLOAD_ALIGNMENT - m_Position % PAYLOAD_ALIGNMENT) % PAYLOAD_ALIGNMENT)) return nullptr;
+			T const *data = reinterpret_cast<T const *>(m_Data + m_Position);
+			if (!skip(static_cast<size_t>(elements) * sizeof(T))) return nullptr;
+			if (nullptr != count) *count = elements;
+			return data;
+		}
+
+		char const *string() {
+			uint32_t const length = value<uint32_t>();
+			if (m_Failed || NULL_COUNT == length) return nullptr;
+			char const *data = reinterpret_cast<char const *>(m_Data + m_Position);
+			if (!skip(static_cast<size_t>(length) + 1) || '\0' != data[length]) m_Failed = true;
+			return data;
+		}
+
+		void beginCall() { m_NextOutput = 0; }
+
+		void *output(size_t size) {
+			std::vector<uint8_t> &slot = m_Outputs[m_NextOutput++ % OUTPUT_SLOTS];
+			if (slot.size() < std::max(size, OUTPUT_BYTES)) slot.resize(std::max(size, OUTPUT_BYTES));
+			return slot.data();
+		}
+
+		uint8_t *mapping(GLenum target) const {
+			for (std::pair<GLenum, uint8_t *> const &mapping : m_Mappings) {
+				if (target == mapping.first) return mapping.second;
+			}
+			return nullptr;
+		}
+
+		std::vector<GLsync> m_Syncs;
+		std::vector<std::pair<GLenum, uint8_t *>> m_Mappings;
+		std::vector<char const *> m_Strings; // for the 1 string array argument a function can have
+		std::vector<void const *> m_Offsets;
+		uint64_t m_ResultMismatches = 0;
+
+	private:
+		uint8_t const *m_Data;
+		size_t m_Size;
+		size_t m_Position = 0;
+		bool m_Failed = false;
+		std::vector<uint8_t> m_Outputs[OUTPUT_SLOTS];
+		size_t m_NextOutput = 0;
+	};
+
+
+
+	// 1 instantiation per entry point: the driver's pointer, the tracing wrapper glad points at while installed, the replayer
+	template <GLFunction F, typename Proc>
+	struct Entry;
+
+	template <GLFunction F, typename R, typename... Args>
+	struct Entry<F, R (APIENTRYP)(Args...)> {
+		using Proc = R (APIENTRYP)(Args...);
+
+		static Proc s_Driver;
+
+		static R APIENTRY trace(Args... args);
+		static Clock::rep replay(TraceReader &reader);
+	};
+
+	template <GLFunction F, typename R, typename... Args>
+	typename Entry<F, R (APIENTRYP)(Args...)>::Proc Entry<F, R (APIENTRYP)(Args...)>::s_Driver = nullptr;
+
+	// the driver's function behind a glad name, for the tracer's own (untraced) queries
+#define GL_DRIVER(name) Entry<GLFunction::name, decltype(glad_##name)>::s_Driver
+
+	template <typename R>
+	struct Result {
+		R m_Value = R();
+
+		template <typename Proc, typename Tuple, size_t... I>
+		void call(Proc proc, Tuple const &args, std::index_sequence<I...>) { m_Value = proc(std::get<I>(args)...); }
+		R get() const { return m_Value; }
+	};
+
+	template <>
+	struct Result<void> {
+		std::nullptr_t m_Value = nullptr; // hooks and result writers see nullptr for void functions
+
+		template <typename Proc, typename Tuple, size_t... I>
+		void call(Proc proc, Tuple const &args, std::index_sequence<I...>) { proc(std::get<I>(args)...); }
+		void get() const {}
+	};
+
+
+
+	// bytes a pixel transfer touches from its pointer on, with the pixel store state (skips included)
+	size_t pixelBytes(GLenum format, GLenum type) {
+		size_t components = 0;
+		switch (format) {
+		case GL_RED: case GL_GREEN: case GL_BLUE: case GL_RED_INTEGER: case GL_GREEN_INTEGER: case GL_BLUE_INTEGER:
+		case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX: components = 1; break;
+		case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL: components = 2; break;
+		case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: case GL_BGR_INTEGER: components = 3; break;
+		case GL_RGBA: case GL_BGRA: case GL_RGBA_INTEGER: case GL_BGRA_INTEGER: components = 4; break;
+		default: return 0;
+		}
+		switch (type) {
+		case GL_UNSIGNED_BYTE: case GL_BYTE: return components;
+		case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: return components * 2;
+		case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: return components * 4;
+		case GL_UNSIGNED_BYTE_3_3_2: case GL_UNSIGNED_BYTE_2_3_3_REV: return 1;
+		case GL_UNSIGNED_SHORT_5_6_5: case GL_UNSIGNED_SHORT_5_6_5_REV: case GL_UNSIGNED_SHORT_4_4_4_4: case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+		case GL_UNSIGNED_SHORT_5_5_5_1: case GL_UNSIGNED_SHORT_1_5_5_5_REV: return 2;
+		case GL_UNSIGNED_INT_8_8_8_8: case GL_UNSIGNED_INT_8_8_8_8_REV: case GL_UNSIGNED_INT_10_10_10_2: case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_24_8: case GL_UNSIGNED_INT_10F_11F_11F_REV: case GL_UNSIGNED_INT_5_9_9_9_REV: return 4;
+		case GL_FLOAT_32_UNSIGNED_INT_24_8_REV: return 8;
+		default: return 0;
+		}
+	}
+
+	// volume = 3D calls, the only ones GL_*_IMAGE_HEIGHT and GL_*_SKIP_IMAGES apply to
+	size_t imageBytes(PixelStore const &store, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, bool volume) {
+		size_t const pixel = pixelBytes(format, type);
+		if (0 == pixel || 0 >= width || 0 >= height || 0 >= depth) return 0;
+		size_t const alignment = static_cast<size_t>(std::max(store.m_Alignment, 1));
+		size_t const rowPixels = toSize(0 < store.m_RowLength ? store.m_RowLength : width);
+		size_t const rowBytes = (rowPixels * pixel + alignment - 1) / alignment * alignment;
+		size_t const imageRows = toSize(volume && 0 < store.m_ImageHeight ? store.m_ImageHeight : height);
+		size_t const skipImages = volume ? toSize(store.m_SkipImages) : 0;
+		return (skipImages + toSize(depth) - 1) * imageRows * rowBytes + (toSize(store.m_SkipRows) + toSize(height) - 1) * rowBytes +
+			(toSize(store.m_SkipPixels) + toSize(width)) * pixel;
+	}
+
+	size_t texImageBytes(GLenum target, GLint level, GLenum format, GLenum type) {
+		GLint width = 0;
+		GLint height = 0;
+		GLint depth = 0;
+		GL_DRIVER(glGetTexLevelParameteriv)(target, level, GL_TEXTURE_WIDTH, &width);
+		GL_DRIVER(glGetTexLevelParameteriv)(target, level, GL_TEXTURE_HEIGHT, &height);
+		GL_DRIVER(glGetTexLevelParameteriv)(target, level, GL_TEXTURE_DEPTH, &depth);
+		return imageBytes(s_Pack, width, height, depth, format, type, 1 < depth);
+	}
+
+	size_t compressedTexImageBytes(GLenum target, GLint level) {
+		GLint size = 0;
+		GL_DRIVER(glGetTexLevelParameteriv)(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+		return toSize(size);
+	}
+
+	// for glTexParameter*v / glSamplerParameter*v
+	size_t parameterCount(GLenum pname) {
+		return GL_TEXTURE_BORDER_COLOR == pname || GL_TEXTURE_SWIZZLE_RGBA == pname ? 4 : 1;
+	}
+
+	Mapping *findMapping(GLenum target) {
+		for (Mapping &mapping : s_Mappings) {
+			if (target == mapping.m_Target) return &mapping;
+		}
+		return nullptr;
+	}
+
+	void removeMapping(GLenum target) {
+		s_Mappings.erase(std::remove_if(s_Mappings.begin(), s_Mappings.end(), [target](Mapping const &mapping) { return target == mapping.m_Target; }), s_Mappings.end());
+	}
+
+
+
+	// how many elements each typed const pointer argument of a function points at (all of a function's arrays have the same count)
+	// every function with one needs a GL_PAYLOAD, the wrapper static_asserts it
+	template <GLFunction F>
+	struct Payload {
+		static bool const DEFINED = false;
+		template <typename Tuple> static size_t count(Tuple const &) { return 0; }
+	};
+
+	// what a void const * argument points at in client memory, PIXELS = an offset instead while an unpack buffer is bound,
+	// functions without one (draws, attribute pointers) are recorded as offsets: the core profile has no client arrays
+	template <GLFunction F>
+	struct Data {
+		static bool const DEFINED = false;
+		static bool const PIXELS = false;
+		template <typename Tuple> static size_t bytes(Tuple const &) { return 0; }
+	};
+
+	// bytes an output pointer gets written (the replay's scratch size), PIXELS = an offset instead while a pack buffer is bound
+	template <GLFunction F>
+	struct Output {
+		static bool const PIXELS = false;
+		template <typename Tuple> static size_t bytes(Tuple const &) { return 0; }
+	};
+
+	// triangles a draw submits (instances included), 0 for everything else
+	template <GLFunction F>
+	struct Triangles {
+		template <typename Tuple> static uint64_t count(Tuple const &) { return 0; }
+	};
+
+	uint64_t triangleCount(GLenum mode, GLsizei vertices) {
+		size_t const count = toSize(vertices);
+		switch (mode) {
+		case GL_TRIANGLES: return count / 3;
+		case GL_TRIANGLE_STRIP: case GL_TRIANGLE_FAN: return 2 < count ? count - 2 : 0;
+		case GL_TRIANGLES_ADJACENCY: return count / 6;
+		case GL_TRIANGLE_STRIP_ADJACENCY: return 4 < count ? (count - 4) / 2 : 0;
+		default: return 0;
+		}
+	}
+
+	uint64_t multiTriangleCount(GLenum mode, GLsizei const *counts, GLsizei drawCount) {
+		uint64_t triangles = 0;
+		for (GLsizei i = 0; nullptr != counts && i < drawCount; ++i) triangles += triangleCount(mode, counts[i]);
+		return triangles;
+	}
+
+#define GL_ARG(i) std::get<i>(a)
+#define GL_PAYLOAD(name, elements) \
+	template <> struct Payload<GLFunction::name> { \
+		static bool const DEFINED = true; \
+		template <typename Tuple> static size_t count(Tuple const &a) { (void)a; return toSize(static_cast<int64_t>(elements)); } \
+	};
+#define GL_DATA(name, pixels, byteCount) \
+	template <> struct Data<GLFunction::name> { \
+		static bool const DEFINED = true; \
+		static bool const PIXELS = pixels; \
+		template <typename Tuple> static size_t bytes(Tuple const &a) { (void)a; return toSize(static_cast<int64_t>(byteCount)); } \
+	};
+#define GL_OUTPUT(name, pixels, byteCount) \
+	template <> struct Output<GLFunction::name> { \
+		static bool const PIXELS = pixels; \
+		template <typename Tuple> static size_t bytes(Tuple const &a) { (void)a; return toSize(static_cast<int64_t>(byteCount)); } \
+	};
+#define GL_TRIANGLES_DRAWN(name, triangles) \
+	template <> struct Triangles<GLFunction::name> { \
+		template <typename Tuple> static uint64_t count(Tuple const &a) { (void)a; return triangles; } \
+	};
+
+	GL_PAYLOAD(glDeleteTextures, GL_ARG(0))
+	GL_PAYLOAD(glDeleteQueries, GL_ARG(0))
+	GL_PAYLOAD(glDeleteBuffers, GL_ARG(0))
+	GL_PAYLOAD(glDeleteRenderbuffers, GL_ARG(0))
+	GL_PAYLOAD(glDeleteFramebuffers, GL_ARG(0))
+	GL_PAYLOAD(glDeleteVertexArrays, GL_ARG(0))
+	GL_PAYLOAD(glDeleteSamplers, GL_ARG(0))
+	GL_PAYLOAD(glDrawBuffers, GL_ARG(0))
+	GL_PAYLOAD(glMultiDrawArrays, GL_ARG(3))
+	GL_PAYLOAD(glMultiDrawElements, GL_ARG(4))
+	GL_PAYLOAD(glMultiDrawElementsBaseVertex, GL_ARG(4))
+	GL_PAYLOAD(glShaderSource, GL_ARG(1))
+	GL_PAYLOAD(glTransformFeedbackVaryings, GL_ARG(1))
+	GL_PAYLOAD(glGetUniformIndices, GL_ARG(1))
+	GL_PAYLOAD(glGetActiveUniformsiv, GL_ARG(1))
+
+	GL_PAYLOAD(glUniform1fv, GL_ARG(1))
+	GL_PAYLOAD(glUniform2fv, GL_ARG(1) * 2)
+	GL_PAYLOAD(glUniform3fv, GL_ARG(1) * 3)
+	GL_PAYLOAD(glUniform4fv, GL_ARG(1) * 4)
+	GL_PAYLOAD(glUniform1iv, GL_ARG(1))
+	GL_PAYLOAD(glUniform2iv, GL_ARG(1) * 2)
+	GL_PAYLOAD(glUniform3iv, GL_ARG(1) * 3)
+	GL_PAYLOAD(glUniform4iv, GL_ARG(1) * 4)
+	GL_PAYLOAD(glUniform1uiv, GL_ARG(1))
+	GL_PAYLOAD(glUniform2uiv, GL_ARG(1) * 2)
+	GL_PAYLOAD(glUniform3uiv, GL_ARG(1) * 3)
+	GL_PAYLOAD(glUniform4uiv, GL_ARG(1) * 4)
+	GL_PAYLOAD(glUniformMatrix2fv, GL_ARG(1) * 4)
+	GL_PAYLOAD(glUniformMatrix3fv, GL_ARG(1) * 9)
+	GL_PAYLOAD(glUniformMatrix4fv, GL_ARG(1) * 16)
+	GL_PAYLOAD(glUniformMatrix2x3fv, GL_ARG(1) * 6)
+	GL_PAYLOAD(glUniformMatrix3x2fv, GL_ARG(1) * 6)
+	GL_PAYLOAD(glUniformMatrix2x4fv, GL_ARG(1) * 8)
+	GL_PAYLOAD(glUniformMatrix4x2fv, GL_ARG(1) * 8)
+	GL_PAYLOAD(glUniformMatrix3x4fv, GL_ARG(1) * 12)
+	GL_PAYLOAD(glUniformMatrix4x3fv, GL_ARG(1) * 12)
+
+	GL_PAYLOAD(glTexParameterfv, parameterCount(GL_ARG(1)))
+	GL_PAYLOAD(glTexParameteriv, parameterCount(GL_ARG(1)))
+	GL_PAYLOAD(glTexParameterIiv, parameterCount(GL_ARG(1)))
+	GL_PAYLOAD(glTexParameterIuiv, parameterCount(GL_ARG(1)))
+	GL_PAYLOAD(glSamplerParameterfv, parameterCount(GL_ARG(1)))
+	GL_PAYLOAD(glSamplerParameteriv, parameterCount(GL_ARG(1)))
+	GL_PAYLOAD(glSamplerParameterIiv, parameterCount(GL_ARG(1)))
+	GL_PAYLOAD(glSamplerParameterIuiv, parameterCount(GL_ARG(1)))
+	GL_PAYLOAD(glPointParameterfv, 1)
+	GL_PAYLOAD(glPointParameteriv, 1)
+	GL_PAYLOAD(glClearBufferfv, GL_COLOR == GL_ARG(0) ? 4 : 1)
+	GL_PAYLOAD(glClearBufferiv, GL_COLOR == GL_ARG(0) ? 4 : 1)
+	GL_PAYLOAD(glClearBufferuiv, GL_COLOR == GL_ARG(0) ? 4 : 1)
+
+	GL_PAYLOAD(glVertexAttrib1dv, 1)
+	GL_PAYLOAD(glVertexAttrib1fv, 1)
+	GL_PAYLOAD(glVertexAttrib1sv, 1)
+	GL_PAYLOAD(glVertexAttrib2dv, 2)
+	GL_PAYLOAD(glVertexAttrib2fv, 2)
+	GL_PAYLOAD(glVertexAttrib2sv, 2)
+	GL_PAYLOAD(glVertexAttrib3dv, 3)
+	GL_PAYLOAD(glVertexAttrib3fv, 3)
+	GL_PAYLOAD(glVertexAttrib3sv, 3)
+	GL_PAYLOAD(glVertexAttrib4Nbv, 4)
+	GL_PAYLOAD(glVertexAttrib4Niv, 4)
+	GL_PAYLOAD(glVertexAttrib4Nsv, 4)
+	GL_PAYLOAD(glVertexAttrib4Nubv, 4)
+	GL_PAYLOAD(glVertexAttrib4Nuiv, 4)
+	GL_PAYLOAD(glVertexAttrib4Nusv, 4)
+	GL_PAYLOAD(glVertexAttrib4bv, 4)
+	GL_PAYLOAD(glVertexAttrib4dv, 4)
+	GL_PAYLOAD(glVertexAttrib4fv, 4)
+	GL_PAYLOAD(glVertexAttrib4iv, 4)
+	GL_PAYLOAD(glVertexAttrib4sv, 4)
+	GL_PAYLOAD(glVertexAttrib4ubv, 4)
+	GL_PAYLOAD(glVertexAttrib4uiv, 4)
+	GL_PAYLOAD(glVertexAttrib4usv, 4)
+	GL_PAYLOAD(glVertexAttribI1iv, 1)
+	GL_PAYLOAD(glVertexAttribI2iv, 2)
+	GL_PAYLOAD(glVertexAttribI3iv, 3)
+	GL_PAYLOAD(glVertexAttribI4iv, 4)
+	GL_PAYLOAD(glVertexAttribI1uiv, 1)
+	GL_PAYLOAD(glVertexAttribI2uiv, 2)
+	GL_PAYLOAD(glVertexAttribI3uiv, 3)
+	GL_PAYLOAD(glVertexAttribI4uiv, 4)
+	GL_PAYLOAD(glVertexAttribI4bv, 4)
+	GL_PAYLOAD(glVertexAttribI4sv, 4)
+	GL_PAYLOAD(glVertexAttribI4ubv, 4)
+	GL_PAYLOAD(glVertexAttribI4usv, 4)
+
+	// packed (P) attributes: 1 GLuint holds all components
+	GL_PAYLOAD(glVertexAttribP1uiv, 1)
+	GL_PAYLOAD(glVertexAttribP2uiv, 1)
+	GL_PAYLOAD(glVertexAttribP3uiv, 1)
+	GL_PAYLOAD(glVertexAttribP4uiv, 1)
+	GL_PAYLOAD(glVertexP2uiv, 1)
+	GL_PAYLOAD(glVertexP3uiv, 1)
+	GL_PAYLOAD(glVertexP4uiv, 1)
+	GL_PAYLOAD(glTexCoordP1uiv, 1)
+	GL_PAYLOAD(glTexCoordP2uiv, 1)
+	GL_PAYLOAD(glTexCoordP3uiv, 1)
+	GL_PAYLOAD(glTexCoordP4uiv, 1)
+	GL_PAYLOAD(glMultiTexCoordP1uiv, 1)
+	GL_PAYLOAD(glMultiTexCoordP2uiv, 1)
+	GL_PAYLOAD(glMultiTexCoordP3uiv, 1)
+	GL_PAYLOAD(glMultiTexCoordP4uiv, 1)
+	GL_PAYLOAD(glNormalP3uiv, 1)
+	GL_PAYLOAD(glColorP3uiv, 1)
+	GL_PAYLOAD(glColorP4uiv, 1)
+	GL_PAYLOAD(glSecondaryColorP3uiv, 1)
+
+	GL_DATA(glTexImage1D, true, imageBytes(s_Unpack, GL_ARG(3), 1, 1, GL_ARG(5), GL_ARG(6), false))
+	GL_DATA(glTexImage2D, true, imageBytes(s_Unpack, GL_ARG(3), GL_ARG(4), 1, GL_ARG(6), GL_ARG(7), false))
+	GL_DATA(glTexImage3D, true, imageBytes(s_Unpack, GL_ARG(3), GL_ARG(4), GL_ARG(5), GL_ARG(7), GL_ARG(8), true))
+	GL_DATA(glTexSubImage1D, true, imageBytes(s_Unpack, GL_ARG(3), 1, 1, GL_ARG(4), GL_ARG(5), false))
+	GL_DATA(glTexSubImage2D, true, imageBytes(s_Unpack, GL_ARG(4), GL_ARG(5), 1, GL_ARG(6), GL_ARG(7), false))
+	GL_DATA(glTexSubImage3D, true, imageBytes(s_Unpack, GL_ARG(5), GL_ARG(6), GL_ARG(7), GL_ARG(8), GL_ARG(9), true))
+	GL_DATA(glCompressedTexImage1D, true, GL_ARG(5))
+	GL_DATA(glCompressedTexImage2D, true, GL_ARG(6))
+	GL_DATA(glCompressedTexImage3D, true, GL_ARG(7))
+	GL_DATA(glCompressedTexSubImage1D, true, GL_ARG(5))
+	GL_DATA(glCompressedTexSubImage2D, true, GL_ARG(7))
+	GL_DATA(glCompressedTexSubImage3D, true, GL_ARG(9))
+	GL_DATA(glBufferData, false, GL_ARG(1))
+	GL_DATA(glBufferSubData, false, GL_ARG(2))
+
+	GL_OUTPUT(glReadPixels, true, imageBytes(s_Pack, GL_ARG(2), GL_ARG(3), 1, GL_ARG(4), GL_ARG(5), false))
+	GL_OUTPUT(glGetTexImage, true, texImageBytes(GL_ARG(0), GL_ARG(1), GL_ARG(2), GL_ARG(3)))
+	GL_OUTPUT(glGetCompressedTexImage, true, compressedTexImageBytes(GL_ARG(0), GL_ARG(1)))
+	GL_OUTPUT(glGetBufferSubData, false, GL_ARG(2))
+
+	GL_TRIANGLES_DRAWN(glDrawArrays, triangleCount(GL_ARG(0), GL_ARG(2)))
+	GL_TRIANGLES_DRAWN(glDrawArraysInstanced, triangleCount(GL_ARG(0), GL_ARG(2)) * toSize(GL_ARG(3)))
+	GL_TRIANGLES_DRAWN(glDrawElements, triangleCount(GL_ARG(0), GL_ARG(1)))
+	GL_TRIANGLES_DRAWN(glDrawElementsBaseVertex, triangleCount(GL_ARG(0), GL_ARG(1)))
+	GL_TRIANGLES_DRAWN(glDrawElementsInstanced, triangleCount(GL_ARG(0), GL_ARG(1)) * toSize(GL_ARG(4)))
+	GL_TRIANGLES_DRAWN(glDrawElementsInstancedBaseVertex, triangleCount(GL_ARG(0), GL_ARG(1)) * toSize(GL_ARG(4)))
+	GL_TRIANGLES_DRAWN(glDrawRangeElements, triangleCount(GL_ARG(0), GL_ARG(3)))
+	GL_TRIANGLES_DRAWN(glDrawRangeElementsBaseVertex, triangleCount(GL_ARG(0), GL_ARG(3)))
+	GL_TRIANGLES_DRAWN(glMultiDrawArrays, multiTriangleCount(GL_ARG(0), GL_ARG(2), GL_ARG(3)))
+	GL_TRIANGLES_DRAWN(glMultiDrawElements, multiTriangleCount(GL_ARG(0), GL_ARG(1), GL_ARG(4)))
+	GL_TRIANGLES_DRAWN(glMultiDrawElementsBaseVertex, multiTriangleCount(GL_ARG(0), GL_ARG(1), GL_ARG(4)))
+
+#undef GL_TRIANGLES_DRAWN
+#undef GL_OUTPUT
+#undef GL_DATA
+#undef GL_PAYLOAD
+#undef GL_ARG
+
+
+
+	// the lengths array next to a string array (only glShaderSource has one)
+	template <GLFunction F>
+	struct StringLengths {
+		template <typename Tuple> static GLint const *get(Tuple const &) { return nullptr; }
+	};
+
+	template <>
+	struct StringLengths<GLFunction::glShaderSource> {
+		template <typename Tuple> static GLint const *get(Tuple const &args) { return std::get<3>(args); }
+	};
+
+
+
+	// argument encoding, picked by type (F for the sizes above)
+	template <GLFunction F>
+	struct ArgWriter {
+		template <typename Tuple, typename T>
+		static typename std::enable_if<std::is_arithmetic<T>::value>::type write(TraceWriter &writer, Tuple const &, T value) {
+			writer.value(value);
+		}
+
+		template <typename Tuple>
+		static void write(TraceWriter &writer, Tuple const &, GLsync sync) {
+			std::unordered_map<GLsync, uint32_t>::const_iterator const found = s_SyncIds.find(sync);
+			writer.value(s_SyncIds.end() == found ? uint32_t(0) : found->second);
+		}
+
+		template <typename Tuple>
+		static void write(TraceWriter &writer, Tuple const &, GLchar const *string) {
+			writer.string(string, nullptr == string ? 0 : std::strlen(string));
+		}
+
+		template <typename Tuple, typename T>
+		static typename std::enable_if<std::is_arithmetic<T>::value>::type write(TraceWriter &writer, Tuple const &args, T const *values) {
+			static_assert(Payload<F>::DEFINED, "a GL function reading a typed array needs a GL_PAYLOAD count");
+			writer.array(values, Payload<F>::count(args));
+		}
+
+		template <typename Tuple>
+		static void write(TraceWriter &writer, Tuple const &args, void const *data) {
+			if (nullptr == data) {
+				writer.value(POINTER_NULL);
+			}
+			else if (Data<F>::DEFINED && (!Data<F>::PIXELS || 0 == s_UnpackBuffer)) {
+				writer.value(POINTER_CLIENT);
+				writer.array(static_cast<uint8_t const *>(data), Data<F>::bytes(args));
+			}
+			else {
+				writer.value(POINTER_OFFSET);
+				writer.value(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(data)));
+			}
+		}
+
+		template <typename Tuple, typename T>
+		static void write(TraceWriter &writer, Tuple const &args, T *output) {
+			if (nullptr == output) {
+				writer.value(POINTER_NULL);
+			}
+			else if (Output<F>::PIXELS && 0 != s_PackBuffer) {
+				writer.value(POINTER_OFFSET);
+				writer.value(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(output)));
+			}
+			else {
+				writer.value(POINTER_CLIENT);
+				writer.value(static_cast<uint32_t>(Output<F>::bytes(args)));
+			}
+		}
+
+		// glShaderSource's optional lengths say how much of each string counts, everything else is NUL-terminated
+		template <typename Tuple>
+		static void write(TraceWriter &writer, Tuple const &args, GLchar const *const *strings) {
+			size_t const count = Payload<F>::count(args);
+			writer.value(nullptr == strings ? NULL_COUNT : static_cast<uint32_t>(count));
+			if (nullptr == strings) return;
+			GLint const *lengths = StringLengths<F>::get(args);
+			for (size_t i = 0; i < count; ++i) {
+				writer.string(strings[i], nullptr == strings[i] ? 0 : nullptr != lengths && 0 <= lengths[i] ? static_cast<size_t>(lengths[i]) : std::strlen(strings[i]));
+			}
+		}
+
+		// glMultiDrawElements*: offsets into the element buffer
+		template <typename Tuple>
+		static void write(TraceWriter &writer, Tuple const &args, void const *const *offsets) {
+			size_t const count = Payload<F>::count(args);
+			writer.value(nullptr == offsets ? NULL_COUNT : static_cast<uint32_t>(count));
+			for (size_t i = 0; nullptr != offsets && i < count; ++i) writer.value(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(offsets[i])));
+		}
+	};
+
+	template <typename T>
+	typename std::enable_if<std::is_arithmetic<T>::value>::type writeResult(TraceWriter &writer, T value) {
+		writer.value(value);
+	}
+
+	void writeResult(TraceWriter &writer, GLsync sync) {
+		uint32_t const id = ++s_NextSyncId;
+		s_SyncIds[sync] = id;
+		writer.value(id);
+	}
+
+	template <typename T>
+	void writeResult(TraceWriter &, T *) {} // glGetString(), glMapBuffer*(): nothing to compare
+
+	void writeResult(TraceWriter &, std::nullptr_t) {}
+
+
+
+	template <typename T>
+	struct Tag {};
+
+	// argument decoding, the exact mirror of ArgWriter
+	struct ArgReader {
+		template <typename T>
+		static typename std::enable_if<std::is_arithmetic<T>::value, T>::type read(TraceReader &reader, Tag<T>) {
+			return reader.value<T>();
+		}
+
+		static GLsync read(TraceReader &reader, Tag<GLsync>) {
+			uint32_t const id = reader.value<uint32_t>();
+			return id < reader.m_Syncs.size() ? reader.m_Syncs[id] : nullptr;
+		}
+
+		static GLchar const *read(TraceReader &reader, Tag<GLchar const *>) {
+			return reader.string();
+		}
+
+		template <typename T>
+		static typename std::enable_if<std::is_arithmetic<T>::value, T const *>::type read(TraceReader &reader, Tag<T const *>) {
+			return reader.array<T>();
+		}
+
+		static void const *read(TraceReader &reader, Tag<void const *>) {
+			uint8_t const kind = reader.value<uint8_t>();
+			if (POINTER_CLIENT == kind) return reader.array<uint8_t>();
+			if (POINTER_OFFSET == kind) return reinterpret_cast<void const *>(static_cast<uintptr_t>(reader.value<uint64_t>()));
+			return nullptr;
+		}
+
+		template <typename T>
+		static T *read(TraceReader &reader, Tag<T *>) {
+			uint8_t const kind = reader.value<uint8_t>();
+			if (POINTER_CLIENT == kind) return static_cast<T *>(reader.output(reader.value<uint32_t>()));
+			if (POINTER_OFFSET == kind) return reinterpret_cast<T *>(static_cast<uintptr_t>(reader.value<uint64_t>()));
+			return nullptr;
+		}
+
+		static GLchar const *const *read(TraceReader &reader, Tag<GLchar const *const *>) {
+			uint32_t const count = reader.value<uint32_t>();
+			if (NULL_COUNT == count) return nullptr;
+			reader.m_Strings.clear();
+			for (uint32_t i = 0; i < count && !reader.failed(); ++i) reader.m_Strings.push_back(reader.string());
+			return reader.m_Strings.data();
+		}
+
+		static void const *const *read(TraceReader &reader, Tag<void const *const *>) {
+			uint32_t const count = reader.value<uint32_t>();
+			if (NULL_COUNT == count) return nullptr;
+			reader.m_Offsets.clear();
+			for (uint32_t i = 0; i < count && !reader.failed(); ++i) reader.m_Offsets.push_back(reinterpret_cast<void const *>(static_cast<uintptr_t>(reader.value<uint64_t>())));
+			return reader.m_Offsets.data();
+		}
+	};
+
+	template <typename T>
+	typename std::enable_if<std::is_arithmetic<T>::value>::type checkResult(TraceReader &reader, T value, bool compare) {
+		T const recorded = reader.value<T>();
+		if (compare && recorded != value) ++reader.m_ResultMismatches;
+	}
+
+	void checkResult(TraceReader &reader, GLsync sync, bool) {
+		uint32_t const id = reader.value<uint32_t>();
+		if (reader.m_Syncs.size() <= id) reader.m_Syncs.resize(static_cast<size_t>(id) + 1, nullptr);
+		reader.m_Syncs[id] = sync;
+	}
+
+	template <typename T>
+	void checkResult(TraceReader &, T *, bool) {}
+
+	void checkResult(TraceReader &, std::nullptr_t, bool) {}
+
+
+
+	// per function extras around the generic record/replay: state the tracer tracks, and mapped buffer contents
+	// - record(): before the call, appends to the record (after the arguments)
+	// - after(): after the call, whether recording or not
+	// - replay() / replayed(): the same on the replay side
+	// - redundant(): FILTERED (state setting) functions only, true = drop the call (it'd set what's already set)
+	struct DefaultHook {
+		static bool const CHECK_RESULT = true;
+		static bool const FILTERED = false;
+		template <typename Tuple> static bool redundant(Tuple const &) { return false; }
+		template <typename Tuple> static void record(TraceWriter &, Tuple const &) {}
+		template <typename R, typename Tuple> static void after(R const &, Tuple const &) {}
+		template <typename Tuple> static void replay(TraceReader &, Tuple const &) {}
+		template <typename R, typename Tuple> static void replayed(TraceReader &, R const &, Tuple const &) {}
+	};
+
+	template <GLFunction F>
+	struct Hook : DefaultHook {};
+
+	void bindBuffer(GLenum target, GLuint buffer) {
+		if (GL_PIXEL_UNPACK_BUFFER == target) s_UnpackBuffer = buffer;
+		if (GL_PIXEL_PACK_BUFFER == target) s_PackBuffer = buffer;
+	}
+
+	template <>
+	struct Hook<GLFunction::glBindBuffer> : DefaultHook {
+		static bool const FILTERED = true;
+
+		template <typename Tuple>
+		static bool redundant(Tuple const &args) {
+			GLuint *const slot = bufferSlot(std::get<0>(args));
+			return nullptr != slot && !changes(*slot, std::get<1>(args));
+		}
+
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) { bindBuffer(std::get<0>(args), std::get<1>(args)); }
+	};
+
+	// the indexed binding calls bind the generic binding point too
+	template <>
+	struct Hook<GLFunction::glBindBufferBase> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) {
+			GLuint *const slot = bufferSlot(std::get<0>(args));
+			if (nullptr != slot) *slot = std::get<2>(args);
+			bindBuffer(std::get<0>(args), std::get<2>(args));
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glBindBufferRange> : Hook<GLFunction::glBindBufferBase> {};
+
+	template <>
+	struct Hook<GLFunction::glDeleteBuffers> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) {
+			for (GLsizei i = 0; nullptr != std::get<1>(args) && i < std::get<0>(args); ++i) {
+				GLuint const buffer = std::get<1>(args)[i];
+				if (s_UnpackBuffer == buffer) s_UnpackBuffer = 0;
+				if (s_PackBuffer == buffer) s_PackBuffer = 0;
+				forgetName(s_State.m_Buffers, BUFFER_TARGET_COUNT, buffer);
+				std::unordered_map<GLuint, size_t>::iterator const found = s_BufferSizes.find(buffer);
+				if (s_BufferSizes.end() == found) continue;
+				s_BufferBytes -= found->second;
+				s_BufferSizes.erase(found);
+			}
+		}
+	};
+
+	// the size is per buffer object, the name bound to the target is queried (glBufferData isn't a per draw call)
+	template <>
+	struct Hook<GLFunction::glBufferData> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) {
+			GLenum const binding = bufferBinding(std::get<0>(args));
+			GLint buffer = 0;
+			if (0 != binding) GL_DRIVER(glGetIntegerv)(binding, &buffer);
+			if (0 == buffer) return;
+			size_t &size = s_BufferSizes[static_cast<GLuint>(buffer)];
+			s_BufferBytes = s_BufferBytes - size + toSize(std::get<1>(args));
+			size = toSize(std::get<1>(args));
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glUseProgram> : DefaultHook {
+		static bool const FILTERED = true;
+		template <typename Tuple> static bool redundant(Tuple const &args) { return !changes(s_State.m_Program, std::get<0>(args)); }
+	};
+
+	template <>
+	struct Hook<GLFunction::glBindVertexArray> : DefaultHook {
+		static bool const FILTERED = true;
+		template <typename Tuple> static bool redundant(Tuple const &args) { return !changes(s_State.m_VertexArray, std::get<0>(args)); }
+	};
+
+	template <>
+	struct Hook<GLFunction::glDeleteVertexArrays> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) {
+			for (GLsizei i = 0; nullptr != std::get<1>(args) && i < std::get<0>(args); ++i) forgetName(&s_State.m_VertexArray, 1, std::get<1>(args)[i]);
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glActiveTexture> : DefaultHook {
+		static bool const FILTERED = true;
+		template <typename Tuple> static bool redundant(Tuple const &args) { return !changes(s_State.m_ActiveUnit, std::get<0>(args) - GL_TEXTURE0); }
+	};
+
+	template <>
+	struct Hook<GLFunction::glBindTexture> : DefaultHook {
+		static bool const FILTERED = true;
+
+		template <typename Tuple>
+		static bool redundant(Tuple const &args) {
+			GLuint *const slot = textureSlot(std::get<0>(args));
+			return nullptr != slot && !changes(*slot, std::get<1>(args));
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glDeleteTextures> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) {
+			for (GLsizei i = 0; nullptr != std::get<1>(args) && i < std::get<0>(args); ++i) {
+				forgetName(&s_State.m_Textures[0][0], TEXTURE_UNITS * TEXTURE_TARGET_COUNT, std::get<1>(args)[i]);
+			}
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glBindFramebuffer> : DefaultHook {
+		static bool const FILTERED = true;
+		template <typename Tuple> static bool redundant(Tuple const &args) { return redundantFramebuffer(std::get<0>(args), std::get<1>(args)); }
+	};
+
+	template <>
+	struct Hook<GLFunction::glDeleteFramebuffers> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) {
+			for (GLsizei i = 0; nullptr != std::get<1>(args) && i < std::get<0>(args); ++i) {
+				forgetName(&s_State.m_DrawFramebuffer, 1, std::get<1>(args)[i]);
+				forgetName(&s_State.m_ReadFramebuffer, 1, std::get<1>(args)[i]);
+			}
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glEnable> : DefaultHook {
+		static bool const FILTERED = true;
+
+		template <typename Tuple>
+		static bool redundant(Tuple const &args) {
+			GLuint *const slot = capabilitySlot(std::get<0>(args));
+			return nullptr != slot && !changes(*slot, GL_TRUE);
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glDisable> : DefaultHook {
+		static bool const FILTERED = true;
+
+		template <typename Tuple>
+		static bool redundant(Tuple const &args) {
+			GLuint *const slot = capabilitySlot(std::get<0>(args));
+			return nullptr != slot && !changes(*slot, GL_FALSE);
+		}
+	};
+
+	// 1 draw buffer's blend state: the capability as a whole isn't known anymore
+	template <>
+	struct Hook<GLFunction::glEnablei> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) {
+			GLuint *const slot = capabilitySlot(std::get<0>(args));
+			if (nullptr != slot) *slot = UNKNOWN;
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glDisablei> : Hook<GLFunction::glEnablei> {};
+
+	// the core profile only takes GL_FRONT_AND_BACK
+	template <>
+	struct Hook<GLFunction::glPolygonMode> : DefaultHook {
+		static bool const FILTERED = true;
+
+		template <typename Tuple>
+		static bool redundant(Tuple const &args) {
+			if (GL_FRONT_AND_BACK == std::get<0>(args)) return !changes(s_State.m_PolygonMode, std::get<1>(args));
+			s_State.m_PolygonMode = UNKNOWN;
+			return false;
+		}
+	};
+
+	void setPixelStore(GLenum pname, GLint value) {
+		switch (pname) {
+		case GL_UNPACK_ALIGNMENT: s_Unpack.m_Alignment = value; break;
+		case GL_UNPACK_ROW_LENGTH: s_Unpack.m_RowLength = value; break;
+		case GL_UNPACK_IMAGE_HEIGHT: s_Unpack.m_ImageHeight = value; break;
+		case GL_UNPACK_SKIP_PIXELS: s_Unpack.m_SkipPixels = value; break;
+		case GL_UNPACK_SKIP_ROWS: s_Unpack.m_SkipRows = value; break;
+		case GL_UNPACK_SKIP_IMAGES: s_Unpack.m_SkipImages = value; break;
+		case GL_PACK_ALIGNMENT: s_Pack.m_Alignment = value; break;
+		case GL_PACK_ROW_LENGTH: s_Pack.m_RowLength = value; break;
+		case GL_PACK_IMAGE_HEIGHT: s_Pack.m_ImageHeight = value; break;
+		case GL_PACK_SKIP_PIXELS: s_Pack.m_SkipPixels = value; break;
+		case GL_PACK_SKIP_ROWS: s_Pack.m_SkipRows = value; break;
+		case GL_PACK_SKIP_IMAGES: s_Pack.m_SkipImages = value; break;
+		default: break;
+		}
+	}
+
+	template <>
+	struct Hook<GLFunction::glPixelStorei> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) { setPixelStore(std::get<0>(args), std::get<1>(args)); }
+	};
+
+	template <>
+	struct Hook<GLFunction::glPixelStoref> : DefaultHook {
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) { setPixelStore(std::get<0>(args), static_cast<GLint>(std::get<1>(args))); }
+	};
+
+	void addMapping(GLenum target, void *pointer, size_t length, bool capture) {
+		if (nullptr == pointer) return;
+		removeMapping(target);
+		Mapping mapping;
+		mapping.m_Target = target;
+		mapping.m_Pointer = static_cast<uint8_t *>(pointer);
+		mapping.m_Length = length;
+		mapping.m_Capture = capture;
+		s_Mappings.push_back(mapping);
+	}
+
+	void replayMapping(TraceReader &reader, GLenum target, void *pointer) {
+		reader.m_Mappings.erase(std::remove_if(reader.m_Mappings.begin(), reader.m_Mappings.end(),
+			[target](std::pair<GLenum, uint8_t *> const &mapping) { return target == mapping.first; }), reader.m_Mappings.end());
+		if (nullptr != pointer) reader.m_Mappings.emplace_back(target, static_cast<uint8_t *>(pointer));
+	}
+
+	template <>
+	struct Hook<GLFunction::glMapBuffer> : DefaultHook {
+		template <typename Tuple>
+		static void after(void *pointer, Tuple const &args) {
+			GLint size = 0;
+			GL_DRIVER(glGetBufferParameteriv)(std::get<0>(args), GL_BUFFER_SIZE, &size);
+			addMapping(std::get<0>(args), pointer, toSize(size), GL_READ_ONLY != std::get<1>(args));
+		}
+
+		template <typename Tuple>
+		static void replayed(TraceReader &reader, void *pointer, Tuple const &args) { replayMapping(reader, std::get<0>(args), pointer); }
+	};
+
+	template <>
+	struct Hook<GLFunction::glMapBufferRange> : DefaultHook {
+		template <typename Tuple>
+		static void after(void *pointer, Tuple const &args) {
+			GLbitfield const access = std::get<3>(args);
+			addMapping(std::get<0>(args), pointer, toSize(std::get<2>(args)), 0 != (access & GL_MAP_WRITE_BIT) && 0 == (access & GL_MAP_FLUSH_EXPLICIT_BIT));
+		}
+
+		template <typename Tuple>
+		static void replayed(TraceReader &reader, void *pointer, Tuple const &args) { replayMapping(reader, std::get<0>(args), pointer); }
+	};
+
+	// explicitly flushed ranges are recorded at the flush, the replay copies them in before its own flush
+	template <>
+	struct Hook<GLFunction::glFlushMappedBufferRange> : DefaultHook {
+		template <typename Tuple>
+		static void record(TraceWriter &writer, Tuple const &args) {
+			Mapping const *mapping = findMapping(std::get<0>(args));
+			size_t const offset = toSize(std::get<1>(args));
+			bool const valid = nullptr != mapping && offset <= mapping->m_Length;
+			writer.array(valid ? mapping->m_Pointer + offset : nullptr, valid ? std::min(toSize(std::get<2>(args)), mapping->m_Length - offset) : 0);
+		}
+
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) { s_FrameUploadBytes += toSize(std::get<2>(args)); }
+
+		template <typename Tuple>
+		static void replay(TraceReader &reader, Tuple const &args) {
+			size_t count = 0;
+			uint8_t const *bytes = reader.array<uint8_t>(&count);
+			uint8_t *mapping = reader.mapping(std::get<0>(args));
+			if (nullptr != bytes && nullptr != mapping) std::memcpy(mapping + std::get<1>(args), bytes, count);
+		}
+	};
+
+	template <>
+	struct Hook<GLFunction::glUnmapBuffer> : DefaultHook {
+		template <typename Tuple>
+		static void record(TraceWriter &writer, Tuple const &args) {
+			Mapping const *mapping = findMapping(std::get<0>(args));
+			bool const capture = nullptr != mapping && mapping->m_Capture;
+			writer.array(capture ? mapping->m_Pointer : nullptr, capture ? mapping->m_Length : 0);
+		}
+
+		template <typename R, typename Tuple>
+		static void after(R const &, Tuple const &args) {
+			Mapping const *mapping = findMapping(std::get<0>(args));
+			if (nullptr != mapping && mapping->m_Capture) s_FrameUploadBytes += mapping->m_Length;
+			removeMapping(std::get<0>(args));
+		}
+
+		template <typename Tuple>
+		static void replay(TraceReader &reader, Tuple const &args) {
+			size_t count = 0;
+			uint8_t const *bytes = reader.array<uint8_t>(&count);
+			uint8_t *mapping = reader.mapping(std::get<0>(args));
+			if (nullptr != bytes && nullptr != mapping) std::memcpy(mapping, bytes, count);
+		}
+
+		template <typename R, typename Tuple>
+		static void replayed(TraceReader &reader, R const &, Tuple const &args) { replayMapping(reader, std::get<0>(args), nullptr); }
+	};
+
+	// whether the fence had signaled yet is timing, not a divergence
+	template <>
+	struct Hook<GLFunction::glClientWaitSync> : DefaultHook {
+		static bool const CHECK_RESULT = false;
+	};
+
+
+
+	// a non-null void const * argument (the data of an upload)
+	inline bool isClientData(void const *data) { return nullptr != data; }
+	template <typename T> bool isClientData(T const &) { return false; }
+
+	template <typename... Args>
+	bool hasClientData(Args const &... args) {
+		bool any = false;
+		int const expand[] = { 0, (any = any || isClientData(args), 0)... };
+		(void)expand;
+		return any;
+	}
+
+	template <GLFunction F, typename R, typename... Args>
+	R APIENTRY Entry<F, R (APIENTRYP)(Args...)>::trace(Args... args) {
+		if (!t_TraceThread) return s_Driver(args...);
+
+		size_t const index = static_cast<size_t>(F);
+		std::tuple<Args &...> const arguments(args...);
+		if (Hook<F>::FILTERED) {
+			if (s_StateFilter && Hook<F>::redundant(arguments)) {
+				++s_FrameFiltered;
+				return Result<R>().get();
+			}
+			++s_FrameStateChanges;
+		}
+		size_t recordAt = 0;
+		if (s_Recording) {
+			recordAt = s_Writer.beginRecord(static_cast<uint16_t>(index));
+			int const expand[] = { 0, (ArgWriter<F>::write(s_Writer, arguments, args), 0)... };
+			(void)expand;
+			Hook<F>::record(s_Writer, arguments);
+		}
+
+		Result<R> result;
+		Clock::time_point const start = Clock::now();
+		result.call(s_Driver, arguments, std::index_sequence_for<Args...>());
+		Clock::rep const ticks = (Clock::now() - start).count();
+
+		++s_Functions[index].m_Calls;
+		s_Functions[index].m_Ticks += ticks;
+		++s_Frame.m_Calls;
+		s_Frame.m_Ticks += ticks;
+		if (s_IsDraw[index]) ++s_FrameDraws;
+		s_FrameTriangles += Triangles<F>::count(arguments);
+		if (Data<F>::DEFINED && ((Data<F>::PIXELS && 0 != s_UnpackBuffer) || hasClientData(args...))) s_FrameUploadBytes += Data<F>::bytes(arguments);
+
+		Hook<F>::after(result.m_Value, arguments);
+		if (s_Recording) {
+			writeResult(s_Writer, result.m_Value);
+			s_Writer.endRecord(recordAt);
+		}
+		return result.get();
+	}
+
+	template <typename Tuple, size_t... I>
+	void readArguments(TraceReader &reader, Tuple &arguments, std::index_sequence<I...>) {
+		int const expand[] = { 0, (std::get<I>(arguments) = ArgReader::read(reader, Tag<typename std::tuple_element<I, Tuple>::type>()), 0)... };
+		(void)expand;
+	}
+
+	template <GLFunction F, typename R, typename... Args>
+	Clock::rep Entry<F, R (APIENTRYP)(Args...)>::replay(TraceReader &reader) {
+		std::tuple<Args...> arguments;
+		reader.beginCall();
+		readArguments(reader, arguments, std::index_sequence_for<Args...>());
+		Hook<F>::replay(reader, arguments);
+		if (reader.failed()) return 0;
+
+		Result<R> result;
+		Clock::time_point const start = Clock::now();
+		result.call(s_Driver, arguments, std::index_sequence_for<Args...>());
+		Clock::rep const ticks = (Clock::now() - start).count();
+
+		checkResult(reader, result.m_Value, Hook<F>::CHECK_RESULT);
+		Hook<F>::replayed(reader, result.m_Value, arguments);
+		return ticks;
+	}
+
+
+
+	template <GLFunction F, typename Proc>
+	void installFunction(Proc &pointer) {
+		Entry<F, Proc>::s_Driver = pointer;
+		if (nullptr != pointer) pointer = &Entry<F, Proc>::trace;
+	}
+
+	template <GLFunction F, typename Proc>
+	void uninstallFunction(Proc &pointer) {
+		if (nullptr != pointer) pointer = Entry<F, Proc>::s_Driver;
+	}
+
+	using ReplayFn = Clock::rep (*)(TraceReader &);
+
+	// nullptr = the current context didn't load it
+	template <GLFunction F, typename Proc>
+	ReplayFn replayFunction(Proc pointer) {
+		Entry<F, Proc>::s_Driver = pointer;
+		return nullptr == pointer ? nullptr : &Entry<F, Proc>::replay;
+	}
+
+	bool readHeader(uint8_t const *data, size_t size, TraceHeader &header) {
+		if (size < sizeof(TraceHeader)) return false;
+		std::memcpy(&header, data, sizeof(TraceHeader));
+		return TRACE_MAGIC == header.m_Magic && TRACE_VERSION == header.m_Version && FUNCTION_COUNT == header.m_FunctionCount;
+	}
+}
+
+
+
+bool installGLTrace() {
+	if (s_Installed) return false;
+#define GL_FUNCTION(name) installFunction<GLFunction::name>(glad_##name);
+#include "gl_trace_functions.inl"
+#undef GL_FUNCTION
+	for (size_t i = 0; i < FUNCTION_COUNT; ++i) {
+		s_IsDraw[i] = 0 == std::strncmp(FUNCTION_NAMES[i], "glDraw", 6) || 0 == std::strncmp(FUNCTION_NAMES[i], "glMultiDraw", 11);
+	}
+
+	// the state tracked from here on starts as whatever the app already set
+	s_Unpack = PixelStore();
+	s_Pack = PixelStore();
+	GLint value = 0;
+	GL_DRIVER(glGetIntegerv)(GL_PIXEL_UNPACK_BUFFER_BINDING, &value);
+	s_UnpackBuffer = static_cast<GLuint>(value);
+	GL_DRIVER(glGetIntegerv)(GL_PIXEL_PACK_BUFFER_BINDING, &value);
+	s_PackBuffer = static_cast<GLuint>(value);
+	GLenum const PIXEL_STORE[] = { GL_UNPACK_ALIGNMENT, GL_UNPACK_ROW_LENGTH, GL_UNPACK_IMAGE_HEIGHT, GL_UNPACK_SKIP_PIXELS, GL_UNPACK_SKIP_ROWS, GL_UNPACK_SKIP_IMAGES,
+		GL_PACK_ALIGNMENT, GL_PACK_ROW_LENGTH, GL_PACK_IMAGE_HEIGHT, GL_PACK_SKIP_PIXELS, GL_PACK_SKIP_ROWS, GL_PACK_SKIP_IMAGES };
+	for (GLenum const pname : PIXEL_STORE) {
+		GL_DRIVER(glGetIntegerv)(pname, &value);
+		setPixelStore(pname, value);
+	}
+	s_Mappings.clear();
+	forgetState();
+	s_BufferSizes.clear();
+	s_BufferBytes = 0;
+
+	resetGLTraceStats();
+	t_TraceThread = true;
+	s_Installed = true;
+	return true;
+}
+
+void uninstallGLTrace() {
+	if (!s_Installed) return;
+	stopGLTraceRecording();
+#define GL_FUNCTION(name) uninstallFunction<GLFunction::name>(glad_##name);
+#include "gl_trace_functions.inl"
+#undef GL_FUNCTION
+	t_TraceThread = false;
+	s_Installed = false;
+}
+
+bool isGLTraceInstalled() {
+	return s_Installed;
+}
+
+void setGLStateFilter(bool enabled) {
+	if (enabled && !s_StateFilter) forgetState(); // missed what was set while it was off
+	s_StateFilter = enabled;
+}
+
+bool isGLStateFilterEnabled() {
+	return s_StateFilter;
+}
+
+bool startGLTraceRecording(std::string const &path) {
+	if (!s_Installed) return false;
+	stopGLTraceRecording();
+	if (!s_Writer.open(path)) return false;
+
+	TraceHeader header;
+	GLint viewport[4] = {};
+	GL_DRIVER(glGetIntegerv)(GL_VIEWPORT, viewport);
+	header.m_Width = viewport[2];
+	header.m_Height = viewport[3];
+	s_Writer.value(header);
+	s_SyncIds.clear();
+	s_NextSyncId = 0;
+	forgetState(); // the replay starts from a fresh context, the first bind of everything has to be in the trace
+	s_Recording = true;
+	return true;
+}
+
+void stopGLTraceRecording() {
+	if (!s_Recording) return;
+	s_Writer.close();
+	s_Recording = false;
+}
+
+void endGLTraceFrame() {
+	if (!s_Installed) return;
+	s_LastFrame.m_Calls = s_Frame.m_Calls;
+	s_LastFrame.m_DrawCalls = s_FrameDraws;
+	s_LastFrame.m_DriverMs = ticksToMs(s_Frame.m_Ticks);
+	s_LastFrame.m_Triangles = s_FrameTriangles;
+	s_LastFrame.m_StateChanges = s_FrameStateChanges;
+	s_LastFrame.m_StateChangesFiltered = s_FrameFiltered;
+	s_LastFrame.m_UploadBytes = s_FrameUploadBytes;
+	s_LastFrame.m_BufferBytes = s_BufferBytes;
+	s_Frame = FunctionCounters();
+	s_FrameDraws = 0;
+	s_FrameTriangles = 0;
+	s_FrameStateChanges = 0;
+	s_FrameFiltered = 0;
+	s_FrameUploadBytes = 0;
+	if (s_Recording) {
+		s_Writer.value(FRAME_MARKER);
+		s_Writer.flush();
+	}
+}
+
+GLTraceFrameStats getGLTraceLastFrame() {
+	return s_LastFrame;
+}
+
+std::vector<GLTraceFunctionStats> getGLTraceFunctionStats() {
+	std::vector<GLTraceFunctionStats> stats;
+	for (size_t i = 0; i < FUNCTION_COUNT; ++i) {
+		if (0 == s_Functions[i].m_Calls) continue;
+		GLTraceFunctionStats function;
+		function.m_Name = FUNCTION_NAMES[i];
+		function.m_Calls = s_Functions[i].m_Calls;
+		function.m_DriverMs = ticksToMs(s_Functions[i].m_Ticks);
+		stats.push_back(function);
+	}
+	std::sort(stats.begin(), stats.end(), [](GLTraceFunctionStats const &a, GLTraceFunctionStats const &b) { return a.m_DriverMs > b.m_DriverMs; });
+	return stats;
+}
+
+void printGLTraceReport(size_t top) {
+	std::vector<GLTraceFunctionStats> const stats = getGLTraceFunctionStats();
+	double totalMs = 0.0;
+	uint64_t totalCalls = 0;
+	for (GLTraceFunctionStats const &function : stats) {
+		totalMs += function.m_DriverMs;
+		totalCalls += function.m_Calls;
+	}
+	std::printf("GL calls: %llu, driver time: %.2fms, last frame: %llu calls, %llu draws, %.3fms\n", static_cast<unsigned long long>(totalCalls), totalMs,
+		static_cast<unsigned long long>(s_LastFrame.m_Calls), static_cast<unsigned long long>(s_LastFrame.m_DrawCalls), s_LastFrame.m_DriverMs);
+	std::printf("%-32s %12s %12s %10s %8s\n", "function", "calls", "driver ms", "us/call", "share");
+	for (size_t i = 0; i < stats.size() && i < top; ++i) {
+		GLTraceFunctionStats const &function = stats[i];
+		std::printf("%-32s %12llu %12.3f %10.3f %7.1f%%\n", function.m_Name, static_cast<unsigned long long>(function.m_Calls), function.m_DriverMs,
+			function.m_DriverMs * 1e3 / static_cast<double>(function.m_Calls), 0.0 < totalMs ? function.m_DriverMs * 100.0 / totalMs : 0.0);
+	}
+}
+
+void resetGLTraceStats() {
+	for (FunctionCounters &counters : s_Functions) counters = FunctionCounters();
+	s_Frame = FunctionCounters();
+	s_FrameDraws = 0;
+	s_FrameTriangles = 0;
+	s_FrameStateChanges = 0;
+	s_FrameFiltered = 0;
+	s_FrameUploadBytes = 0;
+	s_LastFrame = GLTraceFrameStats();
+}
+
+
+
+bool replayGLTrace(std::string const &path, GLReplayStats &stats) {
+	stats = GLReplayStats();
+	if (s_Installed) return false; // the replayer needs the driver's pointers in glad
+	MappedFile file;
+	TraceHeader header;
+	if (!file.open(path) || !readHeader(file.data(), file.size(), header)) return false;
+
+	ReplayFn replayers[FUNCTION_COUNT] = {};
+	size_t index = 0;
+#define GL_FUNCTION(name) replayers[index++] = replayFunction<GLFunction::name>(glad_##name);
+#include "gl_trace_functions.inl"
+#undef GL_FUNCTION
+
+	TraceReader reader(file.data(), file.size());
+	reader.seek(sizeof(TraceHeader));
+	Clock::rep driverTicks = 0;
+	Clock::time_point const start = Clock::now();
+	Clock::time_point frameStart = start;
+	bool complete = true;
+	while (!reader.atEnd()) {
+		uint16_t const id = reader.value<uint16_t>();
+		if (FRAME_MARKER == id) {
+			glFlush(); // keeps the command queue from growing without a swap
+			Clock::time_point const now = Clock::now();
+			stats.m_FrameMs.push_back(ticksToMs((now - frameStart).count()));
+			frameStart = now;
+			++stats.m_Frames;
+			continue;
+		}
+		uint32_t const size = reader.value<uint32_t>();
+		size_t const end = reader.position() + size;
+		if (reader.failed() || FUNCTION_COUNT <= id || file.size() < end) {
+			complete = false;
+			break;
+		}
+		if (nullptr == replayers[id]) {
+			++stats.m_Skipped;
+			reader.seek(end);
+			continue;
+		}
+		driverTicks += replayers[id](reader);
+		if (reader.failed() || end != reader.position()) {
+			complete = false;
+			break;
+		}
+		++stats.m_Calls;
+	}
+	glFinish();
+
+	stats.m_TotalMs = ticksToMs((Clock::now() - start).count());
+	stats.m_DriverMs = ticksToMs(driverTicks);
+	stats.m_ResultMismatches = reader.m_ResultMismatches;
+	return complete;
+}
+
+int glTraceReplayMain(int argc, char const *argv[]) {
+	std::string const path = 1 < argc ? argv[1] : "gl_trace.bin";
+	TraceHeader header;
+	{
+		MappedFile file;
+		if (!file.open(path) || !readHeader(file.data(), file.size(), header)) {
+			std::printf("%s: not a trace (or one of another version / function list)\n", path.c_str());
+			return -1;
+		}
+	}
+
+	if (!glfwInit()) return -1;
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow *window = glfwCreateWindow(std::max(header.m_Width, 1), std::max(header.m_Height, 1), "trace replay", NULL, NULL);
+	if (NULL == window) {
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+		glfwTerminate();
+		return -1;
+	}
+
+	GLReplayStats stats;
+	bool const complete = replayGLTrace(path, stats);
+	glfwDestroyWindow(window);
+	glfwTerminate();
+
+	std::vector<double> frameMs = stats.m_FrameMs;
+	std::sort(frameMs.begin(), frameMs.end());
+	double const medianMs = frameMs.empty() ? 0.0 : frameMs[frameMs.size() / 2];
+	double const worstMs = frameMs.empty() ? 0.0 : frameMs.back();
+	std::printf("%s: %llu frames, %llu calls (%llu skipped), %llu results differ%s\n", path.c_str(), static_cast<unsigned long long>(stats.m_Frames),
+		static_cast<unsigned long long>(stats.m_Calls), static_cast<unsigned long long>(stats.m_Skipped), static_cast<unsigned long long>(stats.m_ResultMismatches),
+		complete ? "" : ", CUT SHORT (truncated or corrupt)");
+	std::printf("total %.2fms, in the driver %.2fms, frame median %.3fms, worst %.3fms\n", stats.m_TotalMs, stats.m_DriverMs, medianMs, worstMs);
+	return complete ? 0 : -1;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// instrumented GL loader: every glad entry point wrapped to count, time and optionally record the calls
+// - installGLTrace() after gladLoadGL(), swaps each glad_gl* pointer for a wrapper (the list is gl_trace_functions.inl),
+//   uninstallGLTrace() puts the driver's back, nothing is wrapped or slower until then
+// - only the installing thread is traced, a shared-context thread (e.g. the texture upload thread) goes straight to the driver
+// - per function and per frame (endGLTraceFrame()): calls, draw calls and the CPU time spent inside the driver, per frame also
+//   triangles, upload bytes, state changes and the buffer memory in use (what the perf HUD shows)
+// - redundant state filter (off unless setGLStateFilter(true)): a bind / glEnable / glDisable / glPolygonMode that sets what the
+//   tracer last passed on for that state never reaches the driver (counted), the cache starts out unknown at install, at every
+//   recording start and whenever the filter is turned on
+// - recording: a compact binary trace of the call stream (function id + arguments + the client memory they point at:
+//   uploads, uniforms, mapped buffer writes, shader sources), buffered and written once per frame
+// - replayGLTrace() plays a trace back on the current context without the app, glTraceReplayMain() does it headless, so
+//   driver cost can be benchmarked (and compared across drivers/settings) in isolation
+// NOTE: object names aren't remapped, the same driver hands a fresh context the same names in the same order,
+//       replay counts every integer result that differs from the recorded one (a non-zero count = the replay diverged)
+
+
+
+struct GLTraceFrameStats {
+	uint64_t m_Calls = 0;
+	uint64_t m_DrawCalls = 0; // glDraw* + glMultiDraw*
+	double m_DriverMs = 0.0; // CPU time inside the GL functions
+	uint64_t m_Triangles = 0; // instances included, lines and points don't count
+	uint64_t m_StateChanges = 0; // filterable calls that reached the driver
+	uint64_t m_StateChangesFiltered = 0; // redundant ones dropped by the state filter
+	uint64_t m_UploadBytes = 0; // buffer and texture uploads from client memory or a pixel unpack buffer, mapped buffer writes
+	uint64_t m_BufferBytes = 0; // in use at the end of the frame, sums glBufferData sizes (of buffers sized after the install)
+};
+
+struct GLTraceFunctionStats {
+	char const *m_Name = nullptr;
+	uint64_t m_Calls = 0;
+	double m_DriverMs = 0.0;
+};
+
+// GL thread, after gladLoadGL() / gladLoadGLLoader(), false = already installed
+bool installGLTrace();
+void uninstallGLTrace(); // also stops recording
+bool isGLTraceInstalled();
+
+// off by default = every call goes to the driver, on = redundant state changes are dropped (the HUD shows how many)
+void setGLStateFilter(bool enabled);
+bool isGLStateFilterEnabled();
+
+// false = not installed or the file can't be created, a running recording is stopped first
+// start it before the app creates its GL objects: the replay starts from a fresh context, anything made earlier is missing there
+bool startGLTraceRecording(std::string const &path);
+void stopGLTraceRecording();
+
+// once per frame (no-op when not installed): closes the frame's stats and writes a frame marker when recording
+void endGLTraceFrame();
+GLTraceFrameStats getGLTraceLastFrame();
+
+// since install / the last reset, only functions that were called, by driver time (most first)
+std::vector<GLTraceFunctionStats> getGLTraceFunctionStats();
+void printGLTraceReport(size_t top = 20);
+void resetGLTraceStats();
+
+
+
+struct GLReplayStats {
+	uint64_t m_Frames = 0;
+	uint64_t m_Calls = 0;
+	uint64_t m_Skipped = 0; // functions the current context didn't load
+	uint64_t m_ResultMismatches = 0;
+	double m_TotalMs = 0.0; // decoding included
+	double m_DriverMs = 0.0;
+	std::vector<double> m_FrameMs;
+};
+
+// GL thread with a context like the recording one (and the tracer not installed), false = not a trace or it's cut short
+bool replayGLTrace(std::string const &path, GLReplayStats &stats);
+
+// hidden window (the recorded viewport's size) + replayGLTrace(), argv[1] = trace path (default gl_trace.bin), prints the frame times
+int glTraceReplayMain(int argc, char const *argv[]);
@@ -0,0 +1,313 @@
+// GLM's simd layer (glm/simd/matrix.h) and its SIMD code paths for the aligned_* types only exist when GLM may use intrinsics,
+// GLM_FORCE_INTRINSICS is a project-wide preprocessor definition for that
+// add GLM_FORCE_AVX2 (+ /arch:AVX2) or GLM_FORCE_SSE42 etc. to the PROJECT's preprocessor definitions to compare instruction
+// sets, never to this file alone (GLM's inline functions would differ between files = ODR violation)
+
+#include "affine_transform.h"
+#include "benchmarks.h"
+#include "cpu_features.h"
+
+#include <glm/vec2.hpp> // glm::vec2
+#include <glm/vec3.hpp> // glm::vec3
+#include <glm/vec4.hpp> // glm::vec4
+#include <glm/mat4x4.hpp> // glm::mat4
+#include <glm/matrix.hpp> // glm::inverse
+#include <glm/gtc/matrix_transform.hpp> // glm::translate, glm::rotate, glm::scale, glm::perspective
+#include <glm/gtc/quaternion.hpp> // glm::quat, glm::slerp, glm::angleAxis
+#include <glm/gtc/type_ptr.hpp> // glm::value_ptr
+#include <glm/simd/matrix.h> // glm_mat4_mul, glm_mat4_inverse
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+#include <glm/gtc/type_aligned.hpp> // glm::aligned_mat4, glm::aligned_vec3
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+
+
+// ns per call of the GLM operations behind camera() and friends, in every flavour this build supports:
+// - scalar:  packed glm::mat4 / glm::quat (what the demos use)
+// - simd:    GLM's raw simd layer on glm_vec4[4] (only has mul and inverse, the rest is scalar anyway)
+// - aligned: glm::aligned_mat4 (SIMD code paths when GLM_CONFIG_SIMD is enabled)
+// - affine:  AffineTransform (affine_transform.h)
+// output is CSV on stdout (1 header line), rows from different compilers/flags can be concatenated as is
+// max_abs_error is against the scalar variant of the same operation
+
+
+
+namespace {
+	size_t const BENCH_BATCH = 256; // inputs cycled through per pass, small enough to stay in L1
+
+	glm::vec3 g_Translations[BENCH_BATCH];
+	glm::vec3 g_Axes[BENCH_BATCH];
+	float g_Angles[BENCH_BATCH];
+	glm::vec2 g_CameraRotations[BENCH_BATCH];
+	glm::mat4 g_A[BENCH_BATCH];
+	glm::mat4 g_B[BENCH_BATCH];
+	glm::quat g_Q0[BENCH_BATCH];
+	glm::quat g_Q1[BENCH_BATCH];
+
+	glm::mat4 g_Reference[BENCH_BATCH]; // scalar results of the current operation
+	glm::mat4 g_Result[BENCH_BATCH]; // other variant's results, converted back to glm::mat4
+	glm::mat4 g_Out[BENCH_BATCH];
+	glm::quat g_OutQuat[BENCH_BATCH];
+	glm_vec4 g_SimdA[BENCH_BATCH][4];
+	glm_vec4 g_SimdB[BENCH_BATCH][4];
+	glm_vec4 g_SimdOut[BENCH_BATCH][4];
+	AffineTransform g_AffineA[BENCH_BATCH];
+	AffineTransform g_AffineB[BENCH_BATCH];
+	AffineTransform g_AffineOut[BENCH_BATCH];
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	glm::aligned_mat4 g_AlignedA[BENCH_BATCH];
+	glm::aligned_mat4 g_AlignedB[BENCH_BATCH];
+	glm::aligned_mat4 g_AlignedOut[BENCH_BATCH];
+	glm::aligned_vec3 g_AlignedVectors[BENCH_BATCH];
+#endif
+
+	char const *compilerName() {
+		static char name[64];
+#if defined(__clang__)
+		std::snprintf(name, sizeof(name), "clang %d.%d.%d", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(_MSC_VER)
+		std::snprintf(name, sizeof(name), "msvc %d", _MSC_FULL_VER);
+#elif defined(__GNUC__)
+		std::snprintf(name, sizeof(name), "gcc %d.%d.%d", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#else
+		std::snprintf(name, sizeof(name), "unknown");
+#endif
+		return name;
+	}
+
+	// the instruction set GLM was compiled for (GLM_FORCE_* / compiler flags), not what the CPU can do
+	char const *glmArchName() {
+#if (GLM_ARCH & GLM_ARCH_AVX2) == GLM_ARCH_AVX2
+		return "avx2";
+#elif (GLM_ARCH & GLM_ARCH_AVX) == GLM_ARCH_AVX
+		return "avx";
+#elif (GLM_ARCH & GLM_ARCH_SSE42) == GLM_ARCH_SSE42
+		return "sse4.2";
+#elif (GLM_ARCH & GLM_ARCH_SSE41) == GLM_ARCH_SSE41
+		return "sse4.1";
+#elif (GLM_ARCH & GLM_ARCH_SSE2) == GLM_ARCH_SSE2
+		return "sse2";
+#else
+		return "pure";
+#endif
+	}
+
+	char const *buildName() {
+#ifdef NDEBUG
+		return "release";
+#else
+		return "debug";
+#endif
+	}
+
+	// run fn (BENCH_BATCH operations) until ~0.1s has been measured, returns ns per operation
+	template <typename Fn>
+	double measureNs(Fn fn) {
+		int passes = 0;
+		double const start = benchSeconds();
+		double elapsed = 0.0;
+		do {
+			fn();
+			++passes;
+			elapsed = benchSeconds() - start;
+		} while (elapsed < 0.1);
+		return elapsed / (static_cast<double>(passes) * BENCH_BATCH) * 1e9;
+	}
+
+	float maxAbsError() {
+		float worst = 0.0f;
+		for (size_t i = 0; i < BENCH_BATCH; ++i) {
+			for (int c = 0; c < 4; ++c) {
+				for (int r = 0; r < 4; ++r) worst = std::max(worst, std::fabs(g_Result[i][c][r] - g_Reference[i][c][r]));
+			}
+		}
+		return worst;
+	}
+
+	void printRow(char const *operation, char const *variant, double ns, float error) {
+		std::printf("%s,%s,%s,%s,%s,%s,%.3f,%g\n", compilerName(), glmArchName(), GLM_CONFIG_SIMD == GLM_ENABLE ? "on" : "off", buildName(), operation, variant, ns, error);
+	}
+
+	// scalar row, also records the reference results
+	template <typename Fn>
+	void scalarRow(char const *operation, Fn fn) {
+		double const ns = measureNs(fn);
+		std::copy(g_Out, g_Out + BENCH_BATCH, g_Reference);
+		printRow(operation, "scalar", ns, 0.0f);
+	}
+
+	// convert (called after timing) turns the variant's own outputs into g_Result
+	template <typename Fn, typename Convert>
+	void variantRow(char const *operation, char const *variant, Fn fn, Convert convert) {
+		double const ns = measureNs(fn);
+		convert();
+		printRow(operation, variant, ns, maxAbsError());
+	}
+
+	void simdResults() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) {
+			for (int c = 0; c < 4; ++c) _mm_storeu_ps(glm::value_ptr(g_Result[i]) + 4 * c, g_SimdOut[i][c]);
+		}
+	}
+
+	void affineResults() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Result[i] = g_AffineOut[i].toMat4();
+	}
+
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	void alignedResults() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Result[i] = glm::mat4(g_AlignedOut[i]);
+	}
+#endif
+
+	// camera() (main.cpp), all glm::mat4
+	template <typename Mat4, typename Vec3>
+	Mat4 glmCamera(float translate, glm::vec2 const &rotate) {
+		Mat4 const projection(glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.f));
+		Mat4 view = glm::translate(Mat4(1.0f), Vec3(0.0f, 0.0f, -translate));
+		view = glm::rotate(view, rotate.y, Vec3(-1.0f, 0.0f, 0.0f));
+		view = glm::rotate(view, rotate.x, Vec3(0.0f, 1.0f, 0.0f));
+		Mat4 const model = glm::scale(Mat4(1.0f), Vec3(0.5f));
+		return projection * view * model;
+	}
+
+	// the same with VIEW and MODEL composed as 3x4s, so only 1 (cheaper) 4x4 multiply with the projection
+	glm::mat4 affineCamera(float translate, glm::vec2 const &rotate) {
+		glm::mat4 const projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.f);
+		AffineTransform view = AffineTransform::translation(glm::vec3(0.0f, 0.0f, -translate));
+		view = view * AffineTransform::rotation(rotate.y, glm::vec3(-1.0f, 0.0f, 0.0f));
+		view = view * AffineTransform::rotation(rotate.x, glm::vec3(0.0f, 1.0f, 0.0f));
+		AffineTransform const model = AffineTransform::scale(glm::vec3(0.5f));
+		return projection * (view * model);
+	}
+}
+
+
+
+int glmBenchMain() {
+	std::mt19937 rng(30);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	for (size_t i = 0; i < BENCH_BATCH; ++i) {
+		g_Translations[i] = glm::vec3(unit(rng), unit(rng), unit(rng)) * 5.0f;
+		g_Axes[i] = glm::vec3(unit(rng), unit(rng), 1.5f);
+		g_Angles[i] = unit(rng) * 3.14159f;
+		g_CameraRotations[i] = glm::vec2(unit(rng), unit(rng)) * 3.14159f;
+		g_AffineA[i] = AffineTransform::fromTRS(g_Translations[i], g_Axes[i], g_Angles[i], glm::vec3(1.0f + 0.5f * unit(rng)));
+		g_AffineB[i] = AffineTransform::fromTRS(-g_Translations[i], glm::vec3(1.0f, unit(rng), unit(rng)), -g_Angles[i], glm::vec3(1.0f + 0.5f * unit(rng)));
+		g_A[i] = g_AffineA[i].toMat4();
+		g_B[i] = g_AffineB[i].toMat4();
+		g_Q0[i] = glm::angleAxis(g_Angles[i], glm::normalize(g_Axes[i]));
+		g_Q1[i] = glm::angleAxis(-g_Angles[i], glm::normalize(glm::vec3(1.0f, unit(rng), unit(rng))));
+		for (int c = 0; c < 4; ++c) {
+			g_SimdA[i][c] = _mm_loadu_ps(glm::value_ptr(g_A[i]) + 4 * c);
+			g_SimdB[i][c] = _mm_loadu_ps(glm::value_ptr(g_B[i]) + 4 * c);
+		}
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		g_AlignedA[i] = glm::aligned_mat4(g_A[i]);
+		g_AlignedB[i] = glm::aligned_mat4(g_B[i]);
+		g_AlignedVectors[i] = glm::aligned_vec3(g_Translations[i]);
+#endif
+	}
+
+	std::printf("compiler,glm_arch,glm_simd,build,operation,variant,ns_per_op,max_abs_error\n");
+
+	// perspective only exists for the default (packed) qualifier
+	scalarRow("perspective", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Out[i] = glm::perspective(0.5f + 0.001f * g_Angles[i], 4.0f / 3.0f, 0.1f, 100.f);
+	});
+
+	scalarRow("translate", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Out[i] = glm::translate(g_A[i], g_Translations[i]);
+	});
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	variantRow("translate", "aligned", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AlignedOut[i] = glm::translate(g_AlignedA[i], g_AlignedVectors[i]);
+	}, alignedResults);
+#endif
+	variantRow("translate", "affine", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AffineOut[i] = g_AffineA[i] * AffineTransform::translation(g_Translations[i]);
+	}, affineResults);
+
+	scalarRow("rotate", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Out[i] = glm::rotate(g_A[i], g_Angles[i], g_Axes[i]);
+	});
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	variantRow("rotate", "aligned", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AlignedOut[i] = glm::rotate(g_AlignedA[i], g_Angles[i], glm::aligned_vec3(g_Axes[i]));
+	}, alignedResults);
+#endif
+	variantRow("rotate", "affine", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AffineOut[i] = g_AffineA[i] * AffineTransform::rotation(g_Angles[i], g_Axes[i]);
+	}, affineResults);
+
+	scalarRow("scale", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Out[i] = glm::scale(g_A[i], g_Translations[i]);
+	});
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	variantRow("scale", "aligned", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AlignedOut[i] = glm::scale(g_AlignedA[i], g_AlignedVectors[i]);
+	}, alignedResults);
+#endif
+	variantRow("scale", "affine", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AffineOut[i] = g_AffineA[i] * AffineTransform::scale(g_Translations[i]);
+	}, affineResults);
+
+	scalarRow("mat4*mat4", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Out[i] = g_A[i] * g_B[i];
+	});
+	variantRow("mat4*mat4", "simd", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) glm_mat4_mul(g_SimdA[i], g_SimdB[i], g_SimdOut[i]);
+	}, simdResults);
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	variantRow("mat4*mat4", "aligned", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AlignedOut[i] = g_AlignedA[i] * g_AlignedB[i];
+	}, alignedResults);
+#endif
+	variantRow("mat4*mat4", "affine", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AffineOut[i] = g_AffineA[i] * g_AffineB[i];
+	}, affineResults);
+
+	scalarRow("inverse", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Out[i] = glm::inverse(g_A[i]);
+	});
+	variantRow("inverse", "simd", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) glm_mat4_inverse(g_SimdA[i], g_SimdOut[i]);
+	}, simdResults);
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	variantRow("inverse", "aligned", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AlignedOut[i] = glm::inverse(g_AlignedA[i]);
+	}, alignedResults);
+#endif
+	variantRow("inverse", "affine", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AffineOut[i] = inverse(g_AffineA[i]);
+	}, affineResults);
+
+	// GLM 0.9.9.5 has no aligned quaternion, so there's only the scalar row (its error column is how far the results drift from unit length)
+	double const slerpNs = measureNs([]() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_OutQuat[i] = glm::slerp(g_Q0[i], g_Q1[i], 0.25f + 0.001f * g_Angles[i]);
+	});
+	float slerpError = 0.0f;
+	for (size_t i = 0; i < BENCH_BATCH; ++i) slerpError = std::max(slerpError, std::fabs(glm::length(g_OutQuat[i]) - 1.0f));
+	printRow("slerp", "scalar", slerpNs, slerpError);
+
+	scalarRow("camera()", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Out[i] = glmCamera<glm::mat4, glm::vec3>(1.0f + g_Angles[i], g_CameraRotations[i]);
+	});
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+	variantRow("camera()", "aligned", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_AlignedOut[i] = glmCamera<glm::aligned_mat4, glm::aligned_vec3>(1.0f + g_Angles[i], g_CameraRotations[i]);
+	}, alignedResults);
+#endif
+	variantRow("camera()", "affine", []() {
+		for (size_t i = 0; i < BENCH_BATCH; ++i) g_Result[i] = affineCamera(1.0f + g_Angles[i], g_CameraRotations[i]);
+	}, []() {});
+
+	// where the numbers came from (the CPU can support more than this build uses)
+	std::fprintf(stderr, "cpu best simd level: %s\n", simdLevelName(getCpuFeatures().m_BestLevel));
+	return 0;
+}
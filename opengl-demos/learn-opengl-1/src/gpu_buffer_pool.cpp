@@ -0,0 +1,173 @@
+#include "gpu_buffer_pool.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <utility>
+
+
+
+GpuBufferPool::GpuBufferPool(unsigned int usage, size_t arenaSize) : m_Usage(usage), m_ArenaSize(arenaSize) {}
+
+GpuBufferPool::~GpuBufferPool() {
+	for (std::unique_ptr<Arena> const &arena : m_Arenas) {
+		if (arena) glDeleteBuffers(1, &arena->m_Buffer);
+	}
+}
+
+
+
+uint32_t GpuBufferPool::createArena(size_t size) {
+	unsigned int buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), nullptr, m_Usage);
+
+	// reuse the slot of a dropped arena if there is one
+	std::unique_ptr<Arena> arena(new Arena(buffer, size));
+	for (size_t i = 0; i < m_Arenas.size(); ++i) {
+		if (m_Arenas[i]) continue;
+		m_Arenas[i] = std::move(arena);
+		return static_cast<uint32_t>(i);
+	}
+	m_Arenas.push_back(std::move(arena));
+	return static_cast<uint32_t>(m_Arenas.size() - 1);
+}
+
+void GpuBufferPool::setRangeOfBlock(Arena &arena, TlsfAllocator::BlockId block, GpuRangeId range) {
+	if (block >= arena.m_RangeOfBlock.size()) arena.m_RangeOfBlock.resize(block + 1, INVALID_GPU_RANGE);
+	arena.m_RangeOfBlock[block] = range;
+}
+
+
+
+GpuRangeId GpuBufferPool::allocate(size_t size, void const *data, size_t alignment) {
+	// first arena with room
+	uint32_t arenaIndex = 0;
+	TlsfAllocator::BlockId block = TlsfAllocator::INVALID_BLOCK;
+	for (; arenaIndex < m_Arenas.size() && TlsfAllocator::INVALID_BLOCK == block; ++arenaIndex) {
+		if (m_Arenas[arenaIndex]) block = m_Arenas[arenaIndex]->m_Allocator.allocate(size, alignment);
+	}
+	if (TlsfAllocator::INVALID_BLOCK != block) {
+		--arenaIndex;
+	}
+	else {
+		// big enough for TLSF to find the range in it (oversize ranges get an arena of their own)
+		arenaIndex = createArena(std::max(m_ArenaSize, TlsfAllocator::getCapacityFor(size, alignment)));
+		block = m_Arenas[arenaIndex]->m_Allocator.allocate(size, alignment);
+		if (TlsfAllocator::INVALID_BLOCK == block) {
+			// only when the size is past what TLSF can map, don't leave the arena behind
+			glDeleteBuffers(1, &m_Arenas[arenaIndex]->m_Buffer);
+			m_Arenas[arenaIndex].reset();
+			return INVALID_GPU_RANGE;
+		}
+	}
+
+	GpuRangeId range;
+	if (m_FreeRanges.empty()) {
+		range = static_cast<GpuRangeId>(m_Ranges.size());
+		m_Ranges.push_back(Range());
+	}
+	else {
+		range = m_FreeRanges.back();
+		m_FreeRanges.pop_back();
+	}
+	m_Ranges[range].m_Arena = arenaIndex;
+	m_Ranges[range].m_Block = block;
+	m_Ranges[range].m_Size = size;
+	setRangeOfBlock(*m_Arenas[arenaIndex], block, range);
+
+	if (data) upload(range, data, size);
+	return range;
+}
+
+void GpuBufferPool::free(GpuRangeId range) {
+	if (INVALID_GPU_RANGE == range || TlsfAllocator::INVALID_BLOCK == m_Ranges[range].m_Block) return;
+
+	Arena &arena = arenaOf(range);
+	arena.m_RangeOfBlock[m_Ranges[range].m_Block] = INVALID_GPU_RANGE;
+	arena.m_Allocator.free(m_Ranges[range].m_Block);
+	m_Ranges[range] = Range();
+	m_FreeRanges.push_back(range);
+}
+
+void GpuBufferPool::upload(GpuRangeId range, void const *data, size_t size, size_t offset) {
+	glBindBuffer(GL_COPY_WRITE_BUFFER, getBuffer(range));
+	glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(getOffset(range) + offset), static_cast<GLsizeiptr>(size), data);
+}
+
+
+
+size_t GpuBufferPool::compact(size_t budget) {
+	size_t moved = 0;
+
+	// top of the last arena first: into holes of earlier arenas (so later arenas can empty out), else lower in its own
+	for (size_t a = m_Arenas.size(); 0 < a && moved < budget; --a) {
+		uint32_t const sourceIndex = static_cast<uint32_t>(a - 1);
+		if (!m_Arenas[sourceIndex]) continue;
+		Arena &source = *m_Arenas[sourceIndex];
+
+		source.m_Allocator.getUsedBlocksFromTop(m_CompactionBlocks);
+		for (TlsfAllocator::BlockId block : m_CompactionBlocks) {
+			if (moved >= budget) break;
+			size_t const size = source.m_Allocator.getSize(block);
+			size_t const alignment = source.m_Allocator.getAlignment(block);
+			size_t const offset = source.m_Allocator.getOffset(block);
+
+			uint32_t targetIndex = sourceIndex;
+			TlsfAllocator::BlockId target = TlsfAllocator::INVALID_BLOCK;
+			for (uint32_t i = 0; i < sourceIndex && TlsfAllocator::INVALID_BLOCK == target; ++i) {
+				if (!m_Arenas[i]) continue;
+				target = m_Arenas[i]->m_Allocator.allocateBelow(size, alignment, m_Arenas[i]->m_Allocator.getCapacity());
+				targetIndex = i;
+			}
+			if (TlsfAllocator::INVALID_BLOCK == target) {
+				targetIndex = sourceIndex;
+				target = source.m_Allocator.allocateBelow(size, alignment, offset); // ends at or below offset, so no overlap
+			}
+			if (TlsfAllocator::INVALID_BLOCK == target) continue;
+
+			// GL keeps the copy in order with the draws already queued, they still read the old place
+			Arena &destination = *m_Arenas[targetIndex];
+			glBindBuffer(GL_COPY_READ_BUFFER, source.m_Buffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, destination.m_Buffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset),
+				static_cast<GLintptr>(destination.m_Allocator.getOffset(target)), static_cast<GLsizeiptr>(size));
+
+			GpuRangeId const range = source.m_RangeOfBlock[block];
+			source.m_RangeOfBlock[block] = INVALID_GPU_RANGE;
+			source.m_Allocator.free(block);
+			m_Ranges[range].m_Arena = targetIndex;
+			m_Ranges[range].m_Block = target;
+			setRangeOfBlock(destination, target, range);
+			moved += size;
+		}
+
+		// the first arena always stays, the rest go once they're empty
+		if (0 < sourceIndex && source.m_Allocator.isEmpty()) {
+			glDeleteBuffers(1, &source.m_Buffer);
+			m_Arenas[sourceIndex].reset();
+		}
+	}
+
+	m_CompactedBytes += moved;
+	return moved;
+}
+
+GpuBufferPoolStats GpuBufferPool::getStats() const {
+	GpuBufferPoolStats stats;
+	stats.m_RangeCount = m_Ranges.size() - m_FreeRanges.size();
+	stats.m_CompactedBytes = m_CompactedBytes;
+	size_t freeBytes = 0;
+	for (std::unique_ptr<Arena> const &arena : m_Arenas) {
+		if (!arena) continue;
+		TlsfStats const tlsf = arena->m_Allocator.getStats();
+		++stats.m_ArenaCount;
+		stats.m_ReservedBytes += tlsf.m_Capacity;
+		stats.m_UsedBytes += tlsf.m_UsedBytes;
+		stats.m_LargestFreeBlock = std::max(stats.m_LargestFreeBlock, tlsf.m_LargestFreeBlock);
+		freeBytes += tlsf.m_FreeBytes;
+	}
+	if (0 < freeBytes) stats.m_Fragmentation = 1.0 - static_cast<double>(stats.m_LargestFreeBlock) / freeBytes;
+	return stats;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "tlsf_allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// many meshes in a few big GL buffers instead of 1 glGenBuffers() + glBufferData() each
+// - the pool reserves arenas of getArenaSize() bytes (a new one when nothing fits) and TLSF-allocates ranges out of them
+// - a range is (buffer, offset): bind the buffer once and draw with offsets (glVertexAttribPointer / glDrawElements offsets,
+//   or glDrawElementsBaseVertex with offset / vertex stride), so meshes from the same arena share binds
+// - compact() is incremental (call it with a byte budget once per frame, e.g. when the fragmentation stat climbs): it moves
+//   ranges from the top of an arena down into holes with glCopyBufferSubData and drops arenas that end up empty
+//   NOTE: a range's offset (and even buffer) can change in compact(), so look them up when drawing instead of caching them
+// - alignment rules: offsets are multiples of 16 at least; pass the vertex stride (if it's a power of 2) or the index size,
+//   strides like 12 bytes need their byte offset in glVertexAttribPointer (base vertex only works for multiples of the stride)
+// - infrastructure for scenes with many meshes, none of the demos use it (they have 1 or 2 buffers), tlsfAllocatorBenchMain()
+//   checks the allocator under it
+
+
+
+typedef uint32_t GpuRangeId;
+GpuRangeId const INVALID_GPU_RANGE = 0xFFFFFFFFu;
+
+struct GpuBufferPoolStats {
+	size_t m_ArenaCount = 0;
+	size_t m_RangeCount = 0;
+	size_t m_ReservedBytes = 0; // all arenas
+	size_t m_UsedBytes = 0;
+	size_t m_LargestFreeBlock = 0; // in any 1 arena
+	double m_Fragmentation = 0.0; // 1 - largest free block / free bytes, over all arenas
+	size_t m_CompactedBytes = 0; // moved by compact() so far
+};
+
+class GpuBufferPool {
+public:
+	static size_t const DEFAULT_ARENA_SIZE = 32 * 1024 * 1024;
+
+	// usage e.g. GL_STATIC_DRAW, 1 pool per kind of data (vertices / indices) since arenas are bound as a whole
+	explicit GpuBufferPool(unsigned int usage, size_t arenaSize = DEFAULT_ARENA_SIZE);
+	~GpuBufferPool(); // deletes the arenas (needs the GL context to still be current)
+
+	GpuBufferPool(GpuBufferPool const &) = delete;
+	GpuBufferPool &operator=(GpuBufferPool const &) = delete;
+
+	// data may be nullptr (upload() later), ranges bigger than the arena size get an arena of their own
+	// alignment has to be a power of 2, INVALID_GPU_RANGE if the size is too big for any arena
+	GpuRangeId allocate(size_t size, void const *data = nullptr, size_t alignment = TlsfAllocator::GRANULARITY);
+	void free(GpuRangeId range);
+
+	// glBufferSubData() into the range (through GL_COPY_WRITE_BUFFER, so no other binding is disturbed)
+	void upload(GpuRangeId range, void const *data, size_t size, size_t offset = 0);
+
+	unsigned int getBuffer(GpuRangeId range) const { return m_Arenas[m_Ranges[range].m_Arena]->m_Buffer; }
+	size_t getOffset(GpuRangeId range) const { return arenaOf(range).m_Allocator.getOffset(m_Ranges[range].m_Block); }
+	size_t getSize(GpuRangeId range) const { return m_Ranges[range].m_Size; }
+
+	// moves up to budget bytes worth of ranges into lower holes, returns the bytes moved
+	size_t compact(size_t budget);
+
+	size_t getArenaSize() const { return m_ArenaSize; }
+	GpuBufferPoolStats getStats() const;
+
+private:
+	struct Arena {
+		unsigned int m_Buffer;
+		TlsfAllocator m_Allocator;
+		std::vector<GpuRangeId> m_RangeOfBlock; // TLSF block id -> range, for compaction
+
+		Arena(unsigned int buffer, size_t size) : m_Buffer(buffer), m_Allocator(size) {}
+	};
+
+	struct Range {
+		uint32_t m_Arena = 0;
+		TlsfAllocator::BlockId m_Block = TlsfAllocator::INVALID_BLOCK;
+		size_t m_Size = 0; // as requested (the block can be bigger)
+	};
+
+	Arena &arenaOf(GpuRangeId range) { return *m_Arenas[m_Ranges[range].m_Arena]; }
+	Arena const &arenaOf(GpuRangeId range) const { return *m_Arenas[m_Ranges[range].m_Arena]; }
+	uint32_t createArena(size_t size); // index into m_Arenas
+	void setRangeOfBlock(Arena &arena, TlsfAllocator::BlockId block, GpuRangeId range);
+
+	unsigned int m_Usage;
+	size_t m_ArenaSize;
+	std::vector<std::unique_ptr<Arena>> m_Arenas; // entries of dropped arenas are nullptr (ranges keep their arena index)
+	std::vector<Range> m_Ranges; // indexed by GpuRangeId
+	std::vector<GpuRangeId> m_FreeRanges;
+	std::vector<TlsfAllocator::BlockId> m_CompactionBlocks; // scratch for compact()
+	size_t m_CompactedBytes = 0;
+};
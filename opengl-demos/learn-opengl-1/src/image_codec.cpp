@@ -0,0 +1,1348 @@
+#include "image_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+
+
+namespace {
+	uint8_t const PNG_SIGNATURE[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+	// deflate length codes 257..285 and distance codes 0..29 (RFC 1951 3.2.5)
+	uint16_t const LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	uint8_t const LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	uint16_t const DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	uint8_t const DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	// order the code length code lengths are stored in
+	uint8_t const CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+	// a deflate stream can't inflate more than this per compressed byte (a 258 byte match in 2 bits of codes)
+	size_t const MAX_DEFLATE_RATIO = 1032;
+
+	uint32_t readBE32(uint8_t const *bytes) {
+		return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) | (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+	}
+
+	void writeBE32(std::vector<uint8_t> &out, uint32_t value) {
+		out.push_back(static_cast<uint8_t>(value >> 24));
+		out.push_back(static_cast<uint8_t>(value >> 16));
+		out.push_back(static_cast<uint8_t>(value >> 8));
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	uint32_t reverseBits(uint32_t code, int length) {
+		uint32_t reversed = 0;
+		for (int i = 0; i < length; ++i, code >>= 1) reversed = (reversed << 1) | (code & 1);
+		return reversed;
+	}
+
+
+
+	// LSB-first bit reader, reading past the end gives zeros and is caught by isOverrun()
+	class BitReader {
+	public:
+		BitReader(uint8_t const *data, size_t size) : m_Data(data), m_Size(size) {}
+
+		uint32_t peek(int count) { // count <= 24
+			while (m_Count < count) {
+				uint32_t const byte = m_Position < m_Size ? m_Data[m_Position++] : (++m_Padding, 0u);
+				m_Bits |= byte << m_Count;
+				m_Count += 8;
+			}
+			return m_Bits & ((1u << count) - 1);
+		}
+		void consume(int count) { m_Bits >>= count; m_Count -= count; }
+		uint32_t read(int count) {
+			uint32_t const value = peek(count);
+			consume(count);
+			return value;
+		}
+		void alignToByte() { consume(m_Count & 7); }
+
+		// stored blocks: whatever is still buffered first, then straight from the input
+		bool copyBytes(std::vector<uint8_t> &out, size_t count) {
+			for (; 0 < count && 8 <= m_Count; --count) out.push_back(static_cast<uint8_t>(read(8)));
+			if (count > m_Size - m_Position) return false;
+			out.insert(out.end(), m_Data + m_Position, m_Data + m_Position + count);
+			m_Position += count;
+			return true;
+		}
+
+		bool isOverrun() const { return m_Padding * 8 > static_cast<size_t>(m_Count); } // some of the zero padding got used
+
+	private:
+		uint8_t const *m_Data;
+		size_t m_Size;
+		size_t m_Position = 0;
+		size_t m_Padding = 0; // zero bytes fed in past the end
+		uint32_t m_Bits = 0;
+		int m_Count = 0;
+	};
+
+
+
+	// canonical Huffman decoding table: 1 lookup for codes up to FAST_BITS long, a bit-by-bit walk for the rest
+	int const FAST_BITS = 9;
+	int const MAX_CODE_LENGTH = 15;
+
+	struct Huffman {
+		uint16_t m_Fast[1 << FAST_BITS]; // (symbol << 4) | length, 0 = longer code (or none)
+		uint16_t m_Count[MAX_CODE_LENGTH + 1]; // codes of each length
+		uint16_t m_Symbols[288]; // in code order
+	};
+
+	bool buildHuffman(Huffman &huffman, uint8_t const *lengths, int count) {
+		std::memset(huffman.m_Count, 0, sizeof(huffman.m_Count));
+		for (int symbol = 0; symbol < count; ++symbol) ++huffman.m_Count[lengths[symbol]];
+		huffman.m_Count[0] = 0;
+
+		// over-subscribed = broken, incomplete is allowed (e.g. a single distance code)
+		int left = 1;
+		for (int length = 1; length <= MAX_CODE_LENGTH; ++length) {
+			left = (left << 1) - huffman.m_Count[length];
+			if (0 > left) return false;
+		}
+
+		uint16_t offsets[MAX_CODE_LENGTH + 1];
+		uint32_t nextCode[MAX_CODE_LENGTH + 1];
+		offsets[1] = 0;
+		nextCode[1] = 0;
+		for (int length = 1; length < MAX_CODE_LENGTH; ++length) {
+			offsets[length + 1] = offsets[length] + huffman.m_Count[length];
+			nextCode[length + 1] = (nextCode[length] + huffman.m_Count[length]) << 1;
+		}
+
+		std::memset(huffman.m_Fast, 0, sizeof(huffman.m_Fast));
+		for (int symbol = 0; symbol < count; ++symbol) {
+			int const length = lengths[symbol];
+			if (0 == length) continue;
+			huffman.m_Symbols[offsets[length]++] = static_cast<uint16_t>(symbol);
+			uint32_t const code = nextCode[length]++;
+			if (length > FAST_BITS) continue;
+			// the stream is read LSB first, so the table is indexed by the reversed code (every value of the unused high bits)
+			for (uint32_t index = reverseBits(code, length); index < (1u << FAST_BITS); index += 1u << length) {
+				huffman.m_Fast[index] = static_cast<uint16_t>((symbol << 4) | length);
+			}
+		}
+		return true;
+	}
+
+	int decodeSymbol(BitReader &in, Huffman const &huffman) {
+		uint32_t const entry = huffman.m_Fast[in.peek(FAST_BITS)];
+		if (0 != entry) {
+			in.consume(entry & 15);
+			return static_cast<int>(entry >> 4);
+		}
+
+		// same walk as zlib's puff.c: first = first code of this length, index = its position in m_Symbols
+		int code = 0;
+		int first = 0;
+		int index = 0;
+		for (int length = 1; length <= MAX_CODE_LENGTH; ++length) {
+			code |= static_cast<int>(in.read(1));
+			int const count = huffman.m_Count[length];
+			if (code - first < count) return huffman.m_Symbols[index + code - first];
+			index += count;
+			first = (first + count) << 1;
+			code <<= 1;
+		}
+		return -1;
+	}
+
+	struct FixedTables {
+		Huffman m_Literals;
+		Huffman m_Distances;
+
+		FixedTables() {
+			uint8_t lengths[288];
+			std::fill(lengths, lengths + 144, static_cast<uint8_t>(8));
+			std::fill(lengths + 144, lengths + 256, static_cast<uint8_t>(9));
+			std::fill(lengths + 256, lengths + 280, static_cast<uint8_t>(7));
+			std::fill(lengths + 280, lengths + 288, static_cast<uint8_t>(8));
+			buildHuffman(m_Literals, lengths, 288);
+			std::fill(lengths, lengths + 30, static_cast<uint8_t>(5));
+			buildHuffman(m_Distances, lengths, 30);
+		}
+	};
+
+	bool readDynamicTables(BitReader &in, Huffman &literals, Huffman &distances) {
+		int const literalCount = static_cast<int>(in.read(5)) + 257;
+		int const distanceCount = static_cast<int>(in.read(5)) + 1;
+		int const codeLengthCount = static_cast<int>(in.read(4)) + 4;
+		if (286 < literalCount || 30 < distanceCount) return false;
+
+		uint8_t lengths[286 + 30] = {};
+		for (int i = 0; i < codeLengthCount; ++i) lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(in.read(3));
+		Huffman codeLengths;
+		if (!buildHuffman(codeLengths, lengths, 19)) return false;
+
+		// literal and distance lengths are 1 sequence, repeats can run from one into the other
+		std::memset(lengths, 0, sizeof(lengths));
+		int const total = literalCount + distanceCount;
+		for (int i = 0; i < total;) {
+			int const symbol = decodeSymbol(in, codeLengths);
+			if (0 > symbol) return false;
+			if (16 > symbol) {
+				lengths[i++] = static_cast<uint8_t>(symbol);
+				continue;
+			}
+			uint8_t value = 0;
+			int repeat;
+			if (16 == symbol) {
+				if (0 == i) return false;
+				value = lengths[i - 1];
+				repeat = 3 + static_cast<int>(in.read(2));
+			}
+			else if (17 == symbol) {
+				repeat = 3 + static_cast<int>(in.read(3));
+			}
+			else {
+				repeat = 11 + static_cast<int>(in.read(7));
+			}
+			if (i + repeat > total) return false;
+			while (repeat--) lengths[i++] = value;
+		}
+		if (0 == lengths[256]) return false; // no end-of-block code
+		return buildHuffman(literals, lengths, literalCount) && buildHuffman(distances, lengths + literalCount, distanceCount);
+	}
+
+	bool inflateCodes(BitReader &in, Huffman const &literals, Huffman const &distances, size_t maxOutput, std::vector<uint8_t> &out) {
+		while (true) {
+			int const symbol = decodeSymbol(in, literals);
+			if (0 > symbol) return false;
+			if (256 > symbol) {
+				if (out.size() >= maxOutput) return false;
+				out.push_back(static_cast<uint8_t>(symbol));
+				continue;
+			}
+			if (256 == symbol) return true;
+
+			int const lengthCode = symbol - 257;
+			if (29 <= lengthCode) return false;
+			size_t const length = LENGTH_BASE[lengthCode] + in.read(LENGTH_EXTRA[lengthCode]);
+			int const distanceCode = decodeSymbol(in, distances);
+			if (0 > distanceCode || 30 <= distanceCode) return false;
+			size_t const distance = DISTANCE_BASE[distanceCode] + in.read(DISTANCE_EXTRA[distanceCode]);
+			if (distance > out.size() || length > maxOutput - out.size()) return false;
+
+			// byte by byte: the source can overlap what's being written (distance < length repeats a pattern)
+			size_t const from = out.size() - distance;
+			for (size_t i = 0; i < length; ++i) {
+				uint8_t const byte = out[from + i];
+				out.push_back(byte);
+			}
+		}
+	}
+
+
+
+	// --- PNG
+
+	int pngChannels(int colorType) {
+		switch (colorType) {
+		case 0: return 1; // grey
+		case 2: return 3; // RGB
+		case 3: return 1; // palette index
+		case 4: return 2; // grey + alpha
+		case 6: return 4; // RGBA
+		default: return 0;
+		}
+	}
+
+	bool validPngDepth(int colorType, int bitDepth) {
+		if (0 == colorType) return 1 == bitDepth || 2 == bitDepth || 4 == bitDepth || 8 == bitDepth || 16 == bitDepth;
+		if (3 == colorType) return 1 == bitDepth || 2 == bitDepth || 4 == bitDepth || 8 == bitDepth;
+		return 8 == bitDepth || 16 == bitDepth;
+	}
+
+	uint8_t paeth(int left, int up, int upLeft) {
+		int const estimate = left + up - upLeft;
+		int const toLeft = std::abs(estimate - left);
+		int const toUp = std::abs(estimate - up);
+		int const toUpLeft = std::abs(estimate - upLeft);
+		if (toLeft <= toUp && toLeft <= toUpLeft) return static_cast<uint8_t>(left);
+		return static_cast<uint8_t>(toUp <= toUpLeft ? up : upLeft);
+	}
+
+	// in place, prior is the previous row (already unfiltered) or zeros
+	bool unfilterRow(int filter, uint8_t *row, uint8_t const *prior, size_t rowBytes, size_t pixelBytes) {
+		switch (filter) {
+		case 0:
+			return true;
+		case 1:
+			for (size_t i = pixelBytes; i < rowBytes; ++i) row[i] = static_cast<uint8_t>(row[i] + row[i - pixelBytes]);
+			return true;
+		case 2:
+			for (size_t i = 0; i < rowBytes; ++i) row[i] = static_cast<uint8_t>(row[i] + prior[i]);
+			return true;
+		case 3:
+			for (size_t i = 0; i < rowBytes; ++i) row[i] = static_cast<uint8_t>(row[i] + (((i >= pixelBytes ? row[i - pixelBytes] : 0) + prior[i]) >> 1));
+			return true;
+		case 4:
+			for (size_t i = 0; i < rowBytes; ++i) {
+				int const left = i >= pixelBytes ? row[i - pixelBytes] : 0;
+				int const upLeft = i >= pixelBytes ? prior[i - pixelBytes] : 0;
+				row[i] = static_cast<uint8_t>(row[i] + paeth(left, prior[i], upLeft));
+			}
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// sample index of a row, at its full bit depth
+	uint32_t pngSample(uint8_t const *row, size_t index, int bitDepth) {
+		if (16 == bitDepth) return (static_cast<uint32_t>(row[2 * index]) << 8) | row[2 * index + 1];
+		if (8 == bitDepth) return row[index];
+		size_t const bit = index * bitDepth;
+		return (row[bit >> 3] >> (8 - bitDepth - (bit & 7))) & ((1u << bitDepth) - 1);
+	}
+
+	uint8_t to8Bits(uint32_t sample, int bitDepth) {
+		if (16 == bitDepth) return static_cast<uint8_t>(sample >> 8);
+		if (8 == bitDepth) return static_cast<uint8_t>(sample);
+		return static_cast<uint8_t>(sample * 255 / ((1u << bitDepth) - 1));
+	}
+
+
+
+	// --- encoding
+
+	// LSB-first bit writer
+	class BitWriter {
+	public:
+		explicit BitWriter(std::vector<uint8_t> &out) : m_Out(out) {}
+
+		void write(uint32_t value, int count) {
+			m_Bits |= static_cast<uint64_t>(value) << m_Count;
+			m_Count += count;
+			while (8 <= m_Count) {
+				m_Out.push_back(static_cast<uint8_t>(m_Bits));
+				m_Bits >>= 8;
+				m_Count -= 8;
+			}
+		}
+		// Huffman codes go out most significant bit first
+		void writeCode(uint32_t code, int length) { write(reverseBits(code, length), length); }
+		void flush() {
+			if (0 < m_Count) m_Out.push_back(static_cast<uint8_t>(m_Bits));
+			m_Bits = 0;
+			m_Count = 0;
+		}
+
+	private:
+		std::vector<uint8_t> &m_Out;
+		uint64_t m_Bits = 0;
+		int m_Count = 0;
+	};
+
+	void writeFixedLiteral(BitWriter &out, int symbol) {
+		if (144 > symbol) out.writeCode(0x30 + symbol, 8);
+		else if (256 > symbol) out.writeCode(0x190 + symbol - 144, 9);
+		else if (280 > symbol) out.writeCode(symbol - 256, 7);
+		else out.writeCode(0xC0 + symbol - 280, 8);
+	}
+
+	void writeMatch(BitWriter &out, size_t length, size_t distance) {
+		int code = 28;
+		while (LENGTH_BASE[code] > length) --code;
+		writeFixedLiteral(out, 257 + code);
+		out.write(static_cast<uint32_t>(length - LENGTH_BASE[code]), LENGTH_EXTRA[code]);
+		code = 29;
+		while (DISTANCE_BASE[code] > distance) --code;
+		out.writeCode(code, 5);
+		out.write(static_cast<uint32_t>(distance - DISTANCE_BASE[code]), DISTANCE_EXTRA[code]);
+	}
+
+	uint32_t adler32(uint8_t const *data, size_t size) {
+		uint32_t a = 1;
+		uint32_t b = 0;
+		while (0 < size) {
+			size_t const chunk = std::min<size_t>(size, 5552); // the most that can't overflow before the modulo
+			for (size_t i = 0; i < chunk; ++i) {
+				a += data[i];
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+			data += chunk;
+			size -= chunk;
+		}
+		return (b << 16) | a;
+	}
+
+	uint32_t crc32(uint8_t const *data, size_t size) {
+		struct Table {
+			uint32_t m_Entries[256];
+			Table() {
+				for (uint32_t i = 0; i < 256; ++i) {
+					uint32_t c = i;
+					for (int bit = 0; bit < 8; ++bit) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+					m_Entries[i] = c;
+				}
+			}
+		};
+		static Table const s_Table;
+		uint32_t crc = 0xFFFFFFFFu;
+		for (size_t i = 0; i < size; ++i) crc = s_Table.m_Entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return crc ^ 0xFFFFFFFFu;
+	}
+
+	// greedy LZ77 (1 candidate per hash, no chains) into a single fixed-Huffman block
+	void zlibDeflate(std::vector<uint8_t> const &data, std::vector<uint8_t> &out) {
+		size_t const WINDOW = 32768;
+		size_t const MIN_MATCH = 3;
+		size_t const MAX_MATCH = 258;
+		int const HASH_BITS = 15;
+
+		out.push_back(0x78); // deflate, 32K window
+		out.push_back(0x01); // fastest, (0x7801 % 31) == 0
+		BitWriter bits(out);
+		bits.write(1, 1); // final block
+		bits.write(1, 2); // fixed Huffman codes
+
+		std::vector<int32_t> head(static_cast<size_t>(1) << HASH_BITS, -1);
+		size_t const size = data.size();
+		size_t position = 0;
+		while (position < size) {
+			size_t bestLength = 0;
+			size_t bestDistance = 0;
+			if (position + MIN_MATCH <= size) {
+				uint32_t const hash = ((data[position] << 16) ^ (data[position + 1] << 8) ^ data[position + 2]) * 2654435761u >> (32 - HASH_BITS);
+				int32_t const candidate = head[hash];
+				head[hash] = static_cast<int32_t>(position);
+				if (0 <= candidate && position - candidate <= WINDOW) {
+					size_t const limit = std::min(MAX_MATCH, size - position);
+					size_t length = 0;
+					while (length < limit && data[candidate + length] == data[position + length]) ++length;
+					if (MIN_MATCH <= length) {
+						bestLength = length;
+						bestDistance = position - candidate;
+					}
+				}
+			}
+			if (0 == bestLength) {
+				writeFixedLiteral(bits, data[position++]);
+				continue;
+			}
+			writeMatch(bits, bestLength, bestDistance);
+			position += bestLength;
+		}
+		writeFixedLiteral(bits, 256);
+		bits.flush();
+		writeBE32(out, adler32(data.data(), data.size()));
+	}
+
+	void writeChunk(std::vector<uint8_t> &file, char const *type, std::vector<uint8_t> const &data) {
+		writeBE32(file, static_cast<uint32_t>(data.size()));
+		size_t const start = file.size();
+		file.insert(file.end(), type, type + 4);
+		file.insert(file.end(), data.begin(), data.end());
+		writeBE32(file, crc32(file.data() + start, file.size() - start));
+	}
+
+
+
+	// --- JPEG
+
+	// zigzag index -> natural (row-major) index, 16 extra entries so a corrupt run past the end of a block stays inside it
+	uint8_t const JPEG_ZIGZAG[64 + 16] = {
+		0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5, 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+		35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+		63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+	};
+	int const JPEG_MAX_DC = 1 << 15; // a DC prediction outside +-this only comes from a corrupt stream
+	// cos(k pi / 16) * sqrt(2), k = 1..7 (1 for k = 0): the AAN inverse DCT wants coefficient (u, v) scaled by AAN_SCALE[u] * AAN_SCALE[v] / 8
+	float const AAN_SCALE[8] = { 1.0f, 1.387039845f, 1.306562965f, 1.175875602f, 1.0f, 0.785694958f, 0.541196100f, 0.275899379f };
+
+	uint32_t readBE16(uint8_t const *bytes) {
+		return (static_cast<uint32_t>(bytes[0]) << 8) | bytes[1];
+	}
+
+	// MSB-first reader over entropy-coded data: drops the 0 stuffed after every 0xFF, stops at a marker and feeds zeros from there
+	class JpegBitReader {
+	public:
+		JpegBitReader(uint8_t const *data, size_t size, size_t position) : m_Data(data), m_Size(size), m_Position(position) {}
+
+		uint32_t peek(int count) { // count <= 16
+			fill();
+			return m_Bits >> (32 - count);
+		}
+		void consume(int count) { m_Bits <<= count; m_Count -= count; }
+		uint32_t read(int count) {
+			if (0 == count) return 0;
+			uint32_t const value = peek(count);
+			consume(count);
+			return value;
+		}
+		// count bits as a signed value of that magnitude category (EXTEND in T.81 F.2.2.1)
+		int readSigned(int count) {
+			if (0 == count) return 0;
+			int const value = static_cast<int>(read(count));
+			return value < (1 << (count - 1)) ? value - (1 << count) + 1 : value;
+		}
+
+		// the next marker after the data (skipping what's left in the bit buffer), m_Size if there's none
+		size_t skipToMarker() {
+			m_Bits = 0;
+			m_Count = 0;
+			m_Marker = false;
+			while (m_Position + 1 < m_Size && (0xFF != m_Data[m_Position] || 0 == m_Data[m_Position + 1] || 0xFF == m_Data[m_Position + 1])) ++m_Position;
+			if (m_Position + 1 >= m_Size) m_Position = m_Size;
+			return m_Position;
+		}
+		// past the restart marker that has to come next, false = it isn't there
+		bool restart() {
+			size_t const marker = skipToMarker();
+			if (marker == m_Size || 0xD0 > m_Data[marker + 1] || 0xD7 < m_Data[marker + 1]) return false;
+			m_Position = marker + 2;
+			return true;
+		}
+
+	private:
+		void fill() {
+			while (24 >= m_Count) {
+				uint32_t byte = 0;
+				if (!m_Marker && m_Position < m_Size) {
+					byte = m_Data[m_Position];
+					if (0xFF != byte) ++m_Position;
+					else if (m_Position + 1 < m_Size && 0 == m_Data[m_Position + 1]) m_Position += 2;
+					else {
+						byte = 0;
+						m_Marker = true;
+					}
+				}
+				m_Bits |= byte << (24 - m_Count);
+				m_Count += 8;
+			}
+		}
+
+		uint8_t const *m_Data;
+		size_t m_Size;
+		size_t m_Position;
+		uint32_t m_Bits = 0; // next bit in the MSB
+		int m_Count = 0;
+		bool m_Marker = false; // m_Position is at a marker, the rest are zeros
+	};
+
+
+
+	// canonical Huffman table as stored in a DHT segment: 1 lookup for codes up to JPEG_FAST_BITS long, then 1 compare per length
+	int const JPEG_FAST_BITS = 9;
+
+	struct JpegHuffman {
+		bool m_Defined = false;
+		uint16_t m_Fast[1 << JPEG_FAST_BITS]; // (symbol index << 4) | length, 0 = longer code (or none)
+		int32_t m_MaxCode[17]; // last code of each length, -1 = none
+		int32_t m_IndexOffset[17]; // code of a length -> index into m_Symbols
+		uint8_t m_Symbols[256]; // in code order
+	};
+
+	bool buildJpegHuffman(JpegHuffman &huffman, uint8_t const *counts, uint8_t const *symbols, int symbolCount) {
+		std::memcpy(huffman.m_Symbols, symbols, symbolCount);
+		std::memset(huffman.m_Fast, 0, sizeof(huffman.m_Fast));
+		int32_t code = 0;
+		int index = 0;
+		for (int length = 1; length <= 16; ++length) {
+			huffman.m_IndexOffset[length] = index - code;
+			for (int i = 0; i < counts[length - 1]; ++i, ++index, ++code) {
+				if ((1 << length) <= code) return false; // over-subscribed
+				if (length > JPEG_FAST_BITS) continue;
+				uint32_t const first = static_cast<uint32_t>(code) << (JPEG_FAST_BITS - length);
+				for (uint32_t j = 0; j < (1u << (JPEG_FAST_BITS - length)); ++j) huffman.m_Fast[first + j] = static_cast<uint16_t>((index << 4) | length);
+			}
+			huffman.m_MaxCode[length] = 0 < counts[length - 1] ? code - 1 : -1;
+			code <<= 1;
+		}
+		huffman.m_Defined = true;
+		return true;
+	}
+
+	int decodeJpegSymbol(JpegBitReader &in, JpegHuffman const &huffman) {
+		uint32_t const bits = in.peek(16);
+		uint32_t const entry = huffman.m_Fast[bits >> (16 - JPEG_FAST_BITS)];
+		if (0 != entry) {
+			in.consume(entry & 15);
+			return huffman.m_Symbols[entry >> 4];
+		}
+		for (int length = JPEG_FAST_BITS + 1; length <= 16; ++length) {
+			int32_t const code = static_cast<int32_t>(bits >> (16 - length));
+			if (code > huffman.m_MaxCode[length]) continue;
+			in.consume(length);
+			return huffman.m_Symbols[huffman.m_IndexOffset[length] + code];
+		}
+		return -1; // not a code of this table
+	}
+
+
+
+	struct JpegComponent {
+		int m_Id = 0;
+		int m_H = 1; // sampling factors
+		int m_V = 1;
+		int m_Quant = 0;
+		int m_DcTable = 0;
+		int m_AcTable = 0;
+		int m_Width = 0; // samples that cover the image, the rest of the plane is padding to whole MCUs
+		int m_Height = 0;
+		int m_BlocksPerLine = 0;
+		int m_BlocksPerColumn = 0;
+		int m_Dc = 0; // DC prediction
+		std::vector<uint8_t> m_Plane; // m_BlocksPerLine * 8 samples wide
+		std::vector<int16_t> m_Coefficients; // progressive only: 64 per block, natural order, dequantized once every scan is in
+	};
+
+	struct JpegFrame {
+		int m_Width = 0;
+		int m_Height = 0;
+		bool m_Progressive = false;
+		int m_ComponentCount = 0; // 0 = no frame header yet
+		JpegComponent m_Components[3];
+		int m_MaxH = 1;
+		int m_MaxV = 1;
+		int m_McusPerLine = 0;
+		int m_McusPerColumn = 0;
+		float m_Quant[4][64] = {}; // zigzag order, with the inverse DCT's prescale (AAN_SCALE) in already
+		JpegHuffman m_Dc[4];
+		JpegHuffman m_Ac[4];
+		int m_RestartInterval = 0; // MCUs, 0 = none
+		int m_AdobeTransform = -1; // APP14, 0 = the 3 components are RGB
+		uint32_t m_EobRun = 0; // progressive AC scans: blocks left that have nothing more in this band
+	};
+
+	struct JpegScan {
+		int m_Count = 0;
+		int m_Components[3] = {}; // into JpegFrame::m_Components
+		int m_Start = 0; // spectral selection, zigzag indices
+		int m_End = 63;
+		int m_High = 0; // successive approximation bit positions (progressive)
+		int m_Low = 0;
+	};
+
+	int ceilDiv(int value, int divisor) {
+		return (value + divisor - 1) / divisor;
+	}
+
+	bool parseJpegQuantTables(JpegFrame &frame, uint8_t const *data, size_t size) {
+		while (0 < size) {
+			int const precision = data[0] >> 4;
+			int const id = data[0] & 15;
+			size_t const bytes = 1 + 64 * (0 == precision ? 1 : 2);
+			if (1 < precision || 3 < id || size < bytes) return false;
+			for (int k = 0; k < 64; ++k) {
+				uint32_t const step = 0 == precision ? data[1 + k] : readBE16(data + 1 + 2 * k);
+				frame.m_Quant[id][k] = step * AAN_SCALE[JPEG_ZIGZAG[k] >> 3] * AAN_SCALE[JPEG_ZIGZAG[k] & 7] * 0.125f;
+			}
+			data += bytes;
+			size -= bytes;
+		}
+		return true;
+	}
+
+	bool parseJpegHuffmanTables(JpegFrame &frame, uint8_t const *data, size_t size) {
+		while (0 < size) {
+			if (17 > size) return false;
+			int const tableClass = data[0] >> 4;
+			int const id = data[0] & 15;
+			int count = 0;
+			for (int length = 1; length <= 16; ++length) count += data[length];
+			if (1 < tableClass || 3 < id || 256 < count || size < 17 + static_cast<size_t>(count)) return false;
+			if (!buildJpegHuffman(0 == tableClass ? frame.m_Dc[id] : frame.m_Ac[id], data + 1, data + 17, count)) return false;
+			data += 17 + count;
+			size -= 17 + count;
+		}
+		return true;
+	}
+
+	// fileLeft = bytes after the header, the planes are only allocated if they could hold something from there
+	bool parseJpegFrameHeader(JpegFrame &frame, uint8_t const *data, size_t size, size_t fileLeft) {
+		if (0 != frame.m_ComponentCount || 6 > size) return false; // 1 frame per file
+		frame.m_Height = static_cast<int>(readBE16(data + 1));
+		frame.m_Width = static_cast<int>(readBE16(data + 3));
+		int const count = data[5];
+		// 0 height = defined later by a DNL marker, not supported (nor is 12-bit precision)
+		if (8 != data[0] || 0 == frame.m_Width || 0 == frame.m_Height || MAX_IMAGE_SIZE < frame.m_Width || MAX_IMAGE_SIZE < frame.m_Height) return false;
+		if (MAX_IMAGE_PIXELS < static_cast<size_t>(frame.m_Width) * frame.m_Height) return false;
+		if ((1 != count && 3 != count) || size < 6 + 3 * static_cast<size_t>(count)) return false; // grey, YCbCr or RGB (no CMYK)
+
+		for (int i = 0; i < count; ++i) {
+			JpegComponent &component = frame.m_Components[i];
+			uint8_t const *entry = data + 6 + 3 * i;
+			component.m_Id = entry[0];
+			component.m_H = 1 == count ? 1 : entry[1] >> 4; // a lone component is always 1 block per MCU
+			component.m_V = 1 == count ? 1 : entry[1] & 15;
+			component.m_Quant = entry[2];
+			if (1 > component.m_H || 4 < component.m_H || 1 > component.m_V || 4 < component.m_V || 3 < component.m_Quant) return false;
+			frame.m_MaxH = std::max(frame.m_MaxH, component.m_H);
+			frame.m_MaxV = std::max(frame.m_MaxV, component.m_V);
+		}
+		frame.m_ComponentCount = count;
+		frame.m_McusPerLine = ceilDiv(frame.m_Width, 8 * frame.m_MaxH);
+		frame.m_McusPerColumn = ceilDiv(frame.m_Height, 8 * frame.m_MaxV);
+		size_t imageBlocks = 0;
+		for (int i = 0; i < count; ++i) {
+			JpegComponent &component = frame.m_Components[i];
+			component.m_Width = ceilDiv(frame.m_Width * component.m_H, frame.m_MaxH);
+			component.m_Height = ceilDiv(frame.m_Height * component.m_V, frame.m_MaxV);
+			component.m_BlocksPerLine = frame.m_McusPerLine * component.m_H;
+			component.m_BlocksPerColumn = frame.m_McusPerColumn * component.m_V;
+			imageBlocks += static_cast<size_t>(ceilDiv(component.m_Width, 8)) * ceilDiv(component.m_Height, 8);
+		}
+		// every block codes at least a 1 bit DC symbol (sequential, or the first progressive DC scan), so a file with fewer
+		// bits left than blocks is a corrupt header (or cut off before it's even grey everywhere), refused before allocating
+		if (imageBlocks / 8 > fileLeft) return false;
+
+		for (int i = 0; i < count; ++i) {
+			JpegComponent &component = frame.m_Components[i];
+			size_t const blocks = static_cast<size_t>(component.m_BlocksPerLine) * component.m_BlocksPerColumn;
+			component.m_Plane.assign(blocks * 64, 0);
+			if (frame.m_Progressive) component.m_Coefficients.assign(blocks * 64, 0);
+		}
+		return true;
+	}
+
+	bool parseJpegScanHeader(JpegFrame &frame, uint8_t const *data, size_t size, JpegScan &scan) {
+		if (1 > size) return false;
+		scan.m_Count = data[0];
+		if (1 > scan.m_Count || frame.m_ComponentCount < scan.m_Count || size < 4 + 2 * static_cast<size_t>(scan.m_Count)) return false;
+		int blocksPerMcu = 0;
+		for (int i = 0; i < scan.m_Count; ++i) {
+			int index = 0;
+			while (index < frame.m_ComponentCount && frame.m_Components[index].m_Id != data[1 + 2 * i]) ++index;
+			if (index == frame.m_ComponentCount) return false;
+			scan.m_Components[i] = index;
+			JpegComponent &component = frame.m_Components[index];
+			component.m_DcTable = data[2 + 2 * i] >> 4;
+			component.m_AcTable = data[2 + 2 * i] & 15;
+			if (3 < component.m_DcTable || 3 < component.m_AcTable) return false;
+			blocksPerMcu += component.m_H * component.m_V;
+		}
+		if (1 < scan.m_Count && 10 < blocksPerMcu) return false;
+
+		uint8_t const *parameters = data + 1 + 2 * scan.m_Count;
+		scan.m_Start = parameters[0];
+		scan.m_End = parameters[1];
+		scan.m_High = parameters[2] >> 4;
+		scan.m_Low = parameters[2] & 15;
+		if (!frame.m_Progressive) {
+			scan.m_Start = 0;
+			scan.m_End = 63;
+			scan.m_High = scan.m_Low = 0;
+		}
+		else if (scan.m_Start > scan.m_End || 63 < scan.m_End || 13 < scan.m_Low || 13 < scan.m_High || (0 == scan.m_Start && 0 != scan.m_End) || (0 < scan.m_Start && 1 != scan.m_Count)) {
+			return false; // DC and AC in separate scans, AC scans only have 1 component
+		}
+
+		// the tables this scan decodes with have to be there
+		for (int i = 0; i < scan.m_Count; ++i) {
+			JpegComponent const &component = frame.m_Components[scan.m_Components[i]];
+			bool const needsDc = 0 == scan.m_Start && 0 == scan.m_High;
+			bool const needsAc = 0 < scan.m_End;
+			if ((needsDc && !frame.m_Dc[component.m_DcTable].m_Defined) || (needsAc && !frame.m_Ac[component.m_AcTable].m_Defined)) return false;
+		}
+		return true;
+	}
+
+
+
+	// 1D 8-point inverse DCT, AAN factorisation (Arai, Agui, Nakajima; the float version in libjpeg's jidctflt.c)
+	// the inputs have to be prescaled by AAN_SCALE (done with the dequantization, see JpegFrame::m_Quant), every 8th value from in
+	void idct8(float const *in, size_t step, float *out) {
+		float const even0 = in[0] + in[4 * step];
+		float const even1 = in[0] - in[4 * step];
+		float const even3 = in[2 * step] + in[6 * step];
+		float const even2 = (in[2 * step] - in[6 * step]) * 1.414213562f - even3;
+		float const a0 = even0 + even3;
+		float const a3 = even0 - even3;
+		float const a1 = even1 + even2;
+		float const a2 = even1 - even2;
+
+		float const z13 = in[5 * step] + in[3 * step];
+		float const z10 = in[5 * step] - in[3 * step];
+		float const z11 = in[step] + in[7 * step];
+		float const z12 = in[step] - in[7 * step];
+		float const b7 = z11 + z13;
+		float const z5 = (z10 + z12) * 1.847759065f;
+		float const b6 = z5 - 2.613125930f * z10 - b7;
+		float const b5 = (z11 - z13) * 1.414213562f - b6;
+		float const b4 = 1.082392200f * z12 - z5 + b5;
+
+		out[0] = a0 + b7;
+		out[1] = a1 + b6;
+		out[2] = a2 + b5;
+		out[3] = a3 - b4;
+		out[4] = a3 + b4;
+		out[5] = a2 - b5;
+		out[6] = a1 - b6;
+		out[7] = a0 - b7;
+	}
+
+	// prescaled coefficients (natural order) -> 8x8 samples, columns then rows (a column with no AC, the common case, is just its DC)
+	void inverseDct(float const *coefficients, uint8_t *out, size_t stride) {
+		float columns[64]; // transposed: [x][y]
+		for (int x = 0; x < 8; ++x) {
+			float const *in = coefficients + x;
+			float *column = columns + 8 * x;
+			if (0.0f == in[8] && 0.0f == in[16] && 0.0f == in[24] && 0.0f == in[32] && 0.0f == in[40] && 0.0f == in[48] && 0.0f == in[56]) std::fill(column, column + 8, in[0]);
+			else idct8(in, 8, column);
+		}
+		float row[8];
+		for (int y = 0; y < 8; ++y) {
+			idct8(columns + y, 8, row);
+			for (int x = 0; x < 8; ++x) out[y * stride + x] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, row[x] + 128.5f))); // level shift, rounded
+		}
+	}
+
+	bool decodeJpegDc(JpegBitReader &in, JpegHuffman const &table, JpegComponent &component) {
+		int const category = decodeJpegSymbol(in, table);
+		if (0 > category || 11 < category) return false;
+		component.m_Dc += in.readSigned(category);
+		return -JPEG_MAX_DC < component.m_Dc && JPEG_MAX_DC > component.m_Dc;
+	}
+
+	// sequential: the whole block at once, dequantized and prescaled
+	bool decodeBaselineBlock(JpegBitReader &in, JpegFrame const &frame, JpegComponent &component, float *block) {
+		float const *quant = frame.m_Quant[component.m_Quant];
+		JpegHuffman const &ac = frame.m_Ac[component.m_AcTable];
+		std::fill(block, block + 64, 0.0f);
+		if (!decodeJpegDc(in, frame.m_Dc[component.m_DcTable], component)) return false;
+		block[0] = component.m_Dc * quant[0];
+		for (int k = 1; k < 64;) {
+			int const symbol = decodeJpegSymbol(in, ac);
+			if (0 > symbol) return false;
+			int const run = symbol >> 4;
+			int const category = symbol & 15;
+			if (0 == category) {
+				if (15 != run) break; // end of block
+				k += 16; // 16 zeros
+				continue;
+			}
+			k += run;
+			if (63 < k || 10 < category) return false;
+			block[JPEG_ZIGZAG[k]] = in.readSigned(category) * quant[k];
+			++k;
+		}
+		return true;
+	}
+
+	// progressive: 1 band (DC or a range of AC) of 1 bit plane range per scan, first pass or refinement (T.81 G.1.2)
+	bool decodeProgressiveBlock(JpegBitReader &in, JpegFrame &frame, JpegScan const &scan, JpegComponent &component, int16_t *coefficients) {
+		if (0 == scan.m_Start) {
+			if (0 == scan.m_High) {
+				if (!decodeJpegDc(in, frame.m_Dc[component.m_DcTable], component)) return false;
+				coefficients[0] = static_cast<int16_t>(component.m_Dc * (1 << scan.m_Low));
+			}
+			else if (1 == in.read(1)) {
+				coefficients[0] = static_cast<int16_t>(coefficients[0] | (1 << scan.m_Low));
+			}
+			return true;
+		}
+
+		JpegHuffman const &ac = frame.m_Ac[component.m_AcTable];
+		if (0 == scan.m_High) {
+			if (0 < frame.m_EobRun) {
+				--frame.m_EobRun;
+				return true;
+			}
+			for (int k = scan.m_Start; k <= scan.m_End;) {
+				int const symbol = decodeJpegSymbol(in, ac);
+				if (0 > symbol) return false;
+				int const run = symbol >> 4;
+				int const category = symbol & 15;
+				if (0 == category) {
+					if (15 > run) { // end of band for this block and the next (2^run - 1 + bits) blocks
+						frame.m_EobRun = (1u << run) - 1 + in.read(run);
+						break;
+					}
+					k += 16;
+					continue;
+				}
+				k += run;
+				if (scan.m_End < k) return false;
+				coefficients[JPEG_ZIGZAG[k]] = static_cast<int16_t>(in.readSigned(category) * (1 << scan.m_Low));
+				++k;
+			}
+			return true;
+		}
+
+		// refinement: every coefficient that's already nonzero gets a correction bit, new ones (+-1 in this bit) go in between
+		int const plus = 1 << scan.m_Low;
+		int const minus = -plus;
+		auto refine = [&in, plus, minus](int16_t &coefficient) {
+			if (1 == in.read(1) && 0 == (coefficient & plus)) coefficient = static_cast<int16_t>(coefficient + (0 <= coefficient ? plus : minus));
+		};
+		int k = scan.m_Start;
+		if (0 == frame.m_EobRun) {
+			for (; k <= scan.m_End; ++k) {
+				int const symbol = decodeJpegSymbol(in, ac);
+				if (0 > symbol) return false;
+				int run = symbol >> 4;
+				int const category = symbol & 15;
+				int value = 0;
+				if (0 != category) {
+					if (1 != category) return false;
+					value = 1 == in.read(1) ? plus : minus;
+				}
+				else if (15 != run) {
+					frame.m_EobRun = (1u << run) + in.read(run); // this block included
+					break;
+				}
+				// skip run zero coefficients (refining the nonzero ones on the way), the new one goes into the zero after them
+				for (; k <= scan.m_End; ++k) {
+					int16_t &coefficient = coefficients[JPEG_ZIGZAG[k]];
+					if (0 != coefficient) refine(coefficient);
+					else if (0 > --run) break;
+				}
+				if (0 != value) coefficients[JPEG_ZIGZAG[k]] = static_cast<int16_t>(value);
+			}
+		}
+		if (0 < frame.m_EobRun) {
+			// the rest of the band only has correction bits
+			for (; k <= scan.m_End; ++k) {
+				int16_t &coefficient = coefficients[JPEG_ZIGZAG[k]];
+				if (0 != coefficient) refine(coefficient);
+			}
+			--frame.m_EobRun;
+		}
+		return true;
+	}
+
+	bool decodeJpegScan(JpegFrame &frame, JpegScan const &scan, JpegBitReader &in) {
+		// 1 component: its own blocks in raster order (only the ones that cover the image), otherwise whole MCUs
+		JpegComponent const &first = frame.m_Components[scan.m_Components[0]];
+		int const mcusPerLine = 1 == scan.m_Count ? ceilDiv(first.m_Width, 8) : frame.m_McusPerLine;
+		int const mcusPerColumn = 1 == scan.m_Count ? ceilDiv(first.m_Height, 8) : frame.m_McusPerColumn;
+		int const mcuCount = mcusPerLine * mcusPerColumn;
+
+		float block[64];
+		for (int mcu = 0; mcu < mcuCount; ++mcu) {
+			if (0 == mcu || (0 < frame.m_RestartInterval && 0 == mcu % frame.m_RestartInterval)) {
+				if (0 < mcu && !in.restart()) return false;
+				for (int i = 0; i < scan.m_Count; ++i) frame.m_Components[scan.m_Components[i]].m_Dc = 0;
+				frame.m_EobRun = 0;
+			}
+			int const mcuX = mcu % mcusPerLine;
+			int const mcuY = mcu / mcusPerLine;
+			for (int i = 0; i < scan.m_Count; ++i) {
+				JpegComponent &component = frame.m_Components[scan.m_Components[i]];
+				int const h = 1 == scan.m_Count ? 1 : component.m_H;
+				int const v = 1 == scan.m_Count ? 1 : component.m_V;
+				for (int y = 0; y < v; ++y) {
+					for (int x = 0; x < h; ++x) {
+						size_t const blockIndex = static_cast<size_t>(mcuY * v + y) * component.m_BlocksPerLine + mcuX * h + x;
+						if (frame.m_Progressive) {
+							if (!decodeProgressiveBlock(in, frame, scan, component, &component.m_Coefficients[blockIndex * 64])) return false;
+							continue;
+						}
+						if (!decodeBaselineBlock(in, frame, component, block)) return false;
+						size_t const stride = static_cast<size_t>(component.m_BlocksPerLine) * 8;
+						inverseDct(block, &component.m_Plane[(mcuY * v + y) * 8 * stride + (mcuX * h + x) * 8], stride);
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	// progressive: every scan is in, dequantize and transform
+	void finishProgressive(JpegFrame &frame) {
+		float block[64];
+		for (int i = 0; i < frame.m_ComponentCount; ++i) {
+			JpegComponent &component = frame.m_Components[i];
+			float const *quant = frame.m_Quant[component.m_Quant];
+			size_t const stride = static_cast<size_t>(component.m_BlocksPerLine) * 8;
+			for (int y = 0; y < component.m_BlocksPerColumn; ++y) {
+				for (int x = 0; x < component.m_BlocksPerLine; ++x) {
+					int16_t const *coefficients = &component.m_Coefficients[(static_cast<size_t>(y) * component.m_BlocksPerLine + x) * 64];
+					for (int k = 0; k < 64; ++k) block[JPEG_ZIGZAG[k]] = coefficients[JPEG_ZIGZAG[k]] * quant[k];
+					inverseDct(block, &component.m_Plane[y * 8 * stride + x * 8], stride);
+				}
+			}
+		}
+	}
+
+	uint8_t clampToByte(int value) {
+		return static_cast<uint8_t>(0 > value ? 0 : 255 < value ? 255 : value);
+	}
+
+	// sample space position (8 fractional bits) of output pixel i's centre, for a component with factor of maxFactor samples per pixel
+	int samplePosition(int i, int factor, int maxFactor) {
+		return (2 * i + 1) * factor * 128 / maxFactor - 128;
+	}
+
+	// planes -> RGBA8, bottom row first
+	// subsampled components are upsampled linearly between sample centres (what libjpeg's "fancy" upsampling does for 2x):
+	// vertically at their own width first, then across
+	void jpegToRgba(JpegFrame const &frame, Image &out) {
+		int const width = frame.m_Width;
+		int const height = frame.m_Height;
+		out.m_Width = width;
+		out.m_Height = height;
+		out.m_Pixels.resize(static_cast<size_t>(width) * height * 4);
+
+		// per subsampled component and output column: the sample left of it and the weight (/256) of the one right of it
+		std::vector<int> left[3];
+		std::vector<int> weight[3];
+		std::vector<uint16_t> blended[3]; // 1 row, vertically blended (8 fractional bits), +1 sample so right of the last one reads it again
+		std::vector<uint8_t> rows[3];
+		for (int c = 0; c < frame.m_ComponentCount; ++c) {
+			JpegComponent const &component = frame.m_Components[c];
+			if (component.m_H == frame.m_MaxH && component.m_V == frame.m_MaxV) continue;
+			left[c].resize(width);
+			weight[c].resize(width);
+			blended[c].resize(component.m_Width + 1);
+			rows[c].resize(width);
+			for (int x = 0; x < width; ++x) {
+				int const position = samplePosition(x, component.m_H, frame.m_MaxH);
+				left[c][x] = 0 > position ? 0 : position >> 8;
+				weight[c][x] = 0 > position || left[c][x] + 1 >= component.m_Width ? 0 : position & 255;
+			}
+		}
+
+		bool const rgb = 3 == frame.m_ComponentCount && (0 == frame.m_AdobeTransform ||
+			('R' == frame.m_Components[0].m_Id && 'G' == frame.m_Components[1].m_Id && 'B' == frame.m_Components[2].m_Id));
+		for (int y = 0; y < height; ++y) {
+			uint8_t const *samples[3];
+			for (int c = 0; c < frame.m_ComponentCount; ++c) {
+				JpegComponent const &component = frame.m_Components[c];
+				size_t const stride = static_cast<size_t>(component.m_BlocksPerLine) * 8;
+				uint8_t const *plane = component.m_Plane.data();
+				if (rows[c].empty()) {
+					samples[c] = plane + y * stride;
+					continue;
+				}
+				int const position = samplePosition(y, component.m_V, frame.m_MaxV);
+				int const top = 0 > position ? 0 : position >> 8;
+				int const down = 0 > position || top + 1 >= component.m_Height ? 0 : position & 255;
+				uint8_t const *above = plane + top * stride;
+				uint8_t const *below = 0 < down ? above + stride : above;
+				uint16_t *vertical = blended[c].data();
+				for (int x = 0; x < component.m_Width; ++x) vertical[x] = static_cast<uint16_t>(above[x] * (256 - down) + below[x] * down);
+				vertical[component.m_Width] = vertical[component.m_Width - 1];
+				uint8_t *row = rows[c].data();
+				if (2 * component.m_H == frame.m_MaxH) {
+					// 2x across (4:2:0 / 4:2:2, the usual case): 3/4 of the nearest sample + 1/4 of the next one out, no tables
+					row[0] = static_cast<uint8_t>((vertical[0] + 128) >> 8);
+					for (int x = 1; x < width; ++x) {
+						int const nearest = x >> 1;
+						int const other = 0 != (x & 1) ? nearest + 1 : nearest - 1;
+						row[x] = static_cast<uint8_t>((3 * vertical[nearest] + vertical[other] + 512) >> 10);
+					}
+				}
+				else {
+					for (int x = 0; x < width; ++x) {
+						int const l = left[c][x];
+						int const w = weight[c][x];
+						row[x] = static_cast<uint8_t>((vertical[l] * (256 - w) + vertical[l + 1] * w + 32768) >> 16);
+					}
+				}
+				samples[c] = rows[c].data();
+			}
+
+			uint8_t *pixel = &out.m_Pixels[static_cast<size_t>(height - 1 - y) * width * 4];
+			if (1 == frame.m_ComponentCount) {
+				for (int x = 0; x < width; ++x, pixel += 4) {
+					pixel[0] = pixel[1] = pixel[2] = samples[0][x];
+					pixel[3] = 255;
+				}
+			}
+			else if (rgb) {
+				for (int x = 0; x < width; ++x, pixel += 4) {
+					pixel[0] = samples[0][x];
+					pixel[1] = samples[1][x];
+					pixel[2] = samples[2][x];
+					pixel[3] = 255;
+				}
+			}
+			else {
+				// JFIF YCbCr -> RGB, 16.16 fixed point
+				for (int x = 0; x < width; ++x, pixel += 4) {
+					int const luma = samples[0][x] * 65536 + 32768;
+					int const cb = samples[1][x] - 128;
+					int const cr = samples[2][x] - 128;
+					pixel[0] = clampToByte((luma + 91881 * cr) >> 16);
+					pixel[1] = clampToByte((luma - 22554 * cb - 46802 * cr) >> 16);
+					pixel[2] = clampToByte((luma + 116130 * cb) >> 16);
+					pixel[3] = 255;
+				}
+			}
+		}
+	}
+}
+
+
+
+bool zlibInflate(uint8_t const *data, size_t size, size_t maxOutput, std::vector<uint8_t> &out) {
+	out.clear();
+	if (2 > size) return false;
+	uint32_t const header = (static_cast<uint32_t>(data[0]) << 8) | data[1];
+	if (8 != (data[0] & 0x0F) || 0 != header % 31 || 0 != (data[1] & 0x20)) return false; // deflate, valid check bits, no preset dictionary
+
+	static FixedTables const s_Fixed;
+	Huffman literals;
+	Huffman distances;
+	BitReader in(data + 2, size - 2);
+	bool last = false;
+	while (!last) {
+		last = 1 == in.read(1);
+		uint32_t const type = in.read(2);
+		if (0 == type) {
+			in.alignToByte();
+			uint32_t const length = in.read(16);
+			uint32_t const check = in.read(16);
+			if ((length ^ 0xFFFF) != check || length > maxOutput - out.size() || !in.copyBytes(out, length)) return false;
+		}
+		else if (1 == type) {
+			if (!inflateCodes(in, s_Fixed.m_Literals, s_Fixed.m_Distances, maxOutput, out)) return false;
+		}
+		else if (2 == type) {
+			if (!readDynamicTables(in, literals, distances) || !inflateCodes(in, literals, distances, maxOutput, out)) return false;
+		}
+		else {
+			return false;
+		}
+		if (in.isOverrun()) return false;
+	}
+	return true; // the adler32 trailer isn't checked, PNG chunks have their own CRCs
+}
+
+
+
+bool isPng(std::vector<uint8_t> const &file) {
+	return file.size() >= sizeof(PNG_SIGNATURE) && 0 == std::memcmp(file.data(), PNG_SIGNATURE, sizeof(PNG_SIGNATURE));
+}
+
+bool decodePng(std::vector<uint8_t> const &file, Image &out) {
+	if (!isPng(file)) return false;
+
+	int width = 0;
+	int height = 0;
+	int bitDepth = 0;
+	int colorType = -1;
+	uint8_t palette[256][4];
+	std::memset(palette, 0xFF, sizeof(palette));
+	int paletteSize = 0;
+	bool hasColorKey = false;
+	uint32_t colorKey[3] = {};
+	std::vector<uint8_t> compressed;
+
+	size_t position = sizeof(PNG_SIGNATURE);
+	bool ended = false;
+	while (!ended && position + 12 <= file.size()) {
+		uint32_t const length = readBE32(&file[position]);
+		uint8_t const *type = &file[position + 4];
+		uint8_t const *data = &file[position + 8];
+		if (length > file.size() - position - 12) return false;
+
+		// chunk CRCs aren't checked, the zlib stream and the size checks catch what matters
+		if (0 == std::memcmp(type, "IHDR", 4)) {
+			if (13 > length) return false;
+			width = static_cast<int>(std::min<uint32_t>(readBE32(data), MAX_IMAGE_SIZE + 1));
+			height = static_cast<int>(std::min<uint32_t>(readBE32(data + 4), MAX_IMAGE_SIZE + 1));
+			bitDepth = data[8];
+			colorType = data[9];
+			if (0 != data[10] || 0 != data[11] || 0 != data[12]) return false; // compression / filter method, interlacing
+		}
+		else if (0 == std::memcmp(type, "PLTE", 4)) {
+			paletteSize = static_cast<int>(std::min<uint32_t>(length / 3, 256));
+			for (int i = 0; i < paletteSize; ++i) {
+				palette[i][0] = data[3 * i];
+				palette[i][1] = data[3 * i + 1];
+				palette[i][2] = data[3 * i + 2];
+			}
+		}
+		else if (0 == std::memcmp(type, "tRNS", 4)) {
+			if (3 == colorType) {
+				for (uint32_t i = 0; i < length && i < 256; ++i) palette[i][3] = data[i];
+			}
+			else if (0 == colorType && 2 <= length) {
+				hasColorKey = true;
+				colorKey[0] = (static_cast<uint32_t>(data[0]) << 8) | data[1];
+			}
+			else if (2 == colorType && 6 <= length) {
+				hasColorKey = true;
+				for (int c = 0; c < 3; ++c) colorKey[c] = (static_cast<uint32_t>(data[2 * c]) << 8) | data[2 * c + 1];
+			}
+		}
+		else if (0 == std::memcmp(type, "IDAT", 4)) {
+			compressed.insert(compressed.end(), data, data + length);
+		}
+		else if (0 == std::memcmp(type, "IEND", 4)) {
+			ended = true;
+		}
+		position += 12 + static_cast<size_t>(length);
+	}
+
+	int const channels = pngChannels(colorType);
+	if (0 >= width || 0 >= height || MAX_IMAGE_SIZE < width || MAX_IMAGE_SIZE < height) return false;
+	if (MAX_IMAGE_PIXELS < static_cast<size_t>(width) * height) return false;
+	if (0 == channels || !validPngDepth(colorType, bitDepth) || (3 == colorType && 0 == paletteSize)) return false;
+
+	size_t const bitsPerPixel = static_cast<size_t>(channels) * bitDepth;
+	size_t const rowBytes = (width * bitsPerPixel + 7) / 8;
+	size_t const pixelBytes = std::max<size_t>(1, bitsPerPixel / 8); // what the filters call "bpp"
+	size_t const rawSize = height * (rowBytes + 1); // every row starts with its filter type
+	std::vector<uint8_t> raw;
+	raw.reserve(std::min(rawSize, compressed.size() * MAX_DEFLATE_RATIO)); // grows past that only as the stream really inflates
+	if (!zlibInflate(compressed.data(), compressed.size(), rawSize, raw) || raw.size() != rawSize) return false;
+
+	out.m_Width = width;
+	out.m_Height = height;
+	out.m_Pixels.resize(static_cast<size_t>(width) * height * 4);
+	std::vector<uint8_t> const zeros(rowBytes, 0);
+	for (int y = 0; y < height; ++y) {
+		uint8_t *row = &raw[y * (rowBytes + 1) + 1];
+		uint8_t const *prior = 0 < y ? row - (rowBytes + 1) : zeros.data();
+		if (!unfilterRow(row[-1], row, prior, rowBytes, pixelBytes)) return false;
+
+		uint8_t *pixel = &out.m_Pixels[static_cast<size_t>(height - 1 - y) * width * 4]; // bottom row first
+		for (int x = 0; x < width; ++x, pixel += 4) {
+			size_t const first = static_cast<size_t>(x) * channels;
+			if (3 == colorType) {
+				std::memcpy(pixel, palette[pngSample(row, first, bitDepth)], 4);
+				continue;
+			}
+			uint32_t samples[4];
+			for (int c = 0; c < channels; ++c) samples[c] = pngSample(row, first + c, bitDepth);
+			if (0 == colorType || 4 == colorType) { // grey
+				pixel[0] = pixel[1] = pixel[2] = to8Bits(samples[0], bitDepth);
+				pixel[3] = 4 == colorType ? to8Bits(samples[1], bitDepth) : 255;
+				if (hasColorKey && samples[0] == colorKey[0]) pixel[3] = 0;
+			}
+			else {
+				for (int c = 0; c < 3; ++c) pixel[c] = to8Bits(samples[c], bitDepth);
+				pixel[3] = 6 == colorType ? to8Bits(samples[3], bitDepth) : 255;
+				if (hasColorKey && samples[0] == colorKey[0] && samples[1] == colorKey[1] && samples[2] == colorKey[2]) pixel[3] = 0;
+			}
+		}
+	}
+	return true;
+}
+
+
+
+bool isJpeg(std::vector<uint8_t> const &file) {
+	return 3 <= file.size() && 0xFF == file[0] && 0xD8 == file[1] && 0xFF == file[2];
+}
+
+bool decodeJpeg(std::vector<uint8_t> const &file, Image &out) {
+	if (!isJpeg(file)) return false;
+
+	JpegFrame frame;
+	bool scanned = false;
+	size_t position = 2;
+	while (position < file.size()) {
+		// a marker can have any number of 0xFF fill bytes in front of it
+		if (0xFF != file[position]) return false;
+		while (position < file.size() && 0xFF == file[position]) ++position;
+		if (position >= file.size()) break;
+		uint8_t const marker = file[position++];
+		if (0xD9 == marker) break; // EOI
+		if (0xD0 <= marker && 0xD7 >= marker) continue; // a stray restart marker, no payload
+
+		if (position + 2 > file.size()) return false;
+		size_t const length = readBE16(&file[position]);
+		if (2 > length || length > file.size() - position) return false;
+		uint8_t const *data = &file[position + 2];
+		size_t const size = length - 2;
+		position += length;
+
+		if (0xDB == marker) {
+			if (!parseJpegQuantTables(frame, data, size)) return false;
+		}
+		else if (0xC4 == marker) {
+			if (!parseJpegHuffmanTables(frame, data, size)) return false;
+		}
+		else if (0xDD == marker) {
+			if (2 > size) return false;
+			frame.m_RestartInterval = static_cast<int>(readBE16(data));
+		}
+		else if (0xEE == marker) {
+			if (12 <= size && 0 == std::memcmp(data, "Adobe", 5)) frame.m_AdobeTransform = data[11];
+		}
+		else if (0xC0 == marker || 0xC1 == marker || 0xC2 == marker) { // baseline, extended sequential, progressive (Huffman coded)
+			if (0 != frame.m_ComponentCount) return false;
+			frame.m_Progressive = 0xC2 == marker;
+			if (!parseJpegFrameHeader(frame, data, size, file.size() - position)) return false;
+		}
+		else if (0xC0 <= marker && 0xCF >= marker && 0xCC != marker) {
+			return false; // lossless, hierarchical or arithmetic coded
+		}
+		else if (0xDA == marker) {
+			JpegScan scan;
+			if (0 == frame.m_ComponentCount || !parseJpegScanHeader(frame, data, size, scan)) return false;
+			JpegBitReader in(file.data(), file.size(), position);
+			if (!decodeJpegScan(frame, scan, in)) return false;
+			position = in.skipToMarker(); // a file cut off in the middle of a scan ends here, with what's decoded so far
+			scanned = true;
+		}
+		// anything else (APPn, COM, ...) isn't needed
+	}
+	if (!scanned) return false;
+
+	if (frame.m_Progressive) finishProgressive(frame);
+	jpegToRgba(frame, out);
+	return true;
+}
+
+
+
+bool decodeImage(std::vector<uint8_t> const &file, Image &out) {
+	if (isPng(file)) return decodePng(file, out);
+	if (isJpeg(file)) return decodeJpeg(file, out);
+	return false;
+}
+
+
+
+void encodePng(Image const &image, std::vector<uint8_t> &file) {
+	size_t const rowBytes = static_cast<size_t>(image.m_Width) * 4;
+	std::vector<uint8_t> raw;
+	raw.reserve(image.m_Height * (rowBytes + 1));
+
+	// per row, the filter with the smallest sum of |signed residuals| (the usual heuristic)
+	std::vector<uint8_t> const zeros(rowBytes, 0);
+	std::vector<uint8_t> candidates[5];
+	for (std::vector<uint8_t> &candidate : candidates) candidate.resize(rowBytes);
+	for (int y = 0; y < image.m_Height; ++y) {
+		uint8_t const *row = &image.m_Pixels[static_cast<size_t>(image.m_Height - 1 - y) * rowBytes]; // PNG is top row first
+		uint8_t const *prior = 0 < y ? row + rowBytes : zeros.data();
+		int bestFilter = 0;
+		uint64_t bestCost = UINT64_MAX;
+		for (int filter = 0; filter < 5; ++filter) {
+			uint8_t *residuals = candidates[filter].data();
+			uint64_t cost = 0;
+			for (size_t i = 0; i < rowBytes; ++i) {
+				int const left = i >= 4 ? row[i - 4] : 0;
+				int const upLeft = i >= 4 ? prior[i - 4] : 0;
+				int predicted = 0;
+				if (1 == filter) predicted = left;
+				else if (2 == filter) predicted = prior[i];
+				else if (3 == filter) predicted = (left + prior[i]) >> 1;
+				else if (4 == filter) predicted = paeth(left, prior[i], upLeft);
+				residuals[i] = static_cast<uint8_t>(row[i] - predicted);
+				cost += static_cast<uint64_t>(std::abs(static_cast<int8_t>(residuals[i])));
+			}
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestFilter = filter;
+			}
+		}
+		raw.push_back(static_cast<uint8_t>(bestFilter));
+		raw.insert(raw.end(), candidates[bestFilter].begin(), candidates[bestFilter].end());
+	}
+
+	file.assign(PNG_SIGNATURE, PNG_SIGNATURE + sizeof(PNG_SIGNATURE));
+	std::vector<uint8_t> header;
+	writeBE32(header, static_cast<uint32_t>(image.m_Width));
+	writeBE32(header, static_cast<uint32_t>(image.m_Height));
+	uint8_t const format[5] = { 8, 6, 0, 0, 0 }; // 8 bits, RGBA, deflate, adaptive filters, not interlaced
+	header.insert(header.end(), format, format + 5);
+	writeChunk(file, "IHDR", header);
+
+	std::vector<uint8_t> compressed;
+	zlibDeflate(raw, compressed);
+	writeChunk(file, "IDAT", compressed);
+	writeChunk(file, "IEND", std::vector<uint8_t>());
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// image file decoding (and a small encoder) for the texture import path, no GL involved so it can run on any thread
+// - everything decodes to 8-bit RGBA, rows bottom first (the order glTexImage2D() expects)
+// - PNG is built in: the zlib/deflate stream is inflated here (there's no image or zlib library in middleware/)
+//   all colour types and bit depths, 16-bit channels are cut to their high byte, tRNS is applied, interlaced (Adam7) files are refused
+// - JPEG is built in too: baseline, extended and progressive Huffman-coded files, greyscale / YCbCr / RGB, any chroma subsampling
+//   (upsampled linearly between sample centres, like libjpeg's "fancy" upsampling); arithmetic coding, 12-bit, lossless and CMYK are refused
+// - decodeImage() picks the decoder from the file's signature
+
+
+
+struct Image {
+	int m_Width = 0;
+	int m_Height = 0;
+	std::vector<uint8_t> m_Pixels; // RGBA8, tightly packed, bottom row first
+};
+
+// file bytes -> Image, false = not this format or broken (must be safe to call from several threads at once)
+typedef std::function<bool(std::vector<uint8_t> const &file, Image &out)> ImageDecoder;
+
+// largest width/height and width * height (256MB of RGBA8) accepted, so a corrupt header can't ask for gigabytes
+// - on top of that the decoders only size their buffers for what the file's data could fill, a tiny file claiming the maximum
+//   is refused (JPEG), a PNG buffer only grows past that as the stream really inflates
+int const MAX_IMAGE_SIZE = 16384;
+size_t const MAX_IMAGE_PIXELS = 64 * 1024 * 1024;
+
+bool isPng(std::vector<uint8_t> const &file);
+bool decodePng(std::vector<uint8_t> const &file, Image &out);
+
+bool isJpeg(std::vector<uint8_t> const &file);
+bool decodeJpeg(std::vector<uint8_t> const &file, Image &out);
+
+// PNG or JPEG, whichever the file is
+bool decodeImage(std::vector<uint8_t> const &file, Image &out);
+
+// RGBA8 PNG with per-row adaptive filters and fixed-Huffman deflate (fast rather than small: for tools, caches and benchmarks)
+void encodePng(Image const &image, std::vector<uint8_t> &file);
+
+// zlib stream (RFC 1950/1951) -> bytes, fails if the output would be longer than maxOutput
+bool zlibInflate(uint8_t const *data, size_t size, size_t maxOutput, std::vector<uint8_t> &out);
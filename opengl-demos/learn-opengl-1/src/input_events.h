@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// input/window events, decoupled from the GLFW callbacks
+// - the callbacks only push a timestamped InputEvent (no GL calls, so they don't care which thread has the context)
+// - the frame drains the queue at 1 fixed point and applies the events there (see processInputEvents() in main.cpp)
+// - the timestamps are when GLFW delivered the event, so (present time - m_Time) is the input-to-photon latency
+
+
+
+// lock-free ring for exactly 1 producer thread and 1 consumer thread
+template <typename T, size_t CAPACITY>
+class SpscQueue {
+	static_assert(0 == (CAPACITY & (CAPACITY - 1)), "CAPACITY must be a power of 2");
+
+public:
+	// producer only, false (and the item is dropped) when full
+	bool push(T const &item) {
+		size_t const tail = m_Tail.load(std::memory_order_relaxed);
+		if (CAPACITY == tail - m_CachedHead) {
+			m_CachedHead = m_Head.load(std::memory_order_acquire);
+			if (CAPACITY == tail - m_CachedHead) return false;
+		}
+		m_Items[tail & (CAPACITY - 1)] = item;
+		m_Tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer only, false when empty
+	bool pop(T &item) {
+		size_t const head = m_Head.load(std::memory_order_relaxed);
+		if (head == m_CachedTail) {
+			m_CachedTail = m_Tail.load(std::memory_order_acquire);
+			if (head == m_CachedTail) return false;
+		}
+		item = m_Items[head & (CAPACITY - 1)];
+		m_Head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	// the consumer's and the producer's halves on separate cache lines, each side keeps a cached copy of the other's index
+	// so it only touches the other side's line when the queue looks full/empty
+	std::atomic<size_t> m_Head{ 0 };
+	size_t m_CachedTail = 0;
+	char m_ConsumerPadding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+	std::atomic<size_t> m_Tail{ 0 };
+	size_t m_CachedHead = 0;
+	char m_ProducerPadding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+	T m_Items[CAPACITY];
+};
+
+
+
+enum class InputEventType : uint8_t {
+	Key, // glfwSetKeyCallback
+	FramebufferSize // glfwSetFramebufferSizeCallback
+};
+
+struct InputEvent {
+	InputEventType m_Type;
+	int64_t m_Time; // inputTimestamp() when the callback ran
+
+	// Key
+	int m_Key;
+	int m_Scancode;
+	int m_Action;
+	int m_Mods;
+
+	// FramebufferSize
+	int m_Width;
+	int m_Height;
+};
+
+// nanoseconds on a monotonic clock, for event timestamps and latency measurements
+inline int64_t inputTimestamp() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+typedef SpscQueue<InputEvent, 256> InputEventQueue; // way more than can pile up between 2 frames
@@ -0,0 +1,233 @@
+#include "job_system.h"
+
+#include <algorithm>
+
+
+
+namespace {
+	// which JobSystem (if any) the current thread belongs to, and its index in there
+	thread_local JobSystem const *t_System = nullptr;
+	thread_local unsigned int t_Index = 0;
+
+	int const IDLE_SPINS = 64; // failed findJob()s before a worker goes to sleep
+
+	uint32_t xorshift(uint32_t &state) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+}
+
+
+
+bool JobSystem::WorkStealingDeque::push(Job *job) {
+	int64_t const bottom = m_Bottom.load(std::memory_order_relaxed);
+	int64_t const top = m_Top.load(std::memory_order_acquire);
+	if (static_cast<int64_t>(CAPACITY) <= bottom - top) return false;
+
+	m_Jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+	m_Bottom.store(bottom + 1, std::memory_order_release); // publishes the job (and everything written to it) to steal()
+	return true;
+}
+
+JobSystem::Job *JobSystem::WorkStealingDeque::pop() {
+	int64_t const bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+	m_Bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_Top.load(std::memory_order_relaxed);
+
+	if (bottom < top) {
+		// empty
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job *job = m_Jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (top == bottom) {
+		// last job, race the thieves for it
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+JobSystem::Job *JobSystem::WorkStealingDeque::steal() {
+	int64_t top = m_Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t const bottom = m_Bottom.load(std::memory_order_acquire);
+	if (bottom <= top) return nullptr;
+
+	Job *job = m_Jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr; // lost to another thief or the owner
+	return job;
+}
+
+
+
+JobSystem::JobSystem(unsigned int threadCount) {
+	if (0 == threadCount) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	for (unsigned int i = 0; i < threadCount; ++i) {
+		ThreadState *state = new ThreadState();
+		state->m_JobPool = std::vector<Job>(WorkStealingDeque::CAPACITY);
+		state->m_Random = 0x9E3779B9u * (i + 1);
+		m_Threads.push_back(state);
+	}
+
+	// the creating thread is thread 0
+	t_System = this;
+	t_Index = 0;
+
+	for (unsigned int i = 1; i < threadCount; ++i) m_Threads[i]->m_Thread = std::thread(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_Quit.store(true);
+	}
+	m_SleepCondition.notify_all();
+
+	// every worker has to be gone before any state goes, they steal from each other's deques until they quit
+	for (ThreadState *state : m_Threads) {
+		if (state->m_Thread.joinable()) state->m_Thread.join();
+	}
+	for (ThreadState *state : m_Threads) delete state;
+	if (this == t_System) t_System = nullptr;
+}
+
+
+
+unsigned int JobSystem::currentThreadIndex() const {
+	return this == t_System ? t_Index : getThreadCount();
+}
+
+void JobSystem::run(JobCounter &counter, std::function<void(void)> task) {
+	counter.m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+	unsigned int const index = currentThreadIndex();
+	if (getThreadCount() <= index) {
+		// not one of ours, there's no deque to push to
+		task();
+		counter.m_Pending.fetch_sub(1, std::memory_order_release);
+		return;
+	}
+
+	ThreadState &state = *m_Threads[index];
+	Job &job = state.m_JobPool[state.m_NextJob];
+	if (job.m_InUse.load(std::memory_order_acquire)) {
+		// the whole ring is still queued or running, so the deque is as good as full: do it now instead (back-pressure)
+		task();
+		counter.m_Pending.fetch_sub(1, std::memory_order_release);
+		return;
+	}
+	state.m_NextJob = (state.m_NextJob + 1) & (WorkStealingDeque::CAPACITY - 1);
+
+	job.m_Task = std::move(task);
+	job.m_Counter = &counter;
+	job.m_InUse.store(true, std::memory_order_relaxed);
+	if (!state.m_Deque.push(&job)) {
+		execute(&job);
+		return;
+	}
+
+	// seq_cst on both sides (here and in workerLoop) so either the sleeper sees the job or we see the sleeper
+	m_Queued.fetch_add(1, std::memory_order_seq_cst);
+	if (0 < m_Sleeping.load(std::memory_order_seq_cst)) {
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_SleepCondition.notify_one();
+	}
+}
+
+void JobSystem::wait(JobCounter &counter) {
+	unsigned int const index = currentThreadIndex();
+	while (!counter.isDone()) {
+		Job *job = getThreadCount() > index ? findJob(index) : nullptr;
+		if (nullptr != job) execute(job);
+		else std::this_thread::yield();
+	}
+}
+
+void JobSystem::parallelFor(size_t count, std::function<void(size_t begin, size_t end)> const &body, size_t minGrain) {
+	if (0 == count) return;
+
+	// a few chunks per thread so threads that finish early can steal the rest
+	size_t const maxChunks = std::max<size_t>(1, count / std::max<size_t>(1, minGrain));
+	size_t const chunks = std::min<size_t>(maxChunks, 4 * getThreadCount());
+	if (1 == chunks || getThreadCount() <= currentThreadIndex()) {
+		body(0, count);
+		return;
+	}
+
+	// the lambdas only capture a pointer + an index, small enough for std::function not to allocate
+	struct Range {
+		std::function<void(size_t, size_t)> const *m_Body;
+		size_t m_Count;
+		size_t m_Chunks;
+		void runChunk(size_t chunk) const { (*m_Body)(m_Count * chunk / m_Chunks, m_Count * (chunk + 1) / m_Chunks); }
+	};
+	Range const range = { &body, count, chunks };
+
+	JobCounter counter;
+	for (size_t chunk = 1; chunk < chunks; ++chunk) {
+		Range const *r = &range;
+		run(counter, [r, chunk]() { r->runChunk(chunk); });
+	}
+	range.runChunk(0);
+	wait(counter);
+}
+
+
+
+JobSystem::Job *JobSystem::findJob(unsigned int index) {
+	ThreadState &state = *m_Threads[index];
+	Job *job = state.m_Deque.pop();
+
+	if (nullptr == job && 1 < m_Threads.size()) {
+		// try every other thread once, starting at a random one
+		unsigned int const threadCount = getThreadCount();
+		unsigned int const first = xorshift(state.m_Random) % threadCount;
+		for (unsigned int i = 0; i < threadCount && nullptr == job; ++i) {
+			unsigned int const victim = (first + i) % threadCount;
+			if (victim != index) job = m_Threads[victim]->m_Deque.steal();
+		}
+	}
+
+	if (nullptr != job) m_Queued.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+void JobSystem::execute(Job *job) {
+	JobCounter *counter = job->m_Counter;
+	job->m_Task();
+	job->m_Task = nullptr; // release the captures now, not when the slot comes around again
+	job->m_InUse.store(false, std::memory_order_release);
+	counter->m_Pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(unsigned int index) {
+	t_System = this;
+	t_Index = index;
+
+	int idle = 0;
+	while (!m_Quit.load(std::memory_order_relaxed)) {
+		Job *job = findJob(index);
+		if (nullptr != job) {
+			execute(job);
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < IDLE_SPINS) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_Sleeping.fetch_add(1, std::memory_order_seq_cst);
+		m_SleepCondition.wait(lock, [this]() { return m_Quit.load() || 0 < m_Queued.load(std::memory_order_seq_cst); });
+		m_Sleeping.fetch_sub(1, std::memory_order_relaxed);
+		idle = 0;
+	}
+}
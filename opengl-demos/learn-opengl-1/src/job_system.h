@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// work-stealing job system for per-frame work (transform propagation, culling, animation, command recording, ...)
+// - 1 Chase-Lev deque per thread: the owner pushes/pops at the bottom (LIFO, cache-warm), idle threads steal from the top (FIFO)
+// - dependencies are JobCounters: run() bumps one, finishing the job drops it, wait() blocks on it
+//   (a job can run() children on another counter and wait() for them, which gives parent/child and stage-by-stage graphs)
+// - wait() never just blocks, it keeps executing queued jobs until its counter reaches 0
+// - the thread that creates the JobSystem is thread 0 and takes part in the work whenever it waits
+// - run() / parallelFor() / wait() may only be called from that thread or from inside a job, anything else runs inline
+
+
+
+class JobCounter {
+public:
+	bool isDone() const { return 0 == m_Pending.load(std::memory_order_acquire); }
+
+private:
+	friend class JobSystem;
+	std::atomic<int> m_Pending{ 0 };
+};
+
+
+
+class JobSystem {
+public:
+	// threadCount includes the calling thread, 0 = 1 per hardware thread
+	explicit JobSystem(unsigned int threadCount = 0);
+	~JobSystem();
+
+	JobSystem(JobSystem const &) = delete;
+	JobSystem &operator=(JobSystem const &) = delete;
+
+	unsigned int getThreadCount() const { return static_cast<unsigned int>(m_Threads.size()); }
+
+	// queue task on the calling thread's deque (runs it right away if the deque or job pool is full)
+	void run(JobCounter &counter, std::function<void(void)> task);
+
+	// execute queued jobs until counter reaches 0
+	void wait(JobCounter &counter);
+
+	// body(begin, end) over chunks of at least minGrain elements covering [0, count), returns when all of them are done
+	// same signature as ParallelForFn (scene_graph.h), e.g. graph.update([&jobs](size_t n, ...body) { jobs.parallelFor(n, body); })
+	void parallelFor(size_t count, std::function<void(size_t begin, size_t end)> const &body, size_t minGrain = 64);
+
+private:
+	struct Job {
+		std::function<void(void)> m_Task;
+		JobCounter *m_Counter = nullptr;
+		std::atomic<bool> m_InUse{ false }; // until its task has finished, then the slot can be reused
+	};
+
+	// Chase-Lev deque with a fixed capacity ("Correct and Efficient Work-Stealing for Weak Memory Models", Le et al. 2013)
+	class WorkStealingDeque {
+	public:
+		static size_t const CAPACITY = 4096; // power of 2
+
+		bool push(Job *job); // owner only, false when full
+		Job *pop(); // owner only
+		Job *steal(); // any thread
+
+	private:
+		// top is written by thieves and bottom by the owner, so keep them on separate cache lines
+		std::atomic<int64_t> m_Top{ 0 };
+		char m_TopPadding[64 - sizeof(std::atomic<int64_t>)];
+		std::atomic<int64_t> m_Bottom{ 0 };
+		char m_BottomPadding[64 - sizeof(std::atomic<int64_t>)];
+		std::atomic<Job*> m_Jobs[CAPACITY];
+	};
+
+	// everything 1 thread owns (allocated separately, so different threads' states don't share cache lines)
+	struct ThreadState {
+		WorkStealingDeque m_Deque;
+		std::vector<Job> m_JobPool; // ring of WorkStealingDeque::CAPACITY jobs
+		size_t m_NextJob = 0;
+		uint32_t m_Random = 0; // xorshift state for picking steal victims
+		std::thread m_Thread; // not used for thread 0
+	};
+
+	void workerLoop(unsigned int index);
+	Job *findJob(unsigned int index);
+	void execute(Job *job);
+	unsigned int currentThreadIndex() const; // getThreadCount() for threads that don't belong to this system
+
+	std::vector<ThreadState *> m_Threads;
+
+	// idle workers sleep here, run() only takes the mutex when someone is sleeping
+	std::mutex m_SleepMutex;
+	std::condition_variable m_SleepCondition;
+	std::atomic<int> m_Queued{ 0 };
+	std::atomic<int> m_Sleeping{ 0 };
+	std::atomic<bool> m_Quit{ false };
+};
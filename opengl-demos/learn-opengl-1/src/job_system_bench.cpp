@@ -0,0 +1,125 @@
+#include "benchmarks.h"
+#include "job_system.h"
+#include "scene_graph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+
+// scaling from 1 thread up to every hardware thread for
+// - parallelFor over a compute-bound loop
+// - SceneGraph::update() propagating a 100k node hierarchy through JobSystem::parallelFor
+// - the overhead of queueing + running empty jobs
+// results are checked against a serial run
+
+
+
+namespace {
+	size_t const BENCH_ELEMENTS = 1 << 22;
+	size_t const BENCH_NODES = 100000;
+	size_t const BENCH_FANOUT = 8;
+	int const BENCH_EMPTY_JOBS = 100000;
+
+	void computeKernel(std::vector<float> &out, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			float const x = static_cast<float>(i) * 1e-4f;
+			out[i] = std::sin(x) * std::cos(0.5f * x) + std::sqrt(x);
+		}
+	}
+
+	// run fn until ~0.25s has been measured, returns ms per call
+	template <typename Fn>
+	double measureMs(Fn fn) {
+		int calls = 0;
+		double const start = benchSeconds();
+		double elapsed = 0.0;
+		do {
+			fn();
+			++calls;
+			elapsed = benchSeconds() - start;
+		} while (elapsed < 0.25);
+		return elapsed / calls * 1e3;
+	}
+
+	void buildGraph(SceneGraph &graph) {
+		std::mt19937 rng(31);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		for (size_t i = 0; i < BENCH_NODES; ++i) {
+			SceneNodeId const parent = 0 == i ? INVALID_SCENE_NODE : static_cast<SceneNodeId>((i - 1) / BENCH_FANOUT);
+			graph.createNode(parent, AffineTransform::fromTRS(glm::vec3(unit(rng), unit(rng), unit(rng)), glm::vec3(unit(rng), unit(rng), 1.0f), unit(rng), glm::vec3(1.0f)));
+		}
+	}
+}
+
+
+
+int jobSystemBenchMain() {
+	unsigned int const maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<unsigned int> threadCounts;
+	for (unsigned int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+	threadCounts.push_back(maxThreads);
+
+	// serial references
+	std::vector<float> reference(BENCH_ELEMENTS);
+	computeKernel(reference, 0, BENCH_ELEMENTS);
+	SceneGraph referenceGraph;
+	buildGraph(referenceGraph);
+	referenceGraph.setLocalTransform(0, AffineTransform::rotation(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)));
+	referenceGraph.update();
+
+	std::printf("%8s %14s %8s %14s %8s %14s\n", "threads", "parallelFor ms", "speedup", "propagate ms", "speedup", "empty job ns");
+	double baseFor = 0.0;
+	double basePropagate = 0.0;
+	bool allMatch = true;
+	std::vector<float> out(BENCH_ELEMENTS);
+
+	for (unsigned int const threads : threadCounts) {
+		JobSystem jobs(threads);
+		auto const parallelFor = [&jobs](size_t count, std::function<void(size_t, size_t)> const &body) { jobs.parallelFor(count, body, 256); };
+
+		double const forMs = measureMs([&]() {
+			jobs.parallelFor(BENCH_ELEMENTS, [&out](size_t begin, size_t end) { computeKernel(out, begin, end); }, 4096);
+		});
+		allMatch = allMatch && 0 == std::memcmp(out.data(), reference.data(), BENCH_ELEMENTS * sizeof(float));
+
+		// moving the root makes every node dirty, so this is a full propagation through the incremental path
+		SceneGraph graph;
+		buildGraph(graph);
+		graph.update(parallelFor);
+		float angle = 0.0f;
+		double const propagateMs = measureMs([&]() {
+			angle += 0.01f;
+			graph.setLocalTransform(0, AffineTransform::rotation(angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+			graph.update(parallelFor);
+		});
+		graph.setLocalTransform(0, AffineTransform::rotation(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)));
+		graph.update(parallelFor);
+		for (SceneNodeId node = 0; node < BENCH_NODES; ++node) {
+			if (0 != std::memcmp(&graph.getWorldTransform(node), &referenceGraph.getWorldTransform(node), sizeof(AffineTransform))) {
+				allMatch = false;
+				break;
+			}
+		}
+
+		double const start = benchSeconds();
+		JobCounter counter;
+		for (int i = 0; i < BENCH_EMPTY_JOBS; ++i) jobs.run(counter, []() {});
+		jobs.wait(counter);
+		double const emptyNs = (benchSeconds() - start) / BENCH_EMPTY_JOBS * 1e9;
+
+		if (1 == threads) {
+			baseFor = forMs;
+			basePropagate = propagateMs;
+		}
+		std::printf("%8u %14.2f %8.2f %14.2f %8.2f %14.1f\n", threads, forMs, baseFor / forMs, propagateMs, basePropagate / propagateMs, emptyNs);
+	}
+
+	if (!allMatch) std::printf("MISMATCH: parallel results differ from the serial ones\n");
+	return allMatch ? 0 : -1;
+}
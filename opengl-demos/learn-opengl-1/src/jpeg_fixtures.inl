@@ -0,0 +1,147 @@
+// small JPEG files for textureImportBenchMain() to decode, each with the RGB pixels libjpeg decodes it to (float IDCT, fancy
+// upsampling), rows top first
+// - encoded by libjpeg (quality 80, optimized Huffman tables, no JFIF marker) from a gradient with a hard diagonal colour edge, so
+//   the IDCT, chroma upsampling and colour conversion all show up in the pixels
+// - decodeJpeg() isn't bit exact with libjpeg (different IDCT rounding), the bench allows JPEG_FIXTURE_TOLERANCE per channel
+
+// baseline, 4:4:4, restart interval 1 MCU, 16x8
+uint8_t const JPEG_BASELINE_444_RESTART[377] = {
+	0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x06, 0x04, 0x05, 0x06, 0x05, 0x04, 0x06, 0x06, 0x05, 0x06, 0x07, 0x07, 0x06,
+	0x08, 0x0A, 0x10, 0x0A, 0x0A, 0x09, 0x09, 0x0A, 0x14, 0x0E, 0x0F, 0x0C, 0x10, 0x17, 0x14, 0x18, 0x18, 0x17, 0x14, 0x16,
+	0x16, 0x1A, 0x1D, 0x25, 0x1F, 0x1A, 0x1B, 0x23, 0x1C, 0x16, 0x16, 0x20, 0x2C, 0x20, 0x23, 0x26, 0x27, 0x29, 0x2A, 0x29,
+	0x19, 0x1F, 0x2D, 0x30, 0x2D, 0x28, 0x30, 0x25, 0x28, 0x29, 0x28, 0xFF, 0xDB, 0x00, 0x43, 0x01, 0x07, 0x07, 0x07, 0x0A,
+	0x08, 0x0A, 0x13, 0x0A, 0x0A, 0x13, 0x28, 0x1A, 0x16, 0x1A, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0xFF, 0xC0, 0x00, 0x11, 0x08, 0x00, 0x08, 0x00, 0x10, 0x03, 0x01, 0x11, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xFF,
+	0xC4, 0x00, 0x14, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x04, 0xFF, 0xC4, 0x00, 0x1E, 0x10, 0x00, 0x01, 0x04, 0x01, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0x00, 0x04, 0x05, 0x11, 0x02, 0x06, 0x15, 0x21, 0x31, 0x61, 0xFF, 0xC4, 0x00, 0x15, 0x01, 0x01, 0x01,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x06, 0xFF, 0xC4, 0x00, 0x29,
+	0x11, 0x00, 0x00, 0x03, 0x03, 0x0B, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03,
+	0x00, 0x04, 0x05, 0x06, 0x11, 0x12, 0x13, 0x21, 0x31, 0x41, 0x61, 0xA1, 0xE1, 0xF0, 0x22, 0x51, 0x81, 0x91, 0xC1, 0xFF,
+	0xDD, 0x00, 0x04, 0x00, 0x01, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00, 0x7C,
+	0xCB, 0xFD, 0xAE, 0x24, 0x37, 0x6A, 0x28, 0xD5, 0x13, 0xD0, 0x09, 0xE5, 0x7E, 0x4C, 0x55, 0xA6, 0xA9, 0xBC, 0x63, 0xCC,
+	0xEE, 0x68, 0x99, 0x2D, 0x05, 0x79, 0x8B, 0x2F, 0x58, 0x52, 0xCE, 0x1D, 0xF0, 0xF7, 0xF2, 0xFC, 0x9B, 0xFF, 0xD0, 0x3E,
+	0x82, 0x83, 0xCE, 0x52, 0x50, 0x39, 0x73, 0x79, 0xF3, 0x7E, 0x26, 0xC5, 0x65, 0x01, 0xC1, 0x3A, 0xB4, 0xBA, 0x43, 0x5D,
+	0xB9, 0x6B, 0x57, 0x3C, 0x3B, 0xA3, 0x0C, 0x40, 0x08, 0x61, 0x9C, 0xDA, 0x6F, 0xCB, 0x1B, 0xFF, 0xD9,
+};
+uint8_t const JPEG_BASELINE_444_RESTART_RGB[384] = {
+	21, 123, 198, 36, 157, 202, 42, 201, 204, 35, 232, 204, 47, 239, 202, 74, 221, 203, 89, 191, 205, 84, 166, 204, 112, 115, 194, 111, 85, 195, 115, 52, 205, 128, 33, 213, 141, 29, 201, 150, 41, 184, 157, 72, 193, 163, 100, 214,
+	30, 158, 187, 29, 187, 196, 38, 213, 198, 59, 219, 195, 69, 217, 193, 71, 207, 197, 76, 176, 191, 85, 143, 180, 101, 99, 200, 102, 70, 195, 117, 38, 189, 132, 24, 188, 131, 34, 199, 133, 61, 199, 175, 91, 168, 229, 113, 132,
+	26, 183, 174, 34, 199, 193, 40, 221, 190, 42, 231, 163, 57, 220, 165, 78, 185, 191, 91, 144, 196, 91, 115, 175, 88, 73, 200, 109, 48, 177, 126, 28, 177, 134, 29, 191, 156, 46, 171, 194, 73, 127, 218, 114, 115, 222, 150, 136,
+	10, 194, 204, 26, 216, 168, 39, 234, 156, 45, 229, 175, 56, 205, 173, 75, 168, 157, 84, 122, 171, 82, 86, 209, 110, 45, 161, 107, 39, 184, 140, 31, 174, 203, 32, 126, 234, 55, 97, 219, 98, 113, 208, 144, 134, 217, 171, 135,
+	1, 225, 171, 27, 225, 189, 47, 225, 189, 51, 214, 171, 59, 178, 159, 77, 129, 168, 85, 94, 169, 78, 81, 158, 117, 43, 166, 174, 28, 113, 220, 26, 87, 223, 47, 109, 216, 84, 124, 222, 120, 115, 221, 159, 122, 210, 187, 145,
+	56, 214, 130, 17, 230, 176, 14, 223, 194, 56, 184, 171, 73, 145, 157, 69, 118, 161, 112, 85, 140, 179, 53, 100, 205, 28, 80, 197, 34, 101, 204, 46, 107, 219, 66, 97, 212, 103, 109, 194, 147, 137, 204, 181, 139, 232, 196, 118,
+	15, 225, 164, 62, 204, 120, 69, 190, 123, 39, 179, 166, 75, 143, 154, 171, 85, 86, 218, 49, 68, 199, 45, 105, 222, 25, 70, 219, 38, 83, 202, 62, 111, 186, 97, 129, 191, 132, 116, 214, 166, 100, 215, 199, 114, 202, 220, 144,
+	2, 237, 158, 13, 222, 157, 72, 186, 124, 159, 142, 73, 206, 103, 58, 202, 76, 79, 200, 46, 80, 215, 23, 60, 192, 29, 108, 206, 44, 103, 218, 72, 95, 217, 110, 94, 201, 154, 108, 187, 194, 126, 194, 219, 128, 208, 227, 119,
+};
+
+// baseline, 4:2:0, 20x12 (partial MCUs at the right and bottom)
+uint8_t const JPEG_BASELINE_420[406] = {
+	0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x06, 0x04, 0x05, 0x06, 0x05, 0x04, 0x06, 0x06, 0x05, 0x06, 0x07, 0x07, 0x06,
+	0x08, 0x0A, 0x10, 0x0A, 0x0A, 0x09, 0x09, 0x0A, 0x14, 0x0E, 0x0F, 0x0C, 0x10, 0x17, 0x14, 0x18, 0x18, 0x17, 0x14, 0x16,
+	0x16, 0x1A, 0x1D, 0x25, 0x1F, 0x1A, 0x1B, 0x23, 0x1C, 0x16, 0x16, 0x20, 0x2C, 0x20, 0x23, 0x26, 0x27, 0x29, 0x2A, 0x29,
+	0x19, 0x1F, 0x2D, 0x30, 0x2D, 0x28, 0x30, 0x25, 0x28, 0x29, 0x28, 0xFF, 0xDB, 0x00, 0x43, 0x01, 0x07, 0x07, 0x07, 0x0A,
+	0x08, 0x0A, 0x13, 0x0A, 0x0A, 0x13, 0x28, 0x1A, 0x16, 0x1A, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0xFF, 0xC0, 0x00, 0x11, 0x08, 0x00, 0x0C, 0x00, 0x14, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xFF,
+	0xC4, 0x00, 0x18, 0x00, 0x00, 0x03, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x04, 0x07, 0x05, 0x06, 0xFF, 0xC4, 0x00, 0x24, 0x10, 0x00, 0x01, 0x03, 0x04, 0x02, 0x00, 0x07, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x04, 0x05, 0x02, 0x03, 0x06, 0x11, 0x12, 0x31, 0x13, 0x21, 0x22, 0x23,
+	0x25, 0x41, 0x42, 0xFF, 0xC4, 0x00, 0x17, 0x01, 0x00, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x04, 0x05, 0xFF, 0xC4, 0x00, 0x21, 0x11, 0x00, 0x02, 0x02, 0x01, 0x03, 0x05, 0x01,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x05, 0x00, 0x21, 0x31, 0x41, 0x04, 0x11, 0x12,
+	0x23, 0x51, 0xA1, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00, 0x66, 0x7E, 0x5A,
+	0xDC, 0x34, 0x4D, 0x2D, 0xAC, 0x1F, 0x59, 0x1A, 0x00, 0x76, 0xB2, 0x30, 0x08, 0x4B, 0xF3, 0x12, 0x81, 0xD3, 0xA0, 0x45,
+	0x1B, 0xDF, 0x9F, 0x69, 0x1C, 0xA4, 0xFC, 0xB8, 0xB5, 0xF9, 0xDE, 0x89, 0xFB, 0x2A, 0xAD, 0x84, 0xB7, 0xB6, 0xD6, 0x13,
+	0xC4, 0xB3, 0x4E, 0xAA, 0xE3, 0xDA, 0x49, 0x6F, 0xA4, 0x8F, 0xA6, 0xF4, 0x8E, 0xC5, 0xB9, 0xE7, 0x28, 0xAB, 0xA7, 0x14,
+	0x95, 0xA2, 0x57, 0x3E, 0x52, 0x3F, 0xCD, 0xB5, 0xFD, 0xCE, 0x8E, 0xA9, 0x26, 0xB1, 0xA2, 0x86, 0xC0, 0x81, 0xC2, 0x90,
+	0x85, 0x1F, 0xC9, 0x65, 0x1D, 0x19, 0x7B, 0xDE, 0xE2, 0x11, 0x15, 0x41, 0x91, 0x03, 0xB3, 0x6A, 0x73, 0x6A, 0x2A, 0x85,
+	0x74, 0x0C, 0x4E, 0xF9, 0xFF, 0xD9,
+};
+uint8_t const JPEG_BASELINE_420_RGB[720] = {
+	8, 145, 163, 25, 174, 181, 36, 208, 194, 49, 223, 198, 65, 221, 197, 85, 210, 196, 100, 182, 194, 111, 155, 194, 108, 120, 194, 112, 87, 191, 118, 52, 186, 128, 33, 185, 139, 28, 184, 145, 39, 189, 153, 71, 207, 160, 107, 199,
+	170, 146, 168, 192, 187, 168, 211, 210, 182, 215, 216, 184, 13, 156, 164, 29, 183, 181, 41, 213, 197, 53, 225, 203, 70, 219, 200, 83, 199, 198, 93, 165, 190, 97, 132, 186, 93, 98, 182, 100, 70, 182, 113, 45, 180, 128, 34, 180,
+	142, 37, 179, 151, 51, 183, 157, 85, 195, 164, 118, 190, 182, 162, 173, 201, 197, 172, 216, 215, 184, 218, 220, 183, 22, 178, 164, 35, 198, 181, 44, 218, 195, 55, 220, 203, 70, 206, 204, 80, 181, 201, 88, 141, 195, 90, 107, 189,
+	88, 75, 183, 96, 54, 180, 109, 37, 173, 126, 36, 168, 143, 49, 163, 156, 73, 165, 165, 111, 173, 174, 144, 172, 195, 183, 171, 212, 209, 174, 221, 222, 180, 219, 220, 176, 35, 198, 169, 41, 208, 180, 46, 216, 190, 52, 210, 195,
+	65, 189, 199, 75, 160, 197, 83, 121, 192, 88, 90, 190, 87, 62, 180, 97, 46, 175, 109, 34, 161, 126, 40, 151, 148, 60, 144, 168, 94, 147, 185, 138, 158, 197, 173, 163, 208, 199, 166, 219, 218, 170, 222, 222, 172, 216, 216, 164,
+	42, 208, 168, 47, 213, 177, 50, 214, 187, 54, 202, 190, 61, 174, 192, 67, 139, 187, 74, 101, 182, 80, 72, 175, 82, 49, 166, 96, 41, 160, 117, 39, 148, 138, 53, 138, 166, 79, 132, 191, 116, 136, 210, 159, 142, 219, 190, 150,
+	220, 208, 156, 224, 222, 165, 219, 217, 160, 210, 205, 149, 31, 215, 165, 39, 216, 172, 48, 211, 180, 57, 191, 182, 64, 155, 174, 70, 114, 163, 77, 74, 153, 86, 48, 147, 93, 31, 138, 113, 35, 137, 139, 49, 136, 165, 75, 136,
+	188, 109, 131, 207, 143, 133, 217, 179, 134, 222, 201, 138, 224, 214, 152, 224, 218, 158, 215, 204, 150, 200, 189, 135, 10, 224, 164, 21, 219, 166, 37, 203, 167, 51, 171, 159, 68, 127, 145, 83, 84, 130, 104, 51, 121, 124, 35, 119,
+	139, 26, 114, 157, 38, 118, 177, 63, 123, 193, 96, 129, 204, 133, 131, 210, 167, 132, 210, 196, 131, 213, 211, 136, 222, 213, 148, 224, 209, 152, 208, 187, 140, 191, 168, 124, 14, 225, 158, 24, 213, 155, 41, 186, 147, 57, 145, 129,
+	77, 99, 113, 100, 62, 101, 133, 42, 101, 161, 34, 103, 181, 38, 104, 193, 52, 105, 200, 79, 112, 203, 112, 117, 204, 148, 121, 204, 183, 126, 201, 210, 131, 206, 219, 137, 218, 208, 146, 224, 197, 150, 206, 172, 137, 186, 149, 122,
+	35, 209, 138, 38, 188, 127, 51, 152, 112, 73, 116, 99, 108, 87, 96, 142, 66, 96, 169, 48, 91, 184, 36, 84, 195, 40, 82, 206, 64, 90, 209, 99, 100, 208, 134, 109, 204, 172, 121, 204, 206, 133, 197, 226, 136, 199, 223, 139,
+	219, 206, 153, 213, 177, 145, 195, 146, 131, 182, 127, 120, 68, 184, 111, 77, 169, 106, 98, 140, 102, 116, 107, 92, 139, 76, 85, 159, 55, 80, 177, 42, 75, 186, 37, 69, 200, 52, 74, 207, 81, 84, 208, 120, 96, 205, 154, 107,
+	198, 190, 118, 196, 216, 129, 189, 226, 130, 193, 216, 134, 209, 190, 147, 206, 159, 143, 189, 127, 130, 176, 108, 121, 122, 160, 83, 130, 149, 85, 147, 121, 84, 156, 90, 78, 161, 61, 71, 166, 44, 67, 175, 42, 71, 181, 49, 72,
+	194, 75, 81, 199, 107, 92, 201, 148, 106, 200, 181, 115, 194, 208, 121, 193, 225, 126, 187, 222, 120, 190, 205, 124, 198, 169, 137, 196, 137, 139, 179, 106, 126, 167, 86, 118, 158, 159, 79, 160, 141, 75, 166, 106, 69, 165, 73, 60,
+	165, 45, 57, 168, 36, 59, 178, 45, 72, 185, 62, 80, 193, 89, 88, 197, 123, 98, 200, 163, 111, 198, 194, 120, 192, 217, 123, 190, 227, 122, 184, 219, 115, 186, 197, 118, 188, 157, 129, 186, 125, 133, 171, 92, 123, 160, 73, 115,
+};
+
+// progressive (spectral selection + successive approximation), 4:2:0, restart interval 1 MCU, 24x16 (2 MCUs, the second one partial)
+uint8_t const JPEG_PROGRESSIVE_420_RESTART[723] = {
+	0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x06, 0x04, 0x05, 0x06, 0x05, 0x04, 0x06, 0x06, 0x05, 0x06, 0x07, 0x07, 0x06,
+	0x08, 0x0A, 0x10, 0x0A, 0x0A, 0x09, 0x09, 0x0A, 0x14, 0x0E, 0x0F, 0x0C, 0x10, 0x17, 0x14, 0x18, 0x18, 0x17, 0x14, 0x16,
+	0x16, 0x1A, 0x1D, 0x25, 0x1F, 0x1A, 0x1B, 0x23, 0x1C, 0x16, 0x16, 0x20, 0x2C, 0x20, 0x23, 0x26, 0x27, 0x29, 0x2A, 0x29,
+	0x19, 0x1F, 0x2D, 0x30, 0x2D, 0x28, 0x30, 0x25, 0x28, 0x29, 0x28, 0xFF, 0xDB, 0x00, 0x43, 0x01, 0x07, 0x07, 0x07, 0x0A,
+	0x08, 0x0A, 0x13, 0x0A, 0x0A, 0x13, 0x28, 0x1A, 0x16, 0x1A, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+	0xFF, 0xC2, 0x00, 0x11, 0x08, 0x00, 0x10, 0x00, 0x18, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xFF,
+	0xC4, 0x00, 0x17, 0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x04, 0x06, 0x03, 0xFF, 0xC4, 0x00, 0x17, 0x01, 0x00, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x04, 0x05, 0xFF, 0xDD, 0x00, 0x04, 0x00, 0x01, 0xFF, 0xDA, 0x00, 0x0C, 0x03,
+	0x01, 0x00, 0x02, 0x10, 0x03, 0x10, 0x00, 0x00, 0x01, 0xD1, 0x14, 0xEC, 0x98, 0x7F, 0xFF, 0xD0, 0xA1, 0x25, 0xCA, 0xF6,
+	0x3F, 0xFF, 0xC4, 0x00, 0x19, 0x10, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x03, 0x01, 0x04, 0x02, 0x05, 0x13, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x05, 0x02, 0xD0, 0xB0,
+	0x4B, 0xFF, 0xD0, 0xF3, 0xCA, 0xB2, 0xFF, 0x00, 0xFF, 0xD1, 0xD6, 0xD0, 0x4B, 0xFF, 0xD2, 0xEE, 0x7D, 0x9B, 0xFF, 0xD3,
+	0x0E, 0x66, 0x70, 0xFF, 0xD4, 0x4E, 0xEE, 0x87, 0xFF, 0xC4, 0x00, 0x1D, 0x11, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x12, 0x13, 0x22, 0x31, 0x32, 0xFF,
+	0xDA, 0x00, 0x08, 0x01, 0x03, 0x01, 0x01, 0x3F, 0x01, 0x8B, 0x10, 0xE1, 0x33, 0x9F, 0x46, 0x3F, 0xFF, 0xD0, 0x66, 0xDB,
+	0x08, 0xA5, 0x7B, 0x1F, 0xFF, 0xC4, 0x00, 0x1C, 0x11, 0x00, 0x01, 0x03, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x03, 0x31, 0x01, 0x04, 0x12, 0x13, 0x23, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x02,
+	0x01, 0x01, 0x3F, 0x01, 0x3B, 0xED, 0x61, 0x88, 0x4D, 0x57, 0xFF, 0xD0, 0x61, 0xB1, 0x00, 0xE9, 0x2B, 0xFF, 0xC4, 0x00,
+	0x18, 0x10, 0x01, 0x00, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+	0x11, 0x12, 0x31, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x06, 0x3F, 0x02, 0xCC, 0x3F, 0xFF, 0xD0, 0xD4, 0xBF, 0xFF,
+	0xD1, 0xCC, 0x3F, 0xFF, 0xD2, 0xAE, 0xBF, 0xFF, 0xD3, 0xB7, 0xFF, 0xD4, 0xA7, 0xFF, 0xC4, 0x00, 0x1A, 0x10, 0x00, 0x03,
+	0x01, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x11, 0x21, 0x31, 0x41,
+	0x81, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x3F, 0x21, 0xED, 0x6C, 0x3F, 0xFF, 0xD0, 0x86, 0x32, 0x9F, 0xFF,
+	0xD1, 0xAB, 0xF6, 0x1F, 0xFF, 0xD2, 0x62, 0x59, 0xF2, 0xF0, 0xFF, 0xD3, 0xB4, 0x63, 0x87, 0xFF, 0xD4, 0x9C, 0x6A, 0xA7,
+	0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x00, 0x00, 0x10, 0xD7, 0xFF, 0xD0, 0xF7, 0xFF, 0xC4,
+	0x00, 0x18, 0x11, 0x00, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x01, 0x11, 0x21, 0x41, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x03, 0x01, 0x01, 0x3F, 0x10, 0x45, 0x4D, 0x19, 0xE9, 0xFF, 0xD0,
+	0x84, 0x65, 0xAC, 0xFF, 0xC4, 0x00, 0x19, 0x11, 0x00, 0x03, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x11, 0x21, 0x31, 0x41, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x02, 0x01, 0x01, 0x3F, 0x10,
+	0x6E, 0xD7, 0xB9, 0xFF, 0xD0, 0x44, 0xAA, 0xD9, 0x3F, 0xFF, 0xC4, 0x00, 0x1A, 0x10, 0x01, 0x00, 0x03, 0x01, 0x01, 0x01,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x11, 0x21, 0x31, 0x51, 0xD1, 0xFF, 0xDA, 0x00,
+	0x08, 0x01, 0x01, 0x00, 0x01, 0x3F, 0x10, 0x1E, 0x81, 0x86, 0x4F, 0xFF, 0xD0, 0xBF, 0xE7, 0x6B, 0x79, 0x3F, 0xFF, 0xD1,
+	0x20, 0x23, 0x2C, 0x9F, 0xFF, 0xD2, 0x64, 0x1E, 0x47, 0x1F, 0x67, 0xFF, 0xD3, 0x0E, 0x00, 0x47, 0xFF, 0xD4, 0xB9, 0x2C,
+	0x5F, 0xFF, 0xD9,
+};
+uint8_t const JPEG_PROGRESSIVE_420_RESTART_RGB[1152] = {
+	0, 140, 170, 23, 170, 188, 44, 200, 199, 58, 215, 198, 68, 220, 195, 84, 215, 199, 92, 189, 198, 101, 153, 200, 112, 113, 205, 117, 76, 204, 122, 45, 201, 132, 37, 203, 138, 37, 195, 143, 45, 190, 158, 69, 195, 166, 101, 193,
+	172, 145, 188, 184, 181, 190, 204, 210, 200, 215, 219, 202, 227, 217, 205, 241, 206, 210, 246, 176, 210, 237, 149, 197, 7, 160, 176, 31, 185, 193, 50, 210, 202, 61, 218, 199, 69, 217, 195, 80, 204, 194, 87, 174, 193, 94, 137, 192,
+	105, 99, 197, 110, 63, 195, 113, 36, 192, 123, 31, 192, 133, 39, 189, 142, 55, 186, 162, 86, 195, 174, 122, 197, 181, 160, 191, 193, 193, 193, 210, 217, 201, 218, 221, 200, 225, 213, 199, 234, 195, 200, 235, 161, 198, 224, 132, 183,
+	12, 183, 174, 33, 203, 190, 51, 220, 197, 61, 219, 196, 69, 207, 191, 77, 186, 189, 82, 150, 185, 88, 112, 184, 99, 76, 190, 104, 47, 188, 109, 30, 184, 119, 33, 184, 130, 51, 179, 141, 76, 180, 160, 111, 190, 175, 146, 190,
+	187, 181, 185, 201, 206, 186, 213, 224, 192, 217, 220, 189, 221, 204, 188, 223, 178, 185, 221, 138, 180, 209, 108, 168, 13, 201, 166, 31, 215, 179, 49, 223, 188, 57, 214, 187, 66, 193, 184, 73, 166, 183, 79, 126, 180, 85, 91, 179,
+	92, 56, 180, 100, 37, 178, 110, 30, 177, 122, 45, 177, 134, 69, 173, 144, 98, 171, 159, 134, 174, 172, 165, 173, 192, 195, 174, 203, 214, 174, 212, 223, 180, 216, 213, 178, 216, 190, 175, 215, 159, 172, 211, 117, 169, 201, 87, 157,
+	17, 216, 157, 31, 222, 168, 46, 222, 176, 55, 203, 177, 62, 176, 176, 68, 143, 175, 75, 104, 174, 83, 71, 173, 90, 43, 173, 99, 31, 170, 109, 33, 167, 123, 55, 164, 136, 86, 159, 148, 121, 156, 164, 158, 158, 178, 187, 158,
+	198, 212, 161, 207, 221, 162, 213, 220, 166, 211, 202, 163, 210, 172, 163, 209, 137, 161, 207, 96, 162, 199, 69, 155, 25, 227, 154, 36, 226, 164, 47, 214, 168, 51, 189, 166, 58, 155, 164, 64, 118, 162, 73, 82, 161, 81, 54, 161,
+	92, 36, 161, 101, 31, 156, 112, 40, 150, 128, 66, 149, 142, 104, 145, 160, 144, 145, 178, 184, 150, 192, 210, 152, 207, 224, 156, 213, 224, 156, 213, 212, 158, 208, 185, 153, 204, 149, 152, 201, 113, 153, 203, 77, 159, 199, 54, 157,
+	29, 225, 153, 36, 218, 157, 44, 199, 159, 50, 168, 154, 54, 131, 151, 63, 96, 147, 72, 63, 144, 81, 40, 142, 97, 33, 145, 110, 37, 142, 125, 57, 140, 145, 91, 141, 162, 131, 137, 179, 168, 138, 192, 202, 139, 204, 223, 144,
+	210, 224, 147, 211, 216, 150, 208, 194, 149, 200, 161, 144, 196, 122, 145, 197, 89, 149, 200, 58, 160, 200, 40, 162, 31, 216, 149, 37, 206, 151, 45, 183, 150, 52, 148, 144, 61, 110, 140, 71, 78, 133, 82, 49, 128, 91, 31, 121,
+	106, 31, 122, 122, 46, 121, 144, 77, 128, 166, 118, 134, 184, 157, 136, 194, 189, 133, 199, 212, 130, 206, 222, 133, 208, 216, 141, 211, 202, 147, 206, 175, 147, 198, 139, 143, 194, 101, 146, 194, 71, 152, 199, 46, 163, 200, 32, 167,
+	35, 208, 152, 34, 187, 143, 40, 156, 135, 54, 125, 131, 67, 85, 121, 75, 50, 108, 92, 28, 102, 107, 23, 98, 135, 43, 108, 157, 71, 116, 176, 109, 126, 187, 141, 126, 194, 174, 124, 202, 202, 128, 204, 219, 124, 205, 220, 129,
+	212, 208, 147, 206, 179, 149, 197, 146, 143, 194, 115, 147, 191, 80, 149, 188, 49, 152, 192, 32, 164, 199, 30, 175, 41, 191, 145, 41, 171, 137, 50, 138, 126, 59, 98, 113, 71, 56, 97, 89, 30, 88, 121, 31, 93, 150, 45, 102,
+	161, 56, 96, 178, 87, 102, 192, 126, 110, 197, 158, 115, 200, 187, 119, 204, 210, 124, 201, 221, 122, 202, 216, 131, 206, 189, 145, 202, 158, 149, 196, 124, 148, 191, 93, 150, 188, 63, 155, 185, 40, 159, 189, 31, 168, 198, 35, 180,
+	54, 173, 135, 46, 142, 115, 50, 102, 98, 69, 72, 91, 99, 48, 91, 127, 37, 89, 156, 39, 91, 176, 52, 89, 185, 75, 86, 197, 108, 92, 206, 147, 103, 207, 178, 112, 206, 201, 119, 202, 217, 126, 193, 220, 125, 195, 207, 135,
+	198, 168, 144, 196, 133, 150, 187, 97, 148, 183, 70, 150, 183, 47, 157, 180, 34, 161, 185, 38, 171, 194, 46, 184, 71, 142, 108, 65, 117, 94, 76, 86, 87, 103, 68, 90, 137, 54, 96, 160, 47, 93, 176, 47, 85, 180, 57, 75,
+	196, 94, 80, 202, 129, 86, 208, 168, 99, 209, 194, 109, 205, 211, 121, 199, 218, 128, 186, 211, 127, 186, 191, 135, 192, 149, 143, 192, 112, 149, 183, 78, 147, 178, 52, 151, 176, 36, 158, 177, 33, 164, 181, 48, 173, 192, 64, 187,
+	104, 114, 80, 110, 104, 82, 129, 87, 88, 142, 67, 87, 152, 44, 78, 160, 36, 72, 177, 54, 75, 190, 82, 79, 191, 117, 78, 194, 151, 83, 198, 187, 97, 201, 209, 110, 198, 217, 125, 192, 214, 131, 181, 198, 130, 180, 172, 136,
+	186, 130, 141, 187, 95, 146, 177, 61, 144, 173, 41, 150, 172, 33, 158, 172, 39, 164, 176, 64, 174, 187, 85, 185, 158, 108, 75, 152, 90, 67, 154, 66, 65, 155, 47, 63, 159, 32, 61, 166, 38, 63, 179, 68, 74, 187, 105, 83,
+	185, 143, 83, 183, 176, 88, 187, 206, 101, 187, 219, 112, 190, 217, 124, 187, 205, 131, 176, 180, 129, 174, 148, 131, 175, 107, 132, 176, 74, 137, 171, 47, 141, 169, 35, 148, 171, 35, 159, 172, 51, 167, 175, 81, 175, 185, 106, 187,
+	199, 89, 56, 181, 62, 40, 167, 35, 33, 165, 27, 40, 173, 35, 58, 180, 58, 73, 181, 92, 84, 175, 125, 88, 174, 171, 94, 169, 200, 97, 171, 221, 106, 173, 225, 114, 178, 213, 123, 178, 190, 126, 171, 157, 122, 168, 123, 120,
+	164, 85, 117, 165, 59, 125, 165, 37, 134, 168, 34, 147, 174, 42, 162, 176, 64, 172, 179, 102, 180, 189, 131, 192, 193, 53, 20, 186, 42, 18, 185, 31, 29, 184, 32, 44, 186, 40, 59, 184, 64, 74, 184, 106, 93, 179, 147, 100,
+	170, 185, 102, 162, 212, 101, 163, 228, 108, 163, 226, 111, 169, 207, 120, 170, 180, 120, 164, 140, 114, 160, 105, 110, 157, 72, 111, 159, 50, 118, 162, 34, 131, 169, 35, 148, 178, 49, 168, 183, 76, 180, 184, 117, 186, 195, 147, 199,
+};
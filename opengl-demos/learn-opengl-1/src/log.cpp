@@ -0,0 +1,423 @@
+#include "log.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace logDetail {
+	std::atomic<uint8_t> g_MinSeverity{ static_cast<uint8_t>(LogSeverity::Info) };
+}
+
+
+
+namespace {
+	// the ring: records are 8 byte aligned and never wrap, a producer that doesn't fit before the end marks the rest as
+	// skipped and starts over at 0. Every 8 bytes have a state, only the states of record starts are ever non-zero:
+	// set by the producer once the record is complete, cleared by the consumer before it frees the space
+	size_t const RING_BYTES = 1 << 20;
+	size_t const RING_MASK = RING_BYTES - 1;
+	size_t const GRANULE = 8;
+	size_t const MAX_RECORD_BYTES = RING_BYTES / 4;
+	uint32_t const STATE_EMPTY = 0;
+	uint32_t const STATE_RECORD = 1;
+	uint32_t const STATE_WRAP = 2;
+	std::chrono::milliseconds const POLL_INTERVAL(2); // the consumer's sleep when idle, producers don't wake it (that'd be a syscall)
+
+	static_assert(0 == (RING_BYTES & RING_MASK), "RING_BYTES must be a power of 2");
+	static_assert(0 == sizeof(logDetail::RecordHeader) % GRANULE, "records have to stay 8 byte aligned");
+
+	// static storage: zeroed before anything runs and never destroyed, so logging is safe from static constructors too
+	alignas(64) uint8_t s_Ring[RING_BYTES];
+	std::atomic<uint32_t> s_States[RING_BYTES / GRANULE];
+	alignas(64) std::atomic<size_t> s_Head{ 0 }; // consumer
+	alignas(64) std::atomic<size_t> s_Tail{ 0 }; // producers (CAS)
+	alignas(64) std::atomic<uint64_t> s_Dropped{ 0 };
+	std::atomic<uint64_t> s_Records{ 0 };
+	std::atomic<uint64_t> s_Truncated{ 0 };
+	std::atomic<uint32_t> s_NextThread{ 0 };
+	std::atomic<bool> s_Stopped{ false };
+	std::chrono::steady_clock::time_point s_Start;
+
+	thread_local uint32_t t_LogThread = UINT32_MAX;
+
+	char const *const SEVERITY_NAMES[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+
+
+	class StdoutLogSink : public LogSink {
+	public:
+		void write(LogSeverity, char const *line, size_t length) override { std::fwrite(line, 1, length, stdout); }
+		void flush() override { std::fflush(stdout); }
+	};
+
+	class FileLogSink : public LogSink {
+	public:
+		explicit FileLogSink(std::FILE *file) : m_File(file) {}
+		~FileLogSink() { std::fclose(m_File); }
+
+		void write(LogSeverity, char const *line, size_t length) override { std::fwrite(line, 1, length, m_File); }
+		void flush() override { std::fflush(m_File); }
+
+	private:
+		std::FILE *m_File;
+	};
+
+
+
+	// formatting (logger thread)
+	template <typename T>
+	void appendFormatted(std::string &line, char const *spec, T value) {
+		char buffer[128];
+		int const length = std::snprintf(buffer, sizeof(buffer), spec, value);
+		if (length < 0) return;
+		if (static_cast<size_t>(length) < sizeof(buffer)) {
+			line.append(buffer, length);
+			return;
+		}
+		size_t const start = line.size();
+		line.resize(start + length + 1);
+		std::snprintf(&line[start], length + 1, spec, value);
+		line.resize(start + length);
+	}
+
+	bool isOneOf(char c, char const *set) {
+		for (; 0 != *set; ++set) if (*set == c) return true;
+		return false;
+	}
+
+	bool isDigit(char c) {
+		return '0' <= c && c <= '9';
+	}
+
+	// spec = '%' + style (flags, width, precision) + the conversion for the stored type, the format's length modifiers are ignored
+	void appendArg(std::string &line, char const *styleBegin, char const *styleEnd, char conversion, uint8_t const *&in) {
+		logDetail::ArgType const type = static_cast<logDetail::ArgType>(*in++);
+		char spec[32] = "%";
+		size_t length = 1 + (styleEnd - styleBegin);
+		std::memcpy(spec + 1, styleBegin, styleEnd - styleBegin);
+		auto const finish = [&](char const *suffix) {
+			std::memcpy(spec + length, suffix, std::strlen(suffix) + 1);
+		};
+
+		if (logDetail::ArgType::String == type) {
+			uint16_t size;
+			std::memcpy(&size, in, sizeof(size));
+			char const *const text = reinterpret_cast<char const *>(in + sizeof(size));
+			in += sizeof(size) + size;
+			if (styleBegin == styleEnd) {
+				line.append(text, size);
+				return;
+			}
+			finish("s");
+			appendFormatted(line, spec, std::string(text, size).c_str());
+			return;
+		}
+
+		uint64_t bits;
+		std::memcpy(&bits, in, sizeof(bits));
+		in += sizeof(bits);
+		switch (type) {
+		case logDetail::ArgType::Int:
+		case logDetail::ArgType::Uint: {
+			bool const isSigned = logDetail::ArgType::Int == type;
+			if ('c' == conversion) {
+				finish("c");
+				appendFormatted(line, spec, static_cast<int>(bits));
+			}
+			else if (isOneOf(conversion, "uxXo")) {
+				char const suffix[] = { 'l', 'l', conversion, 0 };
+				finish(suffix);
+				appendFormatted(line, spec, static_cast<unsigned long long>(bits));
+			}
+			else if (isSigned) {
+				finish("lld");
+				appendFormatted(line, spec, static_cast<long long>(bits));
+			}
+			else {
+				finish("llu");
+				appendFormatted(line, spec, static_cast<unsigned long long>(bits));
+			}
+			break;
+		}
+		case logDetail::ArgType::Double: {
+			double value;
+			std::memcpy(&value, &bits, sizeof(value));
+			char const suffix[] = { isOneOf(conversion, "fFeEgGaA") ? conversion : 'g', 0 };
+			finish(suffix);
+			appendFormatted(line, spec, value);
+			break;
+		}
+		default:
+			finish("p");
+			appendFormatted(line, spec, reinterpret_cast<void const *>(static_cast<uintptr_t>(bits)));
+			break;
+		}
+	}
+
+	void formatRecord(logDetail::RecordHeader const &header, std::string &line) {
+		line.clear();
+		char prefix[64];
+		double const seconds = std::chrono::duration<double>(std::chrono::nanoseconds(header.m_Time) - s_Start.time_since_epoch()).count();
+		int const prefixLength = std::snprintf(prefix, sizeof(prefix), "[%11.6f t%u] %s: ", seconds, header.m_Thread, SEVERITY_NAMES[static_cast<size_t>(header.m_Severity)]);
+		if (0 < prefixLength) line.append(prefix, prefixLength);
+
+		uint8_t const *in = reinterpret_cast<uint8_t const *>(&header + 1);
+		uint8_t args = header.m_ArgCount;
+		char const *p = header.m_Format;
+		while (0 != *p) {
+			if ('%' != *p) {
+				char const *const run = p;
+				while (0 != *p && '%' != *p) ++p;
+				line.append(run, p - run);
+				continue;
+			}
+			if ('%' == p[1]) {
+				line += '%';
+				p += 2;
+				continue;
+			}
+			// '*' widths aren't supported (they'd take an argument), they end up as text
+			char const *const specBegin = p++;
+			while (0 != *p && isOneOf(*p, "-+ #0")) ++p;
+			while (isDigit(*p)) ++p;
+			if ('.' == *p) {
+				++p;
+				while (isDigit(*p)) ++p;
+			}
+			char const *const styleEnd = p;
+			while (0 != *p && isOneOf(*p, "hljztLqI")) ++p;
+			char const conversion = *p;
+			if (0 != *p) ++p;
+			if (0 == args || 0 == conversion || 20 < styleEnd - specBegin) {
+				line.append(specBegin, p - specBegin);
+				continue;
+			}
+			appendArg(line, specBegin + 1, styleEnd, conversion, in);
+			--args;
+		}
+
+		if (0 != header.m_Truncated) line += " [TRUNCATED]";
+		if (line.empty() || '\n' != line.back()) line += '\n';
+	}
+
+
+
+	struct SinkEntry {
+		std::unique_ptr<LogSink> m_Sink;
+		LogSeverity m_MinSeverity;
+	};
+
+	class Logger {
+	public:
+		Logger() {
+			s_Start = std::chrono::steady_clock::now();
+			m_Sinks.push_back({ makeStdoutLogSink(), LogSeverity::Debug });
+			m_Thread = std::thread(&Logger::run, this);
+		}
+
+		~Logger() {
+			m_Stop.store(true, std::memory_order_release);
+			wake();
+			m_Thread.join();
+			s_Stopped.store(true, std::memory_order_release);
+		}
+
+		void wake() {
+			{
+				std::lock_guard<std::mutex> lock(m_WakeMutex);
+				m_WakeRequested = true;
+			}
+			m_Wake.notify_one();
+		}
+
+		// waits for a whole consumer pass that started after the call
+		void flush() {
+			std::unique_lock<std::mutex> lock(m_PassMutex);
+			uint64_t const target = m_Passes + 2;
+			wake();
+			m_PassDone.wait(lock, [&] { return target <= m_Passes; });
+		}
+
+		std::mutex m_SinkMutex;
+		std::vector<SinkEntry> m_Sinks;
+		std::condition_variable m_Wake;
+
+	private:
+		void run() {
+			std::string line;
+			line.reserve(1024);
+			uint64_t reportedDrops = 0;
+			for (;;) {
+				bool const stopping = m_Stop.load(std::memory_order_acquire);
+				size_t written = 0;
+				{
+					std::lock_guard<std::mutex> lock(m_SinkMutex);
+					written = drain(line);
+					uint64_t const dropped = s_Dropped.load(std::memory_order_relaxed);
+					if (dropped != reportedDrops) {
+						line.clear();
+						appendFormatted(line, "LOG::DROPPED %llu records (ring full)\n", static_cast<unsigned long long>(dropped - reportedDrops));
+						writeLine(LogSeverity::Warning, line);
+						reportedDrops = dropped;
+						++written;
+					}
+					if (0 != written) for (SinkEntry &entry : m_Sinks) entry.m_Sink->flush();
+				}
+				{
+					std::lock_guard<std::mutex> lock(m_PassMutex);
+					++m_Passes;
+				}
+				m_PassDone.notify_all();
+				if (stopping) break;
+				if (0 == written) {
+					std::unique_lock<std::mutex> lock(m_WakeMutex);
+					m_Wake.wait_for(lock, POLL_INTERVAL, [this] { return m_WakeRequested; });
+					m_WakeRequested = false;
+				}
+			}
+		}
+
+		// every committed record in order, stops at the first one that's reserved but not committed yet
+		size_t drain(std::string &line) {
+			size_t head = s_Head.load(std::memory_order_relaxed);
+			size_t written = 0;
+			for (;;) {
+				std::atomic<uint32_t> &state = s_States[(head & RING_MASK) / GRANULE];
+				uint32_t const value = state.load(std::memory_order_acquire);
+				if (STATE_EMPTY == value) break;
+				state.store(STATE_EMPTY, std::memory_order_relaxed);
+				if (STATE_WRAP == value) {
+					head += RING_BYTES - (head & RING_MASK);
+				}
+				else {
+					logDetail::RecordHeader const &header = *reinterpret_cast<logDetail::RecordHeader const *>(s_Ring + (head & RING_MASK));
+					formatRecord(header, line);
+					writeLine(header.m_Severity, line);
+					if (0 != header.m_Truncated) s_Truncated.fetch_add(1, std::memory_order_relaxed);
+					s_Records.fetch_add(1, std::memory_order_relaxed);
+					head += header.m_Bytes;
+					++written;
+				}
+				s_Head.store(head, std::memory_order_release);
+			}
+			return written;
+		}
+
+		void writeLine(LogSeverity severity, std::string const &line) {
+			for (SinkEntry &entry : m_Sinks) {
+				if (severity >= entry.m_MinSeverity) entry.m_Sink->write(severity, line.data(), line.size());
+			}
+		}
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Stop{ false };
+		std::mutex m_WakeMutex;
+		bool m_WakeRequested = false;
+		std::mutex m_PassMutex;
+		std::condition_variable m_PassDone;
+		uint64_t m_Passes = 0;
+	};
+
+	// started on first use, stopped (after writing everything) by the static destructors at exit
+	Logger &logger() {
+		static Logger s_Logger;
+		return s_Logger;
+	}
+}
+
+
+
+uint8_t *logDetail::reserve(LogSeverity severity, char const *format, size_t argBytes, uint8_t argCount) {
+	if (s_Stopped.load(std::memory_order_relaxed)) return nullptr;
+	Logger &instance = logger();
+	size_t const bytes = (sizeof(RecordHeader) + argBytes + GRANULE - 1) & ~(GRANULE - 1);
+	if (MAX_RECORD_BYTES < bytes) {
+		s_Dropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	size_t tail = s_Tail.load(std::memory_order_relaxed);
+	size_t start;
+	size_t end;
+	size_t head;
+	do {
+		size_t const room = RING_BYTES - (tail & RING_MASK);
+		start = room < bytes ? tail + room : tail;
+		end = start + bytes;
+		head = s_Head.load(std::memory_order_acquire);
+		if (RING_BYTES < end - head) {
+			s_Dropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+	} while (!s_Tail.compare_exchange_weak(tail, end, std::memory_order_relaxed, std::memory_order_relaxed));
+	if (start != tail) s_States[(tail & RING_MASK) / GRANULE].store(STATE_WRAP, std::memory_order_release);
+	if (RING_BYTES / 2 <= end - head) instance.m_Wake.notify_one(); // filling up faster than the consumer polls
+
+	if (UINT32_MAX == t_LogThread) t_LogThread = s_NextThread.fetch_add(1, std::memory_order_relaxed);
+	uint8_t *const record = s_Ring + (start & RING_MASK);
+	RecordHeader &header = *reinterpret_cast<RecordHeader *>(record);
+	header.m_Time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	header.m_Format = format;
+	header.m_Thread = t_LogThread;
+	header.m_Bytes = static_cast<uint32_t>(bytes);
+	header.m_Severity = severity;
+	header.m_ArgCount = argCount;
+	header.m_Truncated = 0;
+	return record;
+}
+
+void logDetail::commit(uint8_t *record) {
+	s_States[(record - s_Ring) / GRANULE].store(STATE_RECORD, std::memory_order_release);
+}
+
+
+
+std::unique_ptr<LogSink> makeStdoutLogSink() {
+	return std::unique_ptr<LogSink>(new StdoutLogSink());
+}
+
+std::unique_ptr<LogSink> makeFileLogSink(std::string const &path, bool append) {
+	std::FILE *const file = std::fopen(path.c_str(), append ? "ab" : "wb");
+	if (nullptr == file) return nullptr;
+	return std::unique_ptr<LogSink>(new FileLogSink(file));
+}
+
+void addLogSink(std::unique_ptr<LogSink> sink, LogSeverity minSeverity) {
+	if (!sink || s_Stopped.load(std::memory_order_relaxed)) return;
+	Logger &instance = logger();
+	std::lock_guard<std::mutex> lock(instance.m_SinkMutex);
+	instance.m_Sinks.push_back({ std::move(sink), minSeverity });
+}
+
+void removeLogSinks() {
+	if (s_Stopped.load(std::memory_order_relaxed)) return;
+	Logger &instance = logger();
+	std::lock_guard<std::mutex> lock(instance.m_SinkMutex);
+	instance.m_Sinks.clear();
+}
+
+void setLogSeverity(LogSeverity minSeverity) {
+	logDetail::g_MinSeverity.store(static_cast<uint8_t>(minSeverity), std::memory_order_relaxed);
+}
+
+LogSeverity getLogSeverity() {
+	return static_cast<LogSeverity>(logDetail::g_MinSeverity.load(std::memory_order_relaxed));
+}
+
+void flushLog() {
+	if (s_Stopped.load(std::memory_order_relaxed)) return;
+	logger().flush();
+}
+
+LogStats getLogStats() {
+	LogStats stats;
+	stats.m_Records = s_Records.load(std::memory_order_relaxed);
+	stats.m_Dropped = s_Dropped.load(std::memory_order_relaxed);
+	stats.m_Truncated = s_Truncated.load(std::memory_order_relaxed);
+	return stats;
+}
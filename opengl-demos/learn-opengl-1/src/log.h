@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+// asynchronous logger: the calling thread only copies a binary record into a lock-free ring, a background thread formats and writes it
+// - logInfo("GLFW error %d: %s", error, description) etc., printf style formats, but the arguments are stored as they are
+//   (integers, floating point, pointers and copies of strings) and formatted later, so a call costs a reservation (1 CAS),
+//   a memcpy and a timestamp, no formatting, no lock and no syscall
+// - the format has to outlive the record: a string literal (only the pointer is stored)
+// - the argument's type picks how it's printed, the conversion only picks the style (%x, %.2f, %-8s), a wrong one can't crash
+// - records below setLogSeverity() are rejected before anything is encoded
+// - multiple producers (any thread, incl. driver callback threads), 1 consumer: the logger's own thread, started on first use
+//   and flushed + joined at exit
+// - a full ring drops the record (counted in getLogStats(), reported by the consumer), a producer never waits
+// - sinks: stdout (on by default) and files, each with its own minimum severity, written in batches and flushed once per batch
+
+
+
+enum class LogSeverity : uint8_t {
+	Debug,
+	Info,
+	Warning,
+	Error
+};
+
+// written by the logger thread only (so a sink must not log itself)
+class LogSink {
+public:
+	virtual ~LogSink() {}
+	virtual void write(LogSeverity severity, char const *line, size_t length) = 0; // 1 formatted line, '\n' included
+	virtual void flush() {}
+};
+
+std::unique_ptr<LogSink> makeStdoutLogSink();
+std::unique_ptr<LogSink> makeFileLogSink(std::string const &path, bool append = false); // nullptr = can't open it
+
+void addLogSink(std::unique_ptr<LogSink> sink, LogSeverity minSeverity = LogSeverity::Debug);
+void removeLogSinks(); // incl. the default stdout one
+
+// global filter (default Info)
+void setLogSeverity(LogSeverity minSeverity);
+LogSeverity getLogSeverity();
+
+// blocks until everything logged before the call is written and the sinks are flushed (e.g. before abort())
+void flushLog();
+
+struct LogStats {
+	uint64_t m_Records = 0; // written
+	uint64_t m_Dropped = 0; // ring was full
+	uint64_t m_Truncated = 0; // a string argument was cut to LOG_MAX_STRING_BYTES
+};
+
+LogStats getLogStats();
+
+size_t const LOG_MAX_STRING_BYTES = 4096;
+
+
+
+namespace logDetail {
+	enum class ArgType : uint8_t {
+		Int,
+		Uint,
+		Double,
+		String, // uint16_t length + the bytes (not terminated)
+		Pointer
+	};
+
+	struct RecordHeader {
+		int64_t m_Time; // steady clock ns
+		char const *m_Format;
+		uint32_t m_Thread;
+		uint32_t m_Bytes; // the whole record, header included, padded to 8
+		LogSeverity m_Severity;
+		uint8_t m_ArgCount;
+		uint8_t m_Truncated;
+	};
+
+	extern std::atomic<uint8_t> g_MinSeverity;
+
+	// nullptr = ring full (counted), otherwise commit() the record once its arguments are written behind the header
+	uint8_t *reserve(LogSeverity severity, char const *format, size_t argBytes, uint8_t argCount);
+	void commit(uint8_t *record);
+
+	inline size_t stringBytes(size_t length) { return 1 + sizeof(uint16_t) + (length < LOG_MAX_STRING_BYTES ? length : LOG_MAX_STRING_BYTES); }
+
+	inline size_t argBytes(char const *value) { return stringBytes(value ? std::strlen(value) : 0); }
+	inline size_t argBytes(std::string const &value) { return stringBytes(value.size()); }
+	template <typename T>
+	size_t argBytes(T const *) { return 1 + sizeof(uint64_t); }
+	template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+	size_t argBytes(T) { return 1 + sizeof(uint64_t); }
+
+	inline void writeValue(uint8_t *&out, ArgType type, void const *value) {
+		*out++ = static_cast<uint8_t>(type);
+		std::memcpy(out, value, sizeof(uint64_t));
+		out += sizeof(uint64_t);
+	}
+
+	inline void writeString(uint8_t *&out, char const *value, size_t length, RecordHeader &header) {
+		if (LOG_MAX_STRING_BYTES < length) {
+			length = LOG_MAX_STRING_BYTES;
+			header.m_Truncated = 1;
+		}
+		uint16_t const length16 = static_cast<uint16_t>(length);
+		*out++ = static_cast<uint8_t>(ArgType::String);
+		std::memcpy(out, &length16, sizeof(length16));
+		if (0 != length) std::memcpy(out + sizeof(length16), value, length);
+		out += sizeof(length16) + length;
+	}
+
+	inline void writeArg(uint8_t *&out, RecordHeader &header, char const *value) { writeString(out, value, value ? std::strlen(value) : 0, header); }
+	inline void writeArg(uint8_t *&out, RecordHeader &header, std::string const &value) { writeString(out, value.data(), value.size(), header); }
+	template <typename T>
+	void writeArg(uint8_t *&out, RecordHeader &, T const *value) {
+		uint64_t const address = reinterpret_cast<uintptr_t>(value);
+		writeValue(out, ArgType::Pointer, &address);
+	}
+	template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+	void writeArg(uint8_t *&out, RecordHeader &, T value) {
+		double const converted = value;
+		writeValue(out, ArgType::Double, &converted);
+	}
+	template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+	void writeArg(uint8_t *&out, RecordHeader &, T value) {
+		int64_t const converted = value;
+		writeValue(out, ArgType::Int, &converted);
+	}
+	template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, int>::type = 0>
+	void writeArg(uint8_t *&out, RecordHeader &, T value) {
+		uint64_t const converted = value;
+		writeValue(out, ArgType::Uint, &converted);
+	}
+
+	inline size_t sumArgBytes() { return 0; }
+	template <typename Arg, typename... Args>
+	size_t sumArgBytes(Arg const &arg, Args const &... args) { return argBytes(arg) + sumArgBytes(args...); }
+
+	inline void writeArgs(uint8_t *&, RecordHeader &) {}
+	template <typename Arg, typename... Args>
+	void writeArgs(uint8_t *&out, RecordHeader &header, Arg const &arg, Args const &... args) {
+		writeArg(out, header, arg);
+		writeArgs(out, header, args...);
+	}
+}
+
+inline bool isLogged(LogSeverity severity) {
+	return static_cast<uint8_t>(severity) >= logDetail::g_MinSeverity.load(std::memory_order_relaxed);
+}
+
+template <typename... Args>
+void logMessage(LogSeverity severity, char const *format, Args const &... args) {
+	static_assert(sizeof...(Args) < 256, "too many log arguments");
+	if (!isLogged(severity)) return;
+	uint8_t *const record = logDetail::reserve(severity, format, logDetail::sumArgBytes(args...), static_cast<uint8_t>(sizeof...(Args)));
+	if (nullptr == record) return;
+	logDetail::RecordHeader &header = *reinterpret_cast<logDetail::RecordHeader *>(record);
+	uint8_t *out = record + sizeof(logDetail::RecordHeader);
+	logDetail::writeArgs(out, header, args...);
+	logDetail::commit(record);
+}
+
+template <typename... Args>
+void logDebug(char const *format, Args const &... args) { logMessage(LogSeverity::Debug, format, args...); }
+template <typename... Args>
+void logInfo(char const *format, Args const &... args) { logMessage(LogSeverity::Info, format, args...); }
+template <typename... Args>
+void logWarning(char const *format, Args const &... args) { logMessage(LogSeverity::Warning, format, args...); }
+template <typename... Args>
+void logError(char const *format, Args const &... args) { logMessage(LogSeverity::Error, format, args...); }
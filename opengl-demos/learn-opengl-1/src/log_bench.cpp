@@ -0,0 +1,112 @@
+#include "benchmarks.h"
+#include "log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+// ns per logInfo() call on the producer side (the goal in log.h: tens of nanoseconds, no formatting, lock or syscall)
+// - batches of calls timed as a whole (a clock read per call would cost as much as the call), flushLog() between batches so the
+//   ring never fills, best and median batch reported
+// - a record filtered out by setLogSeverity(), no arguments, the usual int + double + string, a 200 character string
+// - the same record from several threads at once, they all CAS the same tail
+// - check: every record logged reaches the sink (or is counted as dropped), and nothing is dropped while the ring has room
+
+
+
+namespace {
+	int const BATCH_CALLS = 1000; // ~80 KB of records at most, the ring is 1 MB
+	int const BATCHES = 200;
+	int const THREAD_COUNTS[] = { 2, 4 };
+
+	// the logger owns the sink until exit, so what it counts into can't live on logBenchMain()'s stack
+	std::atomic<uint64_t> s_SinkLines{ 0 };
+
+	// stands in for stdout, so the consumer's cost doesn't depend on the console
+	class CountingSink : public LogSink {
+	public:
+		void write(LogSeverity, char const *, size_t) override { s_SinkLines.fetch_add(1, std::memory_order_relaxed); }
+	};
+
+	struct Timing {
+		double m_Best;
+		double m_Median;
+	};
+
+	// ns per call of call(i) over BATCHES batches
+	template <typename Call>
+	Timing timeCalls(Call call) {
+		std::vector<double> batches(BATCHES);
+		for (int batch = 0; batch < BATCHES; ++batch) {
+			double const start = benchSeconds();
+			for (int i = 0; i < BATCH_CALLS; ++i) call(i);
+			batches[batch] = (benchSeconds() - start) / BATCH_CALLS * 1e9;
+			flushLog();
+		}
+		std::sort(batches.begin(), batches.end());
+		return { batches.front(), batches[BATCHES / 2] };
+	}
+
+	void printRow(char const *name, int threads, Timing const &timing) {
+		std::printf("%-28s %7d %10.1f %10.1f\n", name, threads, timing.m_Best, timing.m_Median);
+	}
+}
+
+
+
+int logBenchMain() {
+	removeLogSinks();
+	addLogSink(std::unique_ptr<LogSink>(new CountingSink()));
+	setLogSeverity(LogSeverity::Info);
+	logInfo("warm-up"); // starts the logger thread
+	flushLog();
+
+	std::string const longText(200, 'x');
+	uint64_t expected = 1;
+
+	std::printf("%-28s %7s %10s %10s\n", "record", "threads", "best ns", "median ns");
+	printRow("filtered out (logDebug)", 1, timeCalls([](int i) { logDebug("frame %d", i); }));
+	printRow("no arguments", 1, timeCalls([](int) { logInfo("frame done"); }));
+	printRow("int + double + string", 1, timeCalls([](int i) { logInfo("frame %d took %.2f ms in %s", i, 1.5, "renderer"); }));
+	printRow("200 character string", 1, timeCalls([&longText](int) { logInfo("%s", longText); }));
+	expected += 3 * BATCHES * BATCH_CALLS;
+	bool ok = 0 == getLogStats().m_Dropped;
+
+	for (int const threadCount : THREAD_COUNTS) {
+		// every thread times its own calls, the slowest thread's numbers are reported
+		std::vector<Timing> timings(threadCount);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < threadCount; ++t) {
+			threads.emplace_back([&timings, t]() {
+				timings[t] = timeCalls([](int i) { logInfo("frame %d took %.2f ms in %s", i, 1.5, "renderer"); });
+			});
+		}
+		for (std::thread &thread : threads) thread.join();
+		Timing slowest = timings[0];
+		for (Timing const &timing : timings) {
+			slowest.m_Best = std::max(slowest.m_Best, timing.m_Best);
+			slowest.m_Median = std::max(slowest.m_Median, timing.m_Median);
+		}
+		printRow("int + double + string", threadCount, slowest);
+		expected += static_cast<uint64_t>(threadCount) * BATCHES * BATCH_CALLS;
+	}
+
+	flushLog();
+	LogStats const stats = getLogStats();
+	std::printf("%llu records written, %llu dropped\n", static_cast<unsigned long long>(stats.m_Records), static_cast<unsigned long long>(stats.m_Dropped));
+	if (!ok) std::printf("MISMATCH: records were dropped by a single producer that flushes every %d calls\n", BATCH_CALLS);
+	// the sink also gets a LOG::DROPPED line per consumer pass that saw drops, so it can have more lines than records
+	if (expected != stats.m_Records + stats.m_Dropped || s_SinkLines.load() < stats.m_Records) {
+		std::printf("MISMATCH: %llu records logged, %llu written + %llu dropped, %llu lines reached the sink\n", static_cast<unsigned long long>(expected),
+			static_cast<unsigned long long>(stats.m_Records), static_cast<unsigned long long>(stats.m_Dropped), static_cast<unsigned long long>(s_SinkLines.load()));
+		ok = false;
+	}
+
+	if (!ok) std::printf("MISMATCH: see above\n");
+	return ok ? 0 : -1;
+}
@@ -25,6 +25,18 @@ main notes for this application:
 
 
 
+#include "alloc_tracker.h"
+#include "benchmarks.h"
+#include "frame_allocator.h"
+#include "frame_loop.h"
+#include "gl_debug.h"
+#include "gl_objects.h"
+#include "gl_trace.h"
+#include "input_events.h"
+#include "log.h"
+#include "metrics_server.h"
+#include "perf_hud.h"
+
 //NOTE: must include glad before glfw
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -33,7 +45,8 @@ main notes for this application:
 #include <glm/mat4x4.hpp> // glm::mat4
 #include <glm/gtc/matrix_transform.hpp> // glm::translate, glm::rotate, glm::scale, glm::perspective
 
-#include <iostream>
+#include <chrono>
+#include <memory>
 #include <string>
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
@@ -42,7 +55,8 @@ glm::mat4 camera(float Translate, glm::vec2 const &Rotate);
 void queryGLVersion();
 void errorCallback(int error, char const *description);
 void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods);
-int helloTriangleMain();
+bool processInputEvents(GLFWwindow *window);
+int helloTriangleMain(int argc, char const *argv[]);
 int helloTriangleEx1Main();
 int helloTriangleEx2Main();
 int helloTriangleEx3Main();
@@ -53,6 +67,13 @@ int helloTriangleEx3Main();
 //unsigned int const SCR_WIDTH = 800;
 //unsigned int const SCR_HEIGHT = 600;
 
+// filled by the GLFW callbacks, drained once per frame by processInputEvents()
+InputEventQueue g_InputEvents;
+// the on-screen performance HUD of the window that's running, if it has one (H toggles it)
+PerfHud *g_PerfHud = nullptr;
+// the GL tracer was installed for the HUD's counters (not by --gl-trace), so it's uninstalled again when the HUD is hidden
+bool g_HudGLTrace = false;
+
 
 
 // inline-shaders
@@ -82,10 +103,28 @@ char const *fragmentShaderSourceEx3 = "#version 330 core\n"
 
 
 int main(int argc, char const *argv[]) {
-	return helloTriangleMain();
+	return helloTriangleMain(argc, argv);
 	//return helloTriangleEx1Main();
 	//return helloTriangleEx2Main();
 	//return helloTriangleEx3Main();
+
+	// micro-benchmarks (see benchmarks.h)
+	//return rasterizerBenchMain();
+	//return vertexTransformBenchMain();
+	//return sceneGraphBenchMain();
+	//return glmBenchMain();
+	//return jobSystemBenchMain();
+	//return textureImportBenchMain();
+	//return bcEncoderBenchMain();
+	//return textureContainerBenchMain();
+	//return textureAtlasBenchMain();
+	//return resourceLoaderBenchMain();
+	//return tlsfAllocatorBenchMain();
+	//return textureStreamerBenchMain();
+	//return logBenchMain();
+
+	// tools
+	//return glTraceReplayMain(argc, argv); // plays back a trace recorded with startGLTraceRecording() (see gl_trace.h)
 }
 
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
@@ -98,15 +137,21 @@ void processInput(GLFWwindow *window) {
 
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
 // ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
-	// make sure the viewport matches the new window dimensions; note that width and 
-	// height will be significantly larger than specified on retina displays.
-	glViewport(0, 0, width, height);
+void framebuffer_size_callback(GLFWwindow * /*window*/, int width, int height) {
+	// only queued here, processInputEvents() does the glViewport()
+	InputEvent event = {};
+	event.m_Type = InputEventType::FramebufferSize;
+	event.m_Time = inputTimestamp();
+	event.m_Width = width;
+	event.m_Height = height;
+	g_InputEvents.push(event);
 }
 
 
 glm::mat4 camera(float Translate, glm::vec2 const &Rotate) {
 	glm::mat4 Projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.f);
+	// NOTE: composing VIEW and MODEL as AffineTransforms (affine_transform.h) measured slower than these glm::mat4 ops, even inlined
+	// (glm::translate/rotate/scale only touch the columns they change, a general affine compose does all 3 rows, see glmBenchMain())
 	glm::mat4 View = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -Translate));
 	View = glm::rotate(View, Rotate.y, glm::vec3(-1.0f, 0.0f, 0.0f));
 	View = glm::rotate(View, Rotate.x, glm::vec3(0.0f, 1.0f, 0.0f));
@@ -121,41 +166,110 @@ void queryGLVersion() {
 	std::string glslver = reinterpret_cast<char const *>(glGetString(GL_SHADING_LANGUAGE_VERSION));
 	std::string renderer = reinterpret_cast<char const *>(glGetString(GL_RENDERER));
 
-	std::cout << "OpenGL [ " << version << " ] "
-		<< "with GLSL [ " << glslver << " ] "
-		<< "on renderer [ " << renderer << " ]" << std::endl;
+	logInfo("OpenGL [ %s ] with GLSL [ %s ] on renderer [ %s ]", version, glslver, renderer);
 }
 
 
 
 void errorCallback(int error, char const *description) {
-	std::cout << "GLFW ERROR " << error << ":" << std::endl;
-	std::cout << description << std::endl;
+	// may come from any GLFW call (and thread), only queued here, the logger thread prints it
+	logError("GLFW ERROR %d:\n%s", error, description);
 }
 
-void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods) {
-	//Key codes are often prefixed with GLFW_KEY_ and can be found on the GLFW website
-	if (GLFW_KEY_ESCAPE == key && GLFW_PRESS == action) {
-		glfwSetWindowShouldClose(window, GL_TRUE);
-	}
-	else if (GLFW_KEY_1 == key && GLFW_PRESS == action) {
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-	}
-	else if (GLFW_KEY_2 == key && GLFW_PRESS == action) {
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+void keyCallback(GLFWwindow * /*window*/, int key, int scancode, int action, int mods) {
+	// only queued here, processInputEvents() reacts to it
+	InputEvent event = {};
+	event.m_Type = InputEventType::Key;
+	event.m_Time = inputTimestamp();
+	event.m_Key = key;
+	event.m_Scancode = scancode;
+	event.m_Action = action;
+	event.m_Mods = mods;
+	g_InputEvents.push(event);
+}
+
+// the 1 place per frame where input/window events take effect (on the thread that owns the GL context)
+// returns true if there were any (so an on-demand FrameLoop knows to redraw)
+bool processInputEvents(GLFWwindow *window) {
+	bool any = false;
+	InputEvent event;
+	while (g_InputEvents.pop(event)) {
+		any = true;
+		if (InputEventType::FramebufferSize == event.m_Type) {
+			// make sure the viewport matches the new window dimensions; note that width and 
+			// height will be significantly larger than specified on retina displays.
+			glViewport(0, 0, event.m_Width, event.m_Height);
+			continue;
+		}
+
+		//Key codes are often prefixed with GLFW_KEY_ and can be found on the GLFW website
+		if (GLFW_PRESS != event.m_Action) continue;
+		if (GLFW_KEY_ESCAPE == event.m_Key) {
+			glfwSetWindowShouldClose(window, GL_TRUE);
+		}
+		else if (GLFW_KEY_1 == event.m_Key) {
+			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+		}
+		else if (GLFW_KEY_2 == event.m_Key) {
+			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		}
+		else if (GLFW_KEY_3 == event.m_Key) {
+			glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
+		}
+		else if (GLFW_KEY_R == event.m_Key) {
+			// toggle on-demand redraw, for windows that run on a FrameLoop (set as the window user pointer)
+			FrameLoop *frameLoop = static_cast<FrameLoop *>(glfwGetWindowUserPointer(window));
+			if (frameLoop) frameLoop->setOnDemand(!frameLoop->isOnDemand());
+		}
+		else if (GLFW_KEY_H == event.m_Key && g_PerfHud) {
+			// the HUD's graphs need frames, so keep an on-demand FrameLoop redrawing while it's shown
+			bool const visible = !g_PerfHud->isVisible();
+			g_PerfHud->setVisible(visible);
+			FrameLoop *frameLoop = static_cast<FrameLoop *>(glfwGetWindowUserPointer(window));
+			if (frameLoop) frameLoop->setAnimating(visible);
+			// its draw/triangle/state counters come from the GL tracer, only wrapped while they're on screen
+			if (visible && !isGLTraceInstalled()) {
+				g_HudGLTrace = installGLTrace();
+			}
+			else if (!visible && g_HudGLTrace) {
+				uninstallGLTrace();
+				g_HudGLTrace = false;
+			}
+		}
 	}
-	else if (GLFW_KEY_3 == key && GLFW_PRESS == action) {
-		glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
+	return any;
+}
+
+
+
+// helloTriangleMain()'s command line, everything is off without it
+struct DemoOptions {
+	bool m_GLTrace = false; // --gl-trace: count and time every GL call from the start, not just while the HUD is shown
+	bool m_GLStateFilter = false; // --gl-state-filter: the tracer also drops redundant binds/enables (implies --gl-trace)
+	bool m_Metrics = false; // --metrics: serve frame stats for Prometheus (see metrics_server.h)
+};
+
+DemoOptions parseDemoOptions(int argc, char const *argv[]) {
+	DemoOptions options;
+	for (int i = 1; i < argc; ++i) {
+		std::string const arg = argv[i];
+		if ("--gl-trace" == arg) options.m_GLTrace = true;
+		else if ("--gl-state-filter" == arg) options.m_GLTrace = options.m_GLStateFilter = true;
+		else if ("--metrics" == arg) options.m_Metrics = true;
+		else logWarning("unknown argument [ %s ] ignored (known: --gl-trace, --gl-state-filter, --metrics)", arg);
 	}
+	return options;
 }
 
 
 
-int helloTriangleMain() {
+int helloTriangleMain(int argc, char const *argv[]) {
+	DemoOptions const options = parseDemoOptions(argc, argv);
+
 	// glfw: initialize and configure
 	// ------------------------------
 	if (!glfwInit()) {
-		std::cout << "ERROR: GLFW failed to initialize, TERMINATING" << std::endl;
+		logError("ERROR: GLFW failed to initialize, TERMINATING");
 		return -1;
 	}
 
@@ -171,6 +285,9 @@ int helloTriangleMain() {
 #ifdef __APPLE__
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // uncomment this statement to fix compilation on OS X
 #endif
+#ifdef _DEBUG
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE); // the driver reports every GL error and performance warning (see initGLDebugOutput() below)
+#endif
 
 	// glfw window creation
 	// --------------------
@@ -180,7 +297,7 @@ int helloTriangleMain() {
 
 	GLFWwindow *window = glfwCreateWindow(mode->width, mode->height, "LearnOpenGL", monitor, NULL); // creates the window in full-screen on the primary montitor (w/ proper DPI)
 	if (!window) {
-		std::cout << "Failed to create GLFW window" << std::endl;
+		logError("Failed to create GLFW window");
 		glfwTerminate();
 		return -1;
 	}
@@ -202,7 +319,7 @@ int helloTriangleMain() {
 	// glad: load all OpenGL function pointers
 	// ---------------------------------------
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-		std::cout << "Failed to initialize GLAD" << std::endl;
+		logError("Failed to initialize GLAD");
 		return -1;
 	}
 
@@ -210,17 +327,33 @@ int helloTriangleMain() {
 	//Intialize GLAD (finds appropriate OpenGL configuration for your system)
 	/*
 	if (!gladLoadGL()) {
-		std::cout << "GLAD init failed" << std::endl;
+		logError("GLAD init failed");
 		return -1;
 	}
 	*/
 
 
-	std::cout << "OpenGL target version: " << GLVersion.major << "." << GLVersion.minor << "+" << std::endl;
+	logInfo("OpenGL target version: %d.%d+", GLVersion.major, GLVersion.minor);
 
 	//Query and print out information about our OpenGL environment
 	queryGLVersion();
 
+	// GL errors and the driver's performance warnings: logged once each, counted per frame (gl_debug.h)
+	if (!initGLDebugOutput()) logWarning("GL debug output not supported (needs GL 4.3, KHR_debug or ARB_debug_output)");
+
+	// --gl-trace: count and time every GL call from here on (see gl_trace.h), otherwise the tracer (a wrapper around every GL
+	// call) is only installed while the perf HUD is shown (H)
+	// optional: record them for glTraceReplayMain()
+	if (options.m_GLTrace) {
+		installGLTrace();
+		setGLStateFilter(options.m_GLStateFilter);
+		//startGLTraceRecording("gl_trace.bin");
+	}
+
+	// --metrics: frame stats, GL counters, memory and shader compile times for Prometheus at http://127.0.0.1:9464/metrics, served
+	// from its own thread (see metrics_server.h, tools/scrape_metrics.py), the demo runs without it if the port is taken
+	if (options.m_Metrics) startMetricsServer();
+
 
 
 
@@ -230,6 +363,7 @@ int helloTriangleMain() {
 	// opengl must dynamically compile the shader at RUNTIME
     // ------------------------------------
     // vertex shader
+	auto const compileStart = std::chrono::steady_clock::now(); // the driver may compile in the background, the link status waits for it
     unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER); // returns an ID (>0) to reference the created empty shader object of specified type (use this object to maintain the source code strings that define the shader)
     glShaderSource(vertexShader, 1, &vertexShaderSource, NULL); // here we actually attach the shader source string to the shader object. we pass 1 string and NULL specifies that each string is null-terminated.
 	// note: opengl copies the strings we pass in, so we can free our copies if we wish now
@@ -241,7 +375,7 @@ int helloTriangleMain() {
     if (!success)
     {
         glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::VERTEX::COMPILATION_FAILED\n%s", infoLog);
     }
 
     // fragment shader
@@ -253,11 +387,15 @@ int helloTriangleMain() {
     if (!success)
     {
         glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n%s", infoLog);
     }
 
     // link shader objects (into a SHADER PROGRAM that we can use for rendering)
-    int shaderProgram = glCreateProgram(); // create an empty SHADER PROGRAM OBJECT and return the ID
+	// all the GL objects of this demo live in glObjects' pools (batched creation, deferred deletion, leak report)
+	GLObjects glObjects;
+    ProgramHandle program = glObjects.createProgram("helloTriangle program"); // create an empty SHADER PROGRAM OBJECT, the handle maps to its ID
+    unsigned int shaderProgram = glObjects.get(program);
+	labelGLObject(GLLabelIdentifier::Program, shaderProgram, "helloTriangle program"); // its name in captures
     glAttachShader(shaderProgram, vertexShader); // attach both compiled shaders into the shader program
     glAttachShader(shaderProgram, fragmentShader);
     glLinkProgram(shaderProgram); // link all the attached shaders together in 1 final shader program object (makes a pipeline where outputs of previous shaders get linked to inputs of succesive shaders) - can get linking errors here if the input/output names don't match
@@ -265,8 +403,9 @@ int helloTriangleMain() {
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
     if (!success) {
         glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
     }
+	recordShaderCompile(std::chrono::duration<double>(std::chrono::steady_clock::now() - compileStart).count());
     glDeleteShader(vertexShader); // IMPORTANT: delete the raw shader program objects once they have been successfully linked into a final shader program object - this frees memory and invalidates the name/ID
     glDeleteShader(fragmentShader);
 
@@ -283,15 +422,14 @@ int helloTriangleMain() {
         0, 1, 3,  // first Triangle
         1, 2, 3   // second Triangle
     };
-    unsigned int VBO, VAO, EBO;
-
 	// NOTE: the initialization code should be done ONCE (unless object changes freqeuntly)
-    glGenVertexArrays(1, &VAO); // generate 1 VAO and return the ID in VAO
+    VertexArrayHandle vertexArray = glObjects.createVertexArray("helloTriangle VAO"); // the pool glGenVertexArrays() a batch of IDs at a time and hands out 1
 
-    glGenBuffers(1, &VBO); // generate 1 buffer object name (unique ID?), use glDeleteBuffers() to return ID to pool
-	// NOTE: ID=0 is reserved as a way to unbind/clean memory
+    BufferHandle vertexBuffer = glObjects.createBuffer("helloTriangle VBO"); // 1 buffer object name (unique ID?), glObjects.destroy() returns the ID to the pool
+	// NOTE: ID=0 is reserved as a way to unbind/clean memory (and it's what get() returns for a destroyed handle)
 
-    glGenBuffers(1, &EBO); // generate 1 EBO and return the ID
+    BufferHandle elementBuffer = glObjects.createBuffer("helloTriangle EBO");
+    unsigned int VAO = glObjects.get(vertexArray), VBO = glObjects.get(vertexBuffer), EBO = glObjects.get(elementBuffer);
     // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
 
     glBindVertexArray(VAO); // tell OpenGL to use this VAO for future storage of VBO, EBO, glVertexAttribPointer(), glEnableVertexAttribArray() calls - so we only have 1 VAO bound at a time for use
@@ -375,13 +513,38 @@ int helloTriangleMain() {
 
 	// render loop
 	// -----------
-	while (!glfwWindowShouldClose(window)) {
-		// input
-		// -----
-		//processInput(window);
-
+	// FrameLoop does the glfwPollEvents() / glfwSwapBuffers() and paces the frames with vsync (no more COIL WHINE, see the NOTES
+	// at the bottom), the ~60fps limiter only takes over if the swap interval is set to 0
+	// nothing animates, so it starts in on-demand mode: it only redraws on input/resize and sleeps otherwise (R toggles it)
+	FrameLoopSettings frameSettings;
+	frameSettings.m_SwapInterval = 1;
+	frameSettings.m_TargetFrameTime = 1.0 / 60.0;
+	frameSettings.m_OnDemand = true;
+	FrameLoop frameLoop(window, frameSettings);
+	glfwSetWindowUserPointer(window, &frameLoop); // for processInputEvents()
+
+	std::unique_ptr<PerfHud> perfHud(new PerfHud()); // hidden until H, destroyed before the context goes away
+	g_PerfHud = perfHud.get();
+
+	// transient per-frame data comes from frameArenas.current() (frame_allocator.h), beginFrame() recycles the arena of
+	// FRAME_ARENA_COUNT frames ago, so nothing per frame touches the heap
+	size_t const frameArenaCapacity = 1024 * 1024;
+	FrameArenas frameArenas(frameArenaCapacity);
+
+	ZeroAllocationCheck allocationCheck("helloTriangleMain"); // only does something with ALLOCATION_TRACKING defined
+
+	FrameCallbacks frameCallbacks;
+	// input
+	// -----
+	//processInput(window);
+	frameCallbacks.m_Input = [window]() { return processInputEvents(window); }; // what the callbacks queued during this frame's glfwPollEvents()
+	// nothing animates yet, so there's no m_Simulate and the interpolation alpha is unused
+	frameCallbacks.m_Render = [&](double) {
 		// render
 		// ------
+		frameArenas.beginFrame();
+		perfHud->beginFrame(); // no-op while it's hidden
+		GLDebugGroup const mainPass("main pass"); // a group around the pass in RenderDoc/Nsight captures
 		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 
@@ -389,8 +552,8 @@ int helloTriangleMain() {
 
 
 		// draw our first triangle
-		glUseProgram(shaderProgram); // here we specify OpenGL to use this specific shader program for future SHADER/RENDERING CALLS
-		glBindVertexArray(VAO); // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
+		glUseProgram(glObjects.get(program)); // here we specify OpenGL to use this specific shader program for future SHADER/RENDERING CALLS
+		glBindVertexArray(glObjects.get(vertexArray)); // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
 		// specify the draw mode (e.g. poitns, lines, tris, quads, etc.), the starting index in buffer, and the count (number of entries from the start index - so number of verts to render)
 		//glDrawArrays(GL_TRIANGLES, 0, 6); // this function draws primitives using the currently active shader, current attrb config and VBO data (bound within current VAO)
 		
@@ -401,15 +564,27 @@ int helloTriangleMain() {
 		// glBindVertexArray(0); // no need to unbind it every time
 		// NOTE: I guess we would unbind it if we had another VAO to bind, unless we would just bind the new VAO (which would unbind the previous?)
 
+		int width, height;
+		glfwGetFramebufferSize(window, &width, &height);
+		perfHud->render(frameLoop.getStats(), width, height); // last, on top of everything
 
+		glObjects.endFrame(); // deletes what was destroy()ed in frames the GPU has finished
+		allocationCheck.endFrame();
+		endGLTraceFrame(); // no-op unless installGLTrace() was called
+		endGLDebugFrame();
+		publishFrameMetrics(frameLoop.getStats()); // after endGLTraceFrame(), no-op unless the metrics server is running
+	};
 
-
-
-		// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-		// -------------------------------------------------------------------------------
-		glfwSwapBuffers(window); // swap the front and back buffers so the stuff we rendered to the back in this frame will get displayed in the front
-		glfwPollEvents();
-	}
+	frameLoop.run(frameCallbacks);
+	glfwSetWindowUserPointer(window, nullptr);
+	stopMetricsServer();
+	FrameStats const &frameStats = frameLoop.getStats();
+	logInfo("frames: %llu, frame time avg/min/max: %g/%g/%gms, jitter: %gms", frameStats.m_FrameIndex, frameStats.m_AverageFrameTime * 1000.0,
+		frameStats.m_MinFrameTime * 1000.0, frameStats.m_MaxFrameTime * 1000.0, frameStats.m_FrameTimeJitter * 1000.0);
+#if FRAME_ALLOCATOR_DEBUG
+	logInfo("frame arenas: high-water %zu of %zu bytes", frameArenas.getHighWater(), frameArenaCapacity); // to tune the capacity
+#endif
+	flushLog(); // the reports below print directly, keep them after everything logged so far
 
 
 
@@ -417,9 +592,23 @@ int helloTriangleMain() {
 
 	// optional: de-allocate all resources once they've outlived their purpose:
 	// ------------------------------------------------------------------------
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBO);
-	glDeleteBuffers(1, &EBO);
+	g_PerfHud = nullptr;
+	g_HudGLTrace = false; // a tracer installed for the HUD is reported and uninstalled below like --gl-trace's
+	perfHud.reset();
+	glObjects.destroy(vertexArray);
+	glObjects.destroy(vertexBuffer);
+	glObjects.destroy(elementBuffer);
+	glObjects.destroy(program);
+	glObjects.reportLeaks(); // anything still alive here was forgotten
+	glObjects.deleteAll(); // before glfwTerminate() takes the context away
+	if (isGLTraceInstalled()) {
+		printGLTraceReport();
+		uninstallGLTrace();
+	}
+	if (isGLDebugOutputEnabled()) {
+		printGLDebugReport();
+		shutdownGLDebugOutput();
+	}
 
 
 
@@ -438,7 +627,7 @@ int helloTriangleEx1Main() {
 	// glfw: initialize and configure
 	// ------------------------------
 	if (!glfwInit()) {
-		std::cout << "ERROR: GLFW failed to initialize, TERMINATING" << std::endl;
+		logError("ERROR: GLFW failed to initialize, TERMINATING");
 		return -1;
 	}
 
@@ -463,7 +652,7 @@ int helloTriangleEx1Main() {
 
 	GLFWwindow *window = glfwCreateWindow(mode->width, mode->height, "LearnOpenGL", monitor, NULL); // creates the window in full-screen on the primary montitor (w/ proper DPI)
 	if (!window) {
-		std::cout << "Failed to create GLFW window" << std::endl;
+		logError("Failed to create GLFW window");
 		glfwTerminate();
 		return -1;
 	}
@@ -485,7 +674,7 @@ int helloTriangleEx1Main() {
 	// glad: load all OpenGL function pointers
 	// ---------------------------------------
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-		std::cout << "Failed to initialize GLAD" << std::endl;
+		logError("Failed to initialize GLAD");
 		return -1;
 	}
 
@@ -493,13 +682,13 @@ int helloTriangleEx1Main() {
 	//Intialize GLAD (finds appropriate OpenGL configuration for your system)
 	/*
 	if (!gladLoadGL()) {
-		std::cout << "GLAD init failed" << std::endl;
+		logError("GLAD init failed");
 		return -1;
 	}
 	*/
 
 
-	std::cout << "OpenGL target version: " << GLVersion.major << "." << GLVersion.minor << "+" << std::endl;
+	logInfo("OpenGL target version: %d.%d+", GLVersion.major, GLVersion.minor);
 
 	//Query and print out information about our OpenGL environment
 	queryGLVersion();
@@ -524,7 +713,7 @@ int helloTriangleEx1Main() {
     if (!success)
     {
         glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::VERTEX::COMPILATION_FAILED\n%s", infoLog);
     }
 
     // fragment shader
@@ -536,7 +725,7 @@ int helloTriangleEx1Main() {
     if (!success)
     {
         glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n%s", infoLog);
     }
 
     // link shader objects (into a SHADER PROGRAM that we can use for rendering)
@@ -548,7 +737,7 @@ int helloTriangleEx1Main() {
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
     if (!success) {
         glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
     }
     glDeleteShader(vertexShader); // IMPORTANT: delete the raw shader program objects once they have been successfully linked into a final shader program object - this frees memory and invalidates the name/ID
     glDeleteShader(fragmentShader);
@@ -590,7 +779,10 @@ int helloTriangleEx1Main() {
     glBindVertexArray(0);
 
 
+	glfwSwapInterval(1); // vsync (see the COIL WHINE note at the bottom)
+	ZeroAllocationCheck allocationCheck("helloTriangleEx1Main"); // only does something with ALLOCATION_TRACKING defined
 	while (!glfwWindowShouldClose(window)) {
+		processInputEvents(window); // what the callbacks queued during the last glfwPollEvents()
 
 		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
@@ -606,12 +798,14 @@ int helloTriangleEx1Main() {
 		// -------------------------------------------------------------------------------
 		glfwSwapBuffers(window); // swap the front and back buffers so the stuff we rendered to the back in this frame will get displayed in the front
 		glfwPollEvents();
+		allocationCheck.endFrame();
 	}
 
 	// optional: de-allocate all resources once they've outlived their purpose:
 	// ------------------------------------------------------------------------
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
+	glDeleteProgram(shaderProgram);
 
 	// glfw: terminate, clearing all previously allocated GLFW resources.
 	// ------------------------------------------------------------------
@@ -627,7 +821,7 @@ int helloTriangleEx2Main() {
 	// glfw: initialize and configure
 	// ------------------------------
 	if (!glfwInit()) {
-		std::cout << "ERROR: GLFW failed to initialize, TERMINATING" << std::endl;
+		logError("ERROR: GLFW failed to initialize, TERMINATING");
 		return -1;
 	}
 
@@ -652,7 +846,7 @@ int helloTriangleEx2Main() {
 
 	GLFWwindow *window = glfwCreateWindow(mode->width, mode->height, "LearnOpenGL", monitor, NULL); // creates the window in full-screen on the primary montitor (w/ proper DPI)
 	if (!window) {
-		std::cout << "Failed to create GLFW window" << std::endl;
+		logError("Failed to create GLFW window");
 		glfwTerminate();
 		return -1;
 	}
@@ -674,7 +868,7 @@ int helloTriangleEx2Main() {
 	// glad: load all OpenGL function pointers
 	// ---------------------------------------
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-		std::cout << "Failed to initialize GLAD" << std::endl;
+		logError("Failed to initialize GLAD");
 		return -1;
 	}
 
@@ -682,13 +876,13 @@ int helloTriangleEx2Main() {
 	//Intialize GLAD (finds appropriate OpenGL configuration for your system)
 	/*
 	if (!gladLoadGL()) {
-		std::cout << "GLAD init failed" << std::endl;
+		logError("GLAD init failed");
 		return -1;
 	}
 	*/
 
 
-	std::cout << "OpenGL target version: " << GLVersion.major << "." << GLVersion.minor << "+" << std::endl;
+	logInfo("OpenGL target version: %d.%d+", GLVersion.major, GLVersion.minor);
 
 	//Query and print out information about our OpenGL environment
 	queryGLVersion();
@@ -713,7 +907,7 @@ int helloTriangleEx2Main() {
     if (!success)
     {
         glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::VERTEX::COMPILATION_FAILED\n%s", infoLog);
     }
 
     // fragment shader
@@ -725,7 +919,7 @@ int helloTriangleEx2Main() {
     if (!success)
     {
         glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n%s", infoLog);
     }
 
     // link shader objects (into a SHADER PROGRAM that we can use for rendering)
@@ -737,7 +931,7 @@ int helloTriangleEx2Main() {
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
     if (!success) {
         glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
     }
     glDeleteShader(vertexShader); // IMPORTANT: delete the raw shader program objects once they have been successfully linked into a final shader program object - this frees memory and invalidates the name/ID
     glDeleteShader(fragmentShader);
@@ -820,7 +1014,10 @@ int helloTriangleEx2Main() {
 
 
 
+	glfwSwapInterval(1); // vsync (see the COIL WHINE note at the bottom)
+	ZeroAllocationCheck allocationCheck("helloTriangleEx2Main"); // only does something with ALLOCATION_TRACKING defined
 	while (!glfwWindowShouldClose(window)) {
+		processInputEvents(window); // what the callbacks queued during the last glfwPollEvents()
 
 		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
@@ -840,6 +1037,7 @@ int helloTriangleEx2Main() {
 		// -------------------------------------------------------------------------------
 		glfwSwapBuffers(window); // swap the front and back buffers so the stuff we rendered to the back in this frame will get displayed in the front
 		glfwPollEvents();
+		allocationCheck.endFrame();
 	}
 
 	// optional: de-allocate all resources once they've outlived their purpose:
@@ -849,6 +1047,7 @@ int helloTriangleEx2Main() {
 
 	glDeleteVertexArrays(1, &VAO2);
 	glDeleteBuffers(1, &VBO2);
+	glDeleteProgram(shaderProgram);
 
 	// glfw: terminate, clearing all previously allocated GLFW resources.
 	// ------------------------------------------------------------------
@@ -863,7 +1062,7 @@ int helloTriangleEx3Main() {
 	// glfw: initialize and configure
 	// ------------------------------
 	if (!glfwInit()) {
-		std::cout << "ERROR: GLFW failed to initialize, TERMINATING" << std::endl;
+		logError("ERROR: GLFW failed to initialize, TERMINATING");
 		return -1;
 	}
 
@@ -888,7 +1087,7 @@ int helloTriangleEx3Main() {
 
 	GLFWwindow *window = glfwCreateWindow(mode->width, mode->height, "LearnOpenGL", monitor, NULL); // creates the window in full-screen on the primary montitor (w/ proper DPI)
 	if (!window) {
-		std::cout << "Failed to create GLFW window" << std::endl;
+		logError("Failed to create GLFW window");
 		glfwTerminate();
 		return -1;
 	}
@@ -910,7 +1109,7 @@ int helloTriangleEx3Main() {
 	// glad: load all OpenGL function pointers
 	// ---------------------------------------
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-		std::cout << "Failed to initialize GLAD" << std::endl;
+		logError("Failed to initialize GLAD");
 		return -1;
 	}
 
@@ -918,13 +1117,13 @@ int helloTriangleEx3Main() {
 	//Intialize GLAD (finds appropriate OpenGL configuration for your system)
 	/*
 	if (!gladLoadGL()) {
-		std::cout << "GLAD init failed" << std::endl;
+		logError("GLAD init failed");
 		return -1;
 	}
 	*/
 
 
-	std::cout << "OpenGL target version: " << GLVersion.major << "." << GLVersion.minor << "+" << std::endl;
+	logInfo("OpenGL target version: %d.%d+", GLVersion.major, GLVersion.minor);
 
 	//Query and print out information about our OpenGL environment
 	queryGLVersion();
@@ -949,7 +1148,7 @@ int helloTriangleEx3Main() {
     if (!success)
     {
         glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::VERTEX::COMPILATION_FAILED\n%s", infoLog);
     }
 
     // fragment shader (ORANGE)
@@ -961,7 +1160,7 @@ int helloTriangleEx3Main() {
     if (!success)
     {
         glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n%s", infoLog);
     }
 
 	// fragment shader (YELLOW)
@@ -973,7 +1172,7 @@ int helloTriangleEx3Main() {
 	if (!success)
 	{
 		glGetShaderInfoLog(fragmentShader2, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+		logError("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n%s", infoLog);
 	}
 
     // link shader objects (into a SHADER PROGRAM that we can use for rendering)
@@ -985,7 +1184,7 @@ int helloTriangleEx3Main() {
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
     if (!success) {
         glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        logError("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
     }
     //glDeleteShader(vertexShader); // IMPORTANT: delete the raw shader program objects once they have been successfully linked into a final shader program object - this frees memory and invalidates the name/ID
     glDeleteShader(fragmentShader);
@@ -1001,7 +1200,7 @@ int helloTriangleEx3Main() {
 	glGetProgramiv(shaderProgram2, GL_LINK_STATUS, &success);
 	if (!success) {
 		glGetProgramInfoLog(shaderProgram2, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		logError("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
 	}
 	glDeleteShader(vertexShader); // IMPORTANT: delete the raw shader program objects once they have been successfully linked into a final shader program object - this frees memory and invalidates the name/ID
 	glDeleteShader(fragmentShader2);
@@ -1084,7 +1283,10 @@ int helloTriangleEx3Main() {
 
 
 
+	glfwSwapInterval(1); // vsync (see the COIL WHINE note at the bottom)
+	ZeroAllocationCheck allocationCheck("helloTriangleEx3Main"); // only does something with ALLOCATION_TRACKING defined
 	while (!glfwWindowShouldClose(window)) {
+		processInputEvents(window); // what the callbacks queued during the last glfwPollEvents()
 
 		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
@@ -1106,6 +1308,7 @@ int helloTriangleEx3Main() {
 		// -------------------------------------------------------------------------------
 		glfwSwapBuffers(window); // swap the front and back buffers so the stuff we rendered to the back in this frame will get displayed in the front
 		glfwPollEvents();
+		allocationCheck.endFrame();
 	}
 
 	// optional: de-allocate all resources once they've outlived their purpose:
@@ -1115,6 +1318,8 @@ int helloTriangleEx3Main() {
 
 	glDeleteVertexArrays(1, &VAO2);
 	glDeleteBuffers(1, &VBO2);
+	glDeleteProgram(shaderProgram);
+	glDeleteProgram(shaderProgram2);
 
 	// glfw: terminate, clearing all previously allocated GLFW resources.
 	// ------------------------------------------------------------------
@@ -0,0 +1,551 @@
+#include "metrics_server.h"
+#include "alloc_tracker.h"
+#include "frame_loop.h"
+#include "gl_trace.h"
+#include "log.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "psapi.lib")
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+
+namespace {
+	// everything the render thread publishes, totals since the server started
+	struct MetricsSnapshot {
+		uint64_t m_Frames = 0;
+		uint64_t m_TimedFrames = 0; // the first frame has no frame time
+		double m_FrameTimeSum = 0.0; // seconds
+		double m_WorkTimeSum = 0.0;
+		float m_FrameTimes[METRICS_WINDOW] = {}; // ring, timed frame i is at i % METRICS_WINDOW
+		float m_WorkTimes[METRICS_WINDOW] = {};
+
+		bool m_GLTrace = false;
+		uint64_t m_GLCalls = 0;
+		uint64_t m_DrawCalls = 0;
+		uint64_t m_Triangles = 0;
+		uint64_t m_StateChanges = 0;
+		uint64_t m_StateChangesFiltered = 0;
+		uint64_t m_UploadBytes = 0;
+		uint64_t m_BufferBytes = 0; // gauge, the last frame's
+		double m_DriverSeconds = 0.0;
+	};
+
+	// triple buffer: the render thread fills its back slot and swaps it into the shared one, the server thread swaps the
+	// shared one out when it's fresh, neither ever waits for the other
+	uint8_t const SLOT_MASK = 3;
+	uint8_t const SLOT_FRESH = 4;
+
+	MetricsSnapshot s_Producer; // render thread
+	MetricsSnapshot s_Slots[3];
+	uint8_t s_Back = 0; // render thread
+	uint8_t s_Front = 2; // server thread
+	std::atomic<uint8_t> s_Shared(1);
+
+	double const SHADER_BUCKETS[] = {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5}; // seconds
+	size_t const SHADER_BUCKET_COUNT = sizeof(SHADER_BUCKETS) / sizeof(SHADER_BUCKETS[0]);
+	std::atomic<uint64_t> s_ShaderBuckets[SHADER_BUCKET_COUNT + 1]; // not cumulative, the last one is above all of them
+	std::atomic<uint64_t> s_ShaderNs(0);
+
+	size_t const MAX_CLIENTS = 16;
+	size_t const MAX_REQUEST_BYTES = 8192;
+	size_t const RECEIVE_BYTES = 2048; // per recv()
+	size_t const RESPONSE_BYTES = 16384; // reserved up front, the exposition text is ~4KB (a bigger one grows it once)
+	long const SELECT_TIMEOUT_US = 100000; // how long stopMetricsServer() waits at most for the thread to notice
+
+	std::atomic<bool> s_Running(false);
+	std::atomic<bool> s_StopRequested(false);
+	std::thread s_Thread;
+	uint16_t s_Port = 0;
+	std::string s_UnixSocketPath;
+	uint64_t s_Scrapes = 0; // server thread
+}
+
+
+
+// sockets: winsock and BSD differ in the handle type, closing, non-blocking mode and error codes
+namespace {
+#if defined(_WIN32)
+	typedef SOCKET Socket;
+	Socket const NO_SOCKET = INVALID_SOCKET;
+
+	void closeSocket(Socket socket) { closesocket(socket); }
+	int lastSocketError() { return WSAGetLastError(); }
+	bool isWouldBlock(int error) { return WSAEWOULDBLOCK == error || WSAEINTR == error; }
+	bool setNonBlocking(Socket socket) {
+		u_long nonBlocking = 1;
+		return 0 == ioctlsocket(socket, FIONBIO, &nonBlocking);
+	}
+	bool fitsSelect(Socket) { return true; } // an fd_set is a list of up to FD_SETSIZE (64) sockets, MAX_CLIENTS + 1 fit
+	int const SEND_FLAGS = 0;
+#else
+	typedef int Socket;
+	Socket const NO_SOCKET = -1;
+
+	void closeSocket(Socket socket) { close(socket); }
+	int lastSocketError() { return errno; }
+	bool isWouldBlock(int error) { return EAGAIN == error || EWOULDBLOCK == error || EINTR == error; }
+	bool setNonBlocking(Socket socket) {
+		int const flags = fcntl(socket, F_GETFL, 0);
+		return 0 <= flags && 0 == fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+	}
+	bool fitsSelect(Socket socket) { return socket < FD_SETSIZE; } // an fd_set is a bitmap of descriptors below FD_SETSIZE
+#if defined(MSG_NOSIGNAL)
+	int const SEND_FLAGS = MSG_NOSIGNAL; // a scraper that hung up mustn't SIGPIPE the app
+#else
+	int const SEND_FLAGS = 0;
+#endif
+#endif
+
+	Socket s_Listen = NO_SOCKET;
+
+	// 0 = unknown
+	uint64_t residentMemoryBytes() {
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+		return counters.WorkingSetSize;
+#else
+		// read() into the stack, a FILE would malloc() its buffer on every scrape
+		int const file = open("/proc/self/statm", O_RDONLY);
+		if (0 > file) return 0;
+		char text[128];
+		ssize_t const length = read(file, text, sizeof(text) - 1);
+		close(file);
+		if (0 >= length) return 0;
+		text[length] = '\0';
+		unsigned long long pages = 0, residentPages = 0;
+		if (2 != std::sscanf(text, "%llu %llu", &pages, &residentPages)) return 0;
+		return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+}
+
+
+
+// the exposition text
+namespace {
+	void appendFamily(std::string &out, char const *name, char const *type, char const *help) {
+		out += "# HELP ";
+		out += name;
+		out += ' ';
+		out += help;
+		out += "\n# TYPE ";
+		out += name;
+		out += ' ';
+		out += type;
+		out += '\n';
+	}
+
+	// digits: 7 for values that were floats
+	void appendSample(std::string &out, char const *name, char const *labels, double value, int digits = 9) {
+		char line[192];
+		if (std::isnan(value)) std::snprintf(line, sizeof(line), "%s%s NaN\n", name, labels);
+		else if (std::isinf(value)) std::snprintf(line, sizeof(line), "%s%s %cInf\n", name, labels, 0.0 < value ? '+' : '-');
+		else std::snprintf(line, sizeof(line), "%s%s %.*g\n", name, labels, digits, value);
+		out += line;
+	}
+
+	void appendSample(std::string &out, char const *name, char const *labels, uint64_t value) {
+		char line[192];
+		std::snprintf(line, sizeof(line), "%s%s %llu\n", name, labels, static_cast<unsigned long long>(value));
+		out += line;
+	}
+
+	void appendCounter(std::string &out, char const *name, char const *help, uint64_t value) {
+		appendFamily(out, name, "counter", help);
+		appendSample(out, name, "", value);
+	}
+
+	void appendGauge(std::string &out, char const *name, char const *help, uint64_t value) {
+		appendFamily(out, name, "gauge", help);
+		appendSample(out, name, "", value);
+	}
+
+	// nearest rank quantiles of the window, NaN while it's empty
+	void appendSummary(std::string &out, char const *name, char const *help, float const *window, uint64_t samples, double sum,
+		std::vector<float> &sorted) {
+		static double const QUANTILES[] = {0.5, 0.9, 0.99, 1.0};
+		static char const *const QUANTILE_LABELS[] = {"{quantile=\"0.5\"}", "{quantile=\"0.9\"}", "{quantile=\"0.99\"}", "{quantile=\"1\"}"};
+
+		size_t const count = static_cast<size_t>(std::min<uint64_t>(samples, METRICS_WINDOW));
+		sorted.assign(window, window + count);
+		std::sort(sorted.begin(), sorted.end());
+		appendFamily(out, name, "summary", help);
+		for (size_t i = 0; i < 4; ++i) {
+			double value = NAN;
+			if (0 != count) {
+				size_t const rank = static_cast<size_t>(std::ceil(QUANTILES[i] * count));
+				value = sorted[std::max<size_t>(rank, 1) - 1];
+			}
+			appendSample(out, name, QUANTILE_LABELS[i], value, 7);
+		}
+		char sampleName[128];
+		std::snprintf(sampleName, sizeof(sampleName), "%s_sum", name);
+		appendSample(out, sampleName, "", sum);
+		std::snprintf(sampleName, sizeof(sampleName), "%s_count", name);
+		appendSample(out, sampleName, "", samples);
+	}
+
+	void appendShaderHistogram(std::string &out) {
+		char const *const name = "gl_demo_shader_compile_seconds";
+		appendFamily(out, name, "histogram", "Shader program build time, compile start to link status (any thread, via recordShaderCompile()).");
+		uint64_t cumulative = 0;
+		char labels[64];
+		for (size_t i = 0; i < SHADER_BUCKET_COUNT; ++i) {
+			cumulative += s_ShaderBuckets[i].load(std::memory_order_relaxed);
+			std::snprintf(labels, sizeof(labels), "{le=\"%g\"}", SHADER_BUCKETS[i]);
+			appendSample(out, "gl_demo_shader_compile_seconds_bucket", labels, cumulative);
+		}
+		cumulative += s_ShaderBuckets[SHADER_BUCKET_COUNT].load(std::memory_order_relaxed);
+		appendSample(out, "gl_demo_shader_compile_seconds_bucket", "{le=\"+Inf\"}", cumulative);
+		appendSample(out, "gl_demo_shader_compile_seconds_sum", "", s_ShaderNs.load(std::memory_order_relaxed) * 1e-9);
+		appendSample(out, "gl_demo_shader_compile_seconds_count", "", cumulative); // the +Inf bucket, by definition
+	}
+
+	void buildMetrics(std::string &out, std::vector<float> &sorted) {
+		if (SLOT_FRESH & s_Shared.load(std::memory_order_relaxed)) s_Front = s_Shared.exchange(s_Front, std::memory_order_acq_rel) & SLOT_MASK;
+		MetricsSnapshot const &snapshot = s_Slots[s_Front];
+
+		out.clear();
+		appendCounter(out, "gl_demo_frames_total", "Rendered frames.", snapshot.m_Frames);
+		appendSummary(out, "gl_demo_frame_time_seconds", "Frame start to frame start, quantiles over the last rendered frames.",
+			snapshot.m_FrameTimes, snapshot.m_TimedFrames, snapshot.m_FrameTimeSum, sorted);
+		appendSummary(out, "gl_demo_frame_work_seconds", "CPU time of a frame (input, simulation, render) before the frame limiter.",
+			snapshot.m_WorkTimes, snapshot.m_TimedFrames, snapshot.m_WorkTimeSum, sorted);
+
+		if (snapshot.m_GLTrace) {
+			appendCounter(out, "gl_demo_gl_calls_total", "GL calls made by the render thread.", snapshot.m_GLCalls);
+			appendCounter(out, "gl_demo_draw_calls_total", "glDraw* and glMultiDraw* calls.", snapshot.m_DrawCalls);
+			appendCounter(out, "gl_demo_triangles_total", "Triangles submitted, instances included.", snapshot.m_Triangles);
+			appendCounter(out, "gl_demo_state_changes_total", "Binds and enables that reached the driver.", snapshot.m_StateChanges);
+			appendCounter(out, "gl_demo_state_changes_filtered_total", "Redundant binds and enables dropped by the state filter.",
+				snapshot.m_StateChangesFiltered);
+			appendCounter(out, "gl_demo_upload_bytes_total", "Bytes uploaded to buffers and textures.", snapshot.m_UploadBytes);
+			appendFamily(out, "gl_demo_gl_driver_seconds_total", "counter", "CPU time spent inside GL calls.");
+			appendSample(out, "gl_demo_gl_driver_seconds_total", "", snapshot.m_DriverSeconds);
+			appendGauge(out, "gl_demo_gl_buffer_bytes", "Buffer memory in use (glBufferData sizes).", snapshot.m_BufferBytes);
+		}
+
+#ifdef ALLOCATION_TRACKING
+		AllocationCounts const allocations = processAllocationCounts();
+		appendCounter(out, "gl_demo_heap_allocations_total", "Heap allocations, all threads.", allocations.m_Allocations);
+		appendCounter(out, "gl_demo_heap_allocated_bytes_total", "Heap bytes allocated, all threads.", allocations.m_Bytes);
+#endif
+		uint64_t const resident = residentMemoryBytes();
+		if (0 != resident) appendGauge(out, "process_resident_memory_bytes", "Resident memory size in bytes.", resident);
+
+		appendShaderHistogram(out);
+		appendCounter(out, "gl_demo_log_records_dropped_total", "Log records dropped because the log ring was full.", getLogStats().m_Dropped);
+		appendCounter(out, "gl_demo_metrics_scrapes_total", "Requests for /metrics, this one included.", s_Scrapes);
+	}
+}
+
+
+
+// the server thread
+// - a scrape doesn't touch the heap once it's warm: the client slots and their buffers are made once and reused (clear()
+//   keeps the capacity), the request line is compared in place, the exposition text is rebuilt into the same string
+namespace {
+	struct Client {
+		Socket m_Socket = NO_SOCKET;
+		std::string m_Request;
+		std::string m_Response; // empty = still reading the request
+		size_t m_Sent = 0;
+		std::chrono::steady_clock::time_point m_Accepted;
+	};
+
+	void respond(Client &client, char const *status, char const *contentType, char const *body, size_t bodySize, bool headOnly) {
+		char header[256];
+		std::snprintf(header, sizeof(header), "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n", status,
+			contentType, bodySize);
+		client.m_Response = header;
+		if (!headOnly) client.m_Response.append(body, bodySize);
+	}
+
+	void respond(Client &client, char const *status, char const *body, bool headOnly) {
+		respond(client, status, "text/plain", body, std::strlen(body), headOnly);
+	}
+
+	// a whole request is in: only the request line matters
+	void handleRequest(Client &client, std::string &body, std::vector<float> &sorted) {
+		std::string const &request = client.m_Request;
+		size_t const methodEnd = request.find(' ');
+		size_t const pathEnd = std::string::npos == methodEnd ? std::string::npos : request.find_first_of(" ?\r", methodEnd + 1);
+		if (std::string::npos == pathEnd) {
+			respond(client, "400 Bad Request", "bad request\n", false);
+			return;
+		}
+		size_t const pathLength = pathEnd - methodEnd - 1;
+		bool const head = 0 == request.compare(0, methodEnd, "HEAD");
+		if (0 != request.compare(0, methodEnd, "GET") && !head) respond(client, "405 Method Not Allowed", "GET /metrics\n", false);
+		else if (0 != request.compare(methodEnd + 1, pathLength, "/metrics")) respond(client, "404 Not Found", "GET /metrics\n", head);
+		else {
+			++s_Scrapes;
+			buildMetrics(body, sorted);
+			respond(client, "200 OK", "text/plain; version=0.0.4; charset=utf-8", body.data(), body.size(), head);
+		}
+	}
+
+	// false = done with it (finished, hung up or failed)
+	bool readRequest(Client &client, std::string &body, std::vector<float> &sorted) {
+		char buffer[RECEIVE_BYTES];
+		int const received = static_cast<int>(recv(client.m_Socket, buffer, static_cast<int>(sizeof(buffer)), 0));
+		if (0 == received) return false;
+		if (0 > received) return isWouldBlock(lastSocketError());
+		client.m_Request.append(buffer, received);
+		if (std::string::npos != client.m_Request.find("\r\n\r\n")) handleRequest(client, body, sorted);
+		else if (MAX_REQUEST_BYTES < client.m_Request.size()) respond(client, "431 Request Header Fields Too Large", "too large\n", false);
+		return true;
+	}
+
+	bool writeResponse(Client &client) {
+		size_t const left = client.m_Response.size() - client.m_Sent;
+		int const sent = static_cast<int>(send(client.m_Socket, client.m_Response.data() + client.m_Sent, static_cast<int>(left), SEND_FLAGS));
+		if (0 > sent) return isWouldBlock(lastSocketError());
+		client.m_Sent += sent;
+		return client.m_Sent < client.m_Response.size();
+	}
+
+	void serverLoop(Socket listenSocket) {
+		// clients[0, active) are connected, the rest are spare slots with their buffers
+		std::vector<Client> clients(MAX_CLIENTS);
+		for (Client &client : clients) {
+			client.m_Request.reserve(MAX_REQUEST_BYTES + RECEIVE_BYTES);
+			client.m_Response.reserve(RESPONSE_BYTES);
+		}
+		size_t active = 0;
+		std::string body;
+		body.reserve(RESPONSE_BYTES);
+		std::vector<float> sorted;
+		sorted.reserve(METRICS_WINDOW);
+
+		while (!s_StopRequested.load(std::memory_order_acquire)) {
+			fd_set readSet, writeSet;
+			FD_ZERO(&readSet);
+			FD_ZERO(&writeSet);
+			Socket maxSocket = listenSocket;
+			if (active < MAX_CLIENTS) FD_SET(listenSocket, &readSet); // otherwise the backlog waits
+			for (size_t i = 0; i < active; ++i) {
+				FD_SET(clients[i].m_Socket, clients[i].m_Response.empty() ? &readSet : &writeSet);
+				maxSocket = std::max(maxSocket, clients[i].m_Socket);
+			}
+			timeval timeout;
+			timeout.tv_sec = 0;
+			timeout.tv_usec = SELECT_TIMEOUT_US;
+			int const ready = select(static_cast<int>(maxSocket + 1), &readSet, &writeSet, nullptr, &timeout);
+			if (0 > ready) {
+				int const error = lastSocketError();
+				if (isWouldBlock(error)) continue;
+				logError("METRICS::SELECT_FAILED (error %d), the metrics server stops", error);
+				break;
+			}
+
+			if (0 < ready && FD_ISSET(listenSocket, &readSet)) {
+				while (active < MAX_CLIENTS) {
+					Socket const socket = accept(listenSocket, nullptr, nullptr);
+					if (NO_SOCKET == socket) break; // would block (or failed, select() says when to try again)
+					if (!fitsSelect(socket) || !setNonBlocking(socket)) {
+						closeSocket(socket);
+						continue;
+					}
+					Client &client = clients[active++];
+					client.m_Socket = socket;
+					client.m_Request.clear();
+					client.m_Response.clear();
+					client.m_Sent = 0;
+					client.m_Accepted = std::chrono::steady_clock::now();
+				}
+			}
+
+			auto const now = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < active;) {
+				Client &client = clients[i];
+				bool keep = std::chrono::duration_cast<std::chrono::milliseconds>(now - client.m_Accepted).count() < METRICS_CLIENT_TIMEOUT_MS;
+				if (keep && 0 < ready && FD_ISSET(client.m_Socket, &readSet)) keep = readRequest(client, body, sorted);
+				// straight on to writing: most responses go out in 1 send() right after the request came in
+				if (keep && !client.m_Response.empty()) keep = writeResponse(client);
+				if (keep) {
+					++i;
+					continue;
+				}
+				closeSocket(client.m_Socket);
+				client.m_Socket = NO_SOCKET;
+				--active;
+				if (i != active) std::swap(client, clients[active]); // the buffers move with it, nothing is freed
+			}
+		}
+
+		for (size_t i = 0; i < active; ++i) closeSocket(clients[i].m_Socket);
+	}
+
+	bool failStart(Socket socket, char const *what) {
+		logError("METRICS::%s (error %d), the metrics server isn't running", what, lastSocketError());
+		if (NO_SOCKET != socket) closeSocket(socket);
+#if defined(_WIN32)
+		WSACleanup();
+#endif
+		return false;
+	}
+}
+
+
+
+bool startMetricsServer(MetricsServerSettings const &settings) {
+	if (s_Running.load()) return false;
+#if defined(_WIN32)
+	WSADATA data;
+	if (0 != WSAStartup(MAKEWORD(2, 2), &data)) {
+		logError("METRICS::WSASTARTUP_FAILED");
+		return false;
+	}
+	if (!settings.m_UnixSocketPath.empty()) {
+		logError("METRICS::UNIX_SOCKETS_NOT_SUPPORTED %s", settings.m_UnixSocketPath);
+		WSACleanup();
+		return false;
+	}
+#endif
+
+	Socket socket = NO_SOCKET;
+	uint16_t port = 0;
+#if !defined(_WIN32)
+	if (!settings.m_UnixSocketPath.empty()) {
+		sockaddr_un address;
+		std::memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if (sizeof(address.sun_path) <= settings.m_UnixSocketPath.size()) {
+			logError("METRICS::UNIX_SOCKET_PATH_TOO_LONG %s", settings.m_UnixSocketPath);
+			return false;
+		}
+		std::memcpy(address.sun_path, settings.m_UnixSocketPath.c_str(), settings.m_UnixSocketPath.size() + 1);
+		// a socket left behind by a crashed run would fail the bind, anything else at the path stays
+		struct stat status;
+		if (0 == stat(address.sun_path, &status) && S_ISSOCK(status.st_mode)) unlink(address.sun_path);
+
+		socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (NO_SOCKET == socket) return failStart(socket, "SOCKET_FAILED");
+		if (0 != bind(socket, reinterpret_cast<sockaddr const *>(&address), sizeof(address))) return failStart(socket, "BIND_FAILED");
+	}
+	else
+#endif
+	{
+		sockaddr_in address;
+		std::memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // never reachable from another machine
+		address.sin_port = htons(settings.m_Port);
+
+		socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (NO_SOCKET == socket) return failStart(socket, "SOCKET_FAILED");
+#if !defined(_WIN32)
+		// restart right away while the last run's connections are in TIME_WAIT (on Windows this would allow stealing the port)
+		int const reuse = 1;
+		setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+		if (0 != bind(socket, reinterpret_cast<sockaddr const *>(&address), sizeof(address))) return failStart(socket, "BIND_FAILED");
+		socklen_t length = sizeof(address);
+		if (0 == getsockname(socket, reinterpret_cast<sockaddr *>(&address), &length)) port = ntohs(address.sin_port);
+	}
+	if (0 != listen(socket, SOMAXCONN) || !setNonBlocking(socket)) return failStart(socket, "LISTEN_FAILED");
+
+	s_Listen = socket;
+	s_Port = port;
+	s_UnixSocketPath = settings.m_UnixSocketPath;
+	s_StopRequested.store(false);
+	s_Running.store(true);
+	s_Thread = std::thread(serverLoop, socket);
+	if (s_UnixSocketPath.empty()) logInfo("metrics: http://127.0.0.1:%u/metrics", static_cast<unsigned int>(port));
+	else logInfo("metrics: GET /metrics on the Unix socket %s", s_UnixSocketPath);
+	return true;
+}
+
+void stopMetricsServer() {
+	if (!s_Running.load()) return;
+	s_StopRequested.store(true, std::memory_order_release);
+	s_Thread.join();
+	s_Running.store(false);
+	closeSocket(s_Listen);
+	s_Listen = NO_SOCKET;
+	s_Port = 0;
+#if defined(_WIN32)
+	WSACleanup();
+#else
+	if (!s_UnixSocketPath.empty()) unlink(s_UnixSocketPath.c_str());
+#endif
+	s_UnixSocketPath.clear();
+}
+
+bool isMetricsServerRunning() {
+	return s_Running.load();
+}
+
+uint16_t getMetricsServerPort() {
+	return s_Port;
+}
+
+
+
+void publishFrameMetrics(FrameStats const &frameStats) {
+	if (!s_Running.load(std::memory_order_relaxed)) return;
+
+	MetricsSnapshot &state = s_Producer;
+	++state.m_Frames;
+	if (0.0 < frameStats.m_FrameTime) {
+		size_t const slot = static_cast<size_t>(state.m_TimedFrames % METRICS_WINDOW);
+		state.m_FrameTimes[slot] = static_cast<float>(frameStats.m_FrameTime);
+		state.m_WorkTimes[slot] = static_cast<float>(frameStats.m_WorkTime);
+		state.m_FrameTimeSum += frameStats.m_FrameTime;
+		state.m_WorkTimeSum += frameStats.m_WorkTime;
+		++state.m_TimedFrames;
+	}
+
+	state.m_GLTrace = isGLTraceInstalled();
+	if (state.m_GLTrace) {
+		GLTraceFrameStats const gl = getGLTraceLastFrame();
+		state.m_GLCalls += gl.m_Calls;
+		state.m_DrawCalls += gl.m_DrawCalls;
+		state.m_Triangles += gl.m_Triangles;
+		state.m_StateChanges += gl.m_StateChanges;
+		state.m_StateChangesFiltered += gl.m_StateChangesFiltered;
+		state.m_UploadBytes += gl.m_UploadBytes;
+		state.m_BufferBytes = gl.m_BufferBytes;
+		state.m_DriverSeconds += gl.m_DriverMs * 0.001;
+	}
+
+	s_Slots[s_Back] = state;
+	s_Back = s_Shared.exchange(static_cast<uint8_t>(s_Back | SLOT_FRESH), std::memory_order_acq_rel) & SLOT_MASK;
+}
+
+void recordShaderCompile(double seconds) {
+	size_t bucket = 0;
+	while (bucket < SHADER_BUCKET_COUNT && SHADER_BUCKETS[bucket] < seconds) ++bucket;
+	s_ShaderBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	s_ShaderNs.fetch_add(static_cast<uint64_t>(std::max(seconds, 0.0) * 1e9), std::memory_order_relaxed);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// metrics export for monitoring: a minimal HTTP server on its own thread that answers GET /metrics in the Prometheus text
+// exposition format (tools/scrape_metrics.py scrapes and checks it)
+// - frame time and CPU work time quantiles (0.5/0.9/0.99/1) over the last METRICS_WINDOW rendered frames, frames/draw calls/triangles/
+//   GL calls/state changes/upload bytes as counters (rate() of the upload bytes = upload bandwidth), GL buffer memory, heap
+//   allocations (ALLOCATION_TRACKING only), resident memory, shader compile+link time histogram, dropped log records
+// - the render thread only publishes: publishFrameMetrics() copies its totals and the frame time windows into a triple buffer
+//   (1 atomic exchange, no lock, no syscall), the server thread picks up the newest one and does all the formatting and I/O
+// - a scrape doesn't allocate once the server thread's buffers have grown to fit (ZeroAllocationCheck stays quiet while it's scraped)
+// - non-blocking sockets and select(), several scrapers at once, a scraper that stalls is dropped after METRICS_CLIENT_TIMEOUT_MS
+// - listens on 127.0.0.1 only, or on a Unix domain socket (not on Windows)
+// - the GL counters come from the tracer (gl_trace.h), they're left out while it isn't installed
+
+
+
+struct FrameStats;
+
+struct MetricsServerSettings {
+	uint16_t m_Port = 9464; // TCP on 127.0.0.1, 0 = any free port (see getMetricsServerPort())
+	std::string m_UnixSocketPath; // not empty = a Unix domain socket at this path instead of TCP (removed again on stop)
+};
+
+size_t const METRICS_WINDOW = 512; // frames in the quantile windows (~8.5s at 60fps)
+int const METRICS_CLIENT_TIMEOUT_MS = 5000;
+
+// false = already running, or the socket can't be created/bound (logged)
+bool startMetricsServer(MetricsServerSettings const &settings = MetricsServerSettings());
+void stopMetricsServer(); // closes the connections and joins the thread
+bool isMetricsServerRunning();
+uint16_t getMetricsServerPort(); // the bound TCP port, 0 = not running or a Unix socket
+
+// the render thread, once per rendered frame after endGLTraceFrame() (no-op while the server isn't running)
+void publishFrameMetrics(FrameStats const &frameStats);
+
+// any thread, e.g. from compile start to the link status check of a program (counted even while the server isn't running)
+void recordShaderCompile(double seconds);
@@ -0,0 +1,245 @@
+#include "mip_generator.h"
+#include "frame_allocator.h"
+
+#include <glm/gtc/color_space.hpp> // glm::convertSRGBToLinear, glm::convertLinearToSRGB
+#include <glm/vec3.hpp> // glm::vec3
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace {
+	int const ENCODE_STEPS = 16383; // linear float -> 8 bits goes through a table of ENCODE_STEPS + 1 entries (< 0.2 of a step off)
+	int const MAX_TAPS = 8;
+	double const KAISER_BETA = 4.0;
+
+	struct ColorTables {
+		float m_SrgbToLinear[256];
+		float m_UnormToFloat[256];
+		uint8_t m_LinearToSrgb[ENCODE_STEPS + 1];
+		uint8_t m_FloatToUnorm[ENCODE_STEPS + 1];
+
+		ColorTables() {
+			for (int i = 0; i < 256; ++i) {
+				m_SrgbToLinear[i] = glm::convertSRGBToLinear(glm::vec3(i / 255.0f)).x;
+				m_UnormToFloat[i] = i / 255.0f;
+			}
+			for (int i = 0; i <= ENCODE_STEPS; ++i) {
+				float const value = static_cast<float>(i) / ENCODE_STEPS;
+				m_LinearToSrgb[i] = static_cast<uint8_t>(glm::convertLinearToSRGB(glm::vec3(value)).x * 255.0f + 0.5f);
+				m_FloatToUnorm[i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+			}
+		}
+	};
+
+	ColorTables const &colorTables() {
+		static ColorTables const s_Tables;
+		return s_Tables;
+	}
+
+	// the tables of 1 downsample: per channel, alpha is never sRGB
+	struct Kernel {
+		float const *m_Decode[4];
+		uint8_t const *m_Encode[4];
+		float m_Weights[MAX_TAPS];
+		int m_Taps;
+		bool m_Box;
+	};
+
+	double besselI0(double x) {
+		double sum = 1.0;
+		double term = 1.0;
+		for (int k = 1; k < 32; ++k) {
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	Kernel makeKernel(MipSettings const &settings) {
+		ColorTables const &tables = colorTables();
+		Kernel kernel;
+		for (int c = 0; c < 4; ++c) {
+			bool const srgb = settings.m_Srgb && 3 > c;
+			kernel.m_Decode[c] = srgb ? tables.m_SrgbToLinear : tables.m_UnormToFloat;
+			kernel.m_Encode[c] = srgb ? tables.m_LinearToSrgb : tables.m_FloatToUnorm;
+		}
+
+		kernel.m_Box = MipFilter::Box == settings.m_Filter;
+		if (kernel.m_Box) {
+			kernel.m_Taps = 2;
+			kernel.m_Weights[0] = kernel.m_Weights[1] = 0.5f;
+			return kernel;
+		}
+
+		// source pixel centres sit at -3.5 .. +3.5 from the output pixel's centre, sinc cut off at the output's Nyquist
+		kernel.m_Taps = MAX_TAPS;
+		double weights[MAX_TAPS];
+		double sum = 0.0;
+		double const halfWidth = MAX_TAPS / 2;
+		for (int t = 0; t < MAX_TAPS; ++t) {
+			double const distance = t - (MAX_TAPS - 1) / 2.0;
+			double const x = 3.14159265358979323846 * distance / 2.0;
+			double const ratio = distance / halfWidth;
+			weights[t] = std::sin(x) / x * besselI0(KAISER_BETA * std::sqrt(1.0 - ratio * ratio)) / besselI0(KAISER_BETA);
+			sum += weights[t];
+		}
+		for (int t = 0; t < MAX_TAPS; ++t) kernel.m_Weights[t] = static_cast<float>(weights[t] / sum);
+		return kernel;
+	}
+
+	// Box on an odd size: size = 2 * outputs + 1, so output i covers 2 + 1 / outputs source pixels, 3 taps weighted by how much of
+	// each it covers ((outputs - i, outputs, i + 1) / size), every source pixel adds up to the same weight, the last one too
+	bool oddBox(Kernel const &kernel, int size) {
+		return kernel.m_Box && 1 < size && 1 == size % 2;
+	}
+
+	// source indices (clamped to the edge) of the taps for output index i along an axis of size source pixels, returns the
+	// tap count, the weights are the kernel's or, for oddBox(), written to oddWeights
+	int axisTaps(Kernel const &kernel, int i, int size, int *indices, float *oddWeights) {
+		if (oddBox(kernel, size)) {
+			float const total = static_cast<float>(size);
+			int const outputs = size / 2;
+			for (int t = 0; t < 3; ++t) indices[t] = 2 * i + t;
+			oddWeights[0] = static_cast<float>(outputs - i) / total;
+			oddWeights[1] = static_cast<float>(outputs) / total;
+			oddWeights[2] = static_cast<float>(i + 1) / total;
+			return 3;
+		}
+		int const first = 2 * i - (kernel.m_Taps / 2 - 1);
+		for (int t = 0; t < kernel.m_Taps; ++t) indices[t] = std::min(std::max(first + t, 0), size - 1);
+		return kernel.m_Taps;
+	}
+
+
+
+	void downsampleRowsScalar(Kernel const &kernel, Image const &source, Image &out, int firstRow, int endRow, float *row) {
+		int const sourceWidth = source.m_Width;
+		int taps[MAX_TAPS];
+		float rowWeights[MAX_TAPS];
+		float columnWeights[MAX_TAPS];
+		float const *rowWeightsUsed = oddBox(kernel, source.m_Height) ? rowWeights : kernel.m_Weights;
+		float const *columnWeightsUsed = oddBox(kernel, sourceWidth) ? columnWeights : kernel.m_Weights;
+		for (int y = firstRow; y < endRow; ++y) {
+			// vertical pass, full source width
+			int const rowTaps = axisTaps(kernel, y, source.m_Height, taps, rowWeights);
+			for (int x = 0; x < sourceWidth; ++x) {
+				float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (int t = 0; t < rowTaps; ++t) {
+					uint8_t const *pixel = &source.m_Pixels[(static_cast<size_t>(taps[t]) * sourceWidth + x) * 4];
+					for (int c = 0; c < 4; ++c) sum[c] = sum[c] + rowWeightsUsed[t] * kernel.m_Decode[c][pixel[c]];
+				}
+				for (int c = 0; c < 4; ++c) row[4 * x + c] = sum[c];
+			}
+
+			// horizontal pass + encode
+			uint8_t *pixel = &out.m_Pixels[static_cast<size_t>(y) * out.m_Width * 4];
+			for (int x = 0; x < out.m_Width; ++x, pixel += 4) {
+				int const columnTaps = axisTaps(kernel, x, sourceWidth, taps, columnWeights);
+				float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (int t = 0; t < columnTaps; ++t) {
+					for (int c = 0; c < 4; ++c) sum[c] = sum[c] + columnWeightsUsed[t] * row[4 * taps[t] + c];
+				}
+				for (int c = 0; c < 4; ++c) {
+					float const clamped = std::min(std::max(sum[c], 0.0f), 1.0f); // Kaiser's negative lobes can overshoot
+					pixel[c] = kernel.m_Encode[c][static_cast<int>(clamped * ENCODE_STEPS + 0.5f)];
+				}
+			}
+		}
+	}
+
+	// same arithmetic in the same order as the scalar path, just 4 channels at once
+	void downsampleRowsSSE2(Kernel const &kernel, Image const &source, Image &out, int firstRow, int endRow, float *row) {
+		int const sourceWidth = source.m_Width;
+		int taps[MAX_TAPS];
+		float oddWeights[MAX_TAPS];
+		__m128 kernelWeights[MAX_TAPS];
+		__m128 weights[MAX_TAPS];
+		for (int t = 0; t < kernel.m_Taps; ++t) kernelWeights[t] = weights[t] = _mm_set1_ps(kernel.m_Weights[t]);
+		bool const oddRows = oddBox(kernel, source.m_Height);
+		bool const oddColumns = oddBox(kernel, sourceWidth);
+		__m128 const zero = _mm_setzero_ps();
+		__m128 const one = _mm_set1_ps(1.0f);
+		__m128 const steps = _mm_set1_ps(static_cast<float>(ENCODE_STEPS));
+		__m128 const half = _mm_set1_ps(0.5f);
+		float const *decode0 = kernel.m_Decode[0];
+		float const *decode1 = kernel.m_Decode[1];
+		float const *decode2 = kernel.m_Decode[2];
+		float const *decode3 = kernel.m_Decode[3];
+
+		for (int y = firstRow; y < endRow; ++y) {
+			int const rowTaps = axisTaps(kernel, y, source.m_Height, taps, oddWeights);
+			uint8_t const *sourceRows[MAX_TAPS];
+			for (int t = 0; t < rowTaps; ++t) {
+				sourceRows[t] = &source.m_Pixels[static_cast<size_t>(taps[t]) * sourceWidth * 4];
+				weights[t] = oddRows ? _mm_set1_ps(oddWeights[t]) : kernelWeights[t];
+			}
+			for (int x = 0; x < sourceWidth; ++x) {
+				__m128 sum = zero;
+				for (int t = 0; t < rowTaps; ++t) {
+					uint8_t const *pixel = sourceRows[t] + 4 * x;
+					__m128 const linear = _mm_setr_ps(decode0[pixel[0]], decode1[pixel[1]], decode2[pixel[2]], decode3[pixel[3]]);
+					sum = _mm_add_ps(sum, _mm_mul_ps(weights[t], linear));
+				}
+				_mm_store_ps(row + 4 * x, sum);
+			}
+
+			uint8_t *pixel = &out.m_Pixels[static_cast<size_t>(y) * out.m_Width * 4];
+			for (int x = 0; x < out.m_Width; ++x, pixel += 4) {
+				int const columnTaps = axisTaps(kernel, x, sourceWidth, taps, oddWeights);
+				__m128 sum = zero;
+				for (int t = 0; t < columnTaps; ++t) {
+					__m128 const weight = oddColumns ? _mm_set1_ps(oddWeights[t]) : kernelWeights[t];
+					sum = _mm_add_ps(sum, _mm_mul_ps(weight, _mm_load_ps(row + 4 * taps[t])));
+				}
+				__m128 const clamped = _mm_min_ps(_mm_max_ps(sum, zero), one);
+				alignas(16) int32_t indices[4];
+				_mm_store_si128(reinterpret_cast<__m128i *>(indices), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, steps), half)));
+				for (int c = 0; c < 4; ++c) pixel[c] = kernel.m_Encode[c][indices[c]];
+			}
+		}
+	}
+}
+
+
+
+int mipLevelCount(int width, int height) {
+	int const largest = std::max(std::max(width, height), 1);
+	int count = 1;
+	while (largest >> count) ++count;
+	return count;
+}
+
+void downsampleImage(Image const &source, MipSettings const &settings, Image &out, ParallelForFn const &parallelFor) {
+	out.m_Width = std::max(1, source.m_Width / 2);
+	out.m_Height = std::max(1, source.m_Height / 2);
+	out.m_Pixels.resize(static_cast<size_t>(out.m_Width) * out.m_Height * 4);
+	if (source.m_Pixels.empty()) return;
+
+	Kernel const kernel = makeKernel(settings);
+	bool const sse2 = SimdLevel::SSE2 <= clampSimdLevel(settings.m_Simd);
+	parallelFor(static_cast<size_t>(out.m_Height), [&](size_t begin, size_t end) {
+		// 1 linear float row of the source's width (the thread's scratch arena, it goes to the heap only for very wide images)
+		ScratchScope scratch;
+		float *row = static_cast<float *>(scratch.arena().allocate(static_cast<size_t>(source.m_Width) * 4 * sizeof(float), 16));
+		if (sse2) downsampleRowsSSE2(kernel, source, out, static_cast<int>(begin), static_cast<int>(end), row);
+		else downsampleRowsScalar(kernel, source, out, static_cast<int>(begin), static_cast<int>(end), row);
+	});
+}
+
+void generateMipChain(Image base, MipSettings const &settings, std::vector<Image> &levels, ParallelForFn const &parallelFor) {
+	int count = mipLevelCount(base.m_Width, base.m_Height);
+	if (0 < settings.m_MaxLevels) count = std::min(count, settings.m_MaxLevels);
+
+	levels.clear();
+	levels.reserve(count);
+	levels.push_back(std::move(base));
+	for (int level = 1; level < count; ++level) {
+		Image next;
+		downsampleImage(levels.back(), settings, next, parallelFor);
+		levels.push_back(std::move(next));
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "cpu_features.h"
+#include "image_codec.h"
+#include "scene_graph.h" // ParallelForFn, serialFor
+
+#include <vector>
+
+// CPU mip chain generation, so textures arrive with all their levels instead of a glGenerateMipmap() stall on the GL thread
+// - gamma correct: sRGB colour is decoded to linear (glm/gtc/color_space.hpp conversions, baked into lookup tables), filtered,
+//   and encoded back, alpha is always linear
+// - each level is filtered from the previous one with a separable 2:1 kernel: Box (2 taps) or Kaiser-windowed sinc (8 taps, sharper)
+// - 1 RGBA pixel = 1 SSE register, each output row is a vertical pass into a linear float row then a horizontal pass
+// - output rows are independent, so every level goes to ParallelForFn in one go (JobSystem::parallelFor for big images)
+// - odd sizes round down (5 -> 2) like GL's own chain: Box then takes 3 source pixels per output, weighted by how much of each
+//   the output covers (so every source pixel counts the same, the last row/column included), Kaiser's 8 taps reach them anyway
+
+
+
+enum class MipFilter {
+	Box,
+	Kaiser
+};
+
+struct MipSettings {
+	MipFilter m_Filter = MipFilter::Box;
+	bool m_Srgb = true; // false for data textures (normal maps, masks, ...): every channel filtered as is
+	int m_MaxLevels = 0; // 0 = down to 1x1
+	SimdLevel m_Simd = SimdLevel::SSE2; // Scalar or SSE2 (the scalar path is the reference, both give the same bytes)
+};
+
+// levels[0] = base, then each level half the size of the one before
+void generateMipChain(Image base, MipSettings const &settings, std::vector<Image> &levels, ParallelForFn const &parallelFor = serialFor);
+
+// 1 level from the one above it
+void downsampleImage(Image const &source, MipSettings const &settings, Image &out, ParallelForFn const &parallelFor = serialFor);
+
+// levels a full chain has for this size (log2 of the larger side + 1)
+int mipLevelCount(int width, int height);
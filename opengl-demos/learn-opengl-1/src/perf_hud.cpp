@@ -0,0 +1,345 @@
+#include "perf_hud.h"
+#include "frame_loop.h"
+#include "gl_trace.h"
+#include "log.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdio>
+
+
+
+namespace {
+	// 5x7 glyphs for ' ' (32) to '_' (95), a row per byte (bit 4 = leftmost pixel), lower case is drawn upper case
+	uint8_t const FONT[64][7] = {
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 }, // ' ' !
+		{ 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A }, // " #
+		{ 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 }, { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // $ %
+		{ 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D }, { 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, // & '
+		{ 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // ( )
+		{ 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 }, { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 }, // * +
+		{ 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 }, { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // , -
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // . /
+		{ 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 0 1
+		{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // 2 3
+		{ 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // 4 5
+		{ 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // 6 7
+		{ 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // 8 9
+		{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 }, // : ;
+		{ 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 }, { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 }, // < =
+		{ 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 }, { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 }, // > ?
+		{ 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E }, { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 }, // @ A
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // B C
+		{ 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // D E
+		{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // F G
+		{ 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // H I
+		{ 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // J K
+		{ 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // L M
+		{ 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // N O
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, // P Q
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // R S
+		{ 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // T U
+		{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, // V W
+		{ 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, // X Y
+		{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E }, // Z [
+		{ 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 }, { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E }, // \ ]
+		{ 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }  // ^ _
+	};
+
+	// the font texture: 16 x 4 cells of 6 x 8 texels, plus a white block for the solid quads
+	int const GLYPH_WIDTH = 5;
+	int const GLYPH_HEIGHT = 7;
+	int const CELL_WIDTH = 6;
+	int const CELL_HEIGHT = 8;
+	int const FONT_TEXTURE_WIDTH = 128;
+	int const FONT_TEXTURE_HEIGHT = 32;
+	int const WHITE_X = 120;
+	float const WHITE_U = (WHITE_X + 2.0f) / FONT_TEXTURE_WIDTH;
+	float const WHITE_V = 2.0f / FONT_TEXTURE_HEIGHT;
+
+	// layout, in pixels
+	float const TEXT_SCALE = 2.0f; // pixels per font texel
+	float const CHAR_ADVANCE = CELL_WIDTH * TEXT_SCALE;
+	float const LINE_HEIGHT = (CELL_HEIGHT + 2) * TEXT_SCALE;
+	float const MARGIN = 8.0f;
+	float const PADDING = 8.0f;
+	float const BAR_WIDTH = 3.0f;
+	float const GRAPH_HEIGHT = 48.0f;
+	double const GRAPH_SCALE_MS = 100.0 / 3.0; // full height = 30 fps, the marker is at 60
+
+	// RGBA8 as the bytes are in memory (little endian: 0xAABBGGRR)
+	uint32_t const BACKGROUND = 0xB0000000;
+	uint32_t const WHITE = 0xFFFFFFFF;
+	uint32_t const GREY = 0xFFA0A0A0;
+	uint32_t const CPU_COLOR = 0xFF50D050;
+	uint32_t const GPU_COLOR = 0xFF30A0FF;
+	uint32_t const OVER_COLOR = 0xFF4040FF; // bars cut off at the top of the graph
+	uint32_t const MARKER_COLOR = 0x80FFFFFF;
+
+	char const *const VERTEX_SHADER = "#version 330 core\n"
+		"layout (location = 0) in vec2 aPos;\n"
+		"layout (location = 1) in vec2 aUV;\n"
+		"layout (location = 2) in vec4 aColor;\n"
+		"uniform vec2 uScreen;\n"
+		"out vec2 vUV;\n"
+		"out vec4 vColor;\n"
+		"void main()\n"
+		"{\n"
+		"   vUV = aUV;\n"
+		"   vColor = aColor;\n"
+		"   gl_Position = vec4(aPos.x / uScreen.x * 2.0 - 1.0, 1.0 - aPos.y / uScreen.y * 2.0, 0.0, 1.0);\n" // pixels, y down
+		"}\n";
+	char const *const FRAGMENT_SHADER = "#version 330 core\n"
+		"in vec2 vUV;\n"
+		"in vec4 vColor;\n"
+		"out vec4 FragColor;\n"
+		"uniform sampler2D uFont;\n"
+		"void main()\n"
+		"{\n"
+		"   FragColor = vec4(vColor.rgb, vColor.a * texture(uFont, vUV).r);\n"
+		"}\n";
+
+	GLuint compileShader(GLenum type, char const *source) {
+		GLuint const shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, NULL);
+		glCompileShader(shader);
+		int success;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			char infoLog[512];
+			glGetShaderInfoLog(shader, 512, NULL, infoLog);
+			logError("PERF_HUD::SHADER::COMPILATION_FAILED\n%s", infoLog);
+		}
+		return shader;
+	}
+
+	// B, KB or MB
+	void formatBytes(char *out, size_t size, double bytes) {
+		if (bytes < 1024.0) std::snprintf(out, size, "%.0f B", bytes);
+		else if (bytes < 1024.0 * 1024.0) std::snprintf(out, size, "%.1f KB", bytes / 1024.0);
+		else std::snprintf(out, size, "%.2f MB", bytes / (1024.0 * 1024.0));
+	}
+
+	double newest(double const *history, size_t samples) {
+		return 0 == samples ? 0.0 : history[(samples - 1) % PerfHud::HISTORY];
+	}
+}
+
+
+
+PerfHud::PerfHud() {
+	GLuint const vertexShader = compileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+	GLuint const fragmentShader = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+	m_Program = glCreateProgram();
+	glAttachShader(m_Program, vertexShader);
+	glAttachShader(m_Program, fragmentShader);
+	glLinkProgram(m_Program);
+	int success;
+	glGetProgramiv(m_Program, GL_LINK_STATUS, &success);
+	if (!success) {
+		char infoLog[512];
+		glGetProgramInfoLog(m_Program, 512, NULL, infoLog);
+		logError("PERF_HUD::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
+	}
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+	m_ScreenLocation = glGetUniformLocation(m_Program, "uScreen");
+
+	std::vector<uint8_t> texels(static_cast<size_t>(FONT_TEXTURE_WIDTH) * FONT_TEXTURE_HEIGHT, 0);
+	for (int glyph = 0; glyph < 64; ++glyph) {
+		int const cellX = glyph % 16 * CELL_WIDTH;
+		int const cellY = glyph / 16 * CELL_HEIGHT;
+		for (int y = 0; y < GLYPH_HEIGHT; ++y) {
+			for (int x = 0; x < GLYPH_WIDTH; ++x) {
+				if (0 != (FONT[glyph][y] & (0x10 >> x))) texels[static_cast<size_t>(cellY + y) * FONT_TEXTURE_WIDTH + cellX + x] = 255;
+			}
+		}
+	}
+	for (int y = 0; y < 4; ++y) std::fill_n(&texels[static_cast<size_t>(y) * FONT_TEXTURE_WIDTH + WHITE_X], 4, uint8_t(255));
+	glGenTextures(1, &m_FontTexture);
+	glBindTexture(GL_TEXTURE_2D, m_FontTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, FONT_TEXTURE_WIDTH, FONT_TEXTURE_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, texels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenVertexArrays(1, &m_VertexArray);
+	glGenBuffers(1, &m_VertexBuffer);
+	glBindVertexArray(m_VertexArray);
+	glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void const *>(offsetof(Vertex, m_X)));
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void const *>(offsetof(Vertex, m_U)));
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), reinterpret_cast<void const *>(offsetof(Vertex, m_Color)));
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glGenQueries(static_cast<GLsizei>(QUERY_COUNT), m_Queries);
+	m_Vertices.reserve(4096);
+}
+
+PerfHud::~PerfHud() {
+	if (m_QueryActive) glEndQuery(GL_TIME_ELAPSED);
+	glDeleteQueries(static_cast<GLsizei>(QUERY_COUNT), m_Queries);
+	glDeleteBuffers(1, &m_VertexBuffer);
+	glDeleteVertexArrays(1, &m_VertexArray);
+	glDeleteTextures(1, &m_FontTexture);
+	glDeleteProgram(m_Program);
+}
+
+void PerfHud::setVisible(bool visible) {
+	if (visible == m_Visible) return;
+	m_Visible = visible;
+	m_CpuSamples = 0;
+	m_GpuSamples = 0;
+}
+
+void PerfHud::beginFrame() {
+	if (!m_Visible || m_QueryActive) return;
+	// all slots in flight: this frame isn't timed rather than waiting for the oldest
+	if (QUERY_COUNT == m_QueriesIssued - m_QueriesRead) return;
+	glBeginQuery(GL_TIME_ELAPSED, m_Queries[m_QueriesIssued % QUERY_COUNT]);
+	m_QueryActive = true;
+}
+
+void PerfHud::readQueries() {
+	while (m_QueriesRead < m_QueriesIssued) {
+		GLuint const query = m_Queries[m_QueriesRead % QUERY_COUNT];
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) return;
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+		m_GpuMs[m_GpuSamples++ % HISTORY] = static_cast<double>(nanoseconds) * 1e-6;
+		++m_QueriesRead;
+	}
+}
+
+void PerfHud::addQuad(float x, float y, float width, float height, float u0, float v0, float u1, float v1, uint32_t color) {
+	Vertex const topLeft = { x, y, u0, v0, color };
+	Vertex const topRight = { x + width, y, u1, v0, color };
+	Vertex const bottomLeft = { x, y + height, u0, v1, color };
+	Vertex const bottomRight = { x + width, y + height, u1, v1, color };
+	Vertex const quad[] = { topLeft, bottomLeft, topRight, topRight, bottomLeft, bottomRight };
+	m_Vertices.insert(m_Vertices.end(), quad, quad + 6);
+}
+
+void PerfHud::addRect(float x, float y, float width, float height, uint32_t color) {
+	addQuad(x, y, width, height, WHITE_U, WHITE_V, WHITE_U, WHITE_V, color);
+}
+
+void PerfHud::addText(float x, float y, char const *text, uint32_t color) {
+	for (; 0 != *text; ++text, x += CHAR_ADVANCE) {
+		int c = static_cast<unsigned char>(*text);
+		if ('a' <= c && c <= 'z') c -= 'a' - 'A';
+		if (c <= ' ' || '_' < c) continue; // space, and nothing to draw for what the font doesn't have
+		int const glyph = c - ' ';
+		float const u = static_cast<float>(glyph % 16 * CELL_WIDTH) / FONT_TEXTURE_WIDTH;
+		float const v = static_cast<float>(glyph / 16 * CELL_HEIGHT) / FONT_TEXTURE_HEIGHT;
+		addQuad(x, y, GLYPH_WIDTH * TEXT_SCALE, GLYPH_HEIGHT * TEXT_SCALE, u, v,
+			u + static_cast<float>(GLYPH_WIDTH) / FONT_TEXTURE_WIDTH, v + static_cast<float>(GLYPH_HEIGHT) / FONT_TEXTURE_HEIGHT, color);
+	}
+}
+
+// oldest sample on the left, the newest at the right edge
+void PerfHud::addGraph(float x, float y, float height, double const *history, size_t samples, uint32_t color) {
+	size_t const count = std::min(samples, static_cast<size_t>(HISTORY));
+	float const right = x + HISTORY * BAR_WIDTH;
+	for (size_t i = 0; i < count; ++i) {
+		double const ms = history[(samples - count + i) % HISTORY];
+		float const barHeight = static_cast<float>(std::min(ms / GRAPH_SCALE_MS, 1.0)) * height;
+		addRect(right - (count - i) * BAR_WIDTH, y + height - barHeight, BAR_WIDTH - 1.0f, barHeight, ms > GRAPH_SCALE_MS ? OVER_COLOR : color);
+	}
+	addRect(x, y + height * 0.5f, HISTORY * BAR_WIDTH, 1.0f, MARKER_COLOR); // 16.7 ms
+}
+
+void PerfHud::render(FrameStats const &frameStats, int width, int height) {
+	if (!m_Visible) return;
+	if (m_QueryActive) {
+		glEndQuery(GL_TIME_ELAPSED);
+		m_QueryActive = false;
+		++m_QueriesIssued;
+	}
+	readQueries();
+	m_CpuMs[m_CpuSamples++ % HISTORY] = frameStats.m_WorkTime * 1000.0;
+	if (0 >= width || 0 >= height) return;
+
+	m_Vertices.clear();
+	float const panelWidth = 2.0f * PADDING + HISTORY * BAR_WIDTH;
+	float const panelHeight = 2.0f * PADDING + 6.0f * LINE_HEIGHT + 2.0f * (GRAPH_HEIGHT + PADDING);
+	addRect(MARGIN, MARGIN, panelWidth, panelHeight, BACKGROUND);
+
+	float const x = MARGIN + PADDING;
+	float y = MARGIN + PADDING;
+	char line[96];
+	char bytes[32];
+	char uploads[32];
+	double const frameMs = frameStats.m_FrameTime * 1000.0;
+	std::snprintf(line, sizeof(line), "FPS %.1f   FRAME %.2f MS", 0.0 < frameMs ? 1000.0 / frameMs : 0.0, frameMs);
+	addText(x, y, line, WHITE);
+	y += LINE_HEIGHT;
+
+	std::snprintf(line, sizeof(line), "CPU %.2f MS", newest(m_CpuMs, m_CpuSamples));
+	addText(x, y, line, CPU_COLOR);
+	y += LINE_HEIGHT;
+	addGraph(x, y, GRAPH_HEIGHT, m_CpuMs, m_CpuSamples, CPU_COLOR);
+	y += GRAPH_HEIGHT + PADDING;
+
+	if (0 == m_GpuSamples) std::snprintf(line, sizeof(line), "GPU -");
+	else std::snprintf(line, sizeof(line), "GPU %.2f MS", newest(m_GpuMs, m_GpuSamples));
+	addText(x, y, line, GPU_COLOR);
+	y += LINE_HEIGHT;
+	addGraph(x, y, GRAPH_HEIGHT, m_GpuMs, m_GpuSamples, GPU_COLOR);
+	y += GRAPH_HEIGHT + PADDING;
+
+	if (isGLTraceInstalled()) {
+		GLTraceFrameStats const gl = getGLTraceLastFrame();
+		std::snprintf(line, sizeof(line), "DRAWS %llu   TRIS %llu", static_cast<unsigned long long>(gl.m_DrawCalls), static_cast<unsigned long long>(gl.m_Triangles));
+		addText(x, y, line, WHITE);
+		y += LINE_HEIGHT;
+		std::snprintf(line, sizeof(line), "STATE %llu   FILTERED %llu%s", static_cast<unsigned long long>(gl.m_StateChanges),
+			static_cast<unsigned long long>(gl.m_StateChangesFiltered), isGLStateFilterEnabled() ? "" : " (OFF)");
+		addText(x, y, line, WHITE);
+		y += LINE_HEIGHT;
+		formatBytes(bytes, sizeof(bytes), static_cast<double>(gl.m_BufferBytes));
+		formatBytes(uploads, sizeof(uploads), static_cast<double>(gl.m_UploadBytes));
+		std::snprintf(line, sizeof(line), "BUFFERS %s   UPLOAD %s", bytes, uploads);
+		addText(x, y, line, WHITE);
+	}
+	else {
+		addText(x, y, "GL COUNTERS OFF (INSTALLGLTRACE)", GREY);
+	}
+
+	// filled, blended, no depth: the polygon mode and the enables are put back as found, the blend function and bindings stay the HUD's
+	GLint polygonMode[2] = { GL_FILL, GL_FILL };
+	glGetIntegerv(GL_POLYGON_MODE, polygonMode);
+	GLboolean const blend = glIsEnabled(GL_BLEND);
+	GLboolean const depthTest = glIsEnabled(GL_DEPTH_TEST);
+	GLboolean const cullFace = glIsEnabled(GL_CULL_FACE);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_CULL_FACE);
+
+	glUseProgram(m_Program);
+	glUniform2f(m_ScreenLocation, static_cast<float>(width), static_cast<float>(height));
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, m_FontTexture);
+	glBindVertexArray(m_VertexArray);
+	glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_Vertices.size() * sizeof(Vertex)), m_Vertices.data(), GL_STREAM_DRAW); // orphans last frame's
+	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_Vertices.size()));
+
+	glPolygonMode(GL_FRONT_AND_BACK, static_cast<GLenum>(polygonMode[0]));
+	if (!blend) glDisable(GL_BLEND);
+	if (depthTest) glEnable(GL_DEPTH_TEST);
+	if (cullFace) glEnable(GL_CULL_FACE);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// on-screen performance overlay: FPS, CPU and GPU frame time graphs, draw calls, triangles, state changes (and how many the
+// tracer's state filter dropped), buffer memory in use and upload bytes per frame
+// - all of it (text from a built-in 5x7 bitmap font, backgrounds, graph bars) is 1 vertex buffer of screen space quads and 1 draw call
+// - GPU time: a GL_TIME_ELAPSED query from beginFrame() to render(), read QUERY_COUNT - 1 frames later once it's available
+//   (never waits on the GPU)
+// - the GL counters are the tracer's (gl_trace.h) for the previous frame, they read "off" while it isn't installed; the HUD's
+//   own draw and upload are counted like the app's
+// - nothing happens (and no GL is touched) while it's hidden, the history starts over when it's shown again
+// NOTE: render() reads back the polygon mode and 3 enables to restore them (a visible HUD is a debugging aid, not free)
+
+
+
+struct FrameStats;
+
+class PerfHud {
+public:
+	static size_t const HISTORY = 120; // frames in the graphs
+	static size_t const QUERY_COUNT = 4;
+
+	// GL thread, current context
+	PerfHud();
+	~PerfHud();
+
+	PerfHud(PerfHud const &) = delete;
+	PerfHud &operator=(PerfHud const &) = delete;
+
+	void setVisible(bool visible);
+	bool isVisible() const { return m_Visible; }
+
+	// around the frame's rendering: beginFrame() first thing, render() last (before the swap)
+	void beginFrame();
+	void render(FrameStats const &frameStats, int width, int height);
+
+private:
+	struct Vertex {
+		float m_X;
+		float m_Y;
+		float m_U;
+		float m_V;
+		uint32_t m_Color; // RGBA8
+	};
+
+	void readQueries();
+	void addQuad(float x, float y, float width, float height, float u0, float v0, float u1, float v1, uint32_t color);
+	void addRect(float x, float y, float width, float height, uint32_t color);
+	void addText(float x, float y, char const *text, uint32_t color);
+	void addGraph(float x, float y, float height, double const *history, size_t samples, uint32_t color);
+
+	bool m_Visible = false;
+	unsigned int m_Program = 0;
+	int m_ScreenLocation = -1;
+	unsigned int m_VertexArray = 0;
+	unsigned int m_VertexBuffer = 0;
+	unsigned int m_FontTexture = 0;
+	std::vector<Vertex> m_Vertices; // rebuilt every frame, the capacity stays
+
+	unsigned int m_Queries[QUERY_COUNT] = {};
+	uint64_t m_QueriesIssued = 0; // query i lives in slot i % QUERY_COUNT
+	uint64_t m_QueriesRead = 0;
+	bool m_QueryActive = false;
+
+	double m_CpuMs[HISTORY] = {};
+	double m_GpuMs[HISTORY] = {};
+	size_t m_CpuSamples = 0;
+	size_t m_GpuSamples = 0;
+};
@@ -0,0 +1,493 @@
+#include "rasterizer.h"
+
+#include <glad/glad.h>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+
+namespace {
+	int const SUBPIXEL_BITS = 4;
+	int const SUBPIXEL_ONE = 1 << SUBPIXEL_BITS; // 16 steps per pixel
+	int const SUBPIXEL_HALF = SUBPIXEL_ONE / 2; // pixel centers are sampled at +0.5
+	int const BLOCK_SIZE = 8; // 8x8 pixel blocks, 1 AVX2 register (or 2 SSE registers) covers a block row
+	float const GUARD_BAND = 8192.0f; // keeps every edge function value inside an int64 (and partial blocks inside an int32)
+	float const FLOOR_BIAS = 16384.0f; // (int)(v + FLOOR_BIAS) - FLOOR_BIAS == floor(v) for v inside the guard band
+
+	// lane i is enabled when i < cols (indexed by cols)
+	alignas(32) int32_t const s_ColumnMasks[BLOCK_SIZE + 1][BLOCK_SIZE] = {
+		{ 0,  0,  0,  0,  0,  0,  0,  0},
+		{-1,  0,  0,  0,  0,  0,  0,  0},
+		{-1, -1,  0,  0,  0,  0,  0,  0},
+		{-1, -1, -1,  0,  0,  0,  0,  0},
+		{-1, -1, -1, -1,  0,  0,  0,  0},
+		{-1, -1, -1, -1, -1,  0,  0,  0},
+		{-1, -1, -1, -1, -1, -1,  0,  0},
+		{-1, -1, -1, -1, -1, -1, -1,  0},
+		{-1, -1, -1, -1, -1, -1, -1, -1}
+	};
+	alignas(32) int32_t const s_ZeroLanes[BLOCK_SIZE] = {};
+
+	int popcount8(unsigned int bits) {
+		bits = bits - ((bits >> 1) & 0x55u);
+		bits = (bits & 0x33u) + ((bits >> 2) & 0x33u);
+		return static_cast<int>((bits + (bits >> 4)) & 0x0Fu);
+	}
+
+	float floorFast(float v) {
+		return static_cast<float>(static_cast<int>(v + FLOOR_BIAS)) - FLOOR_BIAS;
+	}
+
+	// NaN/inf coordinates are skipped by every primitive: a clamp lets NaN through and the int conversion is undefined
+	bool isFinite2(float const *v) {
+		return std::isfinite(v[0]) && std::isfinite(v[1]);
+	}
+
+
+
+	// one 8x8 (or smaller, at the right/bottom of the target) block that survived the trivial reject
+	struct BlockJob {
+		uint32_t *m_Row; // top-left pixel of the block
+		int m_Stride;
+		int m_Rows;
+		int m_Cols;
+		uint32_t m_Color;
+		bool m_Covered; // every pixel center in the block is inside the triangle (trivial accept)
+		int32_t m_Origin[3]; // edge values at the top-left pixel center, 0 for edges the whole block is inside of
+		int32_t m_RowStep[3]; // edge delta between 2 rows
+		int32_t const *m_LaneOffsets[3]; // edge delta for each of the 8 columns
+	};
+
+	// a clipped line segment, endpoints are inside [0, width) x [0, height)
+	struct LineJob {
+		float m_X0, m_Y0;
+		float m_StepX, m_StepY;
+		int m_Count; // pixels to write (steps + 1)
+	};
+
+	typedef uint64_t (*BlockKernel)(BlockJob const &job);
+
+
+
+	// fill the [x0, x0 + cols) x [y0, y0 + rows) rectangle (already clipped), used by points
+	uint64_t fillRect(RasterTarget const &target, int x0, int y0, int cols, int rows, uint32_t color) {
+		uint32_t *row = target.m_Pixels + static_cast<size_t>(y0) * target.m_Stride + x0;
+		for (int r = 0; r < rows; ++r, row += target.m_Stride) {
+			for (int c = 0; c < cols; ++c) row[c] = color;
+		}
+		return static_cast<uint64_t>(rows) * cols;
+	}
+
+	// clip a point square against the target, returns false if nothing is left
+	bool clipPointRect(RasterTarget const &target, int &x0, int &y0, int &cols, int &rows) {
+		int x1 = x0 + cols;
+		int y1 = y0 + rows;
+		x0 = std::max(x0, 0);
+		y0 = std::max(y0, 0);
+		x1 = std::min(x1, target.m_Width);
+		y1 = std::min(y1, target.m_Height);
+		cols = x1 - x0;
+		rows = y1 - y0;
+		return 0 < cols && 0 < rows;
+	}
+
+
+
+	// LINES AND POINTS (scalar at every SIMD level)
+	// ---------------------------------------------
+	// SSE2/AVX2 versions computed 4/8 DDA steps or point corners at once, but the pixel writes are scattered single stores
+	// either way, and they measured within noise of these (+-10%, rasterizerBenchMain()), so only the fill path is vectorized
+
+	uint64_t drawLine(RasterTarget const &target, LineJob const &job, uint32_t color) {
+		float const maxX = static_cast<float>(target.m_Width - 1);
+		float const maxY = static_cast<float>(target.m_Height - 1);
+		for (int i = 0; i < job.m_Count; ++i) {
+			float const t = static_cast<float>(i);
+			float const x = std::min(std::max(job.m_X0 + t * job.m_StepX, 0.0f), maxX);
+			float const y = std::min(std::max(job.m_Y0 + t * job.m_StepY, 0.0f), maxY);
+			target.m_Pixels[static_cast<size_t>(static_cast<int>(y)) * target.m_Stride + static_cast<int>(x)] = color;
+		}
+		return static_cast<uint64_t>(job.m_Count);
+	}
+
+	uint64_t drawPoints(RasterTarget const &target, float const *xy, unsigned int const *indices, size_t count, int size, uint32_t color) {
+		float const offset = 0.5f - 0.5f * static_cast<float>(size);
+		uint64_t written = 0;
+		for (size_t i = 0; i < count; ++i) {
+			size_t const v = (nullptr != indices) ? indices[i] : i;
+			if (!isFinite2(&xy[2 * v])) continue;
+			int x0 = static_cast<int>(floorFast(std::min(std::max(xy[2 * v] + offset, -GUARD_BAND), GUARD_BAND)));
+			int y0 = static_cast<int>(floorFast(std::min(std::max(xy[2 * v + 1] + offset, -GUARD_BAND), GUARD_BAND)));
+			int cols = size;
+			int rows = size;
+			if (clipPointRect(target, x0, y0, cols, rows)) written += fillRect(target, x0, y0, cols, rows, color);
+		}
+		return written;
+	}
+
+
+
+	// SCALAR (reference) BLOCK KERNEL
+	// -------------------------------
+
+	uint64_t blockScalar(BlockJob const &job) {
+		uint32_t *row = job.m_Row;
+		if (job.m_Covered) {
+			for (int r = 0; r < job.m_Rows; ++r, row += job.m_Stride) {
+				for (int c = 0; c < job.m_Cols; ++c) row[c] = job.m_Color;
+			}
+			return static_cast<uint64_t>(job.m_Rows) * job.m_Cols;
+		}
+
+		uint64_t written = 0;
+		int32_t e0 = job.m_Origin[0];
+		int32_t e1 = job.m_Origin[1];
+		int32_t e2 = job.m_Origin[2];
+		for (int r = 0; r < job.m_Rows; ++r, row += job.m_Stride) {
+			for (int c = 0; c < job.m_Cols; ++c) {
+				int32_t const inside = (e0 + job.m_LaneOffsets[0][c]) | (e1 + job.m_LaneOffsets[1][c]) | (e2 + job.m_LaneOffsets[2][c]);
+				if (0 <= inside) {
+					row[c] = job.m_Color;
+					++written;
+				}
+			}
+			e0 += job.m_RowStep[0];
+			e1 += job.m_RowStep[1];
+			e2 += job.m_RowStep[2];
+		}
+		return written;
+	}
+
+	// SSE2 BLOCK KERNEL (4 lanes, a block row is split in 2 halves)
+	// -------------------------------------------------------------
+
+	uint64_t blockSSE2(BlockJob const &job) {
+		__m128i const color = _mm_set1_epi32(static_cast<int>(job.m_Color));
+		uint32_t *row = job.m_Row;
+
+		if (job.m_Covered && BLOCK_SIZE == job.m_Cols) {
+			for (int r = 0; r < job.m_Rows; ++r, row += job.m_Stride) {
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(row), color);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(row + 4), color);
+			}
+			return static_cast<uint64_t>(job.m_Rows) * BLOCK_SIZE;
+		}
+
+		__m128i e0Lo = _mm_add_epi32(_mm_set1_epi32(job.m_Origin[0]), _mm_load_si128(reinterpret_cast<__m128i const *>(job.m_LaneOffsets[0])));
+		__m128i e0Hi = _mm_add_epi32(_mm_set1_epi32(job.m_Origin[0]), _mm_load_si128(reinterpret_cast<__m128i const *>(job.m_LaneOffsets[0] + 4)));
+		__m128i e1Lo = _mm_add_epi32(_mm_set1_epi32(job.m_Origin[1]), _mm_load_si128(reinterpret_cast<__m128i const *>(job.m_LaneOffsets[1])));
+		__m128i e1Hi = _mm_add_epi32(_mm_set1_epi32(job.m_Origin[1]), _mm_load_si128(reinterpret_cast<__m128i const *>(job.m_LaneOffsets[1] + 4)));
+		__m128i e2Lo = _mm_add_epi32(_mm_set1_epi32(job.m_Origin[2]), _mm_load_si128(reinterpret_cast<__m128i const *>(job.m_LaneOffsets[2])));
+		__m128i e2Hi = _mm_add_epi32(_mm_set1_epi32(job.m_Origin[2]), _mm_load_si128(reinterpret_cast<__m128i const *>(job.m_LaneOffsets[2] + 4)));
+		__m128i const step0 = _mm_set1_epi32(job.m_RowStep[0]);
+		__m128i const step1 = _mm_set1_epi32(job.m_RowStep[1]);
+		__m128i const step2 = _mm_set1_epi32(job.m_RowStep[2]);
+		__m128i const colLo = _mm_load_si128(reinterpret_cast<__m128i const *>(s_ColumnMasks[job.m_Cols]));
+		__m128i const colHi = _mm_load_si128(reinterpret_cast<__m128i const *>(s_ColumnMasks[job.m_Cols] + 4));
+
+		uint64_t written = 0;
+		for (int r = 0; r < job.m_Rows; ++r, row += job.m_Stride) {
+			// a pixel is inside when none of the 3 edge values has its sign bit set
+			__m128i const insideLo = _mm_andnot_si128(_mm_srai_epi32(_mm_or_si128(_mm_or_si128(e0Lo, e1Lo), e2Lo), 31), colLo);
+			__m128i const insideHi = _mm_andnot_si128(_mm_srai_epi32(_mm_or_si128(_mm_or_si128(e0Hi, e1Hi), e2Hi), 31), colHi);
+			int const mask = _mm_movemask_ps(_mm_castsi128_ps(insideLo)) | (_mm_movemask_ps(_mm_castsi128_ps(insideHi)) << 4);
+
+			if (0 != mask) {
+				if (BLOCK_SIZE == job.m_Cols) {
+					// all 8 columns are inside the target, so a read-modify-write of the whole row is safe
+					__m128i *dstLo = reinterpret_cast<__m128i *>(row);
+					__m128i *dstHi = reinterpret_cast<__m128i *>(row + 4);
+					_mm_storeu_si128(dstLo, _mm_or_si128(_mm_and_si128(insideLo, color), _mm_andnot_si128(insideLo, _mm_loadu_si128(dstLo))));
+					_mm_storeu_si128(dstHi, _mm_or_si128(_mm_and_si128(insideHi, color), _mm_andnot_si128(insideHi, _mm_loadu_si128(dstHi))));
+				}
+				else {
+					// right edge of the target, never touch memory past the end of the row
+					for (int c = 0; c < job.m_Cols; ++c) {
+						if (mask & (1 << c)) row[c] = job.m_Color;
+					}
+				}
+				written += popcount8(static_cast<unsigned int>(mask));
+			}
+
+			e0Lo = _mm_add_epi32(e0Lo, step0);
+			e0Hi = _mm_add_epi32(e0Hi, step0);
+			e1Lo = _mm_add_epi32(e1Lo, step1);
+			e1Hi = _mm_add_epi32(e1Hi, step1);
+			e2Lo = _mm_add_epi32(e2Lo, step2);
+			e2Hi = _mm_add_epi32(e2Hi, step2);
+		}
+		return written;
+	}
+
+	// AVX2 BLOCK KERNEL (8 lanes, 1 register per block row)
+	// -----------------------------------------------------
+
+	SIMD_TARGET_AVX2 uint64_t blockAVX2(BlockJob const &job) {
+		__m256i const color = _mm256_set1_epi32(static_cast<int>(job.m_Color));
+		__m256i const cols = _mm256_load_si256(reinterpret_cast<__m256i const *>(s_ColumnMasks[job.m_Cols]));
+		uint32_t *row = job.m_Row;
+
+		if (job.m_Covered) {
+			if (BLOCK_SIZE == job.m_Cols) {
+				for (int r = 0; r < job.m_Rows; ++r, row += job.m_Stride) _mm256_storeu_si256(reinterpret_cast<__m256i *>(row), color);
+			}
+			else {
+				for (int r = 0; r < job.m_Rows; ++r, row += job.m_Stride) _mm256_maskstore_epi32(reinterpret_cast<int *>(row), cols, color);
+			}
+			return static_cast<uint64_t>(job.m_Rows) * job.m_Cols;
+		}
+
+		__m256i e0 = _mm256_add_epi32(_mm256_set1_epi32(job.m_Origin[0]), _mm256_load_si256(reinterpret_cast<__m256i const *>(job.m_LaneOffsets[0])));
+		__m256i e1 = _mm256_add_epi32(_mm256_set1_epi32(job.m_Origin[1]), _mm256_load_si256(reinterpret_cast<__m256i const *>(job.m_LaneOffsets[1])));
+		__m256i e2 = _mm256_add_epi32(_mm256_set1_epi32(job.m_Origin[2]), _mm256_load_si256(reinterpret_cast<__m256i const *>(job.m_LaneOffsets[2])));
+		__m256i const step0 = _mm256_set1_epi32(job.m_RowStep[0]);
+		__m256i const step1 = _mm256_set1_epi32(job.m_RowStep[1]);
+		__m256i const step2 = _mm256_set1_epi32(job.m_RowStep[2]);
+
+		uint64_t written = 0;
+		for (int r = 0; r < job.m_Rows; ++r, row += job.m_Stride) {
+			__m256i const inside = _mm256_andnot_si256(_mm256_srai_epi32(_mm256_or_si256(_mm256_or_si256(e0, e1), e2), 31), cols);
+			int const mask = _mm256_movemask_ps(_mm256_castsi256_ps(inside));
+			if (0 != mask) {
+				// masked-off lanes are never touched, so this is also safe at the right edge of the target
+				_mm256_maskstore_epi32(reinterpret_cast<int *>(row), inside, color);
+				written += popcount8(static_cast<unsigned int>(mask));
+			}
+			e0 = _mm256_add_epi32(e0, step0);
+			e1 = _mm256_add_epi32(e1, step1);
+			e2 = _mm256_add_epi32(e2, step2);
+		}
+		return written;
+	}
+
+	// SSE4.1 has nothing the block kernel needs over SSE2, and AVX-512 would only help with scatter (points/lines), so both fall back
+	SimdLevel kernelLevel(SimdLevel level) {
+		level = clampSimdLevel(level);
+		if (SimdLevel::AVX2 <= level) return SimdLevel::AVX2;
+		if (SimdLevel::SSE2 <= level) return SimdLevel::SSE2;
+		return SimdLevel::Scalar;
+	}
+
+	BlockKernel blockKernelFor(SimdLevel level) {
+		if (SimdLevel::AVX2 == level) return blockAVX2;
+		if (SimdLevel::SSE2 == level) return blockSSE2;
+		return blockScalar;
+	}
+
+
+
+	int32_t snapToSubpixel(float v) {
+		return static_cast<int32_t>(std::lround(std::min(std::max(v, -GUARD_BAND), GUARD_BAND) * SUBPIXEL_ONE));
+	}
+
+	// Liang-Barsky clip of p + t * d (t in [0, 1]) against one slab, narrows [t0, t1]
+	bool clipSlab(float p, float d, float lo, float hi, float &t0, float &t1) {
+		if (0.0f == d) return lo <= p && p <= hi;
+		float ta = (lo - p) / d;
+		float tb = (hi - p) / d;
+		if (ta > tb) std::swap(ta, tb);
+		t0 = std::max(t0, ta);
+		t1 = std::min(t1, tb);
+		return t0 <= t1;
+	}
+
+	// clip to the target and turn the segment into DDA steps, returns false if nothing is visible
+	bool setupLine(RasterTarget const &target, float const *a, float const *b, LineJob &job) {
+		if (!isFinite2(a) || !isFinite2(b)) return false;
+
+		float const dx = b[0] - a[0];
+		float const dy = b[1] - a[1];
+		float t0 = 0.0f;
+		float t1 = 1.0f;
+		// keep a hair inside the far edges so the last pixel is never width/height
+		float const maxX = static_cast<float>(target.m_Width) - 1.0f / SUBPIXEL_ONE;
+		float const maxY = static_cast<float>(target.m_Height) - 1.0f / SUBPIXEL_ONE;
+		if (!clipSlab(a[0], dx, 0.0f, maxX, t0, t1)) return false;
+		if (!clipSlab(a[1], dy, 0.0f, maxY, t0, t1)) return false;
+
+		float const x0 = a[0] + t0 * dx;
+		float const y0 = a[1] + t0 * dy;
+		float const cdx = (t1 - t0) * dx;
+		float const cdy = (t1 - t0) * dy;
+		int const steps = static_cast<int>(std::ceil(std::max(std::fabs(cdx), std::fabs(cdy))));
+
+		job.m_X0 = x0;
+		job.m_Y0 = y0;
+		job.m_StepX = (0 < steps) ? cdx / steps : 0.0f;
+		job.m_StepY = (0 < steps) ? cdy / steps : 0.0f;
+		job.m_Count = steps + 1;
+		return true;
+	}
+}
+
+
+
+PolygonMode polygonModeFromGL(unsigned int glMode) {
+	if (GL_POINT == glMode) return PolygonMode::Point;
+	if (GL_LINE == glMode) return PolygonMode::Line;
+	return PolygonMode::Fill;
+}
+
+
+
+Rasterizer::Rasterizer(SimdLevel level) : m_Level(kernelLevel(level)) {}
+
+void Rasterizer::setTarget(RasterTarget const &target) {
+	m_Target = target;
+}
+
+void Rasterizer::setPolygonMode(PolygonMode mode) {
+	m_Mode = mode;
+}
+
+void Rasterizer::setPointSize(int size) {
+	m_PointSize = std::min(std::max(size, 1), 64);
+}
+
+void Rasterizer::setColor(uint32_t color) {
+	m_Color = color;
+}
+
+void Rasterizer::clear(uint32_t color) {
+	if (nullptr == m_Target.m_Pixels) return;
+	for (int y = 0; y < m_Target.m_Height; ++y) {
+		uint32_t *row = m_Target.m_Pixels + static_cast<size_t>(y) * m_Target.m_Stride;
+		std::fill(row, row + m_Target.m_Width, color);
+	}
+}
+
+void Rasterizer::drawTriangles(float const *xy, size_t vertexCount) {
+	if (nullptr == m_Target.m_Pixels) return;
+	size_t const count = vertexCount - vertexCount % 3;
+	m_Stats.m_Triangles += count / 3;
+
+	if (PolygonMode::Point == m_Mode) {
+		m_Stats.m_Pixels += drawPoints(m_Target, xy, nullptr, count, m_PointSize, m_Color);
+		return;
+	}
+	for (size_t i = 0; i < count; i += 3) {
+		float const *v0 = xy + 2 * i;
+		if (PolygonMode::Line == m_Mode) lineTriangle(v0, v0 + 2, v0 + 4);
+		else fillTriangle(v0, v0 + 2, v0 + 4);
+	}
+}
+
+void Rasterizer::drawIndexed(float const *xy, unsigned int const *indices, size_t indexCount) {
+	if (nullptr == m_Target.m_Pixels) return;
+	size_t const count = indexCount - indexCount % 3;
+	m_Stats.m_Triangles += count / 3;
+
+	if (PolygonMode::Point == m_Mode) {
+		m_Stats.m_Pixels += drawPoints(m_Target, xy, indices, count, m_PointSize, m_Color);
+		return;
+	}
+	for (size_t i = 0; i < count; i += 3) {
+		float const *v0 = xy + 2 * static_cast<size_t>(indices[i]);
+		float const *v1 = xy + 2 * static_cast<size_t>(indices[i + 1]);
+		float const *v2 = xy + 2 * static_cast<size_t>(indices[i + 2]);
+		if (PolygonMode::Line == m_Mode) lineTriangle(v0, v1, v2);
+		else fillTriangle(v0, v1, v2);
+	}
+}
+
+
+
+void Rasterizer::lineTriangle(float const *v0, float const *v1, float const *v2) {
+	float const *verts[3] = {v0, v1, v2};
+	for (int e = 0; e < 3; ++e) {
+		LineJob job;
+		if (setupLine(m_Target, verts[e], verts[(e + 1) % 3], job)) m_Stats.m_Pixels += drawLine(m_Target, job, m_Color);
+	}
+}
+
+void Rasterizer::fillTriangle(float const *v0, float const *v1, float const *v2) {
+	if (!isFinite2(v0) || !isFinite2(v1) || !isFinite2(v2)) return;
+
+	// snap to 28.4 fixed point
+	int64_t X[3] = {snapToSubpixel(v0[0]), snapToSubpixel(v1[0]), snapToSubpixel(v2[0])};
+	int64_t Y[3] = {snapToSubpixel(v0[1]), snapToSubpixel(v1[1]), snapToSubpixel(v2[1])};
+
+	int64_t const area = (X[1] - X[0]) * (Y[2] - Y[0]) - (Y[1] - Y[0]) * (X[2] - X[0]);
+	if (0 == area) return; // degenerate
+	if (area < 0) {
+		// no face culling (GL default), just flip to a consistent winding so "inside" is always E >= 0
+		std::swap(X[1], X[2]);
+		std::swap(Y[1], Y[2]);
+	}
+
+	// pixel bounding box: pixel px is a candidate when its center (px * 16 + 8) is within [min, max]
+	int64_t const minXs = std::min(X[0], std::min(X[1], X[2]));
+	int64_t const maxXs = std::max(X[0], std::max(X[1], X[2]));
+	int64_t const minYs = std::min(Y[0], std::min(Y[1], Y[2]));
+	int64_t const maxYs = std::max(Y[0], std::max(Y[1], Y[2]));
+	int const minX = static_cast<int>(std::max<int64_t>((minXs - SUBPIXEL_HALF + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS, 0));
+	int const minY = static_cast<int>(std::max<int64_t>((minYs - SUBPIXEL_HALF + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS, 0));
+	int const maxX = static_cast<int>(std::min<int64_t>((maxXs - SUBPIXEL_HALF) >> SUBPIXEL_BITS, m_Target.m_Width - 1));
+	int const maxY = static_cast<int>(std::min<int64_t>((maxYs - SUBPIXEL_HALF) >> SUBPIXEL_BITS, m_Target.m_Height - 1));
+	if (minX > maxX || minY > maxY) return;
+
+	// edge functions E(px, py) = C + A16 * px + B16 * py, evaluated at pixel centers
+	int64_t C[3];
+	int32_t A16[3];
+	int32_t B16[3];
+	alignas(32) int32_t laneOffsets[3][BLOCK_SIZE];
+	for (int e = 0; e < 3; ++e) {
+		int const a = e;
+		int const b = (e + 1) % 3;
+		int64_t const A = Y[a] - Y[b];
+		int64_t const B = X[b] - X[a];
+		// top-left rule: pixels exactly on an edge only belong to the triangle if it's a top or left edge
+		bool const topLeft = (0 < A) || (0 == A && 0 < B);
+		C[e] = -(A * X[a] + B * Y[a]) + (A + B) * SUBPIXEL_HALF + (topLeft ? 0 : -1);
+		A16[e] = static_cast<int32_t>(A * SUBPIXEL_ONE);
+		B16[e] = static_cast<int32_t>(B * SUBPIXEL_ONE);
+		for (int i = 0; i < BLOCK_SIZE; ++i) laneOffsets[e][i] = i * A16[e];
+	}
+
+	BlockKernel const kernel = blockKernelFor(m_Level);
+	BlockJob job;
+	job.m_Stride = m_Target.m_Stride;
+	job.m_Color = m_Color;
+
+	int64_t const span = BLOCK_SIZE - 1;
+	for (int by = minY & ~(BLOCK_SIZE - 1); by <= maxY; by += BLOCK_SIZE) {
+		job.m_Rows = std::min(BLOCK_SIZE, m_Target.m_Height - by);
+		for (int bx = minX & ~(BLOCK_SIZE - 1); bx <= maxX; bx += BLOCK_SIZE) {
+			job.m_Cols = std::min(BLOCK_SIZE, m_Target.m_Width - bx);
+			job.m_Covered = true;
+
+			bool rejected = false;
+			for (int e = 0; e < 3; ++e) {
+				int64_t const origin = C[e] + static_cast<int64_t>(A16[e]) * bx + static_cast<int64_t>(B16[e]) * by;
+				// smallest/largest value of this edge over the 8x8 block, it's linear so a corner has it
+				int64_t const lo = origin + std::min<int64_t>(A16[e], 0) * span + std::min<int64_t>(B16[e], 0) * span;
+				int64_t const hi = origin + std::max<int64_t>(A16[e], 0) * span + std::max<int64_t>(B16[e], 0) * span;
+				if (hi < 0) {
+					rejected = true; // trivial reject, the whole block is outside this edge
+					break;
+				}
+				if (0 <= lo) {
+					// whole block is inside this edge, so it doesn't need testing per pixel
+					job.m_Origin[e] = 0;
+					job.m_RowStep[e] = 0;
+					job.m_LaneOffsets[e] = s_ZeroLanes;
+				}
+				else {
+					// the edge crosses the block, so |origin| is bounded by the block's range (fits an int32)
+					job.m_Covered = false;
+					job.m_Origin[e] = static_cast<int32_t>(origin);
+					job.m_RowStep[e] = B16[e];
+					job.m_LaneOffsets[e] = laneOffsets[e];
+				}
+			}
+			if (rejected) continue;
+
+			job.m_Row = m_Target.m_Pixels + static_cast<size_t>(by) * m_Target.m_Stride + bx;
+			m_Stats.m_Pixels += kernel(job);
+		}
+	}
+}
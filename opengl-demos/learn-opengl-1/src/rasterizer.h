@@ -0,0 +1,79 @@
+#pragma once
+
+#include "cpu_features.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// CPU triangle rasterizer (for software fallback, occlusion buffers, tooling previews, etc.)
+// - FILL: edge functions evaluated in 8x8 pixel blocks, each block is trivially rejected, trivially accepted (solid fill) or walked row by row in SIMD
+// - LINE: triangle edges drawn with a DDA
+// - POINT: triangle vertices drawn as pointSize x pointSize squares
+// - only FILL has SSE2/AVX2 kernels: vectorized LINE/POINT kernels benchmarked within noise of scalar (their writes are scattered
+//   single pixels), so those 2 modes run the scalar code at every SIMD level
+// - FILL writes exactly the same pixels whichever SIMD level is picked (the scalar path is the reference)
+// - fixed-point vertex positions (4 sub-pixel bits), pixel centers sampled at +0.5, top-left fill rule so shared edges are only drawn once
+
+
+
+// mirrors the 3 glPolygonMode() modes that keyCallback switches between (1/2/3 keys)
+enum class PolygonMode {
+	Point,
+	Line,
+	Fill
+};
+
+// GL_POINT / GL_LINE / GL_FILL -> PolygonMode (anything else is treated as GL_FILL, the GL default)
+PolygonMode polygonModeFromGL(unsigned int glMode);
+
+
+
+// 32-bit colour buffer, row 0 is the first row in memory (so y grows downwards)
+struct RasterTarget {
+	uint32_t *m_Pixels = nullptr;
+	int m_Width = 0;
+	int m_Height = 0;
+	int m_Stride = 0; // pixels (not bytes) between the starts of 2 rows
+};
+
+struct RasterStats {
+	uint64_t m_Triangles = 0; // triangles submitted (degenerate and fully off-screen ones included)
+	uint64_t m_Pixels = 0; // pixels written, overdraw included
+};
+
+
+
+class Rasterizer {
+public:
+	// the requested level is clamped to what the CPU supports, so the default just picks the widest available path
+	explicit Rasterizer(SimdLevel level = SimdLevel::AVX512);
+
+	void setTarget(RasterTarget const &target);
+	void setPolygonMode(PolygonMode mode);
+	void setPointSize(int size); // clamped to [1, 64]
+	void setColor(uint32_t color);
+
+	void clear(uint32_t color);
+
+	// positions are 2 floats (x, y) per vertex, already in target pixel coords (i.e. after the viewport transform)
+	// coords are clamped to a +-8192 pixel guard band, so clip anything bigger than that before submitting
+	// a NaN/inf coord drops its triangle (FILL), the 2 edges it's on (LINE) or just that vertex (POINT)
+	void drawTriangles(float const *xy, size_t vertexCount);
+	void drawIndexed(float const *xy, unsigned int const *indices, size_t indexCount);
+
+	SimdLevel getSimdLevel() const { return m_Level; }
+	PolygonMode getPolygonMode() const { return m_Mode; }
+	RasterStats const &getStats() const { return m_Stats; }
+	void resetStats() { m_Stats = RasterStats(); }
+
+private:
+	void fillTriangle(float const *v0, float const *v1, float const *v2);
+	void lineTriangle(float const *v0, float const *v1, float const *v2);
+
+	SimdLevel m_Level;
+	RasterTarget m_Target;
+	PolygonMode m_Mode = PolygonMode::Fill;
+	int m_PointSize = 1;
+	uint32_t m_Color = 0xFFFFFFFFu;
+	RasterStats m_Stats;
+};
@@ -0,0 +1,362 @@
+#include "resource_loader.h"
+
+//NOTE: must include glad before glfw
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <fstream>
+
+
+
+namespace {
+	size_t const MIN_SLICE = 64 * 1024; // bytes, what goes up when the budget is already spent
+
+	bool readFile(std::string const &path, std::vector<uint8_t> &bytes) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) return false;
+		std::streamoff const size = file.tellg();
+		if (size < 0) return false;
+		bytes.resize(static_cast<size_t>(size));
+		file.seekg(0);
+		return bytes.empty() || static_cast<bool>(file.read(reinterpret_cast<char *>(bytes.data()), size));
+	}
+
+	size_t bytesPerPixel(GLenum format, GLenum type) {
+		size_t components = 4;
+		if (GL_RED == format) components = 1;
+		else if (GL_RG == format) components = 2;
+		else if (GL_RGB == format || GL_BGR == format) components = 3;
+
+		if (GL_FLOAT == type) return components * 4;
+		if (GL_HALF_FLOAT == type || GL_UNSIGNED_SHORT == type) return components * 2;
+		return components; // GL_UNSIGNED_BYTE
+	}
+
+	int levelSize(int size, int level) {
+		return std::max(1, size >> level);
+	}
+
+	// all the levels of a Texture2D
+	size_t textureBytes(DecodedResource const &decoded) {
+		size_t const pixelBytes = bytesPerPixel(decoded.m_Format, decoded.m_Type);
+		size_t bytes = 0;
+		for (int level = 0; level < decoded.m_LevelCount; ++level) {
+			bytes += static_cast<size_t>(levelSize(decoded.m_Width, level)) * levelSize(decoded.m_Height, level) * pixelBytes;
+		}
+		return bytes;
+	}
+}
+
+
+
+ResourceDecoder rawBufferDecoder(unsigned int usage) {
+	return [usage](std::vector<uint8_t> const &file, DecodedResource &out) {
+		out.m_Kind = ResourceKind::Buffer;
+		out.m_Usage = usage;
+		out.m_Data = file;
+		return true;
+	};
+}
+
+
+
+ResourceLoader::ResourceLoader(unsigned int ioThreads, size_t uploadBudget) : m_UploadBudget(uploadBudget) {
+	for (unsigned int i = 0; i < std::max(1u, ioThreads); ++i) m_IOThreads.emplace_back(&ResourceLoader::ioLoop, this);
+}
+
+ResourceLoader::~ResourceLoader() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+	m_WorkAvailable.notify_all();
+	m_UploadAvailable.notify_all();
+	for (std::thread &thread : m_IOThreads) thread.join();
+	if (m_UploadThread.joinable()) m_UploadThread.join();
+	if (nullptr != m_UploadWindow) glfwDestroyWindow(m_UploadWindow);
+
+	for (FencedUpload const &upload : m_FencedUploads) glDeleteSync(static_cast<GLsync>(upload.m_Fence));
+
+	for (std::unique_ptr<Entry> const &entry : m_Entries) {
+		GLuint const object = 0 != entry->m_Object ? entry->m_Object : entry->m_UploadObject;
+		if (0 == object) continue;
+		if (ResourceKind::Buffer == entry->m_Decoded.m_Kind) glDeleteBuffers(1, &object);
+		else glDeleteTextures(1, &object);
+	}
+}
+
+
+
+ResourceId ResourceLoader::addEntry(std::unique_ptr<Entry> entry, int priority) {
+	ResourceId id;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		id = static_cast<ResourceId>(m_Entries.size());
+		entry->m_Priority = priority;
+		m_Entries.push_back(std::move(entry));
+		m_LoadQueue.push(QueueItem{ priority, m_NextSequence++, id });
+	}
+	m_WorkAvailable.notify_one();
+	return id;
+}
+
+ResourceId ResourceLoader::request(std::string const &path, ResourceDecoder decoder, int priority) {
+	std::unique_ptr<Entry> entry(new Entry());
+	entry->m_Path = path;
+	entry->m_Decoder = std::move(decoder);
+	return addEntry(std::move(entry), priority);
+}
+
+ResourceId ResourceLoader::request(ResourceProducer producer, int priority) {
+	std::unique_ptr<Entry> entry(new Entry());
+	entry->m_Producer = std::move(producer);
+	return addEntry(std::move(entry), priority);
+}
+
+void ResourceLoader::setPriority(ResourceId id, int priority) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	Entry &entry = *m_Entries[id];
+	if (entry.m_Priority == priority) return;
+	entry.m_Priority = priority;
+	// the old queue item is now stale (its priority doesn't match any more), so queue it again at the new one
+	if (ResourceState::Queued == entry.m_State) m_LoadQueue.push(QueueItem{ priority, m_NextSequence++, id });
+}
+
+ResourceState ResourceLoader::getState(ResourceId id) const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Entries[id]->m_State;
+}
+
+unsigned int ResourceLoader::getObject(ResourceId id) const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Entries[id]->m_Object;
+}
+
+size_t ResourceLoader::getPendingCount() const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return std::count_if(m_Entries.begin(), m_Entries.end(), [](std::unique_ptr<Entry> const &entry) {
+		return ResourceState::Ready != entry->m_State && ResourceState::Failed != entry->m_State;
+	});
+}
+
+
+
+void ResourceLoader::ioLoop() {
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true) {
+		m_WorkAvailable.wait(lock, [this]() { return m_Quit || !m_LoadQueue.empty(); });
+		if (m_Quit) return;
+
+		QueueItem const item = m_LoadQueue.top();
+		m_LoadQueue.pop();
+		Entry &entry = *m_Entries[item.m_Id];
+		if (ResourceState::Queued != entry.m_State || entry.m_Priority != item.m_Priority) continue; // stale
+
+		entry.m_State = ResourceState::Loading;
+		std::string const path = entry.m_Path;
+		ResourceDecoder const decoder = std::move(entry.m_Decoder);
+		ResourceProducer const producer = std::move(entry.m_Producer);
+
+		// the slow part, without the lock
+		lock.unlock();
+		DecodedResource decoded;
+		bool ok;
+		if (producer) {
+			ok = producer(decoded);
+		}
+		else {
+			std::vector<uint8_t> file;
+			ok = readFile(path, file) && decoder(file, decoded);
+		}
+		if (ok && ResourceKind::Texture2D == decoded.m_Kind) {
+			// uploadSlice() trusts the rows to be all there
+			ok = 0 < decoded.m_Width && 0 < decoded.m_Height && 0 < decoded.m_LevelCount && 32 >= decoded.m_LevelCount &&
+				decoded.m_Data.size() == textureBytes(decoded);
+		}
+		lock.lock();
+
+		if (ok) {
+			entry.m_Decoded = std::move(decoded);
+			entry.m_State = ResourceState::Uploading;
+			m_UploadQueue.push_back(item.m_Id);
+			m_UploadAvailable.notify_one();
+		}
+		else {
+			entry.m_State = ResourceState::Failed;
+		}
+	}
+}
+
+
+
+bool ResourceLoader::startUploadThread(GLFWwindow *mainWindow) {
+	if (nullptr != m_UploadWindow) return true;
+
+	// window hints stick around from the main window's creation (same version/profile), so only visibility needs changing
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	m_UploadWindow = glfwCreateWindow(1, 1, "upload", NULL, mainWindow); // last param = share objects with mainWindow's context
+	glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+	if (nullptr == m_UploadWindow) return false;
+
+	m_UploadThread = std::thread(&ResourceLoader::uploadLoop, this);
+	return true;
+}
+
+void ResourceLoader::uploadLoop() {
+	glfwMakeContextCurrent(m_UploadWindow);
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true) {
+		m_UploadAvailable.wait(lock, [this]() { return m_Quit || !m_UploadQueue.empty(); });
+		if (m_Quit) break;
+
+		// highest priority first, same as uploadPending()
+		std::vector<ResourceId>::iterator next = m_UploadQueue.begin();
+		for (std::vector<ResourceId>::iterator it = m_UploadQueue.begin(); it != m_UploadQueue.end(); ++it) {
+			if (m_Entries[*next]->m_Priority < m_Entries[*it]->m_Priority) next = it;
+		}
+		ResourceId const id = *next;
+		m_UploadQueue.erase(next);
+		Entry &entry = *m_Entries[id];
+
+		// all of it in one go, there's no frame to protect on this thread
+		lock.unlock();
+		size_t uploaded = 0;
+		uploadSlice(entry, SIZE_MAX, uploaded);
+		GLsync const fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush(); // the fence has to reach the GPU, otherwise a wait on it from the main context can hang
+		lock.lock();
+
+		m_FencedUploads.push_back(FencedUpload{ id, fence });
+	}
+	lock.unlock();
+
+	glfwMakeContextCurrent(NULL);
+}
+
+size_t ResourceLoader::uploadPending() {
+	if (nullptr != m_UploadWindow) {
+		// the upload thread did the work, just make the main context's command stream wait for it on the GPU
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (FencedUpload const &upload : m_FencedUploads) {
+			GLsync const fence = static_cast<GLsync>(upload.m_Fence);
+			glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+			glDeleteSync(fence); // only flags it, it stays alive until the wait is done
+			Entry &entry = *m_Entries[upload.m_Id];
+			entry.m_Object = entry.m_UploadObject;
+			entry.m_State = ResourceState::Ready;
+			std::vector<uint8_t>().swap(entry.m_Decoded.m_Data);
+		}
+		m_FencedUploads.clear();
+		return 0;
+	}
+
+	size_t uploaded = 0;
+	while (uploaded < m_UploadBudget || 0 == uploaded) {
+		// highest priority first (the queue is short, a linear scan is fine)
+		Entry *entry = nullptr;
+		size_t queueIndex = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_UploadQueue.empty()) break;
+			for (size_t i = 0; i < m_UploadQueue.size(); ++i) {
+				Entry *candidate = m_Entries[m_UploadQueue[i]].get();
+				if (nullptr == entry || entry->m_Priority < candidate->m_Priority) {
+					entry = candidate;
+					queueIndex = i;
+				}
+			}
+		}
+
+		size_t const budget = m_UploadBudget > uploaded ? m_UploadBudget - uploaded : 0;
+		if (!uploadSlice(*entry, budget, uploaded)) break; // budget used up partway through
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		entry->m_Object = entry->m_UploadObject;
+		entry->m_State = ResourceState::Ready;
+		std::vector<uint8_t>().swap(entry->m_Decoded.m_Data); // the GPU has its copy now
+		m_UploadQueue.erase(m_UploadQueue.begin() + queueIndex);
+	}
+	return uploaded;
+}
+
+bool ResourceLoader::uploadSlice(Entry &entry, size_t budget, size_t &uploaded) {
+	DecodedResource const &decoded = entry.m_Decoded;
+	size_t const total = decoded.m_Data.size();
+	size_t const remaining = total - entry.m_UploadedBytes;
+
+	if (ResourceKind::Buffer == decoded.m_Kind) {
+		// GL_COPY_WRITE_BUFFER isn't part of any VAO, so whatever is bound for drawing stays untouched
+		if (0 == entry.m_UploadObject) {
+			glGenBuffers(1, &entry.m_UploadObject);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, entry.m_UploadObject);
+			glBufferData(GL_COPY_WRITE_BUFFER, total, nullptr, decoded.m_Usage); // allocate once, fill in slices
+		}
+		else {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, entry.m_UploadObject);
+		}
+
+		size_t const slice = std::min(remaining, std::max(budget, MIN_SLICE));
+		if (0 < slice) glBufferSubData(GL_COPY_WRITE_BUFFER, entry.m_UploadedBytes, slice, decoded.m_Data.data() + entry.m_UploadedBytes);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		entry.m_UploadedBytes += slice;
+		uploaded += slice;
+		return total == entry.m_UploadedBytes;
+	}
+
+	// Texture2D: whole rows per slice, level after level (a level is finished before the next one starts)
+	GLint previousTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	if (0 == entry.m_UploadObject) {
+		glGenTextures(1, &entry.m_UploadObject);
+		glBindTexture(GL_TEXTURE_2D, entry.m_UploadObject);
+		for (int level = 0; level < decoded.m_LevelCount; ++level) {
+			glTexImage2D(GL_TEXTURE_2D, level, decoded.m_InternalFormat, levelSize(decoded.m_Width, level), levelSize(decoded.m_Height, level), 0,
+				decoded.m_Format, decoded.m_Type, nullptr);
+		}
+		if (1 < decoded.m_LevelCount) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, decoded.m_LevelCount - 1); // complete without a full chain
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, 1 < decoded.m_LevelCount ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	else {
+		glBindTexture(GL_TEXTURE_2D, entry.m_UploadObject);
+	}
+
+	size_t const pixelBytes = bytesPerPixel(decoded.m_Format, decoded.m_Type);
+	size_t sliceBudget = std::max(budget, MIN_SLICE);
+	size_t levelStart = 0;
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows are tightly packed
+	for (int level = 0; level < decoded.m_LevelCount && 0 < sliceBudget; ++level) {
+		int const width = levelSize(decoded.m_Width, level);
+		int const height = levelSize(decoded.m_Height, level);
+		size_t const rowBytes = width * pixelBytes;
+		size_t const levelBytes = rowBytes * height;
+		if (entry.m_UploadedBytes >= levelStart + levelBytes) {
+			levelStart += levelBytes;
+			continue;
+		}
+
+		int const firstRow = static_cast<int>((entry.m_UploadedBytes - levelStart) / rowBytes);
+		size_t const budgetRows = std::max<size_t>(1, sliceBudget / rowBytes);
+		int const rows = static_cast<int>(std::min<size_t>(height - firstRow, budgetRows));
+		glTexSubImage2D(GL_TEXTURE_2D, level, 0, firstRow, width, rows, decoded.m_Format, decoded.m_Type, decoded.m_Data.data() + levelStart + firstRow * rowBytes);
+
+		size_t const slice = rows * rowBytes;
+		entry.m_UploadedBytes += slice;
+		uploaded += slice;
+		sliceBudget = slice < sliceBudget ? sliceBudget - slice : 0;
+		if (firstRow + rows < height) break; // budget used up partway through this level, the next slice carries on from its row
+		levelStart += levelBytes;
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	bool const done = total == entry.m_UploadedBytes;
+	if (done && 1 == decoded.m_LevelCount && decoded.m_GenerateMipmaps) {
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	}
+	glBindTexture(GL_TEXTURE_2D, previousTexture);
+	return done;
+}
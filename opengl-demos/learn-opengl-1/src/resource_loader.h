@@ -0,0 +1,147 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// asynchronous resource loading, so a big scene shows up piece by piece instead of blocking startup
+// - request() puts a load on a priority queue, I/O threads read the file and run its decoder (no GL involved)
+// - uploadPending() runs on the GL thread once per frame and sends at most the upload budget worth of bytes to the GPU
+//   (glBufferSubData / glTexSubImage2D slices, so 1 huge resource is spread over several frames instead of causing a hitch)
+// - every resource can be polled for its state, the GL object name is valid once it's Ready
+// - optionally startUploadThread(): a hidden window's context (shared with the main one) does the uploads on its own thread,
+//   each finished resource gets a glFenceSync and uploadPending() only queues a glWaitSync for it (no CPU stall, no upload in the frame)
+
+
+
+struct GLFWwindow;
+
+typedef uint32_t ResourceId;
+
+enum class ResourceState {
+	Queued, // waiting for an I/O thread
+	Loading, // being read/decoded
+	Uploading, // decoded, waiting for (or partway through) its uploads
+	Ready,
+	Failed
+};
+
+enum class ResourceKind {
+	Buffer,
+	Texture2D
+};
+
+// what a decoder hands over for upload, GL enums are kept as unsigned int so this header doesn't need glad
+struct DecodedResource {
+	ResourceKind m_Kind = ResourceKind::Buffer;
+	std::vector<uint8_t> m_Data;
+
+	// Buffer (uploaded through GL_COPY_WRITE_BUFFER, so it can be bound as anything afterwards and the bound VAO is left alone)
+	unsigned int m_Usage = 0; // e.g. GL_STATIC_DRAW
+
+	// Texture2D (tightly packed rows, bottom row first like glTexImage2D expects)
+	int m_Width = 0; // of level 0
+	int m_Height = 0;
+	int m_LevelCount = 1; // m_Data holds the levels back to back, level 0 first, each half the size of the one before (e.g. texture_import.h)
+	unsigned int m_InternalFormat = 0; // e.g. GL_RGBA8, GL_SRGB8_ALPHA8
+	unsigned int m_Format = 0; // e.g. GL_RGBA
+	unsigned int m_Type = 0; // e.g. GL_UNSIGNED_BYTE
+	bool m_GenerateMipmaps = true; // ignored when the levels are already there (m_LevelCount > 1)
+};
+
+// file bytes -> upload-ready data (runs on an I/O thread), false = failed
+typedef std::function<bool(std::vector<uint8_t> const &file, DecodedResource &out)> ResourceDecoder;
+// for resources that are generated rather than read (runs on an I/O thread), false = failed
+typedef std::function<bool(DecodedResource &out)> ResourceProducer;
+
+// decoder that uploads the file as is into a buffer object
+ResourceDecoder rawBufferDecoder(unsigned int usage);
+
+
+
+class ResourceLoader {
+public:
+	static size_t const DEFAULT_UPLOAD_BUDGET = 4 * 1024 * 1024; // bytes per frame
+
+	explicit ResourceLoader(unsigned int ioThreads = 2, size_t uploadBudget = DEFAULT_UPLOAD_BUDGET);
+	~ResourceLoader(); // finishes the load in progress on every I/O thread, deletes the GL objects (needs the GL context to still be current)
+
+	ResourceLoader(ResourceLoader const &) = delete;
+	ResourceLoader &operator=(ResourceLoader const &) = delete;
+
+	// higher priority = loaded and uploaded first, equal priorities go in request order
+	ResourceId request(std::string const &path, ResourceDecoder decoder, int priority = 0);
+	ResourceId request(ResourceProducer producer, int priority = 0);
+
+	// only has an effect while the resource is still Queued or Uploading (e.g. bump whatever just came into view)
+	void setPriority(ResourceId id, int priority);
+
+	ResourceState getState(ResourceId id) const;
+	bool isReady(ResourceId id) const { return ResourceState::Ready == getState(id); }
+	unsigned int getObject(ResourceId id) const; // buffer/texture name, 0 until Ready
+
+	// main thread, after mainWindow's context is created and current (GLFW only creates windows on the main thread)
+	// the other context reuses the glad function pointers, which is fine for contexts of the same window/pixel format
+	// returns false (and keeps uploading in uploadPending()) if the shared context can't be created
+	bool startUploadThread(GLFWwindow *mainWindow);
+
+	// GL thread, once per frame, returns the bytes uploaded (at least 1 slice if anything is waiting, even over budget)
+	// with the upload thread running it only hands over what that thread has finished (returns 0)
+	// NOTE: bind a resource again after it turns Ready, GL only guarantees another context's changes are seen after a (re)bind
+	size_t uploadPending();
+
+	void setUploadBudget(size_t bytes) { m_UploadBudget = bytes; }
+	size_t getUploadBudget() const { return m_UploadBudget; }
+	size_t getPendingCount() const; // not Ready or Failed yet
+
+private:
+	struct Entry {
+		std::string m_Path;
+		ResourceDecoder m_Decoder;
+		ResourceProducer m_Producer;
+		int m_Priority = 0;
+		ResourceState m_State = ResourceState::Queued;
+		DecodedResource m_Decoded;
+		size_t m_UploadedBytes = 0; // how far the slices have got (GL thread only)
+		unsigned int m_UploadObject = 0; // GL thread only, becomes m_Object once Ready
+		unsigned int m_Object = 0;
+	};
+
+	struct QueueItem {
+		int m_Priority;
+		uint64_t m_Sequence;
+		ResourceId m_Id;
+		bool operator<(QueueItem const &other) const { return m_Priority < other.m_Priority || (m_Priority == other.m_Priority && m_Sequence > other.m_Sequence); }
+	};
+
+	struct FencedUpload {
+		ResourceId m_Id;
+		void *m_Fence; // GLsync, finished uploads of the upload thread
+	};
+
+	ResourceId addEntry(std::unique_ptr<Entry> entry, int priority);
+	void ioLoop();
+	void uploadLoop();
+	bool uploadSlice(Entry &entry, size_t budget, size_t &uploaded); // GL thread, true once the whole resource is on the GPU
+
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_WorkAvailable;
+	std::vector<std::unique_ptr<Entry>> m_Entries; // indexed by ResourceId
+	std::priority_queue<QueueItem> m_LoadQueue; // stale items (priority changed / already taken) are skipped
+	std::vector<ResourceId> m_UploadQueue; // decoded, waiting for uploadPending() (or the upload thread)
+	std::condition_variable m_UploadAvailable;
+	std::vector<FencedUpload> m_FencedUploads;
+	uint64_t m_NextSequence = 0;
+	size_t m_UploadBudget;
+	bool m_Quit = false;
+	std::vector<std::thread> m_IOThreads;
+	GLFWwindow *m_UploadWindow = nullptr; // hidden, only there for its context
+	std::thread m_UploadThread;
+};
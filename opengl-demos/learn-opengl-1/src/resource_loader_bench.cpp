@@ -0,0 +1,152 @@
+#include "benchmarks.h"
+#include "resource_loader.h"
+
+//NOTE: must include glad before glfw
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+
+// sliced texture uploads through ResourceLoader::uploadPending(): textures with several mip levels go up over several budget-limited
+// frames (the budget runs out partway through a level), then every level is read back and compared against the source
+// - no frame uploads more than the budget, the frames add up to the whole texture, no GL errors
+// - budgets are above the loader's minimum slice and above any row, so the budget is what splits the uploads
+// needs a GL context, so a hidden window is created
+
+
+
+namespace {
+	struct SliceCase {
+		int m_Width;
+		int m_Height;
+		int m_LevelCount;
+		unsigned int m_Format; // GL_RGBA or GL_RGB, 8 bits per channel
+		size_t m_Budget;
+	};
+
+	SliceCase const SLICE_CASES[] = {
+		{ 1500, 1500, 2, GL_RGBA, 4 * 1024 * 1024 }, // level 0 takes 3 frames, the budget runs out partway through it twice
+		{ 1500, 1000, 11, GL_RGBA, 1024 * 1024 }, // full chain, odd sizes
+		{ 333, 200, 9, GL_RGB, 70 * 1024 }, // full chain, rows that aren't a multiple of 4 bytes
+	};
+
+	int const MAX_FRAMES = 1000; // a loader that stops making progress fails instead of hanging
+
+	int levelSize(int size, int level) {
+		return std::max(1, size >> level);
+	}
+
+	size_t levelBytes(SliceCase const &sliceCase, int level) {
+		size_t const pixelBytes = GL_RGBA == sliceCase.m_Format ? 4 : 3;
+		return levelSize(sliceCase.m_Width, level) * levelSize(sliceCase.m_Height, level) * pixelBytes;
+	}
+
+	// levels back to back like DecodedResource wants them, random so a row in the wrong place shows up in the read back
+	std::vector<uint8_t> makeLevels(SliceCase const &sliceCase, unsigned int seed) {
+		size_t total = 0;
+		for (int level = 0; level < sliceCase.m_LevelCount; ++level) total += levelBytes(sliceCase, level);
+		std::vector<uint8_t> data(total);
+		std::mt19937 rng(seed);
+		for (uint8_t &byte : data) byte = static_cast<uint8_t>(rng());
+		return data;
+	}
+
+	// uploads the case until it's Ready and checks it, false = mismatch (printed)
+	bool runCase(SliceCase const &sliceCase, unsigned int seed) {
+		std::vector<uint8_t> const source = makeLevels(sliceCase, seed);
+		ResourceLoader loader(1, sliceCase.m_Budget);
+		ResourceId const id = loader.request([&sliceCase, &source](DecodedResource &out) {
+			out.m_Kind = ResourceKind::Texture2D;
+			out.m_Data = source;
+			out.m_Width = sliceCase.m_Width;
+			out.m_Height = sliceCase.m_Height;
+			out.m_LevelCount = sliceCase.m_LevelCount;
+			out.m_InternalFormat = GL_RGBA == sliceCase.m_Format ? GL_RGBA8 : GL_RGB8;
+			out.m_Format = sliceCase.m_Format;
+			out.m_Type = GL_UNSIGNED_BYTE;
+			return true;
+		});
+
+		int frames = 0;
+		size_t uploaded = 0;
+		size_t largestFrame = 0;
+		double uploadSeconds = 0.0;
+		while (ResourceState::Ready != loader.getState(id) && ResourceState::Failed != loader.getState(id) && frames < MAX_FRAMES) {
+			double const start = benchSeconds();
+			size_t const bytes = loader.uploadPending();
+			uploadSeconds += benchSeconds() - start;
+			if (0 == bytes) {
+				std::this_thread::yield(); // still decoding
+				continue;
+			}
+			++frames;
+			uploaded += bytes;
+			largestFrame = std::max(largestFrame, bytes);
+		}
+
+		bool ok = ResourceState::Ready == loader.getState(id) && source.size() == uploaded && largestFrame <= sliceCase.m_Budget;
+		ok = ok && static_cast<size_t>(frames) >= (source.size() + sliceCase.m_Budget - 1) / sliceCase.m_Budget;
+
+		// every level against the source
+		std::vector<uint8_t> readBack;
+		size_t levelStart = 0;
+		glBindTexture(GL_TEXTURE_2D, loader.getObject(id));
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		for (int level = 0; level < sliceCase.m_LevelCount; ++level) {
+			size_t const bytes = levelBytes(sliceCase, level);
+			readBack.assign(bytes, 0);
+			glGetTexImage(GL_TEXTURE_2D, level, sliceCase.m_Format, GL_UNSIGNED_BYTE, readBack.data());
+			if (!std::equal(readBack.begin(), readBack.end(), source.begin() + levelStart)) {
+				std::printf("  level %d differs\n", level);
+				ok = false;
+			}
+			levelStart += bytes;
+		}
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		GLenum const error = glGetError();
+		ok = ok && GL_NO_ERROR == error;
+
+		std::printf("%5dx%-5d %6s %3d %10zu %8d %12zu %10.2f %s\n", sliceCase.m_Width, sliceCase.m_Height, GL_RGBA == sliceCase.m_Format ? "RGBA8" : "RGB8",
+			sliceCase.m_LevelCount, sliceCase.m_Budget / 1024, frames, largestFrame / 1024, uploadSeconds * 1e3, ok ? "ok" : "MISMATCH");
+		if (GL_NO_ERROR != error) std::printf("  GL error 0x%x\n", error);
+		return ok;
+	}
+}
+
+
+
+int resourceLoaderBenchMain() {
+	if (!glfwInit()) return -1;
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow *window = glfwCreateWindow(64, 64, "resource loader bench", NULL, NULL);
+	if (NULL == window) {
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+		glfwTerminate();
+		return -1;
+	}
+
+	std::printf("%11s %6s %3s %10s %8s %12s %10s\n", "size", "format", "lvl", "budget KB", "frames", "max frame KB", "upload ms");
+	bool ok = true;
+	unsigned int seed = 0;
+	for (SliceCase const &sliceCase : SLICE_CASES) ok = runCase(sliceCase, seed++) && ok;
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+
+	if (!ok) std::printf("MISMATCH: see above\n");
+	return ok ? 0 : -1;
+}
@@ -0,0 +1,219 @@
+#include "scene_graph.h"
+
+#include <glm/geometric.hpp> // glm::dot, glm::length
+
+#include <algorithm>
+#include <cmath>
+
+
+
+void serialFor(size_t count, std::function<void(size_t begin, size_t end)> const &body) {
+	if (0 < count) body(0, count);
+}
+
+
+
+SceneNodeId SceneGraph::createNode(SceneNodeId parent, AffineTransform const &local) {
+	SceneNodeId const node = static_cast<SceneNodeId>(m_SlotOfNode.size());
+	Slot const slot = static_cast<Slot>(m_NodeOfSlot.size());
+
+	// appended unsorted, the next update() re-sorts everything
+	m_SlotOfNode.push_back(slot);
+	m_NodeOfSlot.push_back(node);
+	m_ParentSlot.push_back(INVALID_SCENE_NODE == parent ? INVALID_SCENE_NODE : m_SlotOfNode[parent]);
+	m_FirstChild.push_back(0);
+	m_ChildCount.push_back(0);
+	m_Local.push_back(local);
+	m_World.push_back(local);
+	m_Bounds.push_back(glm::vec4(0.0f, 0.0f, 0.0f, -1.0f));
+	m_QueuedStamp.push_back(0);
+	m_DirtyFlag.push_back(0);
+	m_StructureDirty = true;
+	return node;
+}
+
+SceneNodeId SceneGraph::getParent(SceneNodeId node) const {
+	Slot const parent = m_ParentSlot[m_SlotOfNode[node]];
+	return INVALID_SCENE_NODE == parent ? INVALID_SCENE_NODE : m_NodeOfSlot[parent];
+}
+
+void SceneGraph::setLocalTransform(SceneNodeId node, AffineTransform const &local) {
+	m_Local[m_SlotOfNode[node]] = local;
+	if (!m_DirtyFlag[node]) {
+		m_DirtyFlag[node] = 1;
+		m_DirtyNodes.push_back(node);
+	}
+}
+
+void SceneGraph::setBoundingSphere(SceneNodeId node, glm::vec3 const &center, float radius) {
+	m_Bounds[m_SlotOfNode[node]] = glm::vec4(center, radius);
+}
+
+
+
+void SceneGraph::rebuild() {
+	size_t const count = m_SlotOfNode.size();
+
+	// parent node id per node id (m_ParentSlot is in the old slot order)
+	std::vector<SceneNodeId> parentOf(count);
+	for (size_t slot = 0; slot < count; ++slot) {
+		Slot const parent = m_ParentSlot[slot];
+		parentOf[m_NodeOfSlot[slot]] = INVALID_SCENE_NODE == parent ? INVALID_SCENE_NODE : m_NodeOfSlot[parent];
+	}
+
+	// children per node id (CSR, counting sort by parent keeps them in creation order)
+	std::vector<uint32_t> childStart(count + 1, 0);
+	for (size_t node = 0; node < count; ++node) {
+		if (INVALID_SCENE_NODE != parentOf[node]) ++childStart[parentOf[node] + 1];
+	}
+	for (size_t node = 0; node < count; ++node) childStart[node + 1] += childStart[node];
+	std::vector<SceneNodeId> children(childStart[count]);
+	std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+	for (size_t node = 0; node < count; ++node) {
+		if (INVALID_SCENE_NODE != parentOf[node]) children[fill[parentOf[node]]++] = static_cast<SceneNodeId>(node);
+	}
+
+	// breadth-first: roots, then the children of every node in order, so depth never decreases and siblings stay together
+	std::vector<SceneNodeId> order;
+	order.reserve(count);
+	for (size_t node = 0; node < count; ++node) {
+		if (INVALID_SCENE_NODE == parentOf[node]) order.push_back(static_cast<SceneNodeId>(node));
+	}
+	std::vector<uint32_t> depth(count, 0);
+	m_LevelStart.clear();
+	for (size_t i = 0; i < order.size(); ++i) {
+		SceneNodeId const node = order[i];
+		if (m_LevelStart.size() <= depth[node]) m_LevelStart.push_back(i);
+		for (uint32_t c = childStart[node]; c < childStart[node + 1]; ++c) {
+			depth[children[c]] = depth[node] + 1;
+			order.push_back(children[c]);
+		}
+	}
+	m_LevelStart.push_back(count);
+
+	std::vector<Slot> newSlot(count);
+	for (size_t i = 0; i < count; ++i) newSlot[order[i]] = static_cast<Slot>(i);
+
+	std::vector<AffineTransform> local(count);
+	std::vector<glm::vec4> bounds(count);
+	for (size_t i = 0; i < count; ++i) {
+		SceneNodeId const node = order[i];
+		local[i] = m_Local[m_SlotOfNode[node]];
+		bounds[i] = m_Bounds[m_SlotOfNode[node]];
+		m_NodeOfSlot[i] = node;
+		m_ParentSlot[i] = INVALID_SCENE_NODE == parentOf[node] ? INVALID_SCENE_NODE : newSlot[parentOf[node]];
+		m_ChildCount[i] = childStart[node + 1] - childStart[node];
+		m_FirstChild[i] = 0 < m_ChildCount[i] ? newSlot[children[childStart[node]]] : 0;
+	}
+	m_SlotOfNode.swap(newSlot);
+	m_Local.swap(local);
+	m_Bounds.swap(bounds);
+	std::fill(m_QueuedStamp.begin(), m_QueuedStamp.end(), 0);
+
+	if (m_Frontier.size() < m_LevelStart.size()) m_Frontier.resize(m_LevelStart.size());
+	m_StructureDirty = false;
+}
+
+void SceneGraph::computeWorld(Slot slot) {
+	Slot const parent = m_ParentSlot[slot];
+	m_World[slot] = INVALID_SCENE_NODE == parent ? m_Local[slot] : m_World[parent] * m_Local[slot];
+}
+
+void SceneGraph::update(ParallelForFn const &parallelFor) {
+	m_Changed.clear();
+
+	if (m_StructureDirty) {
+		// new nodes: recompute everything, level by level
+		rebuild();
+		for (SceneNodeId const node : m_DirtyNodes) m_DirtyFlag[node] = 0;
+		m_DirtyNodes.clear();
+
+		for (size_t level = 0; level + 1 < m_LevelStart.size(); ++level) {
+			size_t const first = m_LevelStart[level];
+			parallelFor(m_LevelStart[level + 1] - first, [this, first](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) computeWorld(static_cast<Slot>(first + i));
+			});
+		}
+		m_Changed = m_NodeOfSlot;
+		return;
+	}
+
+	if (m_DirtyNodes.empty()) return;
+
+	if (0 == ++m_Stamp) {
+		std::fill(m_QueuedStamp.begin(), m_QueuedStamp.end(), 0);
+		m_Stamp = 1;
+	}
+
+	// bucket the dirty nodes by depth (a node whose ancestor is also dirty gets queued once, whichever comes first)
+	for (SceneNodeId const node : m_DirtyNodes) {
+		m_DirtyFlag[node] = 0;
+		Slot const slot = m_SlotOfNode[node];
+		if (m_Stamp == m_QueuedStamp[slot]) continue;
+		m_QueuedStamp[slot] = m_Stamp;
+		size_t const level = std::upper_bound(m_LevelStart.begin(), m_LevelStart.end(), static_cast<size_t>(slot)) - m_LevelStart.begin() - 1;
+		m_Frontier[level].push_back(slot);
+	}
+	m_DirtyNodes.clear();
+
+	// every queued node only reads its parent's world transform (finished in the previous level), so a level runs in parallel,
+	// then its children (contiguous per parent) are queued for the next level
+	for (size_t level = 0; level + 1 < m_LevelStart.size(); ++level) {
+		std::vector<Slot> &queued = m_Frontier[level];
+		if (queued.empty()) continue;
+
+		parallelFor(queued.size(), [this, &queued](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) computeWorld(queued[i]);
+		});
+
+		std::vector<Slot> &next = m_Frontier[level + 1];
+		for (Slot const slot : queued) {
+			m_Changed.push_back(m_NodeOfSlot[slot]);
+			Slot const last = m_FirstChild[slot] + m_ChildCount[slot];
+			for (Slot child = m_FirstChild[slot]; child < last; ++child) {
+				if (m_Stamp == m_QueuedStamp[child]) continue;
+				m_QueuedStamp[child] = m_Stamp;
+				next.push_back(child);
+			}
+		}
+		queued.clear();
+	}
+}
+
+
+
+void SceneGraph::cullSpheres(glm::mat4 const &viewProjection, std::vector<SceneNodeId> &visible) const {
+	// frustum planes straight from the rows of viewProjection (w +- x, w +- y, w +- z), normalized so distances are in world units
+	glm::vec4 rows[4];
+	for (int r = 0; r < 4; ++r) rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+	glm::vec4 planes[6] = { rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[3] + rows[2], rows[3] - rows[2] };
+	for (glm::vec4 &plane : planes) plane /= glm::length(glm::vec3(plane));
+
+	visible.clear();
+	for (size_t slot = 0; slot < m_World.size(); ++slot) {
+		glm::vec4 const &bounds = m_Bounds[slot];
+		if (bounds.w < 0.0f) {
+			visible.push_back(m_NodeOfSlot[slot]);
+			continue;
+		}
+
+		// the largest axis scale of the world transform bounds how much the sphere can grow
+		AffineTransform const &world = m_World[slot];
+		glm::vec3 const center = world.transformPoint(glm::vec3(bounds));
+		float maxScale2 = 0.0f;
+		for (int c = 0; c < 3; ++c) {
+			glm::vec3 const axis(world.m_Rows[0][c], world.m_Rows[1][c], world.m_Rows[2][c]);
+			maxScale2 = std::max(maxScale2, glm::dot(axis, axis));
+		}
+		float const radius = bounds.w * std::sqrt(maxScale2);
+
+		bool inside = true;
+		for (glm::vec4 const &plane : planes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+				inside = false;
+				break;
+			}
+		}
+		if (inside) visible.push_back(m_NodeOfSlot[slot]);
+	}
+}
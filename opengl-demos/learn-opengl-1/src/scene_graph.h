@@ -0,0 +1,87 @@
+#pragma once
+
+#include "affine_transform.h"
+
+#include <glm/vec3.hpp> // glm::vec3
+#include <glm/vec4.hpp> // glm::vec4
+#include <glm/mat4x4.hpp> // glm::mat4
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// transform hierarchy for scenes with lots of nodes (100k+)
+// - flat arrays, sorted breadth-first by depth so every parent comes before its children and siblings are contiguous
+// - setLocalTransform() only flags the node and puts it on a dirty list, update() then recomputes just the dirty subtrees
+// - each depth level only depends on the previous one, so a level is handed to ParallelForFn in one go
+// - feeds drawing (getWorldTransform(), getChangedNodes() for partial instance-buffer uploads) and culling (cullSpheres())
+
+
+
+typedef uint32_t SceneNodeId;
+SceneNodeId const INVALID_SCENE_NODE = 0xFFFFFFFFu;
+
+// runs body(begin, end) over sub-ranges that together cover [0, count), in parallel if it wants to (e.g. JobSystem::parallelFor)
+// body is safe to run concurrently on disjoint ranges
+typedef std::function<void(size_t count, std::function<void(size_t begin, size_t end)> const &body)> ParallelForFn;
+
+// runs the whole range inline on the calling thread
+void serialFor(size_t count, std::function<void(size_t begin, size_t end)> const &body);
+
+
+
+class SceneGraph {
+public:
+	// the parent must already exist, so ids are always in parent-before-child order
+	SceneNodeId createNode(SceneNodeId parent = INVALID_SCENE_NODE, AffineTransform const &local = AffineTransform::identity());
+
+	size_t getNodeCount() const { return m_SlotOfNode.size(); }
+	SceneNodeId getParent(SceneNodeId node) const;
+
+	void setLocalTransform(SceneNodeId node, AffineTransform const &local);
+	AffineTransform const &getLocalTransform(SceneNodeId node) const { return m_Local[m_SlotOfNode[node]]; }
+
+	// object-space bounding sphere used by cullSpheres() (radius < 0, the default, means never culled)
+	void setBoundingSphere(SceneNodeId node, glm::vec3 const &center, float radius);
+
+	// recompute the world transforms of every dirty subtree (everything after createNode())
+	void update(ParallelForFn const &parallelFor);
+	void update() { update(serialFor); }
+
+	// valid after update()
+	AffineTransform const &getWorldTransform(SceneNodeId node) const { return m_World[m_SlotOfNode[node]]; }
+
+	// nodes whose world transform was recomputed by the last update(), so instance data only needs re-uploading for these
+	std::vector<SceneNodeId> const &getChangedNodes() const { return m_Changed; }
+
+	// nodes whose world-space bounding sphere touches the frustum of viewProjection (e.g. the result of camera())
+	void cullSpheres(glm::mat4 const &viewProjection, std::vector<SceneNodeId> &visible) const;
+
+private:
+	typedef uint32_t Slot;
+
+	void rebuild(); // re-sort the arrays after the structure changed
+	void computeWorld(Slot slot);
+
+	// per node id
+	std::vector<Slot> m_SlotOfNode;
+
+	// per slot (breadth-first order)
+	std::vector<SceneNodeId> m_NodeOfSlot;
+	std::vector<Slot> m_ParentSlot; // INVALID_SCENE_NODE for roots
+	std::vector<Slot> m_FirstChild; // children of a slot are contiguous in the next level
+	std::vector<uint32_t> m_ChildCount;
+	std::vector<AffineTransform> m_Local;
+	std::vector<AffineTransform> m_World;
+	std::vector<glm::vec4> m_Bounds; // object-space center + radius
+	std::vector<uint32_t> m_QueuedStamp; // == m_Stamp when the slot is already queued for this update
+	std::vector<size_t> m_LevelStart; // first slot of each depth level (+ 1 past the end)
+
+	std::vector<SceneNodeId> m_DirtyNodes; // setLocalTransform() since the last update()
+	std::vector<uint8_t> m_DirtyFlag; // per node id, so a node only goes on m_DirtyNodes once
+	std::vector<std::vector<Slot>> m_Frontier; // per depth level, reused between updates
+	std::vector<SceneNodeId> m_Changed;
+	uint32_t m_Stamp = 0;
+	bool m_StructureDirty = false;
+};
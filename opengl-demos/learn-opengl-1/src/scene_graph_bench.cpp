@@ -0,0 +1,82 @@
+#include "benchmarks.h"
+#include "scene_graph.h"
+
+#include <glm/vec3.hpp> // glm::vec3
+#include <glm/mat4x4.hpp> // glm::mat4
+#include <glm/gtc/matrix_transform.hpp> // glm::perspective, glm::translate
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+
+// 100k node hierarchy (fan-out 8, ~6 levels deep), reports microseconds per update() for a full rebuild and for a few moving nodes
+// the incremental results are checked against a naive recompute of every node in creation (= parent-before-child) order
+
+
+
+namespace {
+	size_t const BENCH_NODES = 100000;
+	size_t const BENCH_FANOUT = 8;
+	int const BENCH_FRAMES = 200;
+
+	AffineTransform randomLocal(std::mt19937 &rng) {
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> scale(0.9f, 1.1f);
+		return AffineTransform::fromTRS(glm::vec3(unit(rng), unit(rng), unit(rng)) * 4.0f, glm::vec3(unit(rng), unit(rng), 1.0f), unit(rng) * 3.14159f, glm::vec3(scale(rng)));
+	}
+
+	bool matchesNaive(SceneGraph const &graph) {
+		std::vector<AffineTransform> world(graph.getNodeCount());
+		for (SceneNodeId node = 0; node < graph.getNodeCount(); ++node) {
+			SceneNodeId const parent = graph.getParent(node);
+			world[node] = INVALID_SCENE_NODE == parent ? graph.getLocalTransform(node) : world[parent] * graph.getLocalTransform(node);
+			if (0 != std::memcmp(&world[node], &graph.getWorldTransform(node), sizeof(AffineTransform))) return false;
+		}
+		return true;
+	}
+}
+
+
+
+int sceneGraphBenchMain() {
+	std::mt19937 rng(29);
+	SceneGraph graph;
+	for (size_t i = 0; i < BENCH_NODES; ++i) {
+		SceneNodeId const parent = 0 == i ? INVALID_SCENE_NODE : static_cast<SceneNodeId>((i - 1) / BENCH_FANOUT);
+		SceneNodeId const node = graph.createNode(parent, randomLocal(rng));
+		graph.setBoundingSphere(node, glm::vec3(0.0f), 0.5f);
+	}
+
+	double start = benchSeconds();
+	graph.update();
+	std::printf("%-24s %10.1f us (%zu nodes)\n", "full update", (benchSeconds() - start) * 1e6, graph.getChangedNodes().size());
+	bool allMatch = matchesNaive(graph);
+
+	std::printf("%-24s %10s %12s\n", "moving nodes / frame", "us/update", "recomputed");
+	std::uniform_int_distribution<SceneNodeId> pick(0, static_cast<SceneNodeId>(BENCH_NODES - 1));
+	for (int const moving : {1, 10, 100, 1000}) {
+		double elapsed = 0.0;
+		size_t recomputed = 0;
+		for (int frame = 0; frame < BENCH_FRAMES; ++frame) {
+			for (int m = 0; m < moving; ++m) graph.setLocalTransform(pick(rng), randomLocal(rng));
+			start = benchSeconds();
+			graph.update();
+			elapsed += benchSeconds() - start;
+			recomputed += graph.getChangedNodes().size();
+		}
+		std::printf("%-24d %10.2f %12zu\n", moving, elapsed / BENCH_FRAMES * 1e6, recomputed / BENCH_FRAMES);
+		allMatch = allMatch && matchesNaive(graph);
+	}
+
+	glm::mat4 const viewProjection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.f) * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -30.0f));
+	std::vector<SceneNodeId> visible;
+	start = benchSeconds();
+	graph.cullSpheres(viewProjection, visible);
+	std::printf("%-24s %10.1f us (%zu visible)\n", "cull spheres", (benchSeconds() - start) * 1e6, visible.size());
+
+	if (!allMatch) std::printf("MISMATCH: incremental update differs from a full recompute\n");
+	return allMatch ? 0 : -1;
+}
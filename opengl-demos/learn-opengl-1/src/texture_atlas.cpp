@@ -0,0 +1,304 @@
+#include "texture_atlas.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <numeric>
+
+
+
+namespace {
+	struct Rect {
+		int m_X;
+		int m_Y;
+		int m_Width;
+		int m_Height;
+	};
+
+	// bottom-left skyline: the packed area's top edge as horizontal segments, left to right, covering the whole page width
+	class SkylinePacker {
+	public:
+		explicit SkylinePacker(int size) : m_Size(size) { m_Nodes.push_back({ 0, 0, size }); }
+
+		bool insert(int width, int height, int &x, int &y) {
+			size_t bestNode = m_Nodes.size();
+			int bestTop = INT_MAX, bestNodeWidth = INT_MAX;
+			for (size_t i = 0; i < m_Nodes.size(); ++i) {
+				int top;
+				if (!fits(i, width, height, top)) continue;
+				if (top + height < bestTop || (top + height == bestTop && m_Nodes[i].m_Width < bestNodeWidth)) {
+					bestNode = i;
+					bestTop = top + height;
+					bestNodeWidth = m_Nodes[i].m_Width;
+				}
+			}
+			if (m_Nodes.size() == bestNode) return false;
+			x = m_Nodes[bestNode].m_X;
+			y = bestTop - height;
+
+			// the new segment, then whatever it covers gets cut off the segments to its right
+			m_Nodes.insert(m_Nodes.begin() + bestNode, Node{ x, bestTop, width });
+			for (size_t i = bestNode + 1; i < m_Nodes.size();) {
+				Node const &previous = m_Nodes[i - 1];
+				int const overlap = previous.m_X + previous.m_Width - m_Nodes[i].m_X;
+				if (0 >= overlap) break;
+				m_Nodes[i].m_X += overlap;
+				m_Nodes[i].m_Width -= overlap;
+				if (0 < m_Nodes[i].m_Width) break;
+				m_Nodes.erase(m_Nodes.begin() + i);
+			}
+			for (size_t i = 1; i < m_Nodes.size();) {
+				if (m_Nodes[i - 1].m_Y == m_Nodes[i].m_Y) {
+					m_Nodes[i - 1].m_Width += m_Nodes[i].m_Width;
+					m_Nodes.erase(m_Nodes.begin() + i);
+				}
+				else {
+					++i;
+				}
+			}
+			return true;
+		}
+
+	private:
+		struct Node {
+			int m_X;
+			int m_Y; // height of the skyline from m_X to m_X + m_Width
+			int m_Width;
+		};
+
+		// top = the lowest y a rect starting at node's x can sit at (the highest segment under it)
+		bool fits(size_t node, int width, int height, int &top) const {
+			if (m_Nodes[node].m_X + width > m_Size) return false;
+			top = 0;
+			for (int widthLeft = width; 0 < widthLeft; widthLeft -= m_Nodes[node++].m_Width) {
+				top = std::max(top, m_Nodes[node].m_Y);
+				if (top + height > m_Size) return false;
+			}
+			return true;
+		}
+
+		int m_Size;
+		std::vector<Node> m_Nodes;
+	};
+
+	// maximal free rectangles, best short side fit
+	class MaxRectsPacker {
+	public:
+		explicit MaxRectsPacker(int size) { m_Free.push_back({ 0, 0, size, size }); }
+
+		bool insert(int width, int height, int &x, int &y) {
+			size_t best = m_Free.size();
+			int bestShortSide = INT_MAX, bestLongSide = INT_MAX;
+			for (size_t i = 0; i < m_Free.size(); ++i) {
+				Rect const &free = m_Free[i];
+				if (free.m_Width < width || free.m_Height < height) continue;
+				int const shortSide = std::min(free.m_Width - width, free.m_Height - height);
+				int const longSide = std::max(free.m_Width - width, free.m_Height - height);
+				if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+					best = i;
+					bestShortSide = shortSide;
+					bestLongSide = longSide;
+				}
+			}
+			if (m_Free.size() == best) return false;
+			x = m_Free[best].m_X;
+			y = m_Free[best].m_Y;
+			place({ x, y, width, height });
+			return true;
+		}
+
+	private:
+		// every free rect the new one overlaps is replaced by the (up to 4) maximal rects around it, then contained ones go
+		void place(Rect const &used) {
+			size_t const count = m_Free.size();
+			std::vector<Rect> split;
+			for (size_t i = 0; i < count; ++i) {
+				Rect const free = m_Free[i];
+				if (used.m_X >= free.m_X + free.m_Width || used.m_X + used.m_Width <= free.m_X ||
+					used.m_Y >= free.m_Y + free.m_Height || used.m_Y + used.m_Height <= free.m_Y) {
+					split.push_back(free);
+					continue;
+				}
+				if (used.m_X > free.m_X) split.push_back({ free.m_X, free.m_Y, used.m_X - free.m_X, free.m_Height });
+				if (used.m_X + used.m_Width < free.m_X + free.m_Width) split.push_back({ used.m_X + used.m_Width, free.m_Y, free.m_X + free.m_Width - used.m_X - used.m_Width, free.m_Height });
+				if (used.m_Y > free.m_Y) split.push_back({ free.m_X, free.m_Y, free.m_Width, used.m_Y - free.m_Y });
+				if (used.m_Y + used.m_Height < free.m_Y + free.m_Height) split.push_back({ free.m_X, used.m_Y + used.m_Height, free.m_Width, free.m_Y + free.m_Height - used.m_Y - used.m_Height });
+			}
+
+			m_Free.clear();
+			for (size_t i = 0; i < split.size(); ++i) {
+				bool contained = false;
+				for (size_t j = 0; j < split.size() && !contained; ++j) {
+					// identical rects: only the first one stays
+					contained = i != j && contains(split[j], split[i]) && (!contains(split[i], split[j]) || j < i);
+				}
+				if (!contained) m_Free.push_back(split[i]);
+			}
+		}
+
+		static bool contains(Rect const &outer, Rect const &inner) {
+			return inner.m_X >= outer.m_X && inner.m_Y >= outer.m_Y && inner.m_X + inner.m_Width <= outer.m_X + outer.m_Width && inner.m_Y + inner.m_Height <= outer.m_Y + outer.m_Height;
+		}
+
+		std::vector<Rect> m_Free;
+	};
+
+	int alignUp(int value, int alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// first page with room, a new one when none has, -1 = m_MaxPages reached
+	template <typename Packer>
+	int packRect(std::vector<Packer> &packers, int pageSize, int maxPages, int width, int height, int &x, int &y) {
+		for (size_t page = 0; page < packers.size(); ++page) {
+			if (packers[page].insert(width, height, x, y)) return static_cast<int>(page);
+		}
+		if (static_cast<int>(packers.size()) >= maxPages) return -1;
+		packers.emplace_back(pageSize);
+		return packers.back().insert(width, height, x, y) ? static_cast<int>(packers.size() - 1) : -1;
+	}
+
+	// the image at (x, y) plus border pixels on every side copied from its nearest edge
+	void blitWithBorder(Image const &image, int border, int x, int y, Image &page) {
+		size_t const rowBytes = static_cast<size_t>(image.m_Width) * 4;
+		for (int row = -border; row < image.m_Height + border; ++row) {
+			uint8_t const *source = &image.m_Pixels[std::min(std::max(row, 0), image.m_Height - 1) * rowBytes];
+			uint8_t *destination = &page.m_Pixels[(static_cast<size_t>(y + row) * page.m_Width + x) * 4];
+			std::memcpy(destination, source, rowBytes);
+			for (int i = 1; i <= border; ++i) {
+				std::memcpy(destination - i * 4, source, 4);
+				std::memcpy(destination + rowBytes + (i - 1) * 4, source + rowBytes - 4, 4);
+			}
+		}
+	}
+
+	void setTextureParameters(GLenum target, int border) {
+		// the border keeps levels down to 1 border pixel apart from their neighbours, coarser ones would mix images
+		int maxLevel = 0;
+		while (1 < (border >> maxLevel)) ++maxLevel;
+		glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, maxLevel);
+		glTexParameteri(target, GL_TEXTURE_MIN_FILTER, 0 < maxLevel ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		if (0 < maxLevel) glGenerateMipmap(target);
+	}
+}
+
+
+
+bool buildTextureAtlas(std::vector<Image> const &images, AtlasSettings const &settings, TextureAtlas &out, ParallelForFn const &parallelFor) {
+	int const alignment = std::max(1, settings.m_Alignment);
+	int const border = alignUp(std::max(0, settings.m_Padding), alignment); // a whole number of alignment steps, so the image starts aligned
+	int const pageSize = settings.m_PageSize;
+	out.m_PageSize = pageSize;
+	out.m_Border = border;
+	out.m_Pages.clear();
+	out.m_Entries.assign(images.size(), AtlasEntry());
+	out.m_Occupancy = 0.0;
+
+	// biggest first: tall ones for the skyline (fewer gaps under its steps), by longest side for max rects
+	std::vector<size_t> order(images.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		Image const &first = images[a];
+		Image const &second = images[b];
+		if (AtlasPacker::Skyline == settings.m_Packer) return first.m_Height > second.m_Height || (first.m_Height == second.m_Height && first.m_Width > second.m_Width);
+		int const firstLong = std::max(first.m_Width, first.m_Height), secondLong = std::max(second.m_Width, second.m_Height);
+		return firstLong > secondLong || (firstLong == secondLong && std::min(first.m_Width, first.m_Height) > std::min(second.m_Width, second.m_Height));
+	});
+
+	std::vector<SkylinePacker> skylines;
+	std::vector<MaxRectsPacker> maxRects;
+	bool allPacked = true;
+	double imagePixels = 0.0;
+	for (size_t const i : order) {
+		Image const &image = images[i];
+		if (0 >= image.m_Width || 0 >= image.m_Height || image.m_Pixels.size() != static_cast<size_t>(image.m_Width) * image.m_Height * 4) {
+			allPacked = false;
+			continue;
+		}
+		int const width = alignUp(image.m_Width + 2 * border, alignment);
+		int const height = alignUp(image.m_Height + 2 * border, alignment);
+		int x = 0, y = 0;
+		int const page = AtlasPacker::Skyline == settings.m_Packer ? packRect(skylines, pageSize, settings.m_MaxPages, width, height, x, y) :
+			packRect(maxRects, pageSize, settings.m_MaxPages, width, height, x, y);
+		if (0 > page) {
+			allPacked = false;
+			continue;
+		}
+
+		AtlasEntry &entry = out.m_Entries[i];
+		entry.m_Page = page;
+		entry.m_X = x + border;
+		entry.m_Y = y + border;
+		entry.m_Width = image.m_Width;
+		entry.m_Height = image.m_Height;
+		entry.m_UvOffset[0] = static_cast<float>(entry.m_X) / pageSize;
+		entry.m_UvOffset[1] = static_cast<float>(entry.m_Y) / pageSize;
+		entry.m_UvScale[0] = static_cast<float>(entry.m_Width) / pageSize;
+		entry.m_UvScale[1] = static_cast<float>(entry.m_Height) / pageSize;
+		imagePixels += static_cast<double>(image.m_Width) * image.m_Height;
+	}
+
+	size_t const pageCount = std::max(skylines.size(), maxRects.size());
+	out.m_Pages.resize(pageCount);
+	for (Image &page : out.m_Pages) {
+		page.m_Width = page.m_Height = pageSize;
+		page.m_Pixels.assign(static_cast<size_t>(pageSize) * pageSize * 4, 0);
+	}
+	// packed rects don't overlap, so the copies don't either
+	parallelFor(images.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			AtlasEntry const &entry = out.m_Entries[i];
+			if (entry.isPacked()) blitWithBorder(images[i], border, entry.m_X, entry.m_Y, out.m_Pages[entry.m_Page]);
+		}
+	});
+	if (0 < pageCount) out.m_Occupancy = imagePixels / (static_cast<double>(pageSize) * pageSize * pageCount);
+	return allPacked;
+}
+
+void remapAtlasUVs(AtlasEntry const &entry, float *uvs, size_t vertexCount, size_t stride) {
+	for (size_t i = 0; i < vertexCount; ++i, uvs += stride) {
+		uvs[0] = uvs[0] * entry.m_UvScale[0] + entry.m_UvOffset[0];
+		uvs[1] = uvs[1] * entry.m_UvScale[1] + entry.m_UvOffset[1];
+	}
+}
+
+
+
+unsigned int uploadAtlasArray(TextureAtlas const &atlas, bool srgb) {
+	if (atlas.m_Pages.empty()) return 0;
+	GLint previousTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &previousTexture);
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+
+	GLsizei const layers = static_cast<GLsizei>(atlas.m_Pages.size());
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, atlas.m_PageSize, atlas.m_PageSize, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	for (GLsizei layer = 0; layer < layers; ++layer) {
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, atlas.m_PageSize, atlas.m_PageSize, 1, GL_RGBA, GL_UNSIGNED_BYTE, atlas.m_Pages[layer].m_Pixels.data());
+	}
+	setTextureParameters(GL_TEXTURE_2D_ARRAY, atlas.m_Border);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, previousTexture);
+	return texture;
+}
+
+unsigned int uploadAtlasPage(TextureAtlas const &atlas, int page, bool srgb) {
+	if (0 > page || static_cast<int>(atlas.m_Pages.size()) <= page) return 0;
+	GLint previousTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, atlas.m_PageSize, atlas.m_PageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, atlas.m_Pages[page].m_Pixels.data());
+	setTextureParameters(GL_TEXTURE_2D, atlas.m_Border);
+
+	glBindTexture(GL_TEXTURE_2D, previousTexture);
+	return texture;
+}
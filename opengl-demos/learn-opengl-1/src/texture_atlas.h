@@ -0,0 +1,63 @@
+#pragma once
+
+#include "image_codec.h"
+#include "scene_graph.h" // ParallelForFn, serialFor
+
+#include <cstddef>
+#include <vector>
+
+// many small images packed into a few big pages, so materials that only differ by texture stop costing a bind each
+// - Skyline (bottom-left, fast, good for similar heights) or MaxRects (best short side fit, denser, slower with many images)
+// - pages are either separate GL_TEXTURE_2D atlases or the layers of 1 GL_TEXTURE_2D_ARRAY: with the array every packed
+//   image is reachable from 1 bind, draws pick their page with a layer index (vertex attribute or per-instance data)
+// - each image gets a border of its own edge pixels (m_Padding) and starts on an m_Alignment boundary, so bilinear filtering
+//   and 4x4 block compression of the page don't mix neighbours, the uploads stop the mip chain where the border runs out
+// - AtlasEntry has the page + a UV scale/offset, remapAtlasUVs() rewrites a mesh's [0,1] UVs in place
+// NOTE: UVs that wrap (repeat) can't be atlased, those textures keep their own binding
+
+
+
+enum class AtlasPacker {
+	Skyline,
+	MaxRects
+};
+
+struct AtlasSettings {
+	AtlasPacker m_Packer = AtlasPacker::MaxRects;
+	int m_PageSize = 2048; // square pages (every layer of an array texture has the same size)
+	int m_Padding = 4; // edge pixels repeated around each image
+	int m_Alignment = 4; // image origins are multiples of this (4 = BC block size)
+	int m_MaxPages = 256; // GL 3.3's minimum GL_MAX_ARRAY_TEXTURE_LAYERS
+};
+
+struct AtlasEntry {
+	int m_Page = -1; // -1 = not packed (bigger than a page, or m_MaxPages ran out)
+	int m_X = 0; // pixels, the image itself (without its border)
+	int m_Y = 0;
+	int m_Width = 0;
+	int m_Height = 0;
+	float m_UvOffset[2] = { 0.0f, 0.0f }; // page UV = image UV * m_UvScale + m_UvOffset
+	float m_UvScale[2] = { 1.0f, 1.0f };
+
+	bool isPacked() const { return 0 <= m_Page; }
+};
+
+struct TextureAtlas {
+	int m_PageSize = 0;
+	int m_Border = 0; // m_Padding rounded up to the alignment
+	std::vector<Image> m_Pages; // RGBA8, bottom row first like every Image
+	std::vector<AtlasEntry> m_Entries; // 1 per input image, same order
+	double m_Occupancy = 0.0; // image pixels (without borders) / page pixels
+};
+
+// false = some images weren't packed (their entries say so, the rest of the atlas is still usable)
+bool buildTextureAtlas(std::vector<Image> const &images, AtlasSettings const &settings, TextureAtlas &out, ParallelForFn const &parallelFor = serialFor);
+
+// in place, 2 floats per vertex every stride floats (e.g. 5 for interleaved xyz + uv with uvs pointing at the first u)
+void remapAtlasUVs(AtlasEntry const &entry, float *uvs, size_t vertexCount, size_t stride = 2);
+
+// GL thread: the pages as layers of 1 GL_TEXTURE_2D_ARRAY / 1 page as its own GL_TEXTURE_2D, clamped, glGenerateMipmap() down to
+// the level where the border is 1 pixel (GL_TEXTURE_MAX_LEVEL), returns the texture name (the binding of its target is restored)
+// sRGB = GL_SRGB8_ALPHA8 instead of GL_RGBA8
+unsigned int uploadAtlasArray(TextureAtlas const &atlas, bool srgb = true);
+unsigned int uploadAtlasPage(TextureAtlas const &atlas, int page, bool srgb = true);
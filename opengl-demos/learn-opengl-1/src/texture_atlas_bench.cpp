@@ -0,0 +1,101 @@
+#include "benchmarks.h"
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+
+// atlas packing of a UI/decal-like set of small textures (mostly powers of 2, some odd sizes)
+// - per packer: pages, occupancy (overall and of the last page, which shows the denser packer at equal page counts), build time (pack + copy) and what it does to texture binds (1 per image before,
+//   1 per page with 2D atlases, 1 with an array texture)
+// - checks: every image is in its page unchanged, its border repeats its edges, and no two bordered rects overlap
+
+
+
+namespace {
+	int const BENCH_IMAGE_COUNT = 600;
+	int const BENCH_PAGE_SIZE = 1024;
+
+	std::vector<Image> makeImages(int count) {
+		std::mt19937 rng(3);
+		int const SIZES[] = { 16, 32, 32, 64, 64, 64, 128, 128, 256 };
+		std::vector<Image> images(count);
+		for (int i = 0; i < count; ++i) {
+			Image &image = images[i];
+			bool const odd = 0 == i % 5;
+			image.m_Width = odd ? 8 + static_cast<int>(rng() % 180) : SIZES[rng() % 9];
+			image.m_Height = odd ? 8 + static_cast<int>(rng() % 180) : SIZES[rng() % 9];
+			image.m_Pixels.resize(static_cast<size_t>(image.m_Width) * image.m_Height * 4);
+			for (uint8_t &byte : image.m_Pixels) byte = static_cast<uint8_t>(rng());
+		}
+		return images;
+	}
+
+	bool pixelEquals(Image const &page, int x, int y, Image const &image, int imageX, int imageY) {
+		return 0 == std::memcmp(&page.m_Pixels[(static_cast<size_t>(y) * page.m_Width + x) * 4], &image.m_Pixels[(static_cast<size_t>(imageY) * image.m_Width + imageX) * 4], 4);
+	}
+
+	bool checkAtlas(std::vector<Image> const &images, TextureAtlas const &atlas) {
+		int const border = atlas.m_Border;
+		std::vector<std::vector<uint8_t>> coverage(atlas.m_Pages.size(), std::vector<uint8_t>(static_cast<size_t>(atlas.m_PageSize) * atlas.m_PageSize, 0));
+		for (size_t i = 0; i < images.size(); ++i) {
+			AtlasEntry const &entry = atlas.m_Entries[i];
+			if (!entry.isPacked()) return false;
+			Image const &page = atlas.m_Pages[entry.m_Page];
+			for (int y = -border; y < entry.m_Height + border; ++y) {
+				for (int x = -border; x < entry.m_Width + border; ++x) {
+					int const imageX = std::min(std::max(x, 0), entry.m_Width - 1);
+					int const imageY = std::min(std::max(y, 0), entry.m_Height - 1);
+					if (!pixelEquals(page, entry.m_X + x, entry.m_Y + y, images[i], imageX, imageY)) return false;
+					uint8_t &covered = coverage[entry.m_Page][static_cast<size_t>(entry.m_Y + y) * atlas.m_PageSize + entry.m_X + x];
+					if (0 != covered) return false;
+					covered = 1;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+
+
+int textureAtlasBenchMain() {
+	bool ok = true;
+	std::vector<Image> const images = makeImages(BENCH_IMAGE_COUNT);
+	std::printf("%d images into %dx%d pages\n", BENCH_IMAGE_COUNT, BENCH_PAGE_SIZE, BENCH_PAGE_SIZE);
+	std::printf("%10s %6s %10s %10s %10s %14s %14s\n", "packer", "pages", "occupancy", "last page", "build ms", "binds (2D)", "binds (array)");
+	for (AtlasPacker const packer : { AtlasPacker::Skyline, AtlasPacker::MaxRects }) {
+		AtlasSettings settings;
+		settings.m_Packer = packer;
+		settings.m_PageSize = BENCH_PAGE_SIZE;
+		TextureAtlas atlas;
+		double const start = benchSeconds();
+		bool const packed = buildTextureAtlas(images, settings, atlas);
+		double const ms = (benchSeconds() - start) * 1e3;
+		double lastPagePixels = 0.0;
+		for (AtlasEntry const &entry : atlas.m_Entries) {
+			if (static_cast<size_t>(entry.m_Page) + 1 == atlas.m_Pages.size()) lastPagePixels += static_cast<double>(entry.m_Width) * entry.m_Height;
+		}
+		std::printf("%10s %6zu %9.1f%% %9.1f%% %10.2f %7d -> %-4zu %7d -> 1\n", AtlasPacker::Skyline == packer ? "skyline" : "maxrects", atlas.m_Pages.size(),
+			atlas.m_Occupancy * 100.0, lastPagePixels * 100.0 / (static_cast<double>(BENCH_PAGE_SIZE) * BENCH_PAGE_SIZE), ms, BENCH_IMAGE_COUNT, atlas.m_Pages.size(), BENCH_IMAGE_COUNT);
+		ok = ok && packed && checkAtlas(images, atlas);
+	}
+
+	// UV rewrite of a quad onto the first image
+	{
+		TextureAtlas atlas;
+		buildTextureAtlas(images, AtlasSettings(), atlas);
+		float uvs[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+		remapAtlasUVs(atlas.m_Entries[0], uvs, 4);
+		AtlasEntry const &entry = atlas.m_Entries[0];
+		ok = ok && uvs[0] * atlas.m_PageSize == entry.m_X && uvs[1] * atlas.m_PageSize == entry.m_Y &&
+			uvs[4] * atlas.m_PageSize == entry.m_X + entry.m_Width && uvs[5] * atlas.m_PageSize == entry.m_Y + entry.m_Height;
+	}
+
+	if (!ok) std::printf("MISMATCH: an image is missing, changed or overlapping\n");
+	return ok ? 0 : -1;
+}
@@ -0,0 +1,436 @@
+#include "texture_container.h"
+
+#include <glad/glad.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+// compressed formats from extensions (S3TC) or from after 3.3 (BPTC), not in the core 3.3 glad header
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#endif
+
+
+
+namespace {
+	uint8_t const KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+	uint32_t const KTX_ENDIANNESS = 0x04030201;
+	size_t const KTX_HEADER_BYTES = 64;
+
+	uint32_t const DDS_MAGIC = 0x20534444; // "DDS "
+	size_t const DDS_HEADER_BYTES = 4 + 124; // magic + DDS_HEADER
+	size_t const DDS_DX10_HEADER_BYTES = 20;
+	uint32_t const DDPF_ALPHAPIXELS = 0x1;
+	uint32_t const DDPF_FOURCC = 0x4;
+	uint32_t const DDPF_RGB = 0x40;
+	uint32_t const DDSCAPS2_CUBEMAP = 0x200;
+	uint32_t const DDSCAPS2_VOLUME = 0x200000;
+	uint32_t const D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+	uint32_t const D3D10_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+	struct CompressedFormat {
+		GLenum m_InternalFormat;
+		GLenum m_BaseFormat; // what KTX's glBaseInternalFormat wants
+		size_t m_BlockBytes;
+	};
+
+	CompressedFormat const COMPRESSED_FORMATS[] = {
+		{ GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_RGB, 8 },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_RGBA, 8 },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, GL_RGBA, 16 },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_RGBA, 16 },
+		{ GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, GL_RGB, 8 },
+		{ GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, GL_RGBA, 8 },
+		{ GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, GL_RGBA, 16 },
+		{ GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, GL_RGBA, 16 },
+		{ GL_COMPRESSED_RED_RGTC1, GL_RED, 8 },
+		{ GL_COMPRESSED_SIGNED_RED_RGTC1, GL_RED, 8 },
+		{ GL_COMPRESSED_RG_RGTC2, GL_RG, 16 },
+		{ GL_COMPRESSED_SIGNED_RG_RGTC2, GL_RG, 16 },
+		{ GL_COMPRESSED_RGBA_BPTC_UNORM, GL_RGBA, 16 },
+		{ GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, GL_RGBA, 16 }
+	};
+
+	CompressedFormat const *findCompressedFormat(GLenum internalFormat) {
+		for (CompressedFormat const &format : COMPRESSED_FORMATS) {
+			if (internalFormat == format.m_InternalFormat) return &format;
+		}
+		return nullptr;
+	}
+
+	// 8 bit uncompressed formats, 0 = not supported
+	size_t bytesPerPixel(GLenum format) {
+		switch (format) {
+		case GL_RED: return 1;
+		case GL_RG: return 2;
+		case GL_RGB: return 3;
+		case GL_RGBA: case GL_BGRA: return 4;
+		}
+		return 0;
+	}
+
+	// both containers are little-endian, like every platform this runs on
+	uint32_t readU32(uint8_t const *data) {
+		uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	uint32_t makeFourCC(char a, char b, char c, char d) {
+		return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+	}
+
+	// expected bytes of a level, 0 = format not supported
+	size_t levelBytes(TextureContainerView const &view, int width, int height) {
+		if (view.m_Compressed) {
+			CompressedFormat const *format = findCompressedFormat(view.m_InternalFormat);
+			return nullptr == format ? 0 : static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * format->m_BlockBytes;
+		}
+		size_t const alignment = static_cast<size_t>(view.m_UnpackAlignment);
+		size_t const rowBytes = (width * bytesPerPixel(view.m_Format) + alignment - 1) / alignment * alignment;
+		return rowBytes * height;
+	}
+
+	// view's format and level 0 size already set, fills in the level views from offset, false = the file is too short
+	bool addLevels(uint8_t const *data, size_t size, size_t offset, int levelCount, bool sizePrefixed, TextureContainerView &out) {
+		int const maxDimension = std::max(out.m_Width, out.m_Height);
+		if (0 >= levelCount || TextureContainerView::MAX_LEVELS < levelCount || (maxDimension >> (levelCount - 1)) == 0) return false;
+		out.m_LevelCount = levelCount;
+		out.m_DataBytes = 0;
+		for (int level = 0; level < levelCount; ++level) {
+			TextureLevelView &view = out.m_Levels[level];
+			view.m_Width = std::max(1, out.m_Width >> level);
+			view.m_Height = std::max(1, out.m_Height >> level);
+			view.m_Size = levelBytes(out, view.m_Width, view.m_Height);
+			if (0 == view.m_Size) return false;
+			if (sizePrefixed) {
+				// KTX: imageSize, the level, padding up to 4 bytes
+				if (size - offset < 4 || view.m_Size != readU32(data + offset)) return false;
+				offset += 4;
+			}
+			if (size - offset < view.m_Size) return false;
+			view.m_Data = data + offset;
+			offset += view.m_Size;
+			if (sizePrefixed) offset = std::min(size, (offset + 3) & ~static_cast<size_t>(3));
+			out.m_DataBytes += view.m_Size;
+		}
+		return true;
+	}
+
+	double millisecondsSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+
+
+bool parseKtx(uint8_t const *data, size_t size, TextureContainerView &out) {
+	if (size < KTX_HEADER_BYTES || 0 != std::memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER))) return false;
+	uint32_t header[13];
+	for (int i = 0; i < 13; ++i) header[i] = readU32(data + 12 + 4 * i);
+	uint32_t const endianness = header[0], glType = header[1], glTypeSize = header[2], glFormat = header[3], glInternalFormat = header[4];
+	uint32_t const pixelWidth = header[6], pixelHeight = header[7], pixelDepth = header[8];
+	uint32_t const arrayElements = header[9], faces = header[10], mipmapLevels = header[11], keyValueBytes = header[12];
+
+	// 2D only, in this machine's byte order
+	if (KTX_ENDIANNESS != endianness || 0 == pixelWidth || 0 == pixelHeight || 1 < pixelDepth || 0 != arrayElements || 1 != faces) return false;
+	if (32768 < pixelWidth || 32768 < pixelHeight || size - KTX_HEADER_BYTES < keyValueBytes) return false;
+
+	out = TextureContainerView();
+	out.m_Container = TextureContainerFormat::KTX;
+	out.m_Compressed = 0 == glType;
+	out.m_InternalFormat = glInternalFormat;
+	out.m_UnpackAlignment = 4;
+	out.m_Width = static_cast<int>(pixelWidth);
+	out.m_Height = static_cast<int>(pixelHeight);
+	if (out.m_Compressed) {
+		if (0 != glFormat || nullptr == findCompressedFormat(glInternalFormat)) return false;
+	}
+	else {
+		if (GL_UNSIGNED_BYTE != glType || 1 != glTypeSize || 0 == bytesPerPixel(glFormat)) return false;
+		out.m_Format = glFormat;
+		out.m_Type = glType;
+		out.m_GenerateMipmaps = 0 == mipmapLevels;
+	}
+	return addLevels(data, size, KTX_HEADER_BYTES + keyValueBytes, static_cast<int>(std::max(1u, std::min(mipmapLevels, 64u))), true, out);
+}
+
+bool parseDds(uint8_t const *data, size_t size, TextureContainerView &out) {
+	if (size < DDS_HEADER_BYTES || DDS_MAGIC != readU32(data) || 124 != readU32(data + 4) || 32 != readU32(data + 4 + 72)) return false;
+	uint32_t const height = readU32(data + 4 + 8);
+	uint32_t const width = readU32(data + 4 + 12);
+	uint32_t const mipMapCount = readU32(data + 4 + 24);
+	uint32_t const pixelFlags = readU32(data + 4 + 76);
+	uint32_t const fourCC = readU32(data + 4 + 80);
+	uint32_t const bitCount = readU32(data + 4 + 84);
+	uint32_t const masks[4] = { readU32(data + 4 + 88), readU32(data + 4 + 92), readU32(data + 4 + 96), readU32(data + 4 + 100) };
+	uint32_t const caps2 = readU32(data + 4 + 108);
+	if (0 == width || 0 == height || 32768 < width || 32768 < height || 0 != (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))) return false;
+
+	out = TextureContainerView();
+	out.m_Container = TextureContainerFormat::DDS;
+	out.m_Width = static_cast<int>(width);
+	out.m_Height = static_cast<int>(height);
+	size_t offset = DDS_HEADER_BYTES;
+
+	GLenum internalFormat = 0, format = 0;
+	if (0 != (pixelFlags & DDPF_FOURCC) && makeFourCC('D', 'X', '1', '0') == fourCC) {
+		if (size - offset < DDS_DX10_HEADER_BYTES) return false;
+		uint32_t const dxgiFormat = readU32(data + offset);
+		uint32_t const dimension = readU32(data + offset + 4);
+		uint32_t const miscFlag = readU32(data + offset + 8);
+		uint32_t const arraySize = readU32(data + offset + 12);
+		offset += DDS_DX10_HEADER_BYTES;
+		if (D3D10_RESOURCE_DIMENSION_TEXTURE2D != dimension || 0 != (miscFlag & D3D10_RESOURCE_MISC_TEXTURECUBE) || 1 < arraySize) return false;
+		switch (dxgiFormat) {
+		case 28: internalFormat = GL_RGBA8; format = GL_RGBA; break; // R8G8B8A8_UNORM
+		case 29: internalFormat = GL_SRGB8_ALPHA8; format = GL_RGBA; break; // R8G8B8A8_UNORM_SRGB
+		case 87: internalFormat = GL_RGBA8; format = GL_BGRA; break; // B8G8R8A8_UNORM
+		case 91: internalFormat = GL_SRGB8_ALPHA8; format = GL_BGRA; break; // B8G8R8A8_UNORM_SRGB
+		case 71: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break; // BC1_UNORM
+		case 72: internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT; break;
+		case 74: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break; // BC2_UNORM
+		case 75: internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT; break;
+		case 77: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break; // BC3_UNORM
+		case 78: internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; break;
+		case 80: internalFormat = GL_COMPRESSED_RED_RGTC1; break; // BC4_UNORM
+		case 81: internalFormat = GL_COMPRESSED_SIGNED_RED_RGTC1; break;
+		case 83: internalFormat = GL_COMPRESSED_RG_RGTC2; break; // BC5_UNORM
+		case 84: internalFormat = GL_COMPRESSED_SIGNED_RG_RGTC2; break;
+		case 98: internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM; break; // BC7_UNORM
+		case 99: internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM; break;
+		default: return false;
+		}
+	}
+	else if (0 != (pixelFlags & DDPF_FOURCC)) {
+		if (makeFourCC('D', 'X', 'T', '1') == fourCC) internalFormat = 0 != (pixelFlags & DDPF_ALPHAPIXELS) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		else if (makeFourCC('D', 'X', 'T', '2') == fourCC || makeFourCC('D', 'X', 'T', '3') == fourCC) internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+		else if (makeFourCC('D', 'X', 'T', '4') == fourCC || makeFourCC('D', 'X', 'T', '5') == fourCC) internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		else if (makeFourCC('A', 'T', 'I', '1') == fourCC || makeFourCC('B', 'C', '4', 'U') == fourCC) internalFormat = GL_COMPRESSED_RED_RGTC1;
+		else if (makeFourCC('B', 'C', '4', 'S') == fourCC) internalFormat = GL_COMPRESSED_SIGNED_RED_RGTC1;
+		else if (makeFourCC('A', 'T', 'I', '2') == fourCC || makeFourCC('B', 'C', '5', 'U') == fourCC) internalFormat = GL_COMPRESSED_RG_RGTC2;
+		else if (makeFourCC('B', 'C', '5', 'S') == fourCC) internalFormat = GL_COMPRESSED_SIGNED_RG_RGTC2;
+		else return false;
+	}
+	else if (0 != (pixelFlags & DDPF_RGB) && 32 == bitCount && 0xFF00 == masks[1] && (0 == masks[3] || 0xFF000000u == masks[3])) {
+		internalFormat = 0 == masks[3] ? GL_RGB8 : GL_RGBA8;
+		if (0xFF == masks[0] && 0xFF0000 == masks[2]) format = GL_RGBA;
+		else if (0xFF0000 == masks[0] && 0xFF == masks[2]) format = GL_BGRA;
+		else return false;
+	}
+	else {
+		return false;
+	}
+
+	out.m_Compressed = 0 == format;
+	out.m_InternalFormat = internalFormat;
+	out.m_Format = format;
+	out.m_Type = out.m_Compressed ? 0 : GL_UNSIGNED_BYTE;
+	return addLevels(data, size, offset, static_cast<int>(std::max(1u, std::min(mipMapCount, 64u))), false, out);
+}
+
+bool parseTextureContainer(uint8_t const *data, size_t size, TextureContainerView &out) {
+	if (size >= sizeof(KTX_IDENTIFIER) && 0 == std::memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER))) return parseKtx(data, size, out);
+	if (size >= 4 && DDS_MAGIC == readU32(data)) return parseDds(data, size, out);
+	return false;
+}
+
+bool writeKtx(std::string const &path, unsigned int internalFormat, int width, int height, std::vector<std::vector<uint8_t>> const &levels) {
+	CompressedFormat const *format = findCompressedFormat(internalFormat);
+	if (nullptr == format || levels.empty()) return false;
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) return false;
+
+	// glType, glTypeSize, glFormat = 0 / 1 / 0 for compressed data, no array, 1 face, no key/value data
+	uint32_t const header[13] = { KTX_ENDIANNESS, 0, 1, 0, internalFormat, format->m_BaseFormat, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+		0, 0, 1, static_cast<uint32_t>(levels.size()), 0 };
+	file.write(reinterpret_cast<char const *>(KTX_IDENTIFIER), sizeof(KTX_IDENTIFIER));
+	file.write(reinterpret_cast<char const *>(header), sizeof(header));
+	char const padding[3] = {};
+	for (std::vector<uint8_t> const &level : levels) {
+		uint32_t const imageSize = static_cast<uint32_t>(level.size());
+		file.write(reinterpret_cast<char const *>(&imageSize), sizeof(imageSize));
+		file.write(reinterpret_cast<char const *>(level.data()), level.size());
+		file.write(padding, (4 - level.size() % 4) % 4);
+	}
+	return static_cast<bool>(file);
+}
+
+
+
+MappedFile::MappedFile(MappedFile &&other) : m_Data(other.m_Data), m_Size(other.m_Size) {
+	other.m_Data = nullptr;
+	other.m_Size = 0;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) {
+	if (this == &other) return *this;
+	close();
+	std::swap(m_Data, other.m_Data);
+	std::swap(m_Size, other.m_Size);
+	return *this;
+}
+
+bool MappedFile::open(std::string const &path) {
+	close();
+#if defined(_WIN32)
+	HANDLE const file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (INVALID_HANDLE_VALUE == file) return false;
+	LARGE_INTEGER size;
+	bool const sized = 0 != GetFileSizeEx(file, &size) && 0 < size.QuadPart && static_cast<unsigned long long>(size.QuadPart) <= SIZE_MAX;
+	HANDLE const mapping = sized ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+	CloseHandle(file); // the mapping keeps the file open
+	if (nullptr == mapping) return false;
+	void const *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping); // and the view keeps the mapping
+	if (nullptr == view) return false;
+	m_Size = static_cast<size_t>(size.QuadPart);
+#else
+	int const file = ::open(path.c_str(), O_RDONLY);
+	if (0 > file) return false;
+	struct stat info;
+	bool const sized = 0 == fstat(file, &info) && 0 < info.st_size;
+	void *view = sized ? mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+	::close(file); // the mapping keeps the file open
+	if (MAP_FAILED == view) return false;
+	madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+	m_Size = static_cast<size_t>(info.st_size);
+#endif
+	m_Data = static_cast<uint8_t const *>(view);
+	return true;
+}
+
+void MappedFile::close() {
+	if (nullptr == m_Data) return;
+#if defined(_WIN32)
+	UnmapViewOfFile(m_Data);
+#else
+	munmap(const_cast<uint8_t *>(m_Data), m_Size);
+#endif
+	m_Data = nullptr;
+	m_Size = 0;
+}
+
+
+
+unsigned int uploadTextureContainer(TextureContainerView const &view, TextureUploadPath path, unsigned int *pixelBuffer, TextureUploadStats *stats) {
+	if (0 == view.m_LevelCount) return 0;
+	std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+
+	GLint previousTexture = 0, previousUnpackBuffer = 0, previousAlignment = 4;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previousUnpackBuffer);
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+
+	// where each level's glTexImage call reads from: the mapping, or offsets into the pixel buffer
+	uint8_t const *sources[TextureContainerView::MAX_LEVELS];
+	for (int level = 0; level < view.m_LevelCount; ++level) sources[level] = view.m_Levels[level].m_Data;
+	bool fromBuffer = false;
+	if (TextureUploadPath::PixelBuffer == path && nullptr != pixelBuffer) {
+		if (0 == *pixelBuffer) glGenBuffers(1, pixelBuffer);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, *pixelBuffer);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(view.m_DataBytes), nullptr, GL_STREAM_DRAW); // orphan, never waits on the last upload
+		uint8_t *mapped = static_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(view.m_DataBytes), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+		if (nullptr != mapped) {
+			size_t offset = 0;
+			for (int level = 0; level < view.m_LevelCount; ++level) {
+				std::memcpy(mapped + offset, view.m_Levels[level].m_Data, view.m_Levels[level].m_Size);
+				sources[level] = reinterpret_cast<uint8_t const *>(offset); // bound unpack buffer: the "pointer" is an offset
+				offset += view.m_Levels[level].m_Size;
+			}
+			fromBuffer = GL_FALSE != glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER); // false = the copy was lost, send the mapping instead
+		}
+		if (!fromBuffer) {
+			for (int level = 0; level < view.m_LevelCount; ++level) sources[level] = view.m_Levels[level].m_Data;
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+	}
+	else {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, view.m_UnpackAlignment);
+	for (int level = 0; level < view.m_LevelCount; ++level) {
+		TextureLevelView const &levelView = view.m_Levels[level];
+		if (view.m_Compressed) {
+			glCompressedTexImage2D(GL_TEXTURE_2D, level, view.m_InternalFormat, levelView.m_Width, levelView.m_Height, 0, static_cast<GLsizei>(levelView.m_Size), sources[level]);
+		}
+		else {
+			glTexImage2D(GL_TEXTURE_2D, level, static_cast<GLint>(view.m_InternalFormat), levelView.m_Width, levelView.m_Height, 0, view.m_Format, view.m_Type, sources[level]);
+		}
+	}
+	bool const mipmapped = 1 < view.m_LevelCount || view.m_GenerateMipmaps;
+	if (view.m_GenerateMipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+	else glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, view.m_LevelCount - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+	glBindTexture(GL_TEXTURE_2D, previousTexture);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previousUnpackBuffer);
+
+	if (nullptr != stats) {
+		stats->m_Bytes += view.m_DataBytes;
+		stats->m_UploadMs += millisecondsSince(start);
+	}
+	return texture;
+}
+
+unsigned int loadTextureContainer(std::string const &path, TextureUploadPath uploadPath, unsigned int *pixelBuffer, TextureUploadStats *stats) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	MappedFile file;
+	if (!file.open(path)) return 0;
+	if (nullptr != stats) stats->m_MapMs += millisecondsSince(start);
+
+	start = std::chrono::steady_clock::now();
+	TextureContainerView view;
+	if (!parseTextureContainer(file.data(), file.size(), view)) return 0;
+	if (nullptr != stats) stats->m_ParseMs += millisecondsSince(start);
+
+	// glTexImage has copied (or DMA'd) everything by the time it returns, so the mapping can go right after
+	return uploadTextureContainer(view, uploadPath, pixelBuffer, stats);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// KTX (version 1) and DDS textures straight from a memory-mapped file, the warm-start path for pre-compressed textures
+// - MappedFile maps the whole file read-only, the parsers only validate the header and point into the mapping,
+//   so no byte of pixel data is copied before the driver's own copy in glCompressedTexImage2D() / glTexImage2D()
+// - 2D textures with any number of levels: BC1/2/3/4/5/7 (S3TC, RGTC, BPTC) or 8 bit RGBA/BGRA (KTX also R/RG/RGB), sRGB variants included
+//   (no cube maps, arrays, volumes or KTX files that need byte swapping, those are rejected)
+// - uploadTextureContainer(): direct from the mapping, or through a pixel unpack buffer (1 memcpy from the page cache
+//   into driver-owned memory, the glTexImage calls then only source from the buffer and return without touching the file)
+// - TextureUploadStats has the bytes and time of each step for a throughput report
+
+
+
+struct TextureLevelView {
+	uint8_t const *m_Data = nullptr; // in the mapping, valid as long as the MappedFile is
+	size_t m_Size = 0;
+	int m_Width = 0;
+	int m_Height = 0;
+};
+
+enum class TextureContainerFormat {
+	KTX,
+	DDS
+};
+
+// GL enums are kept as unsigned int so this header doesn't need glad
+struct TextureContainerView {
+	static int const MAX_LEVELS = 16; // up to 32768x32768
+
+	TextureContainerFormat m_Container = TextureContainerFormat::KTX;
+	bool m_Compressed = false;
+	unsigned int m_InternalFormat = 0; // e.g. GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_SRGB8_ALPHA8
+	unsigned int m_Format = 0; // uncompressed only, e.g. GL_RGBA, GL_BGRA
+	unsigned int m_Type = 0; // uncompressed only, e.g. GL_UNSIGNED_BYTE
+	int m_UnpackAlignment = 1; // KTX pads rows to 4 bytes, DDS doesn't pad
+	bool m_GenerateMipmaps = false; // KTX with 0 levels: the file has level 0 and asks for the rest to be generated
+	int m_Width = 0; // of level 0
+	int m_Height = 0;
+	int m_LevelCount = 0;
+	TextureLevelView m_Levels[MAX_LEVELS]; // no allocation per texture
+	size_t m_DataBytes = 0; // all levels
+};
+
+// false = not a 2D texture this can upload, or any size in it doesn't match the file (nothing is read past size)
+bool parseKtx(uint8_t const *data, size_t size, TextureContainerView &out);
+bool parseDds(uint8_t const *data, size_t size, TextureContainerView &out);
+bool parseTextureContainer(uint8_t const *data, size_t size, TextureContainerView &out); // by the magic number
+
+// compressed formats only (e.g. what bc_encoder.h produces), level 0 first, false = unknown format or couldn't write the file
+bool writeKtx(std::string const &path, unsigned int internalFormat, int width, int height, std::vector<std::vector<uint8_t>> const &levels);
+
+
+
+// read-only mapping of a whole file (CreateFileMapping on Windows, mmap elsewhere)
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile() { close(); }
+
+	MappedFile(MappedFile const &) = delete;
+	MappedFile &operator=(MappedFile const &) = delete;
+	MappedFile(MappedFile &&other);
+	MappedFile &operator=(MappedFile &&other);
+
+	bool open(std::string const &path); // false = missing, empty or couldn't be mapped
+	void close();
+
+	bool isOpen() const { return nullptr != m_Data; }
+	uint8_t const *data() const { return m_Data; }
+	size_t size() const { return m_Size; }
+
+private:
+	uint8_t const *m_Data = nullptr;
+	size_t m_Size = 0;
+};
+
+
+
+enum class TextureUploadPath {
+	Direct, // glTexImage from the mapping
+	PixelBuffer // memcpy into a GL_PIXEL_UNPACK_BUFFER, glTexImage from that
+};
+
+struct TextureUploadStats {
+	size_t m_Bytes = 0;
+	double m_MapMs = 0.0; // open + map
+	double m_ParseMs = 0.0;
+	double m_UploadMs = 0.0; // until the GL calls return (add a glFinish() before reading it to include the driver's work)
+
+	double megabytesPerSecond() const { return 0.0 < m_UploadMs ? m_Bytes / (1024.0 * 1024.0) / (m_UploadMs * 1e-3) : 0.0; }
+};
+
+// GL thread: new texture with every level, returns its name (the GL_TEXTURE_2D and GL_PIXEL_UNPACK_BUFFER bindings are restored)
+// the pixel buffer path reuses *pixelBuffer across calls (created on first use, orphaned and refilled per upload, the caller deletes it)
+unsigned int uploadTextureContainer(TextureContainerView const &view, TextureUploadPath path = TextureUploadPath::Direct, unsigned int *pixelBuffer = nullptr,
+	TextureUploadStats *stats = nullptr);
+
+// GL thread: map + parse + upload in one go, 0 = failed, every step's time is added to stats (if any)
+unsigned int loadTextureContainer(std::string const &path, TextureUploadPath uploadPath = TextureUploadPath::Direct, unsigned int *pixelBuffer = nullptr,
+	TextureUploadStats *stats = nullptr);
@@ -0,0 +1,166 @@
+#include "bc_encoder.h"
+#include "benchmarks.h"
+#include "texture_container.h"
+
+//NOTE: must include glad before glfw
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+// compressed texture upload throughput from KTX files (in the OS file cache, i.e. a warm start), for 3 ways in:
+// - read: the file read into a buffer (what a loader without mapping does), parse, glCompressedTexImage2D from the buffer
+// - mapped: parse + glCompressedTexImage2D straight from the mapping
+// - mapped + PBO: the mapping copied into a pixel unpack buffer, glCompressedTexImage2D from that
+// every pass ends with a glFinish(), and level 0 is read back and compared against the file, plus a DDS copy of 1 texture
+// has to parse to the same levels
+// needs a GL context, so a hidden window is created
+
+
+
+namespace {
+	int const BENCH_TEXTURE_SIZE = 1024;
+	int const BENCH_TEXTURE_COUNT = 16;
+
+	enum class ReadMode {
+		Read,
+		Mapped,
+		MappedPixelBuffer
+	};
+
+	std::string benchPath(int i, char const *extension) {
+		return "container_bench_" + std::to_string(i) + extension;
+	}
+
+	// random blocks (throughput doesn't care what they decode to), full chain
+	std::vector<std::vector<uint8_t>> makeLevels(BcFormat format, unsigned int seed) {
+		std::mt19937 rng(seed);
+		std::vector<std::vector<uint8_t>> levels;
+		for (int size = BENCH_TEXTURE_SIZE; size >= 1; size /= 2) {
+			levels.emplace_back(bcImageBytes(format, size, size));
+			for (uint8_t &byte : levels.back()) byte = static_cast<uint8_t>(rng());
+		}
+		return levels;
+	}
+
+	// legacy header with a FourCC, only the fields the parser reads
+	bool writeDds(std::string const &path, char const *fourCC, int size, std::vector<std::vector<uint8_t>> const &levels) {
+		uint32_t header[32] = {};
+		std::memcpy(&header[0], "DDS ", 4);
+		header[1] = 124;
+		header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000; // caps, height, width, pixel format, mip count
+		header[3] = static_cast<uint32_t>(size);
+		header[4] = static_cast<uint32_t>(size);
+		header[7] = static_cast<uint32_t>(levels.size());
+		header[19] = 32;
+		header[20] = 0x4; // DDPF_FOURCC
+		std::memcpy(&header[21], fourCC, 4);
+		header[27] = 0x1000 | 0x400000 | 0x8; // texture, mipmap, complex
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<char const *>(header), sizeof(header));
+		for (std::vector<uint8_t> const &level : levels) file.write(reinterpret_cast<char const *>(level.data()), level.size());
+		return static_cast<bool>(file);
+	}
+
+	unsigned int loadWith(ReadMode mode, std::string const &path, unsigned int *pixelBuffer, TextureUploadStats &stats) {
+		if (ReadMode::Mapped == mode) return loadTextureContainer(path, TextureUploadPath::Direct, nullptr, &stats);
+		if (ReadMode::MappedPixelBuffer == mode) return loadTextureContainer(path, TextureUploadPath::PixelBuffer, pixelBuffer, &stats);
+
+		double start = benchSeconds();
+		std::ifstream file(path, std::ios::binary);
+		std::vector<uint8_t> const bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		stats.m_MapMs += (benchSeconds() - start) * 1e3;
+		start = benchSeconds();
+		TextureContainerView view;
+		if (!parseTextureContainer(bytes.data(), bytes.size(), view)) return 0;
+		stats.m_ParseMs += (benchSeconds() - start) * 1e3;
+		return uploadTextureContainer(view, TextureUploadPath::Direct, nullptr, &stats);
+	}
+}
+
+
+
+int textureContainerBenchMain() {
+	if (!glfwInit()) return -1;
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow *window = glfwCreateWindow(64, 64, "container bench", NULL, NULL);
+	if (NULL == window) {
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+		glfwTerminate();
+		return -1;
+	}
+
+	// BC1 where the driver has S3TC, BC4 (core) otherwise
+	BcFormat const format = isS3tcSupported() ? BcFormat::BC1 : BcFormat::BC4;
+	bool ok = true;
+	std::vector<std::vector<std::vector<uint8_t>>> sources;
+	for (int i = 0; i < BENCH_TEXTURE_COUNT; ++i) {
+		sources.push_back(makeLevels(format, static_cast<unsigned int>(i)));
+		ok = ok && writeKtx(benchPath(i, ".ktx"), bcGLFormat(format, false), BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE, sources.back());
+	}
+
+	// the DDS copy parses to the same levels
+	{
+		ok = ok && writeDds(benchPath(0, ".dds"), BcFormat::BC1 == format ? "DXT1" : "ATI1", BENCH_TEXTURE_SIZE, sources[0]);
+		MappedFile file;
+		TextureContainerView view;
+		ok = ok && file.open(benchPath(0, ".dds")) && parseDds(file.data(), file.size(), view) && static_cast<size_t>(view.m_LevelCount) == sources[0].size();
+		for (int level = 0; ok && level < view.m_LevelCount; ++level) {
+			ok = view.m_Levels[level].m_Size == sources[0][level].size() && 0 == std::memcmp(view.m_Levels[level].m_Data, sources[0][level].data(), view.m_Levels[level].m_Size);
+		}
+		std::printf("DDS levels %s\n", ok ? "match" : "DIFFER");
+	}
+
+	std::printf("%d %s textures of %dx%d with mips\n", BENCH_TEXTURE_COUNT, bcFormatName(format), BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE);
+	std::printf("%16s %10s %10s %10s %10s %10s\n", "path", "read ms", "parse ms", "upload ms", "total ms", "MB/s");
+	unsigned int pixelBuffer = 0;
+	std::vector<uint8_t> readBack;
+	for (int pass = 0; pass < 2; ++pass) { // the 1st pass warms up the file cache and the driver
+		for (ReadMode const mode : { ReadMode::Read, ReadMode::Mapped, ReadMode::MappedPixelBuffer }) {
+			TextureUploadStats stats;
+			std::vector<GLuint> textures;
+			double const start = benchSeconds();
+			for (int i = 0; i < BENCH_TEXTURE_COUNT; ++i) textures.push_back(loadWith(mode, benchPath(i, ".ktx"), &pixelBuffer, stats));
+			glFinish();
+			double const totalMs = (benchSeconds() - start) * 1e3;
+
+			for (int i = 0; i < BENCH_TEXTURE_COUNT; ++i) {
+				readBack.assign(sources[i][0].size(), 0);
+				glBindTexture(GL_TEXTURE_2D, textures[i]);
+				glGetCompressedTexImage(GL_TEXTURE_2D, 0, readBack.data());
+				ok = ok && 0 != textures[i] && readBack == sources[i][0];
+			}
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+
+			if (0 == pass) continue;
+			char const *name = ReadMode::Read == mode ? "read" : ReadMode::Mapped == mode ? "mapped" : "mapped + PBO";
+			std::printf("%16s %10.2f %10.2f %10.2f %10.2f %10.1f\n", name, stats.m_MapMs, stats.m_ParseMs, stats.m_UploadMs, totalMs,
+				stats.m_Bytes / (1024.0 * 1024.0) / (totalMs * 1e-3));
+		}
+	}
+	if (0 != pixelBuffer) glDeleteBuffers(1, &pixelBuffer);
+
+	for (int i = 0; i < BENCH_TEXTURE_COUNT; ++i) std::remove(benchPath(i, ".ktx").c_str());
+	std::remove(benchPath(0, ".dds").c_str());
+	glfwDestroyWindow(window);
+	glfwTerminate();
+
+	if (!ok) std::printf("MISMATCH: see above\n");
+	return ok ? 0 : -1;
+}
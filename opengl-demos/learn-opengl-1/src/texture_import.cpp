@@ -0,0 +1,96 @@
+#include "texture_import.h"
+#include "job_system.h"
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+
+
+
+namespace {
+	size_t const MIP_ROW_GRAIN = 8; // output rows per parallelFor chunk
+
+	bool readFile(std::string const &path, std::vector<uint8_t> &bytes) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) return false;
+		std::streamoff const size = file.tellg();
+		if (size < 0) return false;
+		bytes.resize(static_cast<size_t>(size));
+		file.seekg(0);
+		return bytes.empty() || static_cast<bool>(file.read(reinterpret_cast<char *>(bytes.data()), size));
+	}
+
+	// 1 job per item, each job's mip levels split further across the threads
+	// load(i, storage) returns the file bytes of item i (in storage if they had to be read), nullptr = failed
+	template <typename LoadFn>
+	size_t importInJobs(JobSystem &jobs, size_t count, TextureImportSettings const &settings, std::vector<DecodedResource> &out, LoadFn const &load) {
+		out.clear();
+		out.resize(count);
+		std::atomic<size_t> failed{ 0 };
+		ParallelForFn const parallelFor = [&jobs](size_t rows, std::function<void(size_t, size_t)> const &body) { jobs.parallelFor(rows, body, MIP_ROW_GRAIN); };
+
+		JobCounter counter;
+		for (size_t i = 0; i < count; ++i) {
+			jobs.run(counter, [&, i]() {
+				std::vector<uint8_t> storage;
+				std::vector<uint8_t> const *file = load(i, storage);
+				if (nullptr == file || !importTexture(*file, settings, out[i], parallelFor)) {
+					out[i] = DecodedResource();
+					failed.fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+		}
+		jobs.wait(counter);
+		return failed.load();
+	}
+}
+
+
+
+bool importTexture(std::vector<uint8_t> const &file, TextureImportSettings const &settings, DecodedResource &out, ParallelForFn const &parallelFor) {
+	Image image;
+	if (!settings.m_Decoder || !settings.m_Decoder(file, image) || image.m_Pixels.size() != static_cast<size_t>(image.m_Width) * image.m_Height * 4) return false;
+
+	out.m_Kind = ResourceKind::Texture2D;
+	out.m_Width = image.m_Width;
+	out.m_Height = image.m_Height;
+	out.m_InternalFormat = settings.m_Mips.m_Srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+	out.m_Format = GL_RGBA;
+	out.m_Type = GL_UNSIGNED_BYTE;
+	out.m_GenerateMipmaps = false;
+
+	if (!settings.m_GenerateMips) {
+		out.m_LevelCount = 1;
+		out.m_Data = std::move(image.m_Pixels);
+		return true;
+	}
+
+	std::vector<Image> levels;
+	generateMipChain(std::move(image), settings.m_Mips, levels, parallelFor);
+	size_t bytes = 0;
+	for (Image const &level : levels) bytes += level.m_Pixels.size();
+	out.m_LevelCount = static_cast<int>(levels.size());
+	out.m_Data.resize(bytes);
+	uint8_t *destination = out.m_Data.data();
+	for (Image const &level : levels) {
+		std::memcpy(destination, level.m_Pixels.data(), level.m_Pixels.size());
+		destination += level.m_Pixels.size();
+	}
+	return true;
+}
+
+ResourceDecoder textureImportDecoder(TextureImportSettings const &settings) {
+	return [settings](std::vector<uint8_t> const &file, DecodedResource &out) { return importTexture(file, settings, out); };
+}
+
+size_t importTextures(JobSystem &jobs, std::vector<std::vector<uint8_t>> const &files, TextureImportSettings const &settings, std::vector<DecodedResource> &out) {
+	return importInJobs(jobs, files.size(), settings, out, [&files](size_t i, std::vector<uint8_t> &) { return &files[i]; });
+}
+
+size_t importTextureFiles(JobSystem &jobs, std::vector<std::string> const &paths, TextureImportSettings const &settings, std::vector<DecodedResource> &out) {
+	return importInJobs(jobs, paths.size(), settings, out, [&paths](size_t i, std::vector<uint8_t> &storage) {
+		return readFile(paths[i], storage) ? &storage : nullptr;
+	});
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "image_codec.h"
+#include "mip_generator.h"
+#include "resource_loader.h"
+#include "scene_graph.h" // ParallelForFn, serialFor
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// texture import: image file -> decoded RGBA8 -> CPU mip chain -> DecodedResource with every level, off the GL thread
+// - the result goes through the normal upload path (ResourceLoader uploads the levels in budgeted slices, no glGenerateMipmap())
+// - through ResourceLoader::request(path, textureImportDecoder(...)) files are imported in parallel across its I/O threads
+// - importTextures() is the bulk path: 1 job per file on a JobSystem, and big levels are split across the threads as well,
+//   so a batch scales with core count and so does a single large image
+
+
+
+class JobSystem;
+
+struct TextureImportSettings {
+	ImageDecoder m_Decoder = decodeImage; // PNG or JPEG, any other format plugs in as an ImageDecoder
+	MipSettings m_Mips;
+	bool m_GenerateMips = true; // false = level 0 only (and no glGenerateMipmap() either)
+};
+
+// file bytes -> upload-ready texture (GL_SRGB8_ALPHA8 if m_Mips.m_Srgb, GL_RGBA8 otherwise), false = the decoder failed
+bool importTexture(std::vector<uint8_t> const &file, TextureImportSettings const &settings, DecodedResource &out, ParallelForFn const &parallelFor = serialFor);
+
+// ResourceDecoder for ResourceLoader::request(), settings are copied
+ResourceDecoder textureImportDecoder(TextureImportSettings const &settings);
+
+// out[i] is files[i] (or paths[i]) imported, failed ones are left empty, returns how many failed
+// must be called from the thread that created jobs (or from one of its jobs)
+size_t importTextures(JobSystem &jobs, std::vector<std::vector<uint8_t>> const &files, TextureImportSettings const &settings, std::vector<DecodedResource> &out);
+size_t importTextureFiles(JobSystem &jobs, std::vector<std::string> const &paths, TextureImportSettings const &settings, std::vector<DecodedResource> &out);
@@ -0,0 +1,224 @@
+#include "benchmarks.h"
+#include "image_codec.h"
+#include "job_system.h"
+#include "mip_generator.h"
+#include "texture_import.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+
+// texture import throughput
+// - mip generation MPix/s (source pixels) per filter, scalar vs SSE2 (their outputs are compared)
+// - a batch of PNGs through importTextures() from 1 thread up to every hardware thread
+// plus correctness checks: a flat colour stays exactly the same all the way down the chain (even and odd sizes), Box weighs
+// every pixel of an odd size the same, a black/white checkerboard averages to linear 0.5 (sRGB 188), not to sRGB 128 like a
+// gamma-unaware filter would, and the JPEG fixtures
+// (jpeg_fixtures.inl: baseline, progressive, 4:4:4, 4:2:0, restart intervals) decode to libjpeg's pixels
+
+
+
+namespace {
+	int const BENCH_IMAGE_SIZE = 1024;
+	int const BENCH_IMAGE_COUNT = 32;
+
+#include "jpeg_fixtures.inl"
+
+	struct JpegFixture {
+		char const *m_Name;
+		uint8_t const *m_File;
+		size_t m_FileSize;
+		uint8_t const *m_Rgb; // libjpeg's decode, top row first
+		int m_Width;
+		int m_Height;
+	};
+
+	JpegFixture const JPEG_FIXTURES[] = {
+		{ "baseline 4:4:4 restarts", JPEG_BASELINE_444_RESTART, sizeof(JPEG_BASELINE_444_RESTART), JPEG_BASELINE_444_RESTART_RGB, 16, 8 },
+		{ "baseline 4:2:0", JPEG_BASELINE_420, sizeof(JPEG_BASELINE_420), JPEG_BASELINE_420_RGB, 20, 12 },
+		{ "progressive 4:2:0 restarts", JPEG_PROGRESSIVE_420_RESTART, sizeof(JPEG_PROGRESSIVE_420_RESTART), JPEG_PROGRESSIVE_420_RESTART_RGB, 24, 16 },
+	};
+
+	int const JPEG_FIXTURE_TOLERANCE = 3; // per channel, what the AAN float IDCT's rounding differs from libjpeg's by at most
+
+	// smooth gradients with a band of noise, so the PNGs compress somewhere between photos and flat art
+	Image makeImage(int size, unsigned int seed) {
+		std::mt19937 rng(seed);
+		Image image;
+		image.m_Width = image.m_Height = size;
+		image.m_Pixels.resize(static_cast<size_t>(size) * size * 4);
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				uint8_t *pixel = &image.m_Pixels[(static_cast<size_t>(y) * size + x) * 4];
+				bool const noisy = (y / 64) % 4 == static_cast<int>(seed % 4);
+				pixel[0] = static_cast<uint8_t>(noisy ? rng() : x * 255 / size);
+				pixel[1] = static_cast<uint8_t>(y * 255 / size);
+				pixel[2] = static_cast<uint8_t>((x ^ y) + seed);
+				pixel[3] = static_cast<uint8_t>(noisy ? 255 : 128 + (x + y) % 128);
+			}
+		}
+		return image;
+	}
+
+	Image makeFlat(int size, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+		Image image;
+		image.m_Width = image.m_Height = size;
+		for (int i = 0; i < size * size; ++i) {
+			uint8_t const pixel[4] = { r, g, b, a };
+			image.m_Pixels.insert(image.m_Pixels.end(), pixel, pixel + 4);
+		}
+		return image;
+	}
+
+	// decodes through decodeImage() (what importTextures() uses), false = failed or off by more than the tolerance (printed)
+	bool checkJpegFixture(JpegFixture const &fixture) {
+		std::vector<uint8_t> const file(fixture.m_File, fixture.m_File + fixture.m_FileSize);
+		Image image;
+		if (!decodeImage(file, image) || fixture.m_Width != image.m_Width || fixture.m_Height != image.m_Height) {
+			std::printf("%-28s FAILED to decode\n", fixture.m_Name);
+			return false;
+		}
+		int maxDifference = 0;
+		bool opaque = true;
+		for (int y = 0; y < image.m_Height; ++y) {
+			uint8_t const *expected = &fixture.m_Rgb[static_cast<size_t>(y) * image.m_Width * 3];
+			uint8_t const *pixel = &image.m_Pixels[static_cast<size_t>(image.m_Height - 1 - y) * image.m_Width * 4]; // bottom row first
+			for (int x = 0; x < image.m_Width; ++x, expected += 3, pixel += 4) {
+				for (int c = 0; c < 3; ++c) maxDifference = std::max(maxDifference, std::abs(pixel[c] - expected[c]));
+				opaque = opaque && 255 == pixel[3];
+			}
+		}
+		bool const ok = maxDifference <= JPEG_FIXTURE_TOLERANCE && opaque;
+		std::printf("%-28s max difference %d%s\n", fixture.m_Name, maxDifference, ok ? "" : " MISMATCH");
+		return ok;
+	}
+
+	// ms per full chain, run until ~0.25s has been measured
+	double measureChainMs(Image const &base, MipSettings const &settings, std::vector<Image> &levels) {
+		int calls = 0;
+		double const start = benchSeconds();
+		double elapsed = 0.0;
+		do {
+			generateMipChain(base, settings, levels);
+			++calls;
+			elapsed = benchSeconds() - start;
+		} while (elapsed < 0.25);
+		return elapsed / calls * 1e3;
+	}
+}
+
+
+
+int textureImportBenchMain() {
+	bool ok = true;
+
+	// gamma correctness
+	{
+		Image checkerboard = makeFlat(4, 0, 0, 0, 255);
+		for (int i = 0; i < 16; ++i) {
+			if (0 == (i % 4 + i / 4) % 2) std::fill(&checkerboard.m_Pixels[i * 4], &checkerboard.m_Pixels[i * 4] + 3, static_cast<uint8_t>(255));
+		}
+		std::vector<Image> levels;
+		generateMipChain(checkerboard, MipSettings(), levels);
+		int const grey = levels[1].m_Pixels[0];
+		std::printf("checkerboard -> %d (188 expected)\n", grey);
+		ok = ok && 188 == grey;
+
+		for (MipFilter const filter : { MipFilter::Box, MipFilter::Kaiser }) {
+			for (int const size : { 64, 45 }) { // 45: odd all the way down (45, 22, 11, 5, 2, 1)
+				MipSettings settings;
+				settings.m_Filter = filter;
+				generateMipChain(makeFlat(size, 13, 100, 250, 77), settings, levels);
+				for (Image const &level : levels) {
+					for (size_t i = 0; i < level.m_Pixels.size(); i += 4) ok = ok && 13 == level.m_Pixels[i] && 100 == level.m_Pixels[i + 1] && 250 == level.m_Pixels[i + 2] && 77 == level.m_Pixels[i + 3];
+				}
+			}
+		}
+		std::printf("flat colour chains %s\n", ok ? "unchanged" : "CHANGED");
+
+		// odd sizes with Box: 3x3 -> 1x1 has to weigh all 9 source pixels the same (255 / 9 = 28 from any 1 white pixel)
+		MipSettings linear;
+		linear.m_Srgb = false;
+		Image single;
+		bool even = true;
+		for (int i = 0; i < 9; ++i) {
+			Image dot = makeFlat(3, 0, 0, 0, 0);
+			std::fill(&dot.m_Pixels[i * 4], &dot.m_Pixels[i * 4] + 4, static_cast<uint8_t>(255));
+			downsampleImage(dot, linear, single);
+			even = even && 28 == single.m_Pixels[0] && 28 == single.m_Pixels[3];
+		}
+		std::printf("odd size box weights %s\n", even ? "even" : "UNEVEN");
+		ok = ok && even;
+	}
+
+	// JPEG decoding against libjpeg
+	std::printf("\n");
+	for (JpegFixture const &fixture : JPEG_FIXTURES) ok = checkJpegFixture(fixture) && ok;
+
+	// mip generation, 1 thread
+	Image const base = makeImage(BENCH_IMAGE_SIZE, 1);
+	double const sourcePixels = static_cast<double>(BENCH_IMAGE_SIZE) * BENCH_IMAGE_SIZE * 4 / 3; // every level's source
+	std::printf("\n%8s %8s %12s %10s\n", "filter", "simd", "ms/chain", "MPix/s");
+	for (MipFilter const filter : { MipFilter::Box, MipFilter::Kaiser }) {
+		std::vector<Image> reference;
+		for (SimdLevel const simd : { SimdLevel::Scalar, SimdLevel::SSE2 }) {
+			MipSettings settings;
+			settings.m_Filter = filter;
+			settings.m_Simd = simd;
+			std::vector<Image> levels;
+			double const ms = measureChainMs(base, settings, levels);
+			std::printf("%8s %8s %12.2f %10.1f\n", MipFilter::Box == filter ? "box" : "kaiser", simdLevelName(simd), ms, sourcePixels / (ms * 1e3));
+			if (reference.empty()) {
+				reference = std::move(levels);
+				continue;
+			}
+			for (size_t i = 0; i < levels.size(); ++i) ok = ok && levels[i].m_Pixels == reference[i].m_Pixels;
+		}
+	}
+
+	// import scaling
+	std::vector<std::vector<uint8_t>> files(BENCH_IMAGE_COUNT);
+	size_t fileBytes = 0;
+	for (int i = 0; i < BENCH_IMAGE_COUNT; ++i) {
+		encodePng(makeImage(BENCH_IMAGE_SIZE, static_cast<unsigned int>(i)), files[i]);
+		fileBytes += files[i].size();
+	}
+	std::printf("\n%d PNGs of %dx%d, %.1f MB\n", BENCH_IMAGE_COUNT, BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE, fileBytes / (1024.0 * 1024.0));
+
+	unsigned int const maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<unsigned int> threadCounts;
+	for (unsigned int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+	threadCounts.push_back(maxThreads);
+
+	std::printf("%8s %12s %12s %8s\n", "threads", "import ms", "images/s", "speedup");
+	double baseMs = 0.0;
+	std::vector<DecodedResource> firstRun;
+	for (unsigned int const threads : threadCounts) {
+		JobSystem jobs(threads);
+		std::vector<DecodedResource> out;
+		TextureImportSettings settings;
+		double const start = benchSeconds();
+		size_t const failed = importTextures(jobs, files, settings, out);
+		double const ms = (benchSeconds() - start) * 1e3;
+		if (1 == threads) baseMs = ms;
+		std::printf("%8u %12.1f %12.1f %8.2f\n", threads, ms, BENCH_IMAGE_COUNT / (ms * 1e-3), baseMs / ms);
+
+		ok = ok && 0 == failed;
+		if (firstRun.empty()) {
+			// the PNG round trip is lossless
+			Image const original = makeImage(BENCH_IMAGE_SIZE, 0);
+			ok = ok && std::equal(original.m_Pixels.begin(), original.m_Pixels.end(), out[0].m_Data.begin());
+			firstRun = std::move(out);
+			continue;
+		}
+		for (size_t i = 0; i < out.size(); ++i) ok = ok && out[i].m_Data == firstRun[i].m_Data;
+	}
+
+	if (!ok) std::printf("MISMATCH: see above\n");
+	return ok ? 0 : -1;
+}
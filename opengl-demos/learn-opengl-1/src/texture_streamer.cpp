@@ -0,0 +1,279 @@
+#include "texture_streamer.h"
+
+#include <glad/glad.h>
+#include <glm/geometric.hpp> // glm::length
+#include <glm/vec4.hpp> // glm::vec4
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+
+namespace {
+	int levelSize(int size, int level) {
+		return std::max(1, size >> level);
+	}
+}
+
+
+
+TextureStreamer::TextureStreamer(size_t budgetBytes, size_t uploadBudget) : m_BudgetBytes(budgetBytes), m_UploadBudget(uploadBudget) {
+	m_Thread = std::thread(&TextureStreamer::streamLoop, this);
+}
+
+TextureStreamer::~TextureStreamer() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+	m_WorkAvailable.notify_all();
+	m_Thread.join();
+
+	for (Texture const &texture : m_Textures) {
+		if (texture.m_Object) glDeleteTextures(1, &texture.m_Object);
+	}
+}
+
+
+
+StreamedTextureId TextureStreamer::add(StreamedTextureDesc const &desc, MipLoader loader) {
+	Texture texture;
+	texture.m_Desc = desc;
+	if (0 >= texture.m_Desc.m_LevelCount) {
+		int const largest = std::max(std::max(desc.m_Width, desc.m_Height), 1);
+		texture.m_Desc.m_LevelCount = 1;
+		while (largest >> texture.m_Desc.m_LevelCount) ++texture.m_Desc.m_LevelCount;
+	}
+	texture.m_ResidentLevel = texture.m_Desc.m_LevelCount;
+	texture.m_DesiredLevel = texture.m_Desc.m_LevelCount - 1;
+
+	StreamedTextureId const id = static_cast<StreamedTextureId>(m_Textures.size());
+	m_Textures.push_back(texture);
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Loaders.push_back(std::move(loader));
+	}
+
+	// the coarsest level is always wanted, whatever the budget says
+	queueLoad(id, texture.m_Desc.m_LevelCount - 1);
+	return id;
+}
+
+
+
+int TextureStreamer::levelForBounds(glm::mat4 const &mvp, glm::vec3 const &center, float radius, int viewportHeight, int width, int height, int levelCount, float bias) {
+	glm::vec4 const clip = mvp * glm::vec4(center, 1.0f);
+	if (clip.w <= radius) return 0; // the camera is in (or right at) the sphere
+
+	// clip y row of the matrix: its length is how much object-space distance scales on screen (before the divide by w)
+	float const scaleY = glm::length(glm::vec3(mvp[0][1], mvp[1][1], mvp[2][1]));
+	float const pixels = radius * scaleY / clip.w * viewportHeight; // sphere diameter on screen (NDC is 2 wide)
+	if (pixels < 1.0f) return levelCount - 1;
+
+	float const texels = static_cast<float>(std::max(width, height));
+	int const level = static_cast<int>(std::floor(std::log2(texels / pixels) + bias));
+	return std::min(std::max(level, 0), levelCount - 1);
+}
+
+void TextureStreamer::requestFromBounds(StreamedTextureId id, glm::mat4 const &mvp, glm::vec3 const &center, float radius, int viewportHeight, float bias) {
+	StreamedTextureDesc const &desc = m_Textures[id].m_Desc;
+	requestLevel(id, levelForBounds(mvp, center, radius, viewportHeight, desc.m_Width, desc.m_Height, desc.m_LevelCount, bias));
+}
+
+void TextureStreamer::requestLevel(StreamedTextureId id, int level) {
+	Texture &texture = m_Textures[id];
+	level = std::min(std::max(level, 0), texture.m_Desc.m_LevelCount - 1);
+	texture.m_DesiredLevel = std::min(texture.m_DesiredLevel, level);
+	if (level < texture.m_Desc.m_LevelCount - 1) texture.m_LastUsedFrame = m_Frame;
+}
+
+
+
+size_t TextureStreamer::levelBytes(Texture const &texture, int level) const {
+	StreamedTextureDesc const &desc = texture.m_Desc;
+	return static_cast<size_t>(levelSize(desc.m_Width, level)) * levelSize(desc.m_Height, level) * desc.m_BytesPerPixel;
+}
+
+void TextureStreamer::queueLoad(StreamedTextureId id, int level) {
+	Texture &texture = m_Textures[id];
+	texture.m_Loading = true;
+	++m_LoadingCount;
+	m_LoadingBytes += levelBytes(texture, level);
+
+	LoadRequest request;
+	request.m_Id = id;
+	request.m_Level = level;
+	request.m_Width = levelSize(texture.m_Desc.m_Width, level);
+	request.m_Height = levelSize(texture.m_Desc.m_Height, level);
+	request.m_Pixels = static_cast<size_t>(request.m_Width) * request.m_Height;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		request.m_Sequence = m_NextSequence++;
+		m_LoadQueue.push(request);
+	}
+	m_WorkAvailable.notify_one();
+}
+
+void TextureStreamer::streamLoop() {
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true) {
+		m_WorkAvailable.wait(lock, [this]() { return m_Quit || !m_LoadQueue.empty(); });
+		if (m_Quit) return;
+
+		LoadRequest const request = m_LoadQueue.top();
+		m_LoadQueue.pop();
+		MipLoader const loader = m_Loaders[request.m_Id];
+
+		// the slow part, without the lock
+		lock.unlock();
+		LoadedLevel loaded;
+		loaded.m_Id = request.m_Id;
+		loaded.m_Level = request.m_Level;
+		loaded.m_Ok = loader(request.m_Level, request.m_Width, request.m_Height, loaded.m_Pixels);
+		lock.lock();
+
+		m_Loaded.push_back(std::move(loaded));
+	}
+}
+
+
+
+void TextureStreamer::upload(Texture &texture, LoadedLevel const &loaded) {
+	StreamedTextureDesc const &desc = texture.m_Desc;
+	int previousTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	if (0 == texture.m_Object) {
+		glGenTextures(1, &texture.m_Object);
+		glBindTexture(GL_TEXTURE_2D, texture.m_Object);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, desc.m_LevelCount - 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	else {
+		glBindTexture(GL_TEXTURE_2D, texture.m_Object);
+	}
+
+	int previousAlignment = 4;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows are tightly packed
+	glTexImage2D(GL_TEXTURE_2D, loaded.m_Level, desc.m_InternalFormat, levelSize(desc.m_Width, loaded.m_Level), levelSize(desc.m_Height, loaded.m_Level), 0,
+		desc.m_Format, desc.m_Type, loaded.m_Pixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+	// levels below the base level are ignored for completeness, so the texture samples fine with just [base, max] defined
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, loaded.m_Level);
+	glBindTexture(GL_TEXTURE_2D, previousTexture);
+
+	texture.m_ResidentLevel = loaded.m_Level;
+	m_ResidentBytes += levelBytes(texture, loaded.m_Level);
+	++m_UploadedLevels;
+}
+
+void TextureStreamer::evictOverBudget(size_t wantedBytes) {
+	size_t const budget = wantedBytes < m_BudgetBytes ? m_BudgetBytes - wantedBytes : 0;
+	if (m_ResidentBytes + m_LoadingBytes <= budget) return;
+
+	// least recently used first: a texture's finest level goes if nobody needs it this frame (or it's finer than needed)
+	std::vector<std::pair<uint64_t, StreamedTextureId>> candidates;
+	for (size_t i = 0; i < m_Textures.size(); ++i) {
+		Texture const &texture = m_Textures[i];
+		if (texture.m_ResidentLevel < texture.m_Desc.m_LevelCount - 1) candidates.push_back(std::make_pair(texture.m_LastUsedFrame, static_cast<StreamedTextureId>(i)));
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	int previousTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	for (std::pair<uint64_t, StreamedTextureId> const &candidate : candidates) {
+		Texture &texture = m_Textures[candidate.second];
+		glBindTexture(GL_TEXTURE_2D, texture.m_Object);
+		while (m_ResidentBytes + m_LoadingBytes > budget && texture.m_ResidentLevel < texture.m_Desc.m_LevelCount - 1) {
+			bool const neededNow = m_Frame == texture.m_LastUsedFrame && texture.m_ResidentLevel >= texture.m_DesiredLevel;
+			if (neededNow) break;
+			int const level = texture.m_ResidentLevel;
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+			glTexImage2D(GL_TEXTURE_2D, level, texture.m_Desc.m_InternalFormat, 0, 0, 0, texture.m_Desc.m_Format, texture.m_Desc.m_Type, nullptr);
+			texture.m_ResidentLevel = level + 1;
+			m_ResidentBytes -= levelBytes(texture, level);
+			++m_EvictedLevels;
+		}
+		if (m_ResidentBytes + m_LoadingBytes <= budget) break;
+	}
+	glBindTexture(GL_TEXTURE_2D, previousTexture);
+}
+
+void TextureStreamer::update() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (LoadedLevel &loaded : m_Loaded) m_ToUpload.push_back(std::move(loaded));
+		m_Loaded.clear();
+	}
+
+	// uploads, at least 1 per frame even if it's over the upload budget
+	size_t uploaded = 0;
+	size_t done = 0;
+	for (; done < m_ToUpload.size() && (0 == done || uploaded < m_UploadBudget); ++done) {
+		LoadedLevel const &loaded = m_ToUpload[done];
+		Texture &texture = m_Textures[loaded.m_Id];
+		size_t const bytes = levelBytes(texture, loaded.m_Level);
+		texture.m_Loading = false;
+		--m_LoadingCount;
+		m_LoadingBytes -= bytes;
+		if (!loaded.m_Ok || loaded.m_Pixels.size() != bytes) {
+			texture.m_Failed = true;
+			++m_FailedLoads;
+			continue;
+		}
+		// the level under it got evicted meanwhile, the chain would have a hole
+		if (loaded.m_Level != texture.m_ResidentLevel - 1) continue;
+		upload(texture, loaded);
+		uploaded += bytes;
+	}
+	m_ToUpload.erase(m_ToUpload.begin(), m_ToUpload.begin() + done);
+
+	// room for the next level of everything that wants to be sharper, taken from what nobody needs right now
+	size_t wantedBytes = 0;
+	for (Texture const &texture : m_Textures) {
+		if (!texture.m_Loading && !texture.m_Failed && texture.m_ResidentLevel > texture.m_DesiredLevel) wantedBytes += levelBytes(texture, texture.m_ResidentLevel - 1);
+	}
+	evictOverBudget(wantedBytes);
+
+	// next finer level for whatever wants to be sharper, as far as the budget goes
+	for (size_t i = 0; i < m_Textures.size(); ++i) {
+		Texture &texture = m_Textures[i];
+		if (texture.m_Loading || texture.m_Failed || texture.m_ResidentLevel <= texture.m_DesiredLevel) continue;
+		int const level = texture.m_ResidentLevel - 1;
+		if (m_ResidentBytes + m_LoadingBytes + levelBytes(texture, level) > m_BudgetBytes) continue;
+		queueLoad(static_cast<StreamedTextureId>(i), level);
+	}
+
+	// requests are per frame
+	for (Texture &texture : m_Textures) texture.m_DesiredLevel = texture.m_Desc.m_LevelCount - 1;
+	++m_Frame;
+}
+
+
+
+unsigned int TextureStreamer::getTexture(StreamedTextureId id) const {
+	Texture const &texture = m_Textures[id];
+	return texture.m_ResidentLevel < texture.m_Desc.m_LevelCount ? texture.m_Object : 0;
+}
+
+int TextureStreamer::getResidentLevel(StreamedTextureId id) const {
+	return m_Textures[id].m_ResidentLevel;
+}
+
+int TextureStreamer::getDesiredLevel(StreamedTextureId id) const {
+	return m_Textures[id].m_DesiredLevel;
+}
+
+TextureStreamerStats TextureStreamer::getStats() const {
+	TextureStreamerStats stats;
+	stats.m_TextureCount = m_Textures.size();
+	stats.m_ResidentBytes = m_ResidentBytes;
+	stats.m_BudgetBytes = m_BudgetBytes;
+	stats.m_LoadingCount = m_LoadingCount;
+	stats.m_UploadedLevels = m_UploadedLevels;
+	stats.m_EvictedLevels = m_EvictedLevels;
+	stats.m_FailedLoads = m_FailedLoads;
+	return stats;
+}
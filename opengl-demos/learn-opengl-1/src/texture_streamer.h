@@ -0,0 +1,141 @@
+#pragma once
+
+#include <glm/vec3.hpp> // glm::vec3
+#include <glm/mat4x4.hpp> // glm::mat4
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// mip streaming, so texture memory scales with what's on screen rather than with what's in the scene
+// - a texture starts with only its coarsest mip, finer ones are loaded 1 at a time (coarse to fine) while something asks for them
+// - demand comes from the screen: requestFromBounds() projects an object's bounding sphere with its camera() matrix, the
+//   pixels it covers pick the finest mip worth having (1 texel per pixel)
+// - loads run on a streaming thread, coarser mips first across all textures (everything gets a rough version before anything gets
+//   a sharp one), update() uploads them on the GL thread within a per-frame byte budget
+// - when the memory budget is exceeded (or a wanted mip wouldn't fit), update() evicts the finest mip of whichever texture needed
+//   it least recently (LRU), mips demanded this frame and the coarsest mips are never evicted
+// - GL 3.3 has no sparse textures: levels are glTexImage2D()'d 1 by 1, GL_TEXTURE_BASE_LEVEL points at the finest resident one,
+//   and eviction redefines the level as 0x0 so the driver can release it
+
+
+
+typedef uint32_t StreamedTextureId;
+
+struct StreamedTextureDesc {
+	int m_Width = 0; // level 0 (finest)
+	int m_Height = 0;
+	int m_LevelCount = 0; // 0 = the full chain down to 1x1
+	unsigned int m_InternalFormat = 0; // e.g. GL_SRGB8_ALPHA8
+	unsigned int m_Format = 0; // e.g. GL_RGBA
+	unsigned int m_Type = 0; // e.g. GL_UNSIGNED_BYTE
+	int m_BytesPerPixel = 4; // for the memory budget (and the expected size of a loaded level)
+};
+
+// fills pixels with the level's rows (tightly packed, bottom row first), runs on the streaming thread, false = failed
+typedef std::function<bool(int level, int width, int height, std::vector<uint8_t> &pixels)> MipLoader;
+
+struct TextureStreamerStats {
+	size_t m_TextureCount = 0;
+	size_t m_ResidentBytes = 0;
+	size_t m_BudgetBytes = 0;
+	size_t m_LoadingCount = 0; // queued or being loaded
+	uint64_t m_UploadedLevels = 0; // so far
+	uint64_t m_EvictedLevels = 0; // so far
+	uint64_t m_FailedLoads = 0; // so far
+};
+
+
+
+class TextureStreamer {
+public:
+	static size_t const DEFAULT_UPLOAD_BUDGET = 4 * 1024 * 1024; // bytes per frame
+
+	explicit TextureStreamer(size_t budgetBytes, size_t uploadBudget = DEFAULT_UPLOAD_BUDGET);
+	~TextureStreamer(); // finishes the load in progress, deletes the textures (needs the GL context to still be current)
+
+	TextureStreamer(TextureStreamer const &) = delete;
+	TextureStreamer &operator=(TextureStreamer const &) = delete;
+
+	// GL thread, the coarsest level is queued right away
+	StreamedTextureId add(StreamedTextureDesc const &desc, MipLoader loader);
+
+	// this frame wants the texture sharp enough for a bounding sphere (object space) drawn with mvp (e.g. from camera())
+	// on a viewport viewportHeight pixels high, assuming the texture spans the object once (bias > 0 = blurrier)
+	void requestFromBounds(StreamedTextureId id, glm::mat4 const &mvp, glm::vec3 const &center, float radius, int viewportHeight, float bias = 0.0f);
+	// this frame wants at least this level (0 = finest)
+	void requestLevel(StreamedTextureId id, int level);
+
+	// GL thread, once per frame after the requests: uploads loaded levels, evicts over budget, queues the next loads
+	void update();
+
+	unsigned int getTexture(StreamedTextureId id) const; // 0 until the coarsest level is in
+	int getResidentLevel(StreamedTextureId id) const; // finest level on the GPU, m_LevelCount if none yet
+	int getDesiredLevel(StreamedTextureId id) const; // finest level requested this frame
+
+	void setBudget(size_t bytes) { m_BudgetBytes = bytes; }
+	TextureStreamerStats getStats() const;
+
+	// the level requestFromBounds() picks, exposed for tools and tests
+	static int levelForBounds(glm::mat4 const &mvp, glm::vec3 const &center, float radius, int viewportHeight, int width, int height, int levelCount, float bias);
+
+private:
+	struct Texture {
+		StreamedTextureDesc m_Desc;
+		unsigned int m_Object = 0;
+		int m_ResidentLevel = 0; // finest level on the GPU (m_LevelCount = none)
+		int m_DesiredLevel = 0; // this frame's finest request (m_LevelCount - 1 if nobody asked)
+		uint64_t m_LastUsedFrame = 0; // last frame anyone requested more than the coarsest level
+		bool m_Loading = false; // at most 1 level in flight per texture (always m_ResidentLevel - 1)
+		bool m_Failed = false; // a load failed, stop streaming this one
+	};
+
+	struct LoadRequest {
+		size_t m_Pixels; // smaller = higher priority
+		uint64_t m_Sequence;
+		StreamedTextureId m_Id;
+		int m_Level;
+		int m_Width; // of the level
+		int m_Height;
+		bool operator<(LoadRequest const &other) const { return m_Pixels > other.m_Pixels || (m_Pixels == other.m_Pixels && m_Sequence > other.m_Sequence); }
+	};
+
+	struct LoadedLevel {
+		StreamedTextureId m_Id;
+		int m_Level;
+		bool m_Ok;
+		std::vector<uint8_t> m_Pixels;
+	};
+
+	size_t levelBytes(Texture const &texture, int level) const;
+	void queueLoad(StreamedTextureId id, int level); // GL thread
+	void upload(Texture &texture, LoadedLevel const &loaded);
+	void evictOverBudget(size_t wantedBytes); // until wantedBytes more fit in the budget (or only needed levels are left)
+	void streamLoop();
+
+	std::vector<Texture> m_Textures; // indexed by StreamedTextureId, GL thread only
+	std::vector<LoadedLevel> m_ToUpload; // loaded, waiting for upload budget (GL thread only)
+	size_t m_BudgetBytes;
+	size_t m_UploadBudget;
+	size_t m_ResidentBytes = 0;
+	uint64_t m_Frame = 1;
+	uint64_t m_UploadedLevels = 0;
+	uint64_t m_EvictedLevels = 0;
+	uint64_t m_FailedLoads = 0;
+	size_t m_LoadingCount = 0;
+	size_t m_LoadingBytes = 0; // counted against the budget already
+
+	std::mutex m_Mutex; // guards everything below
+	std::condition_variable m_WorkAvailable;
+	std::priority_queue<LoadRequest> m_LoadQueue;
+	std::vector<MipLoader> m_Loaders; // by StreamedTextureId, so the streaming thread never touches m_Textures
+	std::vector<LoadedLevel> m_Loaded;
+	uint64_t m_NextSequence = 0;
+	bool m_Quit = false;
+	std::thread m_Thread;
+};
@@ -0,0 +1,223 @@
+#include "benchmarks.h"
+#include "texture_streamer.h"
+
+//NOTE: must include glad before glfw
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/mat4x4.hpp> // glm::mat4
+#include <glm/gtc/matrix_transform.hpp> // glm::perspective, glm::lookAt, glm::scale
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+
+
+// TextureStreamer checks, plus how many frames streaming takes
+// - levelForBounds(): a sphere of known screen size picks log2(texels / pixels), rounded towards coarser, clamped to the chain,
+//   with bias and object scale taken into account
+// - LRU/budget: 2 textures streamed in fully, then only 1 of them is used, then a 3rd one wants all of its levels: the budget only
+//   has room if a level goes, and it has to come from the texture that was used least recently, not the 3rd one (needed this frame);
+//   then a budget below what's on screen takes everything else down to its coarsest level but leaves what's needed
+// - the resident bytes never go over the budget, the streamed levels hold the loader's pixels and GL_UNPACK_ALIGNMENT is left alone
+// needs a GL context, so a hidden window is created
+
+
+
+namespace {
+	int const TEXTURE_SIZE = 64; // 7 levels, 16 KB level 0, 21844 bytes the full chain
+	int const MAX_FRAMES = 1000; // a streamer that stops making progress fails instead of hanging
+
+	struct BoundsCase {
+		float m_Distance; // from the camera, along its view direction
+		float m_Scale; // of the object
+		float m_Bias;
+		int m_Expected;
+	};
+
+	// 90 degree vertical fov on a 1024 pixel viewport: a radius 1 sphere at distance d covers 1024 / d pixels (a 1024 texture
+	// wants level log2(d)), distances keep away from whole powers of 2 so rounding in the projection can't flip the level
+	BoundsCase const BOUNDS_CASES[] = {
+		{ 0.5f, 1.0f, 0.0f, 0 }, // camera inside the sphere
+		{ 1.5f, 1.0f, 0.0f, 0 },
+		{ 2.5f, 1.0f, 0.0f, 1 },
+		{ 10.0f, 1.0f, 0.0f, 3 },
+		{ 10.0f, 1.0f, 1.0f, 4 }, // bias makes it blurrier
+		{ 10.0f, 1.0f, -1.0f, 2 },
+		{ 5.0f, 2.0f, 0.0f, 1 }, // twice as big twice as far = same size on screen
+		{ 600.0f, 1.0f, 0.0f, 9 },
+		{ 3000.0f, 1.0f, 0.0f, 10 }, // below 1 pixel: the coarsest level
+		{ 0.5f, 1.0f, 5.0f, 0 }, // inside the sphere wins over the bias
+	};
+
+	bool checkLevelForBounds() {
+		int const VIEWPORT_HEIGHT = 1024;
+		int const TEXTURE_LEVELS = 11; // 1024 .. 1
+		bool ok = true;
+		glm::mat4 const projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 10000.0f);
+		for (BoundsCase const &boundsCase : BOUNDS_CASES) {
+			// off to the side and looked at from an angle, only the depth along the view direction matters
+			glm::vec3 const center(3.0f, -2.0f, 1.0f);
+			glm::mat4 const view = glm::lookAt(center + glm::vec3(0.0f, 0.0f, boundsCase.m_Distance) + glm::vec3(0.7f, 0.2f, 0.0f),
+				center + glm::vec3(0.7f, 0.2f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			glm::mat4 const model = glm::scale(glm::mat4(1.0f), glm::vec3(boundsCase.m_Scale));
+			glm::mat4 const mvp = projection * view * model;
+			int const level = TextureStreamer::levelForBounds(mvp, center / boundsCase.m_Scale, 1.0f, VIEWPORT_HEIGHT, 1024, 512,
+				TEXTURE_LEVELS, boundsCase.m_Bias);
+			if (boundsCase.m_Expected == level) continue;
+			std::printf("MISMATCH: levelForBounds() at distance %.1f, scale %.1f, bias %.1f is %d, expected %d\n", boundsCase.m_Distance,
+				boundsCase.m_Scale, boundsCase.m_Bias, level, boundsCase.m_Expected);
+			ok = false;
+		}
+		return ok;
+	}
+
+	uint8_t pixelByte(StreamedTextureId id, int level, size_t i) {
+		return static_cast<uint8_t>(i * 7 + level * 31 + id * 101);
+	}
+
+	MipLoader makeLoader(StreamedTextureId id) {
+		return [id](int level, int width, int height, std::vector<uint8_t> &pixels) {
+			pixels.resize(static_cast<size_t>(width) * height * 4);
+			for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = pixelByte(id, level, i);
+			return true;
+		};
+	}
+
+	// runs frames with requests(frame) until done() or MAX_FRAMES, false if it ran out of frames or went over the budget (printed)
+	template <typename Requests, typename Done>
+	bool runFrames(TextureStreamer &streamer, char const *phase, Requests requests, Done done) {
+		for (int frame = 0; frame < MAX_FRAMES; ++frame) {
+			requests();
+			streamer.update();
+			TextureStreamerStats const stats = streamer.getStats();
+			if (stats.m_ResidentBytes > stats.m_BudgetBytes) {
+				std::printf("MISMATCH: %s: %zu bytes resident, the budget is %zu\n", phase, stats.m_ResidentBytes, stats.m_BudgetBytes);
+				return false;
+			}
+			if (done()) {
+				std::printf("%-26s %4d frames, %6zu bytes resident\n", phase, frame + 1, stats.m_ResidentBytes);
+				return true;
+			}
+			std::this_thread::yield(); // the streaming thread is still loading
+		}
+		std::printf("MISMATCH: %s didn't finish in %d frames\n", phase, MAX_FRAMES);
+		return false;
+	}
+
+	bool checkLevelContents(TextureStreamer const &streamer, StreamedTextureId id) {
+		int const level = streamer.getResidentLevel(id);
+		int const size = std::max(1, TEXTURE_SIZE >> level);
+		std::vector<uint8_t> readBack(static_cast<size_t>(size) * size * 4);
+		glBindTexture(GL_TEXTURE_2D, streamer.getTexture(id));
+		glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, readBack.data());
+		glBindTexture(GL_TEXTURE_2D, 0);
+		for (size_t i = 0; i < readBack.size(); ++i) {
+			if (pixelByte(id, level, i) == readBack[i]) continue;
+			std::printf("MISMATCH: texture %u level %d differs from what its loader made at byte %zu\n", id, level, i);
+			return false;
+		}
+		return true;
+	}
+
+	bool checkEviction() {
+		size_t const CHAIN_BYTES = 21844;
+		size_t const BUDGET = 2 * CHAIN_BYTES + 6000; // 2 full chains and the 3rd's coarse levels, not its level 0 (16 KB)
+
+		TextureStreamer streamer(BUDGET);
+		StreamedTextureDesc desc;
+		desc.m_Width = TEXTURE_SIZE;
+		desc.m_Height = TEXTURE_SIZE;
+		desc.m_InternalFormat = GL_RGBA8;
+		desc.m_Format = GL_RGBA;
+		desc.m_Type = GL_UNSIGNED_BYTE;
+		// added in this order so the least recently used one isn't the first (or last) texture
+		StreamedTextureId const recent = streamer.add(desc, makeLoader(0));
+		StreamedTextureId const old = streamer.add(desc, makeLoader(1));
+		StreamedTextureId const c = streamer.add(desc, makeLoader(2));
+
+		// 2 textures fully, c stays at its coarsest level
+		bool ok = runFrames(streamer, "old + recent to level 0", [&]() {
+			streamer.requestLevel(recent, 0);
+			streamer.requestLevel(old, 0);
+		}, [&]() {
+			return 0 == streamer.getResidentLevel(recent) && 0 == streamer.getResidentLevel(old) && 6 == streamer.getResidentLevel(c);
+		});
+
+		// a few frames of only 1 of them, so the other one is the least recently used
+		int framesOfRecent = 0;
+		ok = ok && runFrames(streamer, "only recent", [&]() { streamer.requestLevel(recent, 0); }, [&]() { return 5 == ++framesOfRecent; });
+
+		// c wants everything, nothing else is on screen: old's level 0 has to go, recent's stays, c's own levels are needed
+		ok = ok && runFrames(streamer, "c to level 0", [&]() { streamer.requestLevel(c, 0); }, [&]() { return 0 == streamer.getResidentLevel(c); });
+		if (!ok) return false;
+
+		TextureStreamerStats const stats = streamer.getStats();
+		if (1 != streamer.getResidentLevel(old) || 0 != streamer.getResidentLevel(recent) || 1 != stats.m_EvictedLevels) {
+			std::printf("MISMATCH: resident levels old %d recent %d c %d, %llu evicted, expected 1 0 0 and 1 (old's level 0)\n",
+				streamer.getResidentLevel(old), streamer.getResidentLevel(recent), streamer.getResidentLevel(c),
+				static_cast<unsigned long long>(stats.m_EvictedLevels));
+			return false;
+		}
+		ok = checkLevelContents(streamer, recent) && checkLevelContents(streamer, old) && checkLevelContents(streamer, c);
+
+		// the budget drops below what's on screen: everything else goes, levels needed this frame stay even if that's over budget
+		streamer.setBudget(CHAIN_BYTES);
+		for (int frame = 0; frame < 3; ++frame) {
+			streamer.requestLevel(recent, 0);
+			streamer.requestLevel(c, 0);
+			streamer.update();
+		}
+		if (6 != streamer.getResidentLevel(old) || 0 != streamer.getResidentLevel(recent) || 0 != streamer.getResidentLevel(c)) {
+			std::printf("MISMATCH: after shrinking the budget: resident levels old %d recent %d c %d, expected 6 0 0\n",
+				streamer.getResidentLevel(old), streamer.getResidentLevel(recent), streamer.getResidentLevel(c));
+			return false;
+		}
+		return ok;
+	}
+}
+
+
+
+int textureStreamerBenchMain() {
+	bool ok = checkLevelForBounds();
+
+	if (!glfwInit()) return -1;
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow *window = glfwCreateWindow(64, 64, "texture streamer bench", NULL, NULL);
+	if (NULL == window) {
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+		glfwTerminate();
+		return -1;
+	}
+
+	// uploads set their own alignment, whatever the caller had has to survive them
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
+	ok = checkEviction() && ok;
+	int unpackAlignment = 0;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	if (8 != unpackAlignment) {
+		std::printf("MISMATCH: GL_UNPACK_ALIGNMENT is %d after streaming, it was 8\n", unpackAlignment);
+		ok = false;
+	}
+	GLenum const error = glGetError();
+	if (GL_NO_ERROR != error) {
+		std::printf("MISMATCH: GL error 0x%x\n", error);
+		ok = false;
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+
+	if (!ok) std::printf("MISMATCH: see above\n");
+	return ok ? 0 : -1;
+}
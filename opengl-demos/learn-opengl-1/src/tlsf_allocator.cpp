@@ -0,0 +1,250 @@
+#include "tlsf_allocator.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+
+
+
+namespace {
+	size_t const GRANULARITY_LOG2 = 4;
+
+	// index of the lowest set bit, v != 0
+	unsigned int lowestBit(uint32_t v) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, v);
+		return static_cast<unsigned int>(index);
+#else
+		return static_cast<unsigned int>(__builtin_ctz(v));
+#endif
+	}
+
+	// index of the highest set bit, v != 0 (split in 32-bit halves, the x86 build has no 64-bit bit scan)
+	unsigned int highestBit(uint64_t v) {
+		uint32_t const high = static_cast<uint32_t>(v >> 32);
+		uint32_t const part = high ? high : static_cast<uint32_t>(v);
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, part);
+#else
+		unsigned int const index = 31 - static_cast<unsigned int>(__builtin_clz(part));
+#endif
+		return static_cast<unsigned int>(index) + (high ? 32 : 0);
+	}
+
+	size_t alignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+
+
+TlsfAllocator::TlsfAllocator(size_t capacity) : m_Capacity(capacity & ~(GRANULARITY - 1)) {
+	for (size_t fl = 0; fl < FL_COUNT; ++fl) {
+		for (size_t sl = 0; sl < SL_COUNT; ++sl) m_FreeLists[fl][sl] = INVALID_BLOCK;
+	}
+	if (m_Capacity < GRANULARITY) return;
+
+	BlockId const block = newBlock();
+	m_Blocks[block].m_Size = m_Capacity;
+	m_FirstBlock = m_LastBlock = block;
+	insertFree(block);
+}
+
+
+
+void TlsfAllocator::mapping(size_t size, size_t &fl, size_t &sl) {
+	if (size < (SL_COUNT << GRANULARITY_LOG2)) {
+		// small sizes: first level 0, 1 list per GRANULARITY step
+		fl = 0;
+		sl = size >> GRANULARITY_LOG2;
+		return;
+	}
+	size_t const log2 = highestBit(size);
+	sl = (size >> (log2 - SL_BITS)) - SL_COUNT;
+	fl = log2 - (SL_BITS + GRANULARITY_LOG2) + 1;
+}
+
+TlsfAllocator::BlockId TlsfAllocator::newBlock() {
+	if (!m_UnusedBlocks.empty()) {
+		BlockId const block = m_UnusedBlocks.back();
+		m_UnusedBlocks.pop_back();
+		m_Blocks[block] = Block();
+		return block;
+	}
+	m_Blocks.push_back(Block());
+	return static_cast<BlockId>(m_Blocks.size() - 1);
+}
+
+void TlsfAllocator::insertFree(BlockId block) {
+	size_t fl, sl;
+	mapping(m_Blocks[block].m_Size, fl, sl);
+	BlockId const head = m_FreeLists[fl][sl];
+	m_Blocks[block].m_Free = true;
+	m_Blocks[block].m_PrevFree = INVALID_BLOCK;
+	m_Blocks[block].m_NextFree = head;
+	if (INVALID_BLOCK != head) m_Blocks[head].m_PrevFree = block;
+	m_FreeLists[fl][sl] = block;
+	m_FlBitmap |= 1u << fl;
+	m_SlBitmaps[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::removeFree(BlockId block) {
+	size_t fl, sl;
+	mapping(m_Blocks[block].m_Size, fl, sl);
+	BlockId const prev = m_Blocks[block].m_PrevFree;
+	BlockId const next = m_Blocks[block].m_NextFree;
+	if (INVALID_BLOCK != prev) m_Blocks[prev].m_NextFree = next;
+	else m_FreeLists[fl][sl] = next;
+	if (INVALID_BLOCK != next) m_Blocks[next].m_PrevFree = prev;
+	m_Blocks[block].m_Free = false;
+
+	if (INVALID_BLOCK != m_FreeLists[fl][sl]) return;
+	m_SlBitmaps[fl] &= ~(1u << sl);
+	if (0 == m_SlBitmaps[fl]) m_FlBitmap &= ~(1u << fl);
+}
+
+size_t TlsfAllocator::roundUpToClass(size_t size) {
+	if (size >= (SL_COUNT << GRANULARITY_LOG2)) size += (static_cast<size_t>(1) << (highestBit(size) - SL_BITS)) - 1;
+	return size;
+}
+
+TlsfAllocator::BlockId TlsfAllocator::findFree(size_t size) const {
+	// round up to the next size class, so every block in the list found is big enough
+	size = roundUpToClass(size);
+	size_t fl, sl;
+	mapping(size, fl, sl);
+	if (fl >= FL_COUNT) return INVALID_BLOCK;
+
+	uint32_t slMap = m_SlBitmaps[fl] & (~0u << sl);
+	if (0 == slMap) {
+		uint32_t const flMap = fl + 1 < FL_COUNT ? m_FlBitmap & (~0u << (fl + 1)) : 0;
+		if (0 == flMap) return INVALID_BLOCK;
+		fl = lowestBit(flMap);
+		slMap = m_SlBitmaps[fl];
+	}
+	return m_FreeLists[fl][lowestBit(slMap)];
+}
+
+TlsfAllocator::BlockId TlsfAllocator::split(BlockId block, size_t size) {
+	if (m_Blocks[block].m_Size - size < GRANULARITY) return INVALID_BLOCK;
+
+	BlockId const rest = newBlock(); // before taking references, this can grow m_Blocks
+	Block &original = m_Blocks[block];
+	Block &tail = m_Blocks[rest];
+	tail.m_Offset = original.m_Offset + size;
+	tail.m_Size = original.m_Size - size;
+	tail.m_PrevPhysical = block;
+	tail.m_NextPhysical = original.m_NextPhysical;
+	if (INVALID_BLOCK != tail.m_NextPhysical) m_Blocks[tail.m_NextPhysical].m_PrevPhysical = rest;
+	else m_LastBlock = rest;
+	original.m_Size = size;
+	original.m_NextPhysical = rest;
+	return rest;
+}
+
+TlsfAllocator::BlockId TlsfAllocator::use(BlockId block, size_t size, size_t alignment) {
+	removeFree(block);
+
+	// padding in front for the alignment becomes its own free block (its physical neighbours can't be free, they'd have been merged)
+	size_t const padding = alignUp(m_Blocks[block].m_Offset, alignment) - m_Blocks[block].m_Offset;
+	if (0 < padding) {
+		BlockId const rest = split(block, padding);
+		insertFree(block);
+		block = rest;
+	}
+	BlockId const tail = split(block, size);
+	if (INVALID_BLOCK != tail) insertFree(tail);
+
+	m_Blocks[block].m_Alignment = alignment;
+	m_UsedBytes += m_Blocks[block].m_Size;
+	++m_AllocationCount;
+	return block;
+}
+
+
+
+size_t TlsfAllocator::getCapacityFor(size_t size, size_t alignment) {
+	// what allocate() searches for: a free block that big (the whole capacity, in an empty allocator) lands in a list findFree() takes
+	size = alignUp(std::max<size_t>(size, 1), GRANULARITY);
+	alignment = alignment < GRANULARITY ? GRANULARITY : alignment;
+	size_t const rounded = roundUpToClass(size + alignment - GRANULARITY);
+	if (rounded < (SL_COUNT << GRANULARITY_LOG2)) return alignUp(rounded, GRANULARITY);
+	// the start of that class is enough, anything below it maps to a lower list
+	return rounded & ~((static_cast<size_t>(1) << (highestBit(rounded) - SL_BITS)) - 1);
+}
+
+TlsfAllocator::BlockId TlsfAllocator::allocate(size_t size, size_t alignment) {
+	size = alignUp(std::max<size_t>(size, 1), GRANULARITY);
+	alignment = alignment < GRANULARITY ? GRANULARITY : alignment;
+	BlockId const block = findFree(size + alignment - GRANULARITY); // room for the worst-case padding
+	if (INVALID_BLOCK == block) return INVALID_BLOCK;
+	return use(block, size, alignment);
+}
+
+TlsfAllocator::BlockId TlsfAllocator::allocateBelow(size_t size, size_t alignment, size_t limit) {
+	size = alignUp(std::max<size_t>(size, 1), GRANULARITY);
+	alignment = alignment < GRANULARITY ? GRANULARITY : alignment;
+	for (BlockId block = m_FirstBlock; INVALID_BLOCK != block && m_Blocks[block].m_Offset < limit; block = m_Blocks[block].m_NextPhysical) {
+		Block const &candidate = m_Blocks[block];
+		if (!candidate.m_Free) continue;
+		size_t const end = alignUp(candidate.m_Offset, alignment) + size;
+		if (end <= candidate.m_Offset + candidate.m_Size && end <= limit) return use(block, size, alignment);
+	}
+	return INVALID_BLOCK;
+}
+
+void TlsfAllocator::free(BlockId block) {
+	if (INVALID_BLOCK == block || m_Blocks[block].m_Free) return;
+	m_UsedBytes -= m_Blocks[block].m_Size;
+	--m_AllocationCount;
+
+	// merge with free neighbours
+	BlockId const prev = m_Blocks[block].m_PrevPhysical;
+	if (INVALID_BLOCK != prev && m_Blocks[prev].m_Free) {
+		removeFree(prev);
+		m_Blocks[prev].m_Size += m_Blocks[block].m_Size;
+		m_Blocks[prev].m_NextPhysical = m_Blocks[block].m_NextPhysical;
+		if (INVALID_BLOCK != m_Blocks[prev].m_NextPhysical) m_Blocks[m_Blocks[prev].m_NextPhysical].m_PrevPhysical = prev;
+		else m_LastBlock = prev;
+		m_UnusedBlocks.push_back(block);
+		block = prev;
+	}
+	BlockId const next = m_Blocks[block].m_NextPhysical;
+	if (INVALID_BLOCK != next && m_Blocks[next].m_Free) {
+		removeFree(next);
+		m_Blocks[block].m_Size += m_Blocks[next].m_Size;
+		m_Blocks[block].m_NextPhysical = m_Blocks[next].m_NextPhysical;
+		if (INVALID_BLOCK != m_Blocks[block].m_NextPhysical) m_Blocks[m_Blocks[block].m_NextPhysical].m_PrevPhysical = block;
+		else m_LastBlock = block;
+		m_UnusedBlocks.push_back(next);
+	}
+	insertFree(block);
+}
+
+
+
+void TlsfAllocator::getUsedBlocksFromTop(std::vector<BlockId> &blocks) const {
+	blocks.clear();
+	for (BlockId block = m_LastBlock; INVALID_BLOCK != block; block = m_Blocks[block].m_PrevPhysical) {
+		if (!m_Blocks[block].m_Free) blocks.push_back(block);
+	}
+}
+
+TlsfStats TlsfAllocator::getStats() const {
+	TlsfStats stats;
+	stats.m_Capacity = m_Capacity;
+	stats.m_UsedBytes = m_UsedBytes;
+	stats.m_FreeBytes = m_Capacity - m_UsedBytes;
+	stats.m_AllocationCount = m_AllocationCount;
+	for (BlockId block = m_FirstBlock; INVALID_BLOCK != block; block = m_Blocks[block].m_NextPhysical) {
+		if (!m_Blocks[block].m_Free) continue;
+		++stats.m_FreeBlockCount;
+		stats.m_LargestFreeBlock = std::max(stats.m_LargestFreeBlock, m_Blocks[block].m_Size);
+	}
+	if (0 < stats.m_FreeBytes) stats.m_Fragmentation = 1.0 - static_cast<double>(stats.m_LargestFreeBlock) / stats.m_FreeBytes;
+	return stats;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// two-level segregated fit allocator ("TLSF: a New Dynamic Memory Allocator for Real-Time Systems", Masmano et al. 2004)
+// over a range of offsets, the memory itself lives elsewhere (a GL buffer, see GpuBufferPool)
+// - allocate()/free() are O(1): free blocks sit in lists by size class (first level = power of 2, second level = SL_COUNT
+//   linear steps within it) and 2 levels of bitmaps find a non-empty list that's big enough with 2 bit scans
+// - block headers are kept on the side (m_Blocks) since the managed memory can't hold them
+// - free neighbours are merged right away, so fragmentation only comes from live blocks in the way (see allocateBelow() for compaction)
+
+
+
+struct TlsfStats {
+	size_t m_Capacity = 0;
+	size_t m_UsedBytes = 0; // including alignment padding that couldn't be split off
+	size_t m_FreeBytes = 0;
+	size_t m_LargestFreeBlock = 0;
+	size_t m_FreeBlockCount = 0;
+	size_t m_AllocationCount = 0;
+	double m_Fragmentation = 0.0; // 1 - largest free block / free bytes, 0 = all free space is in 1 piece
+};
+
+class TlsfAllocator {
+public:
+	typedef uint32_t BlockId;
+	static BlockId const INVALID_BLOCK = 0xFFFFFFFFu;
+	static size_t const GRANULARITY = 16; // every offset and size is a multiple of this (and the smallest block)
+
+	explicit TlsfAllocator(size_t capacity);
+
+	// alignment has to be a power of 2, INVALID_BLOCK if nothing fits
+	BlockId allocate(size_t size, size_t alignment = GRANULARITY);
+	void free(BlockId block);
+
+	// smallest capacity an empty allocator needs for allocate(size, alignment) to succeed (allocate() rounds the search up to the
+	// next size class and adds room for the worst-case alignment padding, so this is more than size)
+	static size_t getCapacityFor(size_t size, size_t alignment = GRANULARITY);
+
+	// lowest-offset fit that ends at or below limit, INVALID_BLOCK if there's none (O(blocks), for compaction)
+	BlockId allocateBelow(size_t size, size_t alignment, size_t limit);
+
+	size_t getOffset(BlockId block) const { return m_Blocks[block].m_Offset; }
+	size_t getSize(BlockId block) const { return m_Blocks[block].m_Size; }
+	size_t getAlignment(BlockId block) const { return m_Blocks[block].m_Alignment; }
+	size_t getCapacity() const { return m_Capacity; }
+	bool isEmpty() const { return 0 == m_AllocationCount; }
+
+	// used blocks from the highest offset down (compaction moves the topmost ones first)
+	void getUsedBlocksFromTop(std::vector<BlockId> &blocks) const;
+
+	TlsfStats getStats() const;
+
+private:
+	static size_t const SL_BITS = 4;
+	static size_t const SL_COUNT = 1 << SL_BITS;
+	static size_t const FL_COUNT = 32;
+
+	struct Block {
+		size_t m_Offset = 0;
+		size_t m_Size = 0;
+		size_t m_Alignment = 0; // what it was allocated with (used blocks only)
+		BlockId m_PrevPhysical = INVALID_BLOCK;
+		BlockId m_NextPhysical = INVALID_BLOCK;
+		BlockId m_PrevFree = INVALID_BLOCK;
+		BlockId m_NextFree = INVALID_BLOCK;
+		bool m_Free = false;
+	};
+
+	static void mapping(size_t size, size_t &fl, size_t &sl);
+	static size_t roundUpToClass(size_t size); // smallest size whose list only holds blocks of at least size
+
+	BlockId newBlock();
+	void insertFree(BlockId block);
+	void removeFree(BlockId block);
+	BlockId findFree(size_t size) const; // a free block of at least size (after rounding up to its size class)
+	BlockId split(BlockId block, size_t size); // cuts block down to size, returns the (unlisted) rest or INVALID_BLOCK
+	BlockId use(BlockId block, size_t size, size_t alignment); // turns (part of) a free block into an allocation
+
+	size_t m_Capacity;
+	std::vector<Block> m_Blocks;
+	std::vector<BlockId> m_UnusedBlocks; // recycled entries of m_Blocks
+	BlockId m_FirstBlock = INVALID_BLOCK; // lowest offset
+	BlockId m_LastBlock = INVALID_BLOCK; // highest offset
+
+	uint32_t m_FlBitmap = 0;
+	uint32_t m_SlBitmaps[FL_COUNT] = {};
+	BlockId m_FreeLists[FL_COUNT][SL_COUNT];
+
+	size_t m_UsedBytes = 0;
+	size_t m_AllocationCount = 0;
+};
@@ -0,0 +1,180 @@
+#include "benchmarks.h"
+#include "tlsf_allocator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+
+// TLSF allocator (the offset allocator under GpuBufferPool): randomized checks, then allocate()/free() timing
+// - random sizes (16 B .. 1 MB, mostly small like meshes) and power-of-2 alignments, allocated and freed in random order:
+//   live blocks never overlap, stay inside the capacity, are aligned and at least as big as asked for, and the stats add up
+// - freeing everything in random order coalesces back to 1 free block of the whole capacity
+// - getCapacityFor(size, alignment) is enough for an empty allocator and 16 bytes less isn't
+// - timing: steady state of ~4000 live blocks, every allocate() paired with a free() of a random live block
+
+
+
+namespace {
+	size_t const BENCH_CAPACITY = 256 * 1024 * 1024;
+	int const BENCH_ROUNDS = 20;
+	int const BENCH_OPERATIONS = 20000; // per round, every live block is checked after each round
+	int const CAPACITY_CASES = 200000;
+
+	struct LiveBlock {
+		TlsfAllocator::BlockId m_Block;
+		size_t m_Size; // as requested
+		size_t m_Alignment;
+	};
+
+	size_t randomSize(std::mt19937 &rng) {
+		// log-uniform, so small blocks are common but big ones show up too
+		return 1 + rng() % (static_cast<size_t>(16) << (rng() % 17));
+	}
+
+	size_t randomAlignment(std::mt19937 &rng) {
+		return static_cast<size_t>(1) << (rng() % 13); // 1 .. 4096
+	}
+
+	// false = mismatch (printed)
+	bool checkLiveBlocks(TlsfAllocator const &allocator, std::vector<LiveBlock> &live) {
+		std::sort(live.begin(), live.end(), [&allocator](LiveBlock const &a, LiveBlock const &b) {
+			return allocator.getOffset(a.m_Block) < allocator.getOffset(b.m_Block);
+		});
+		size_t end = 0;
+		size_t used = 0;
+		for (LiveBlock const &block : live) {
+			size_t const offset = allocator.getOffset(block.m_Block);
+			size_t const size = allocator.getSize(block.m_Block);
+			if (offset < end) {
+				std::printf("MISMATCH: block at %zu overlaps the one ending at %zu\n", offset, end);
+				return false;
+			}
+			if (0 != offset % block.m_Alignment || 0 != offset % TlsfAllocator::GRANULARITY) {
+				std::printf("MISMATCH: block at %zu isn't aligned to %zu\n", offset, block.m_Alignment);
+				return false;
+			}
+			if (size < block.m_Size) {
+				std::printf("MISMATCH: block at %zu is %zu bytes, %zu were asked for\n", offset, size, block.m_Size);
+				return false;
+			}
+			end = offset + size;
+			used += size;
+		}
+		if (end > allocator.getCapacity()) {
+			std::printf("MISMATCH: blocks end at %zu, past the capacity %zu\n", end, allocator.getCapacity());
+			return false;
+		}
+
+		TlsfStats const stats = allocator.getStats();
+		if (stats.m_AllocationCount != live.size() || stats.m_UsedBytes != used || stats.m_FreeBytes != stats.m_Capacity - used) {
+			std::printf("MISMATCH: stats say %zu blocks / %zu bytes used, there are %zu / %zu\n", stats.m_AllocationCount,
+				stats.m_UsedBytes, live.size(), used);
+			return false;
+		}
+		return true;
+	}
+
+	bool checkRandomized(unsigned int seed) {
+		std::mt19937 rng(seed);
+		TlsfAllocator allocator(BENCH_CAPACITY);
+		std::vector<LiveBlock> live;
+		int failed = 0;
+
+		for (int round = 0; round < BENCH_ROUNDS; ++round) {
+			// grow for the first half of the rounds, shrink in the second, so it goes from empty to full-ish and back
+			unsigned int const allocatePercent = round < BENCH_ROUNDS / 2 ? 60 : 40;
+			for (int i = 0; i < BENCH_OPERATIONS; ++i) {
+				if (live.empty() || rng() % 100 < allocatePercent) {
+					LiveBlock block;
+					block.m_Size = randomSize(rng);
+					block.m_Alignment = randomAlignment(rng);
+					block.m_Block = allocator.allocate(block.m_Size, block.m_Alignment);
+					if (TlsfAllocator::INVALID_BLOCK == block.m_Block) {
+						++failed;
+						continue;
+					}
+					live.push_back(block);
+				}
+				else {
+					size_t const index = rng() % live.size();
+					allocator.free(live[index].m_Block);
+					live[index] = live.back();
+					live.pop_back();
+				}
+			}
+			if (!checkLiveBlocks(allocator, live)) return false;
+		}
+		std::printf("randomized: %d operations, %zu blocks live at the end, %d allocations didn't fit\n", BENCH_ROUNDS * BENCH_OPERATIONS,
+			live.size(), failed);
+
+		std::shuffle(live.begin(), live.end(), rng);
+		for (LiveBlock const &block : live) allocator.free(block.m_Block);
+		TlsfStats const stats = allocator.getStats();
+		if (1 != stats.m_FreeBlockCount || stats.m_LargestFreeBlock != allocator.getCapacity() || !allocator.isEmpty()) {
+			std::printf("MISMATCH: after freeing everything there are %zu free blocks, the largest %zu of %zu bytes\n",
+				stats.m_FreeBlockCount, stats.m_LargestFreeBlock, allocator.getCapacity());
+			return false;
+		}
+		return true;
+	}
+
+	bool checkCapacityFor(unsigned int seed) {
+		std::mt19937 rng(seed);
+		for (int i = 0; i < CAPACITY_CASES; ++i) {
+			size_t const size = 1 + rng() % (static_cast<size_t>(1) << (rng() % 28));
+			size_t const alignment = randomAlignment(rng);
+			size_t const capacity = TlsfAllocator::getCapacityFor(size, alignment);
+			TlsfAllocator enough(capacity);
+			TlsfAllocator tooSmall(capacity - TlsfAllocator::GRANULARITY);
+			bool const fits = TlsfAllocator::INVALID_BLOCK != enough.allocate(size, alignment);
+			bool const fitsSmaller = TlsfAllocator::INVALID_BLOCK != tooSmall.allocate(size, alignment);
+			if (fits && !fitsSmaller) continue;
+			std::printf("MISMATCH: getCapacityFor(%zu, %zu) = %zu, allocate() %s in it and %s in %zu bytes less\n", size, alignment,
+				capacity, fits ? "fits" : "fails", fitsSmaller ? "fits" : "fails", TlsfAllocator::GRANULARITY);
+			return false;
+		}
+		return true;
+	}
+}
+
+
+
+int tlsfAllocatorBenchMain() {
+	bool allMatch = checkRandomized(1);
+	allMatch = checkCapacityFor(2) && allMatch;
+
+	int const LIVE_BLOCKS = 4000;
+	int const PAIRS = 2000000;
+	std::mt19937 rng(3);
+	std::vector<size_t> sizes(4096);
+	std::vector<size_t> alignments(sizes.size());
+	for (size_t i = 0; i < sizes.size(); ++i) {
+		sizes[i] = randomSize(rng);
+		alignments[i] = 0 == i % 4 ? randomAlignment(rng) : TlsfAllocator::GRANULARITY;
+	}
+	std::vector<uint32_t> victims(PAIRS);
+	for (uint32_t &victim : victims) victim = rng() % LIVE_BLOCKS;
+
+	TlsfAllocator allocator(BENCH_CAPACITY);
+	std::vector<TlsfAllocator::BlockId> live(LIVE_BLOCKS);
+	for (int i = 0; i < LIVE_BLOCKS; ++i) live[i] = allocator.allocate(sizes[i % sizes.size()], alignments[i % sizes.size()]);
+
+	double const start = benchSeconds();
+	for (int i = 0; i < PAIRS; ++i) {
+		TlsfAllocator::BlockId &victim = live[victims[i]];
+		allocator.free(victim);
+		size_t const index = i & (sizes.size() - 1);
+		victim = allocator.allocate(sizes[index], alignments[index]);
+	}
+	double const elapsed = benchSeconds() - start;
+
+	TlsfStats const stats = allocator.getStats();
+	std::printf("allocate + free: %.1f ns per pair, %d live blocks, fragmentation %.3f over %zu free blocks\n", elapsed / PAIRS * 1e9,
+		LIVE_BLOCKS, stats.m_Fragmentation, stats.m_FreeBlockCount);
+
+	if (!allMatch) std::printf("MISMATCH: see above\n");
+	return allMatch ? 0 : -1;
+}
@@ -0,0 +1,374 @@
+#include "vertex_transform.h"
+
+#include <glm/gtc/type_ptr.hpp> // glm::value_ptr
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+
+
+namespace {
+	// viewport mapping folded into 1 multiply-add per component: window = ndc * scale + offset
+	struct ViewportMapping {
+		float m_Scale[3];
+		float m_Offset[3];
+	};
+
+	ViewportMapping makeViewportMapping(Viewport const &viewport) {
+		float const halfW = 0.5f * viewport.m_Width;
+		float const halfH = 0.5f * viewport.m_Height;
+		float const halfD = 0.5f * (viewport.m_Far - viewport.m_Near);
+		ViewportMapping mapping;
+		mapping.m_Scale[0] = halfW;
+		mapping.m_Offset[0] = viewport.m_X + halfW;
+		mapping.m_Scale[1] = viewport.m_FlipY ? -halfH : halfH;
+		mapping.m_Offset[1] = viewport.m_Y + halfH;
+		mapping.m_Scale[2] = halfD;
+		mapping.m_Offset[2] = viewport.m_Near + halfD;
+		return mapping;
+	}
+
+	struct StreamPointers {
+		float const *m_X;
+		float const *m_Y;
+		float const *m_Z;
+		float *m_OutX;
+		float *m_OutY;
+		float *m_OutZ;
+		float *m_OutW;
+		size_t m_Count; // valid vertices, the kernels round up to their width (the streams are padded)
+	};
+
+	// m is column-major (glm layout), so row r of the matrix is m[r], m[r + 4], m[r + 8], m[r + 12]
+	typedef void (*TransformKernel)(float const *m, StreamPointers const &s);
+	typedef void (*ProjectKernel)(float const *m, ViewportMapping const &vp, StreamPointers const &s, uint8_t *clipCodes);
+
+	// bit k of each mask is set when lane k is outside that plane
+	void writeClipCodes(uint8_t *clipCodes, size_t count, int left, int right, int bottom, int top, int nearMask, int farMask) {
+		for (size_t k = 0; k < count; ++k) {
+			clipCodes[k] = static_cast<uint8_t>(
+				(((left >> k) & 1) * CLIP_LEFT) | (((right >> k) & 1) * CLIP_RIGHT) |
+				(((bottom >> k) & 1) * CLIP_BOTTOM) | (((top >> k) & 1) * CLIP_TOP) |
+				(((nearMask >> k) & 1) * CLIP_NEAR) | (((farMask >> k) & 1) * CLIP_FAR));
+		}
+	}
+
+
+
+	// SCALAR (reference)
+	// ------------------
+
+	void transformScalar(float const *m, StreamPointers const &s) {
+		for (size_t i = 0; i < s.m_Count; ++i) {
+			float const x = s.m_X[i];
+			float const y = s.m_Y[i];
+			float const z = s.m_Z[i];
+			s.m_OutX[i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+			s.m_OutY[i] = m[1] * x + m[5] * y + m[9] * z + m[13];
+			s.m_OutZ[i] = m[2] * x + m[6] * y + m[10] * z + m[14];
+			s.m_OutW[i] = m[3] * x + m[7] * y + m[11] * z + m[15];
+		}
+	}
+
+	void projectScalar(float const *m, ViewportMapping const &vp, StreamPointers const &s, uint8_t *clipCodes) {
+		for (size_t i = 0; i < s.m_Count; ++i) {
+			float const x = s.m_X[i];
+			float const y = s.m_Y[i];
+			float const z = s.m_Z[i];
+			float const cx = m[0] * x + m[4] * y + m[8] * z + m[12];
+			float const cy = m[1] * x + m[5] * y + m[9] * z + m[13];
+			float const cz = m[2] * x + m[6] * y + m[10] * z + m[14];
+			float const cw = m[3] * x + m[7] * y + m[11] * z + m[15];
+
+			if (nullptr != clipCodes) {
+				clipCodes[i] = static_cast<uint8_t>(
+					((cx < -cw) ? CLIP_LEFT : 0) | ((cx > cw) ? CLIP_RIGHT : 0) |
+					((cy < -cw) ? CLIP_BOTTOM : 0) | ((cy > cw) ? CLIP_TOP : 0) |
+					((cz < -cw) ? CLIP_NEAR : 0) | ((cz > cw) ? CLIP_FAR : 0));
+			}
+
+			// perspective divide (clip -> NDC), then NDC -> window
+			float const invW = 1.0f / cw;
+			s.m_OutX[i] = cx * invW * vp.m_Scale[0] + vp.m_Offset[0];
+			s.m_OutY[i] = cy * invW * vp.m_Scale[1] + vp.m_Offset[1];
+			s.m_OutZ[i] = cz * invW * vp.m_Scale[2] + vp.m_Offset[2];
+			s.m_OutW[i] = invW;
+		}
+	}
+
+
+
+	// SSE2 (4 vertices per iteration)
+	// -------------------------------
+
+	void transformSSE2(float const *m, StreamPointers const &s) {
+		__m128 col[16];
+		for (int i = 0; i < 16; ++i) col[i] = _mm_set1_ps(m[i]);
+
+		for (size_t i = 0; i < s.m_Count; i += 4) {
+			__m128 const x = _mm_loadu_ps(s.m_X + i);
+			__m128 const y = _mm_loadu_ps(s.m_Y + i);
+			__m128 const z = _mm_loadu_ps(s.m_Z + i);
+			_mm_storeu_ps(s.m_OutX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[0], x), _mm_mul_ps(col[4], y)), _mm_add_ps(_mm_mul_ps(col[8], z), col[12])));
+			_mm_storeu_ps(s.m_OutY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[1], x), _mm_mul_ps(col[5], y)), _mm_add_ps(_mm_mul_ps(col[9], z), col[13])));
+			_mm_storeu_ps(s.m_OutZ + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[2], x), _mm_mul_ps(col[6], y)), _mm_add_ps(_mm_mul_ps(col[10], z), col[14])));
+			_mm_storeu_ps(s.m_OutW + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[3], x), _mm_mul_ps(col[7], y)), _mm_add_ps(_mm_mul_ps(col[11], z), col[15])));
+		}
+	}
+
+	void projectSSE2(float const *m, ViewportMapping const &vp, StreamPointers const &s, uint8_t *clipCodes) {
+		__m128 col[16];
+		for (int i = 0; i < 16; ++i) col[i] = _mm_set1_ps(m[i]);
+		__m128 const scaleX = _mm_set1_ps(vp.m_Scale[0]);
+		__m128 const scaleY = _mm_set1_ps(vp.m_Scale[1]);
+		__m128 const scaleZ = _mm_set1_ps(vp.m_Scale[2]);
+		__m128 const offsetX = _mm_set1_ps(vp.m_Offset[0]);
+		__m128 const offsetY = _mm_set1_ps(vp.m_Offset[1]);
+		__m128 const offsetZ = _mm_set1_ps(vp.m_Offset[2]);
+		__m128 const one = _mm_set1_ps(1.0f);
+		__m128 const signBit = _mm_set1_ps(-0.0f);
+
+		for (size_t i = 0; i < s.m_Count; i += 4) {
+			__m128 const x = _mm_loadu_ps(s.m_X + i);
+			__m128 const y = _mm_loadu_ps(s.m_Y + i);
+			__m128 const z = _mm_loadu_ps(s.m_Z + i);
+			__m128 const cx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[0], x), _mm_mul_ps(col[4], y)), _mm_add_ps(_mm_mul_ps(col[8], z), col[12]));
+			__m128 const cy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[1], x), _mm_mul_ps(col[5], y)), _mm_add_ps(_mm_mul_ps(col[9], z), col[13]));
+			__m128 const cz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[2], x), _mm_mul_ps(col[6], y)), _mm_add_ps(_mm_mul_ps(col[10], z), col[14]));
+			__m128 const cw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col[3], x), _mm_mul_ps(col[7], y)), _mm_add_ps(_mm_mul_ps(col[11], z), col[15]));
+
+			if (nullptr != clipCodes) {
+				__m128 const negW = _mm_xor_ps(cw, signBit);
+				writeClipCodes(clipCodes + i, std::min<size_t>(4, s.m_Count - i),
+					_mm_movemask_ps(_mm_cmplt_ps(cx, negW)), _mm_movemask_ps(_mm_cmpgt_ps(cx, cw)),
+					_mm_movemask_ps(_mm_cmplt_ps(cy, negW)), _mm_movemask_ps(_mm_cmpgt_ps(cy, cw)),
+					_mm_movemask_ps(_mm_cmplt_ps(cz, negW)), _mm_movemask_ps(_mm_cmpgt_ps(cz, cw)));
+			}
+
+			__m128 const invW = _mm_div_ps(one, cw);
+			_mm_storeu_ps(s.m_OutX + i, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cx, invW), scaleX), offsetX));
+			_mm_storeu_ps(s.m_OutY + i, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cy, invW), scaleY), offsetY));
+			_mm_storeu_ps(s.m_OutZ + i, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cz, invW), scaleZ), offsetZ));
+			_mm_storeu_ps(s.m_OutW + i, invW);
+		}
+	}
+
+
+
+	// AVX2 + FMA (8 vertices per iteration)
+	// -------------------------------------
+
+	SIMD_TARGET_AVX2_FMA void transformAVX2(float const *m, StreamPointers const &s) {
+		__m256 col[16];
+		for (int i = 0; i < 16; ++i) col[i] = _mm256_set1_ps(m[i]);
+
+		for (size_t i = 0; i < s.m_Count; i += 8) {
+			__m256 const x = _mm256_loadu_ps(s.m_X + i);
+			__m256 const y = _mm256_loadu_ps(s.m_Y + i);
+			__m256 const z = _mm256_loadu_ps(s.m_Z + i);
+			_mm256_storeu_ps(s.m_OutX + i, _mm256_fmadd_ps(col[0], x, _mm256_fmadd_ps(col[4], y, _mm256_fmadd_ps(col[8], z, col[12]))));
+			_mm256_storeu_ps(s.m_OutY + i, _mm256_fmadd_ps(col[1], x, _mm256_fmadd_ps(col[5], y, _mm256_fmadd_ps(col[9], z, col[13]))));
+			_mm256_storeu_ps(s.m_OutZ + i, _mm256_fmadd_ps(col[2], x, _mm256_fmadd_ps(col[6], y, _mm256_fmadd_ps(col[10], z, col[14]))));
+			_mm256_storeu_ps(s.m_OutW + i, _mm256_fmadd_ps(col[3], x, _mm256_fmadd_ps(col[7], y, _mm256_fmadd_ps(col[11], z, col[15]))));
+		}
+	}
+
+	SIMD_TARGET_AVX2_FMA void projectAVX2(float const *m, ViewportMapping const &vp, StreamPointers const &s, uint8_t *clipCodes) {
+		__m256 col[16];
+		for (int i = 0; i < 16; ++i) col[i] = _mm256_set1_ps(m[i]);
+		__m256 const scaleX = _mm256_set1_ps(vp.m_Scale[0]);
+		__m256 const scaleY = _mm256_set1_ps(vp.m_Scale[1]);
+		__m256 const scaleZ = _mm256_set1_ps(vp.m_Scale[2]);
+		__m256 const offsetX = _mm256_set1_ps(vp.m_Offset[0]);
+		__m256 const offsetY = _mm256_set1_ps(vp.m_Offset[1]);
+		__m256 const offsetZ = _mm256_set1_ps(vp.m_Offset[2]);
+		__m256 const one = _mm256_set1_ps(1.0f);
+		__m256 const signBit = _mm256_set1_ps(-0.0f);
+
+		for (size_t i = 0; i < s.m_Count; i += 8) {
+			__m256 const x = _mm256_loadu_ps(s.m_X + i);
+			__m256 const y = _mm256_loadu_ps(s.m_Y + i);
+			__m256 const z = _mm256_loadu_ps(s.m_Z + i);
+			__m256 const cx = _mm256_fmadd_ps(col[0], x, _mm256_fmadd_ps(col[4], y, _mm256_fmadd_ps(col[8], z, col[12])));
+			__m256 const cy = _mm256_fmadd_ps(col[1], x, _mm256_fmadd_ps(col[5], y, _mm256_fmadd_ps(col[9], z, col[13])));
+			__m256 const cz = _mm256_fmadd_ps(col[2], x, _mm256_fmadd_ps(col[6], y, _mm256_fmadd_ps(col[10], z, col[14])));
+			__m256 const cw = _mm256_fmadd_ps(col[3], x, _mm256_fmadd_ps(col[7], y, _mm256_fmadd_ps(col[11], z, col[15])));
+
+			if (nullptr != clipCodes) {
+				__m256 const negW = _mm256_xor_ps(cw, signBit);
+				writeClipCodes(clipCodes + i, std::min<size_t>(8, s.m_Count - i),
+					_mm256_movemask_ps(_mm256_cmp_ps(cx, negW, _CMP_LT_OQ)), _mm256_movemask_ps(_mm256_cmp_ps(cx, cw, _CMP_GT_OQ)),
+					_mm256_movemask_ps(_mm256_cmp_ps(cy, negW, _CMP_LT_OQ)), _mm256_movemask_ps(_mm256_cmp_ps(cy, cw, _CMP_GT_OQ)),
+					_mm256_movemask_ps(_mm256_cmp_ps(cz, negW, _CMP_LT_OQ)), _mm256_movemask_ps(_mm256_cmp_ps(cz, cw, _CMP_GT_OQ)));
+			}
+
+			__m256 const invW = _mm256_div_ps(one, cw);
+			_mm256_storeu_ps(s.m_OutX + i, _mm256_fmadd_ps(_mm256_mul_ps(cx, invW), scaleX, offsetX));
+			_mm256_storeu_ps(s.m_OutY + i, _mm256_fmadd_ps(_mm256_mul_ps(cy, invW), scaleY, offsetY));
+			_mm256_storeu_ps(s.m_OutZ + i, _mm256_fmadd_ps(_mm256_mul_ps(cz, invW), scaleZ, offsetZ));
+			_mm256_storeu_ps(s.m_OutW + i, invW);
+		}
+	}
+
+
+
+	// AVX-512 (16 vertices per iteration)
+	// -----------------------------------
+
+	SIMD_TARGET_AVX512 void transformAVX512(float const *m, StreamPointers const &s) {
+		__m512 col[16];
+		for (int i = 0; i < 16; ++i) col[i] = _mm512_set1_ps(m[i]);
+
+		for (size_t i = 0; i < s.m_Count; i += 16) {
+			__m512 const x = _mm512_loadu_ps(s.m_X + i);
+			__m512 const y = _mm512_loadu_ps(s.m_Y + i);
+			__m512 const z = _mm512_loadu_ps(s.m_Z + i);
+			_mm512_storeu_ps(s.m_OutX + i, _mm512_fmadd_ps(col[0], x, _mm512_fmadd_ps(col[4], y, _mm512_fmadd_ps(col[8], z, col[12]))));
+			_mm512_storeu_ps(s.m_OutY + i, _mm512_fmadd_ps(col[1], x, _mm512_fmadd_ps(col[5], y, _mm512_fmadd_ps(col[9], z, col[13]))));
+			_mm512_storeu_ps(s.m_OutZ + i, _mm512_fmadd_ps(col[2], x, _mm512_fmadd_ps(col[6], y, _mm512_fmadd_ps(col[10], z, col[14]))));
+			_mm512_storeu_ps(s.m_OutW + i, _mm512_fmadd_ps(col[3], x, _mm512_fmadd_ps(col[7], y, _mm512_fmadd_ps(col[11], z, col[15]))));
+		}
+	}
+
+	SIMD_TARGET_AVX512 void projectAVX512(float const *m, ViewportMapping const &vp, StreamPointers const &s, uint8_t *clipCodes) {
+		__m512 col[16];
+		for (int i = 0; i < 16; ++i) col[i] = _mm512_set1_ps(m[i]);
+		__m512 const scaleX = _mm512_set1_ps(vp.m_Scale[0]);
+		__m512 const scaleY = _mm512_set1_ps(vp.m_Scale[1]);
+		__m512 const scaleZ = _mm512_set1_ps(vp.m_Scale[2]);
+		__m512 const offsetX = _mm512_set1_ps(vp.m_Offset[0]);
+		__m512 const offsetY = _mm512_set1_ps(vp.m_Offset[1]);
+		__m512 const offsetZ = _mm512_set1_ps(vp.m_Offset[2]);
+		__m512 const one = _mm512_set1_ps(1.0f);
+		__m512 const zero = _mm512_setzero_ps();
+
+		for (size_t i = 0; i < s.m_Count; i += 16) {
+			__m512 const x = _mm512_loadu_ps(s.m_X + i);
+			__m512 const y = _mm512_loadu_ps(s.m_Y + i);
+			__m512 const z = _mm512_loadu_ps(s.m_Z + i);
+			__m512 const cx = _mm512_fmadd_ps(col[0], x, _mm512_fmadd_ps(col[4], y, _mm512_fmadd_ps(col[8], z, col[12])));
+			__m512 const cy = _mm512_fmadd_ps(col[1], x, _mm512_fmadd_ps(col[5], y, _mm512_fmadd_ps(col[9], z, col[13])));
+			__m512 const cz = _mm512_fmadd_ps(col[2], x, _mm512_fmadd_ps(col[6], y, _mm512_fmadd_ps(col[10], z, col[14])));
+			__m512 const cw = _mm512_fmadd_ps(col[3], x, _mm512_fmadd_ps(col[7], y, _mm512_fmadd_ps(col[11], z, col[15])));
+
+			if (nullptr != clipCodes) {
+				// AVX-512F has no float xor, so -w is 0 - w
+				__m512 const negW = _mm512_sub_ps(zero, cw);
+				writeClipCodes(clipCodes + i, std::min<size_t>(16, s.m_Count - i),
+					_mm512_cmp_ps_mask(cx, negW, _CMP_LT_OQ), _mm512_cmp_ps_mask(cx, cw, _CMP_GT_OQ),
+					_mm512_cmp_ps_mask(cy, negW, _CMP_LT_OQ), _mm512_cmp_ps_mask(cy, cw, _CMP_GT_OQ),
+					_mm512_cmp_ps_mask(cz, negW, _CMP_LT_OQ), _mm512_cmp_ps_mask(cz, cw, _CMP_GT_OQ));
+			}
+
+			__m512 const invW = _mm512_div_ps(one, cw);
+			_mm512_storeu_ps(s.m_OutX + i, _mm512_fmadd_ps(_mm512_mul_ps(cx, invW), scaleX, offsetX));
+			_mm512_storeu_ps(s.m_OutY + i, _mm512_fmadd_ps(_mm512_mul_ps(cy, invW), scaleY, offsetY));
+			_mm512_storeu_ps(s.m_OutZ + i, _mm512_fmadd_ps(_mm512_mul_ps(cz, invW), scaleZ, offsetZ));
+			_mm512_storeu_ps(s.m_OutW + i, invW);
+		}
+	}
+
+
+
+	SimdLevel kernelLevel(SimdLevel level) {
+		level = clampSimdLevel(level);
+		if (SimdLevel::SSE41 == level) return SimdLevel::SSE2; // nothing in SSE4.1 helps a multiply-add chain
+		return level;
+	}
+
+	TransformKernel transformKernelFor(SimdLevel level) {
+		switch (level) {
+			case SimdLevel::AVX512: return transformAVX512;
+			case SimdLevel::AVX2: return transformAVX2;
+			case SimdLevel::SSE2: return transformSSE2;
+			default: return transformScalar;
+		}
+	}
+
+	ProjectKernel projectKernelFor(SimdLevel level) {
+		switch (level) {
+			case SimdLevel::AVX512: return projectAVX512;
+			case SimdLevel::AVX2: return projectAVX2;
+			case SimdLevel::SSE2: return projectSSE2;
+			default: return projectScalar;
+		}
+	}
+
+	StreamPointers makeStreams(PositionsSoA const &in, PositionsSoA &out) {
+		out.resize(in.m_Count);
+		StreamPointers s;
+		s.m_X = in.m_X.data();
+		s.m_Y = in.m_Y.data();
+		s.m_Z = in.m_Z.data();
+		s.m_OutX = out.m_X.data();
+		s.m_OutY = out.m_Y.data();
+		s.m_OutZ = out.m_Z.data();
+		s.m_OutW = out.m_W.data();
+		s.m_Count = in.m_Count;
+		return s;
+	}
+}
+
+
+
+void PositionsSoA::resize(size_t count) {
+	size_t const padded = (count + POSITION_BLOCK - 1) / POSITION_BLOCK * POSITION_BLOCK;
+	m_Count = count;
+	m_X.resize(padded);
+	m_Y.resize(padded);
+	m_Z.resize(padded);
+	m_W.resize(padded);
+	std::fill(m_X.begin() + count, m_X.end(), 0.0f);
+	std::fill(m_Y.begin() + count, m_Y.end(), 0.0f);
+	std::fill(m_Z.begin() + count, m_Z.end(), 0.0f);
+	std::fill(m_W.begin() + count, m_W.end(), 0.0f);
+}
+
+void PositionsSoA::loadAoS(float const *xyz, size_t count, size_t stride) {
+	resize(count);
+	float *x = m_X.data();
+	float *y = m_Y.data();
+	float *z = m_Z.data();
+
+	size_t i = 0;
+	if (3 == stride) {
+		// 4 tightly packed vertices = 3 registers: [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3], shuffle them into x/y/z
+		for (; i + 4 <= count; i += 4) {
+			__m128 const a = _mm_loadu_ps(xyz + 3 * i);
+			__m128 const b = _mm_loadu_ps(xyz + 3 * i + 4);
+			__m128 const c = _mm_loadu_ps(xyz + 3 * i + 8);
+			__m128 const b2b3c1c2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+			__m128 const a1a2b0b1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+			_mm_storeu_ps(x + i, _mm_shuffle_ps(a, b2b3c1c2, _MM_SHUFFLE(2, 0, 3, 0)));
+			_mm_storeu_ps(y + i, _mm_shuffle_ps(a1a2b0b1, b2b3c1c2, _MM_SHUFFLE(3, 1, 2, 0)));
+			_mm_storeu_ps(z + i, _mm_shuffle_ps(a1a2b0b1, c, _MM_SHUFFLE(3, 0, 3, 1)));
+		}
+	}
+	for (; i < count; ++i) {
+		x[i] = xyz[stride * i];
+		y[i] = xyz[stride * i + 1];
+		z[i] = xyz[stride * i + 2];
+	}
+}
+
+void PositionsSoA::storeXY(float *xy) const {
+	for (size_t i = 0; i < m_Count; ++i) {
+		xy[2 * i] = m_X[i];
+		xy[2 * i + 1] = m_Y[i];
+	}
+}
+
+
+
+VertexTransformer::VertexTransformer(SimdLevel level) : m_Level(kernelLevel(level)) {}
+
+void VertexTransformer::transform(glm::mat4 const &m, PositionsSoA const &in, PositionsSoA &clip) const {
+	StreamPointers const s = makeStreams(in, clip);
+	transformKernelFor(m_Level)(glm::value_ptr(m), s);
+}
+
+void VertexTransformer::project(glm::mat4 const &mvp, PositionsSoA const &in, Viewport const &viewport, PositionsSoA &window, uint8_t *clipCodes) const {
+	StreamPointers const s = makeStreams(in, window);
+	projectKernelFor(m_Level)(glm::value_ptr(mvp), makeViewportMapping(viewport), s, clipCodes);
+}
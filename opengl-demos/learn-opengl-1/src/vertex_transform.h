@@ -0,0 +1,83 @@
+#pragma once
+
+#include "cpu_features.h"
+
+#include <glm/mat4x4.hpp> // glm::mat4
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// batched vertex transforms on SoA (structure of arrays) position blocks
+// - GLM's glm_mat4_mul_vec4 (glm/simd/matrix.h) transforms 1 vec4 per call and spends most of it on shuffles,
+//   here every matrix element is broadcast once and 4 (SSE2), 8 (AVX2+FMA) or 16 (AVX-512) vertices go through per iteration
+// - the demos' vertex data is AoS float[3] (x, y, z, x, y, z, ...), so convert once with loadAoS() and keep the SoA copy around
+// - this is the inner loop for CPU skinning / culling / the software rasterizer
+
+
+
+// 1 array per component, padded up to POSITION_BLOCK entries so every kernel only ever runs whole blocks
+// NOTE: the padding lanes hold junk after a transform, only the first m_Count entries are meaningful
+struct PositionsSoA {
+	static size_t const POSITION_BLOCK = 16; // widest kernel (AVX-512)
+
+	void resize(size_t count); // also zeroes the padding lanes
+
+	// stride = floats from one vertex to the next (3 for the demos' tightly packed float[3] positions)
+	void loadAoS(float const *xyz, size_t count, size_t stride = 3);
+
+	// interleaved (x, y) pairs, the layout Rasterizer::drawTriangles() takes
+	void storeXY(float *xy) const;
+
+	size_t paddedSize() const { return m_X.size(); }
+
+	size_t m_Count = 0;
+	std::vector<float> m_X;
+	std::vector<float> m_Y;
+	std::vector<float> m_Z;
+	std::vector<float> m_W; // only used by outputs (clip w, or 1/w after project())
+};
+
+
+
+// what glViewport() + glDepthRange() describe (see the VIEWPORT TRANSFORM note at the bottom of main.cpp)
+struct Viewport {
+	float m_X = 0.0f;
+	float m_Y = 0.0f;
+	float m_Width = 0.0f;
+	float m_Height = 0.0f;
+	float m_Near = 0.0f; // glDepthRange() defaults
+	float m_Far = 1.0f;
+	bool m_FlipY = false; // GL window coords are y-up, set this for y-down targets (e.g. RasterTarget)
+};
+
+// per-vertex outcodes from project(), a vertex is inside the view volume when its code is 0
+enum ClipCode : uint8_t {
+	CLIP_LEFT = 1 << 0, // x < -w
+	CLIP_RIGHT = 1 << 1, // x > w
+	CLIP_BOTTOM = 1 << 2, // y < -w
+	CLIP_TOP = 1 << 3, // y > w
+	CLIP_NEAR = 1 << 4, // z < -w
+	CLIP_FAR = 1 << 5 // z > w
+};
+
+
+
+class VertexTransformer {
+public:
+	// the requested level is clamped to what the CPU supports (SSE4.1 runs the SSE2 kernel)
+	explicit VertexTransformer(SimdLevel level = SimdLevel::AVX512);
+
+	SimdLevel getSimdLevel() const { return m_Level; }
+
+	// clip = m * (x, y, z, 1), all 4 output components written
+	void transform(glm::mat4 const &m, PositionsSoA const &in, PositionsSoA &clip) const;
+
+	// transform + perspective divide + viewport mapping in 1 pass
+	// window.xyz = window coords and depth, window.w = 1 / clip w (what perspective-correct interpolation needs)
+	// clipCodes (optional, m_Count entries) gets the ClipCode bits of every vertex, vertices with w <= 0 have junk window coords so check these first
+	void project(glm::mat4 const &mvp, PositionsSoA const &in, Viewport const &viewport, PositionsSoA &window, uint8_t *clipCodes = nullptr) const;
+
+private:
+	SimdLevel m_Level;
+};
@@ -0,0 +1,140 @@
+// glm_mat4_mul_vec4 (glm/simd/matrix.h) is only compiled in when GLM is allowed to use intrinsics: GLM_FORCE_INTRINSICS is a
+// project-wide preprocessor definition (in 1 file only, GLM's inline functions would differ between files = ODR violation)
+
+#include "benchmarks.h"
+#include "vertex_transform.h"
+
+#include <glm/vec3.hpp> // glm::vec3
+#include <glm/vec4.hpp> // glm::vec4
+#include <glm/mat4x4.hpp> // glm::mat4
+#include <glm/gtc/matrix_transform.hpp> // glm::translate, glm::rotate, glm::scale, glm::perspective
+#include <glm/gtc/type_ptr.hpp> // glm::value_ptr
+#include <glm/simd/matrix.h> // glm_mat4_mul_vec4
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+
+// AoS (1 vec4 at a time, like the GPU-less path would do with plain glm) vs the SoA VertexTransformer kernels
+// reports millions of vertices per second for transform-only and transform + divide + viewport (project)
+
+
+
+namespace {
+	size_t const BENCH_VERTICES = 1 << 20;
+
+	// same shape as camera() in main.cpp
+	glm::mat4 benchMVP() {
+		glm::mat4 const projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.f);
+		glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+		view = glm::rotate(view, 0.3f, glm::vec3(-1.0f, 0.0f, 0.0f));
+		view = glm::rotate(view, 0.7f, glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 const model = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+		return projection * view * model;
+	}
+
+	// run fn until ~0.25s has been measured, returns millions of vertices per second
+	template <typename Fn>
+	double measureMVerts(Fn fn) {
+		int passes = 0;
+		double const start = benchSeconds();
+		double elapsed = 0.0;
+		do {
+			fn();
+			++passes;
+			elapsed = benchSeconds() - start;
+		} while (elapsed < 0.25);
+		return static_cast<double>(passes) * BENCH_VERTICES / elapsed * 1e-6;
+	}
+
+	float maxRelativeError(std::vector<float> const &a, std::vector<float> const &b, size_t count) {
+		float worst = 0.0f;
+		for (size_t i = 0; i < count; ++i) worst = std::max(worst, std::fabs(a[i] - b[i]) / std::max(1.0f, std::fabs(b[i])));
+		return worst;
+	}
+}
+
+
+
+int vertexTransformBenchMain() {
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+	std::vector<float> aos(BENCH_VERTICES * 3);
+	for (float &v : aos) v = coord(rng);
+
+	glm::mat4 const mvp = benchMVP();
+	Viewport viewport;
+	viewport.m_Width = 1920.0f;
+	viewport.m_Height = 1080.0f;
+
+	std::vector<glm::vec4> aosOut(BENCH_VERTICES);
+	double sink = 0.0;
+
+	std::printf("%-24s %12s\n", "variant", "Mverts/s");
+
+	// plain glm, 1 vertex at a time (what you'd write first)
+	double const glmTransform = measureMVerts([&]() {
+		for (size_t i = 0; i < BENCH_VERTICES; ++i) aosOut[i] = mvp * glm::vec4(aos[3 * i], aos[3 * i + 1], aos[3 * i + 2], 1.0f);
+	});
+	sink += aosOut[BENCH_VERTICES / 2].x;
+	std::printf("%-24s %12.1f\n", "glm aos transform", glmTransform);
+
+	double const glmProject = measureMVerts([&]() {
+		for (size_t i = 0; i < BENCH_VERTICES; ++i) {
+			glm::vec4 const clip = mvp * glm::vec4(aos[3 * i], aos[3 * i + 1], aos[3 * i + 2], 1.0f);
+			float const invW = 1.0f / clip.w;
+			aosOut[i] = glm::vec4((clip.x * invW + 1.0f) * 0.5f * viewport.m_Width, (clip.y * invW + 1.0f) * 0.5f * viewport.m_Height, (clip.z * invW + 1.0f) * 0.5f, invW);
+		}
+	});
+	sink += aosOut[BENCH_VERTICES / 2].x;
+	std::printf("%-24s %12.1f\n", "glm aos project", glmProject);
+
+	// glm's simd layer, still 1 vec4 per call
+	glm_vec4 simdMatrix[4];
+	for (int c = 0; c < 4; ++c) simdMatrix[c] = _mm_loadu_ps(glm::value_ptr(mvp) + 4 * c);
+	double const glmSimdTransform = measureMVerts([&]() {
+		for (size_t i = 0; i < BENCH_VERTICES; ++i) {
+			glm_vec4 const v = _mm_setr_ps(aos[3 * i], aos[3 * i + 1], aos[3 * i + 2], 1.0f);
+			_mm_storeu_ps(&aosOut[i].x, glm_mat4_mul_vec4(simdMatrix, v));
+		}
+	});
+	sink += aosOut[BENCH_VERTICES / 2].x;
+	std::printf("%-24s %12.1f\n", "glm_mat4_mul_vec4 aos", glmSimdTransform);
+
+	// SoA kernels, 1 row per SIMD level this CPU supports
+	PositionsSoA positions;
+	double const convert = measureMVerts([&]() { positions.loadAoS(aos.data(), BENCH_VERTICES); });
+	std::printf("%-24s %12.1f\n", "aos -> soa convert", convert);
+
+	PositionsSoA reference;
+	std::vector<uint8_t> clipCodes(BENCH_VERTICES);
+	VertexTransformer(SimdLevel::Scalar).project(mvp, positions, viewport, reference, clipCodes.data());
+
+	bool allMatch = true;
+	PositionsSoA out;
+	for (SimdLevel const level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+		VertexTransformer const transformer(level);
+		if (transformer.getSimdLevel() != level) continue;
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "soa %s transform", simdLevelName(level));
+		std::printf("%-24s %12.1f\n", name, measureMVerts([&]() { transformer.transform(mvp, positions, out); }));
+		std::snprintf(name, sizeof(name), "soa %s project", simdLevelName(level));
+		std::printf("%-24s %12.1f\n", name, measureMVerts([&]() { transformer.project(mvp, positions, viewport, out, clipCodes.data()); }));
+
+		// FMA rounds differently from mul + add, so compare with a tolerance rather than bit for bit
+		float const error = std::max(maxRelativeError(out.m_X, reference.m_X, BENCH_VERTICES), maxRelativeError(out.m_Y, reference.m_Y, BENCH_VERTICES));
+		if (1e-4f < error) {
+			std::printf("MISMATCH: %s differs from scalar (max relative error %g)\n", simdLevelName(level), error);
+			allMatch = false;
+		}
+		sink += out.m_X[BENCH_VERTICES / 2];
+	}
+
+	std::printf("(checksum %g)\n", sink);
+	return allMatch ? 0 : -1;
+}
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Scrapes the demo's metrics endpoint (src/metrics_server.h) like Prometheus would and checks the exposition format.
+The demo only serves it when started with --metrics.
+
+- python3 scrape_metrics.py                        http://127.0.0.1:9464/metrics once, prints the samples
+- python3 scrape_metrics.py --unix /tmp/gl.sock    the same over a Unix domain socket
+- python3 scrape_metrics.py --count 5 --interval 2 scrapes repeatedly and prints the counters' per second rates
+  (frames, draw calls, upload bandwidth, ...)
+exits non-zero when the endpoint can't be reached, the response isn't HTTP 200 or the text isn't valid exposition format
+(only the standard library, so it runs on any render node)
+"""
+
+import argparse
+import math
+import re
+import socket
+import sys
+import time
+
+NAME = r'[a-zA-Z_:][a-zA-Z0-9_:]*'
+SAMPLE = re.compile(r'^(' + NAME + r')(\{(.*)\})? (\S+)( -?\d+)?$')
+LABEL = re.compile(r'\s*([a-zA-Z_][a-zA-Z0-9_]*)="((?:[^"\\]|\\.)*)"\s*(,|$)')
+TYPES = ('counter', 'gauge', 'histogram', 'summary', 'untyped')
+
+
+def fetch(args):
+    if args.unix:
+        connection = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        address = args.unix
+    else:
+        connection = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        address = (args.host, args.port)
+    connection.settimeout(args.timeout)
+    try:
+        connection.connect(address)
+        connection.sendall(b'GET /metrics HTTP/1.1\r\nHost: localhost\r\nAccept: text/plain\r\nConnection: close\r\n\r\n')
+        chunks = []
+        while True:
+            chunk = connection.recv(65536)
+            if not chunk:
+                break
+            chunks.append(chunk)
+    finally:
+        connection.close()
+
+    response = b''.join(chunks)
+    header, separator, body = response.partition(b'\r\n\r\n')
+    if not separator:
+        raise ValueError('no HTTP header end')
+    lines = header.decode('latin-1').split('\r\n')
+    if not lines[0].startswith('HTTP/1.1 200'):
+        raise ValueError('status: ' + lines[0])
+    headers = dict(line.split(': ', 1) for line in lines[1:] if ': ' in line)
+    if not headers.get('Content-Type', '').startswith('text/plain; version=0.0.4'):
+        raise ValueError('content type: ' + headers.get('Content-Type', '(none)'))
+    if int(headers.get('Content-Length', -1)) != len(body):
+        raise ValueError('content length %s, got %d bytes' % (headers.get('Content-Length'), len(body)))
+    return body.decode('utf-8')
+
+
+def family_of(name, types):
+    for suffix in ('_bucket', '_sum', '_count'):
+        if name.endswith(suffix) and types.get(name[:-len(suffix)]) in ('histogram', 'summary'):
+            return name[:-len(suffix)]
+    return name
+
+
+def parse_value(text):
+    if text in ('+Inf', '-Inf', 'NaN'):
+        return float(text.replace('Inf', 'inf').replace('NaN', 'nan'))
+    return float(text)
+
+
+def parse(text):
+    """{(name, labels): value}, raises ValueError on anything that isn't valid exposition format"""
+    if text and not text.endswith('\n'):
+        raise ValueError('no newline at the end')
+    types = {}
+    samples = {}
+    seen_families = []
+    for number, line in enumerate(text.splitlines(), 1):
+        if not line:
+            continue
+        if line.startswith('#'):
+            parts = line.split(None, 3)
+            if 3 <= len(parts) and parts[1] == 'TYPE':
+                if len(parts) != 4 or parts[3] not in TYPES or not re.match('^' + NAME + '$', parts[2]):
+                    raise ValueError('line %d: bad TYPE: %s' % (number, line))
+                if parts[2] in types:
+                    raise ValueError('line %d: second TYPE for %s' % (number, parts[2]))
+                if parts[2] in seen_families:
+                    raise ValueError('line %d: TYPE after the samples of %s' % (number, parts[2]))
+                types[parts[2]] = parts[3]
+            continue
+        match = SAMPLE.match(line)
+        if not match:
+            raise ValueError('line %d: bad sample: %s' % (number, line))
+        name, labels_text, value = match.group(1), match.group(3) or '', match.group(4)
+        labels = []
+        position = 0
+        while position < len(labels_text):
+            label = LABEL.match(labels_text, position)
+            if not label:
+                raise ValueError('line %d: bad labels: %s' % (number, line))
+            labels.append((label.group(1), label.group(2)))
+            position = label.end()
+        try:
+            value = parse_value(value)
+        except ValueError:
+            raise ValueError('line %d: bad value: %s' % (number, line))
+        family = family_of(name, types)
+        if family in seen_families and seen_families[-1] != family:
+            raise ValueError('line %d: samples of %s are not together' % (number, family))
+        if family not in seen_families:
+            seen_families.append(family)
+        key = (name, tuple(labels))
+        if key in samples:
+            raise ValueError('line %d: duplicate sample: %s' % (number, line))
+        samples[key] = value
+        if types.get(family) == 'counter' and not (value >= 0):
+            raise ValueError('line %d: negative counter: %s' % (number, line))
+
+    # a histogram's buckets are cumulative and end with +Inf = _count
+    for family, kind in types.items():
+        if kind != 'histogram':
+            continue
+        buckets = sorted((parse_value(dict(labels)['le']), value) for (name, labels), value in samples.items()
+                         if name == family + '_bucket')
+        if not buckets or not math.isinf(buckets[-1][0]):
+            raise ValueError('%s: no +Inf bucket' % family)
+        if any(later < earlier for (_, earlier), (_, later) in zip(buckets, buckets[1:])):
+            raise ValueError('%s: buckets are not cumulative' % family)
+        if samples.get((family + '_count', ())) != buckets[-1][1]:
+            raise ValueError('%s: _count differs from the +Inf bucket' % family)
+    return types, samples
+
+
+def format_key(key):
+    name, labels = key
+    if not labels:
+        return name
+    return '%s{%s}' % (name, ','.join('%s="%s"' % label for label in labels))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=9464)
+    parser.add_argument('--unix', help='Unix domain socket path instead of TCP')
+    parser.add_argument('--count', type=int, default=1, help='scrapes')
+    parser.add_argument('--interval', type=float, default=1.0, help='seconds between scrapes')
+    parser.add_argument('--timeout', type=float, default=5.0, help='seconds')
+    args = parser.parse_args()
+
+    previous = None
+    for scrape in range(args.count):
+        if scrape:
+            time.sleep(args.interval)
+        started = time.perf_counter()
+        try:
+            types, samples = parse(fetch(args))
+        except (OSError, ValueError) as error:
+            print('scrape failed: %s' % error, file=sys.stderr)
+            return 1
+        elapsed_ms = (time.perf_counter() - started) * 1000.0
+        print('scrape %d: %d samples in %d families, %.2fms' % (scrape + 1, len(samples), len(types), elapsed_ms))
+
+        if previous is None:
+            for key, value in sorted(samples.items()):
+                print('  %-60s %.9g' % (format_key(key), value))
+        else:
+            seconds = time.monotonic() - previous[0]
+            for key, value in sorted(samples.items()):
+                if types.get(family_of(key[0], types)) == 'counter' and key in previous[1]:
+                    print('  %-60s %.6g/s' % (format_key(key), (value - previous[1][key]) / seconds))
+        previous = (time.monotonic(), samples)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())